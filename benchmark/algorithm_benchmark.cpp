@@ -0,0 +1,176 @@
+// case insensitive ifind, irfind and iequals against a byte by byte loop and against the lowered copies they
+// replaced, over the lines of the behavior XML files under a folder
+// usage: algorithm_benchmark [folder], the test environment meshes by default
+// the three versions are compared on every line and a mismatch fails the run
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "utilities/algorithm.h"
+
+namespace
+{
+    // words the scanners search for, in a case the XML does not use
+    const std::string_view words[] = {"NUMELEMENTS=\"", "HKBCLIPGENERATOR", "<!-- Original -->", "$EventID["};
+
+    std::string Lowered(std::string_view text)
+    {
+        std::string copy(text);
+        std::transform(copy.begin(), copy.end(), copy.begin(), [](unsigned char ch) { return char(tolower(ch)); });
+        return copy;
+    }
+
+    bool ScalarEquals(std::string_view l, std::string_view r)
+    {
+        if (l.size() != r.size()) return false;
+
+        for (size_t i = 0; i < l.size(); ++i)
+        {
+            if (nemesis::ascii_lower(l[i]) != nemesis::ascii_lower(r[i])) return false;
+        }
+
+        return true;
+    }
+
+    size_t ScalarFind(std::string_view text, std::string_view word)
+    {
+        if (word.size() > text.size()) return std::string_view::npos;
+
+        for (size_t pos = 0; pos + word.size() <= text.size(); ++pos)
+        {
+            if (ScalarEquals(text.substr(pos, word.size()), word)) return pos;
+        }
+
+        return std::string_view::npos;
+    }
+
+    size_t ScalarReverseFind(std::string_view text, std::string_view word)
+    {
+        if (word.size() > text.size()) return std::string_view::npos;
+
+        for (size_t pos = text.size() - word.size() + 1; pos-- > 0;)
+        {
+            if (ScalarEquals(text.substr(pos, word.size()), word)) return pos;
+        }
+
+        return std::string_view::npos;
+    }
+
+    size_t CopyFind(std::string_view text, std::string_view word)
+    {
+        return Lowered(text).find(Lowered(word));
+    }
+
+    size_t CopyReverseFind(std::string_view text, std::string_view word)
+    {
+        return Lowered(text).rfind(Lowered(word));
+    }
+
+    bool CopyEquals(std::string_view l, std::string_view r)
+    {
+        return Lowered(l) == Lowered(r);
+    }
+
+    template <typename Find>
+    size_t FindAll(const std::vector<std::string>& lines, Find&& find)
+    {
+        size_t found = 0;
+
+        for (auto& line : lines)
+        {
+            for (auto word : words)
+            {
+                found += find(line, word) != std::string_view::npos;
+            }
+        }
+
+        return found;
+    }
+
+    template <typename Equals>
+    size_t EqualsAll(const std::vector<std::string>& lines, const std::vector<std::string>& upper, Equals&& equals)
+    {
+        size_t found = 0;
+
+        for (size_t i = 0; i < lines.size(); ++i)
+        {
+            found += equals(lines[i], upper[i]);
+        }
+
+        return found;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path folder = argc > 1 ? argv[1] : NEMESIS_ROOT_DIR "/test environment/data/meshes";
+    std::vector<std::string> lines = bench::ReadLines(folder, ".xml");
+
+    if (lines.empty())
+    {
+        std::printf("no .xml lines under %s\n", folder.string().c_str());
+        return 1;
+    }
+
+    // every other line differs from its upper case copy in its last byte, so iequals reads the whole line
+    std::vector<std::string> upper;
+    upper.reserve(lines.size());
+
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        upper.push_back(nemesis::to_upper_copy(lines[i]));
+
+        if (i % 2 == 1 && !upper.back().empty()) upper.back().back() ^= 0x40;
+    }
+
+    size_t mismatches = 0;
+
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        const std::string& line = lines[i];
+
+        for (auto word : words)
+        {
+            size_t found = nemesis::ifind(line, word);
+            mismatches += found != ScalarFind(line, word) || found != CopyFind(line, word);
+
+            found = nemesis::irfind(line, word);
+            mismatches += found != ScalarReverseFind(line, word) || found != CopyReverseFind(line, word);
+        }
+
+        bool equal = nemesis::iequals(line, upper[i]);
+        mismatches += equal != ScalarEquals(line, upper[i]) || equal != CopyEquals(line, upper[i]);
+    }
+
+    std::printf("%zu lines, %zu mismatches\n", lines.size(), mismatches);
+
+    auto ifind = [](std::string_view text, std::string_view word) { return nemesis::ifind(text, word); };
+    auto irfind = [](std::string_view text, std::string_view word) { return nemesis::irfind(text, word); };
+    auto iequals = [](std::string_view l, std::string_view r) { return nemesis::iequals(l, r); };
+
+    double copy   = bench::Run("ifind, lowered copies", [&] { return FindAll(lines, CopyFind); });
+    double scalar = bench::Run("ifind, byte loop", [&] { return FindAll(lines, ScalarFind); });
+    double sse2   = bench::Run("ifind", [&] { return FindAll(lines, ifind); });
+    bench::Ratio("ifind against lowered copies", copy, sse2);
+    bench::Ratio("ifind against byte loop", scalar, sse2);
+
+    copy   = bench::Run("irfind, lowered copies", [&] { return FindAll(lines, CopyReverseFind); });
+    scalar = bench::Run("irfind, byte loop", [&] { return FindAll(lines, ScalarReverseFind); });
+    sse2   = bench::Run("irfind", [&] { return FindAll(lines, irfind); });
+    bench::Ratio("irfind against lowered copies", copy, sse2);
+    bench::Ratio("irfind against byte loop", scalar, sse2);
+
+    copy   = bench::Run("iequals, lowered copies", [&] { return EqualsAll(lines, upper, CopyEquals); });
+    scalar = bench::Run("iequals, byte loop", [&] { return EqualsAll(lines, upper, ScalarEquals); });
+    sse2   = bench::Run("iequals", [&] { return EqualsAll(lines, upper, iequals); });
+    bench::Ratio("iequals against lowered copies", copy, sse2);
+    bench::Ratio("iequals against byte loop", scalar, sse2);
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    // results are added here so the measured work is not optimized away
+    inline volatile size_t sink = 0;
+
+    // calls fn until minSeconds have passed and prints the time of one call
+    // fn returns a value derived from its work
+    template <typename F>
+    double Run(const char* name, F&& fn, double minSeconds = 0.5)
+    {
+        using clock = std::chrono::steady_clock;
+
+        sink += fn();
+
+        size_t calls = 0;
+        double elapsed;
+        auto start = clock::now();
+
+        do
+        {
+            sink += fn();
+            ++calls;
+            elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        } while (elapsed < minSeconds);
+
+        double perCall = elapsed / calls;
+        std::printf("%-48s %12.3f us\n", name, perCall * 1e6);
+        return perCall;
+    }
+
+    inline void Ratio(const char* name, double before, double after)
+    {
+        std::printf("%-48s %12.2fx\n", name, before / after);
+    }
+
+    // lines of every file with the extension under folder, without their line endings
+    inline std::vector<std::string> ReadLines(const std::filesystem::path& folder, const std::string& extension)
+    {
+        std::vector<std::string> lines;
+
+        for (auto& entry : std::filesystem::recursive_directory_iterator(folder))
+        {
+            if (!entry.is_regular_file() || entry.path().extension() != extension) continue;
+
+            std::ifstream file(entry.path(), std::ios::binary);
+            std::string line;
+
+            while (std::getline(file, line))
+            {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+
+                lines.push_back(std::move(line));
+            }
+        }
+
+        return lines;
+    }
+} // namespace bench
+
+#endif
@@ -0,0 +1,96 @@
+// ClassifyLine against the find() chain it replaced, over the lines of the behavior XML files under a folder
+// usage: lineclassifier_benchmark [folder], the test environment meshes by default
+// the markers both report for every line are compared and a mismatch fails the run
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "utilities/lineclassifier.h"
+
+using nemesis::LineMarker;
+
+namespace
+{
+    struct Literal
+    {
+        LineMarker marker;
+        std::string_view text;
+    };
+
+    // markers that are a plain literal, found at the same position by both
+    const Literal literals[] = {
+        {LineMarker::Comment, "<!--"},
+        {LineMarker::ModCode, "<!-- *"},
+        {LineMarker::NewMod, "<!-- NEW *"},
+        {LineMarker::NewTemplate, "<!-- NEW ^"},
+        {LineMarker::ForEach, "<!-- FOREACH ^"},
+        {LineMarker::Original, "<!-- ORIGINAL -->"},
+        {LineMarker::Close, "<!-- CLOSE -->"},
+        {LineMarker::Condition, "<!-- CONDITION"},
+        {LineMarker::Object, "<hkobject name=\""},
+        {LineMarker::Param, "<hkparam name=\""},
+        {LineMarker::ParamClose, "</hkparam>"},
+        {LineMarker::CString, "<hkcstring>"},
+        {LineMarker::Reference, ">#"},
+        {LineMarker::EventID, "$eventID["},
+        {LineMarker::VariableID, "$variableID["},
+    };
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path folder = argc > 1 ? argv[1] : NEMESIS_ROOT_DIR "/test environment/data/meshes";
+    std::vector<std::string> lines = bench::ReadLines(folder, ".xml");
+
+    if (lines.empty())
+    {
+        std::printf("no .xml lines under %s\n", folder.string().c_str());
+        return 1;
+    }
+
+    size_t mismatches = 0;
+
+    for (auto& line : lines)
+    {
+        nemesis::LineClass lineClass = nemesis::ClassifyLine(line);
+
+        for (auto& literal : literals)
+        {
+            if (lineClass.Find(literal.marker) != line.find(literal.text)) ++mismatches;
+        }
+    }
+
+    std::printf("%zu lines, %zu mismatches\n", lines.size(), mismatches);
+
+    double before = bench::Run("find() per marker", [&] {
+        size_t found = 0;
+
+        for (auto& line : lines)
+        {
+            for (auto& literal : literals)
+            {
+                if (line.find(literal.text) != std::string::npos) ++found;
+            }
+        }
+
+        return found;
+    });
+
+    double after = bench::Run("ClassifyLine", [&] {
+        size_t found = 0;
+
+        for (auto& line : lines)
+        {
+            found += !nemesis::ClassifyLine(line).Empty();
+        }
+
+        return found;
+    });
+
+    bench::Ratio("speedup", before, after);
+    return mismatches == 0 ? 0 : 1;
+}
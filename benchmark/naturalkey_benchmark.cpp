@@ -0,0 +1,151 @@
+// NaturalMap against the std::map it replaced, over the node IDs and headers the update patcher stores
+// on Windows the std::map uses alphanum_less itself and the two iteration orders are compared
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "utilities/naturalkey.h"
+
+#ifdef _WIN32
+#include "utilities/alphanum.hpp"
+
+using OldLess = alphanum_less;
+#else
+// stand in for lstrcmpiA, which folds both strings on every comparison
+struct OldLess
+{
+    bool operator()(const std::string& x, const std::string& y) const
+    {
+        return nemesis::NaturalKey(x) < nemesis::NaturalKey(y);
+    }
+};
+#endif
+
+namespace
+{
+    std::vector<std::string> MakeKeys()
+    {
+        std::vector<std::string> keys;
+
+        for (int i = 0; i < 6000; ++i)
+        {
+            std::string num = std::to_string(i);
+            keys.push_back("#" + std::string(4 - std::min<size_t>(num.length(), 4), '0') + num);
+        }
+
+        const char* codes[] = {"fnis", "Pcea", "zcbe", "tk_dodge", "ultimate-combat", "MCO"};
+
+        for (auto& code : codes)
+        {
+            for (int i = 0; i < 500; ++i)
+            {
+                keys.push_back("#" + std::string(code) + "$" + std::to_string(i));
+            }
+        }
+
+        return keys;
+    }
+} // namespace
+
+int main()
+{
+    std::vector<std::string> keys     = MakeKeys();
+    std::vector<std::string> shuffled = keys;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+
+    std::map<std::string, int, OldLess> oldMap;
+    nemesis::NaturalMap<int> newMap;
+
+    for (auto& key : shuffled)
+    {
+        oldMap[key] = 1;
+        newMap[key] = 1;
+    }
+
+    size_t mismatch = 0;
+    auto newItr     = newMap.begin();
+
+    for (auto& entry : oldMap)
+    {
+        if (newItr == newMap.end() || newItr->first != entry.first) ++mismatch;
+
+        if (newItr != newMap.end()) ++newItr;
+    }
+
+    std::printf("%zu keys, %zu positions ordered differently from the std::map\n\n", keys.size(), mismatch);
+
+    double before = bench::Run("std::map insert (shuffled)", [&]() {
+        std::map<std::string, int, OldLess> map;
+
+        for (auto& key : shuffled)
+        {
+            map[key] = 1;
+        }
+
+        // one lookup, so the NaturalMap merges what it buffered
+        return map.size() + map.count(shuffled.front());
+    });
+    double after = bench::Run("NaturalMap insert (shuffled)", [&]() {
+        nemesis::NaturalMap<int> map;
+
+        for (auto& key : shuffled)
+        {
+            map[key] = 1;
+        }
+
+        // one lookup, so the NaturalMap merges what it buffered
+        return map.size() + map.count(shuffled.front());
+    });
+    bench::Ratio("insert speedup", before, after);
+
+    before = bench::Run("std::map insert (disassembly order)", [&]() {
+        std::map<std::string, int, OldLess> map;
+
+        for (auto& key : oldMap)
+        {
+            map[key.first] = 1;
+        }
+
+        return map.size();
+    });
+    after = bench::Run("NaturalMap insert (disassembly order)", [&]() {
+        nemesis::NaturalMap<int> map;
+
+        for (auto& key : oldMap)
+        {
+            map[key.first] = 1;
+        }
+
+        return map.size();
+    });
+    bench::Ratio("ordered insert speedup", before, after);
+
+    before = bench::Run("std::map find", [&]() {
+        size_t found = 0;
+
+        for (auto& key : shuffled)
+        {
+            found += oldMap.find(key) != oldMap.end();
+        }
+
+        return found;
+    });
+    after = bench::Run("NaturalMap find", [&]() {
+        size_t found = 0;
+
+        for (auto& key : shuffled)
+        {
+            found += newMap.find(key) != newMap.end();
+        }
+
+        return found;
+    });
+    bench::Ratio("find speedup", before, after);
+
+    return mismatch == 0 ? 0 : 1;
+}
@@ -12,7 +12,19 @@
 
 #include "ui/MessageHandler.h"
 
-extern bool error; // get error warning
+namespace nemesis
+{
+    // error state of the run bound to the calling thread, the process wide state on a thread outside of a run
+    // an error raised in a run is also raised in the process wide state, which the ui reads once the run is over
+    class ErrorFlag
+    {
+    public:
+        operator bool() const noexcept;
+        ErrorFlag& operator=(bool value) noexcept;
+    };
+} // namespace nemesis
+
+extern nemesis::ErrorFlag error; // get error warning
 extern bool isPatch;
 
 extern VecWstr warningMsges;
@@ -50,8 +62,8 @@ std::wstring DMLogWarning(int warningcode);
 std::string EngLogError(int errorcode);
 std::string EngLogWarning(int warningcode);
 
-int sameWordCount(std::string, std::string);
-int sameWordCount(std::wstring, std::wstring);
+int sameWordCount(std::string_view, std::string_view);
+int sameWordCount(std::wstring_view, std::wstring_view);
 
 template <typename type>
 inline void AdditionalInput(std::string& message, int counter, type input)
@@ -5,11 +5,14 @@
 #include <unordered_map>
 #include <vector>
 
+#include "utilities/pathinterner.h"
+
 bool AddAnims(std::string& line,
               const std::string& _animPath,
               const std::wstring& outputdir,
               const std::string& behaviorFile,
               const std::string& lowerBehaviorFile,
+              nemesis::PathHandle behaviorHandle,
               const std::string& _newMod,
               std::vector<std::string>& storeline,
               int& counter,
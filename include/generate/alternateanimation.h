@@ -5,8 +5,6 @@
 
 class NemesisInfo;
 
-extern std::unordered_map<std::string, int> AAgroup_Counter;
-
 void AAInitialize(std::string AAList);
 bool AAInstallation(const NemesisInfo* nemesisInfo);
 
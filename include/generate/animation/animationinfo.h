@@ -2,6 +2,7 @@
 #define ANIMATIONINFO_H_
 
 #include "generate/animation/optionlist.h"
+#include "generate/animation/optionset.h"
 
 #pragma warning(disable : 4503)
 
@@ -23,13 +24,10 @@ struct AnimationInfo
     VecStr variableID;
     VecStr motionData;
     VecStr rotationData;
-    SSMap mixOptRegis;
     ImportContainer addition;
-    std::unordered_map<std::string, VecStr> addOn; // option, list of add-on
-    std::unordered_map<std::string, VecStr> mixOptRever;
-    std::unordered_map<std::string, VecStr> linkedOption;
-    std::unordered_map<std::string, bool> groupOption;
-    std::unordered_map<std::string, bool> optionPicked;
+    std::shared_ptr<const AnimOptionData> options; // add-on and mixed options of the template
+    nemesis::OptionSet groupOption;
+    nemesis::OptionSet optionPicked;
     std::unordered_map<std::string, int> optionPickedCount;
     std::unordered_map<std::string, std::unordered_map<std::string, VecStr>> groupAddition;
     std::unordered_map<int, VecStr> AnimObject;
@@ -38,18 +36,19 @@ struct AnimationInfo
     {}
     AnimationInfo(VecStr newAnimInfo,
                   std::filesystem::path curFilename,
-                  OptionList behaviorOption,
+                  const OptionList& behaviorOption,
                   int linecount,
                   bool& isOExist,
                   bool noOption = false);
+    const AnimOptionData& GetOptions() const;
     void addFilename(std::string curFilename);
     void storeAnimObject(VecStr animobjects, std::filesystem::path listFilename, int lineCount);
     void groupAdditionProcess(
         std::string header,
         std::string addOnName,
         std::string name,
-        std::unordered_map<std::string, bool> optionGroup,
-        std::unordered_map<std::string, std::unordered_map<std::string, std::string>> modAddOn);
+        const nemesis::OptionSet& optionGroup,
+        const std::unordered_map<std::string, std::unordered_map<std::string, std::string>>& modAddOn);
 };
 
 #endif
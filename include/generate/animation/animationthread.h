@@ -5,6 +5,9 @@
 #include <memory>
 
 #include "generate/animation/animationinfo.h"
+#include "generate/behaviorreferences.h"
+
+#include "generate/animation/idrange.h"
 
 typedef std::unordered_map<std::string, int> ID;
 
@@ -15,11 +18,15 @@ struct group;
 struct master;
 struct GroupTemplate;
 
+namespace nemesis
+{
+    class FragmentCache;
+}
+
 struct NewAnimLock
 {
-    std::atomic_flag coreLock   = ATOMIC_FLAG_INIT;
     std::atomic_flag subIDLock  = ATOMIC_FLAG_INIT;
-    std::atomic_flag nodeIDLock  = ATOMIC_FLAG_INIT;
+    std::atomic_flag nodeIDLock = ATOMIC_FLAG_INIT;
     std::atomic_flag exportLock = ATOMIC_FLAG_INIT;
 };
 
@@ -28,8 +35,10 @@ struct NewAnimArgs
 public:
     std::string modID, lowerBehaviorFile, ZeroEvent, ZeroVariable;
     int* lastID;
+    std::shared_ptr<nemesis::IDRange> idRange = std::make_shared<nemesis::IDRange>();
+    std::shared_ptr<nemesis::BehaviorReferences> references = std::make_shared<nemesis::BehaviorReferences>();
     bool core, ignoreGroup, hasGroup;
-    bool skip = false;
+    bool skip = false; // core template already generated by an earlier animation
     bool& isCoreDone;
     std::shared_ptr<NewAnimation> dummyAnimation;
     std::unordered_map<int, int>& functionState;
@@ -42,6 +51,7 @@ public:
     std::shared_ptr<master> groupFunctionIDs;
     std::vector<std::vector<std::shared_ptr<AnimationInfo>>>& groupAnimInfo;
     std::shared_ptr<VecStr> allEditLines;
+    std::shared_ptr<nemesis::FragmentCache> fragments; // lines of earlier runs, single animations only
 
     NewAnimArgs(std::string n_modID,
                 std::string n_lowerBehaviorFile,
@@ -96,6 +106,8 @@ struct newGroupArgs
 public:
     std::string templateCode, lowerBehaviorFile, ZeroEvent, ZeroVariable, filename;
     int* lastID, groupCount;
+    std::shared_ptr<nemesis::IDRange> idRange = std::make_shared<nemesis::IDRange>();
+    std::shared_ptr<nemesis::BehaviorReferences> references = std::make_shared<nemesis::BehaviorReferences>();
     std::vector<int> stateID;
     std::shared_ptr<GroupTemplate> groupTemp;
     ImportContainer& exportID;
@@ -13,6 +13,11 @@ struct group;
 struct NewAnimLock;
 struct GroupTemplate;
 
+namespace nemesis
+{
+    class BehaviorReferences;
+}
+
 struct AnimThreadInfo
 {
     NewAnimLock* animLock;
@@ -37,8 +42,12 @@ struct AnimThreadInfo
     int furnitureCount;
 
     const std::unordered_map<int, VecStr> AnimObject;
-    const std::vector<std::unordered_map<std::string, bool>> groupOptionPicked;
-    const std::vector<std::vector<std::unordered_map<std::string, bool>>> masterOptionPicked;
+    const std::vector<nemesis::OptionSet> groupOptionPicked;
+    const std::vector<std::vector<nemesis::OptionSet>> masterOptionPicked;
+    const nemesis::OptionSet groupOptionAll;                // options picked by every animation of the group
+    const nemesis::OptionSet groupOptionAny;                // options picked by at least one animation of the group
+    const std::vector<nemesis::OptionSet> masterOptionAll;  // per group
+    const std::vector<nemesis::OptionSet> masterOptionAny;  // per group
     const std::unordered_map<std::string, std::unordered_map<std::string, VecStr>> groupAddition;
 
     std::string strID;
@@ -82,6 +91,9 @@ struct AnimThreadInfo
 
     std::shared_ptr<VecStr> generatedlines;
 
+    nemesis::BehaviorReferences* references = nullptr; // clips and behaviors of the generated nodes
+    std::string clipName;                              // name of the hkbClipGenerator being generated
+
     AnimThreadInfo(const std::string& _filepath,
                    const std::string& _filename,
                    const std::string& _mainAnimEvent,
@@ -109,8 +121,8 @@ struct AnimThreadInfo
                    const ImportContainer& _addition,
                    ImportContainer* _newImport,
                    const std::unordered_map<std::string, std::unordered_map<std::string, VecStr>>& _groupAddition,
-                   const std::vector<std::unordered_map<std::string, bool>>& _groupOptionPicked,
-                   const std::vector<std::vector<std::unordered_map<std::string, bool>>>& _masterOptionPicked,
+                   const std::vector<nemesis::OptionSet>& _groupOptionPicked,
+                   const std::vector<std::vector<nemesis::OptionSet>>& _masterOptionPicked,
                    std::shared_ptr<group> _groupFunction,
                    std::shared_ptr<VecStr> _generatedlines,
                    NewAnimation* _curAnim,
@@ -0,0 +1,141 @@
+#ifndef CONDITIONEXPR_H_
+#define CONDITIONEXPR_H_
+
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "generate/animation/optionset.h"
+
+namespace nemesis
+{
+    // and/or tree of a "<!-- condition -->" or animation data condition, parsed once per distinct condition text
+    // "&" binds tighter than "|", except that a condition starting with a group takes the rest as the other side of
+    // the group's operator. Both stop at the first operand that decides the result. The operands stay text and are
+    // evaluated by the caller
+    class ConditionExpr
+    {
+    public:
+        struct Operand
+        {
+            std::string text; // option condition without its "!"
+            bool isNot = false;
+
+            // <left == right> / <left != right>, with a trailing "*" when fulfilling it once is enough
+            bool isComparison = false;
+            bool oneTime      = false;
+            std::string left;
+            std::string right;
+
+            // option in the last "[...]" of the text, interned when the operand is parsed; npos when the text does
+            // not end in a plain option name
+            std::string optionName;
+            uint32_t option = OptionIndex::npos;
+
+            // name is the option the caller resolved from the text, tested by index when it is optionName
+            bool TestOption(const OptionSet& set, const std::string& name) const
+            {
+                return option != OptionIndex::npos && name == optionName ? set.test(option) : set.test(name);
+            }
+        };
+
+        // everything an option condition reads, written out in full so that equal signatures mean equal inputs
+        // an empty signature is never remembered
+        class Signature
+        {
+        public:
+            Signature& operator<<(uint64_t value);
+            Signature& operator<<(const std::string& value);
+            Signature& operator<<(const OptionSet& value);
+
+            bool empty() const;
+            const std::string& value() const;
+
+        private:
+            std::string key;
+        };
+
+        // format, filename, numline and original are only used to report a malformed condition
+        static const ConditionExpr& Get(const std::string& condition,
+                                        const std::string& format,
+                                        const std::string& filename,
+                                        int numline,
+                                        const std::string& original);
+
+        // a comparison reads generated values and a mixed option (name*) the animation's own pick, not only the
+        // picked options, so the result of a condition with either is never remembered
+        bool CanRemember() const;
+
+        // leaf(operand) for every operand needed to decide the condition
+        // with a non-empty signature, the result is remembered for the next evaluation under the same signature
+        template <typename Leaf>
+        bool Evaluate(const Signature& signature, Leaf&& leaf) const
+        {
+            bool result;
+
+            if (!signature.empty() && FindMemo(signature.value(), result)) return result;
+
+            result = EvaluateNode(uint32_t(nodes.size() - 1), leaf);
+
+            if (!signature.empty()) StoreMemo(signature.value(), result);
+
+            return result;
+        }
+
+        ConditionExpr() = default;
+        ConditionExpr(const ConditionExpr&) = delete;
+        ConditionExpr& operator=(const ConditionExpr&) = delete;
+
+    private:
+        enum class Kind : uint8_t
+        {
+            Leaf,
+            And,
+            Or
+        };
+
+        struct Node
+        {
+            Kind kind;
+            uint32_t first; // leaf: operand index, and/or: first child in children
+            uint32_t count; // and/or: number of children
+        };
+
+        std::vector<Node> nodes; // root last
+        std::vector<uint32_t> children;
+        std::vector<Operand> operands;
+        bool canRemember = true;
+
+        // the oldest result is dropped once the memo is full
+        mutable std::shared_mutex memoMutex;
+        mutable std::unordered_map<std::string, bool> memo;
+        mutable std::deque<const std::string*> memoOrder;
+
+        template <typename Leaf>
+        bool EvaluateNode(uint32_t index, Leaf& leaf) const
+        {
+            const Node& node = nodes[index];
+
+            if (node.kind == Kind::Leaf) return leaf(operands[node.first]);
+
+            bool decider = node.kind == Kind::Or;
+
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                if (EvaluateNode(children[i], leaf) == decider) return decider;
+            }
+
+            return !decider;
+        }
+
+        bool FindMemo(const std::string& signature, bool& result) const;
+        void StoreMemo(const std::string& signature, bool result) const;
+
+        friend class ConditionParser;
+    };
+} // namespace nemesis
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef FRAGMENTCACHE_H_
+#define FRAGMENTCACHE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "generate/behaviorreferences.h"
+
+typedef std::vector<std::string> VecStr;
+typedef std::unordered_map<std::string, std::string> SSMap;
+typedef std::unordered_map<std::string, SSMap> ImportContainer;
+typedef std::unordered_map<std::string, int> ID;
+
+struct AnimationInfo;
+
+namespace nemesis
+{
+    class IDRange;
+
+    // everything a generated fragment depends on, kept as bytes for the hit check and hashed with 64 bit FNV-1a for
+    // the lookup
+    class FragmentHash
+    {
+    public:
+        FragmentHash& Add(std::string_view bytes);
+        FragmentHash& Add(uint64_t value);
+        FragmentHash& Add(const VecStr& lines);
+        FragmentHash& Add(const std::vector<int>& values);
+
+        // entries of the unordered maps are sorted, so their iteration order does not matter
+        FragmentHash& Add(const ID& map);
+        FragmentHash& Add(const SSMap& map);
+        FragmentHash& Add(const ImportContainer& map);
+        FragmentHash& Add(const std::unordered_map<int, VecStr>& map);
+        FragmentHash& Add(const std::unordered_map<std::string, std::unordered_map<std::string, VecStr>>& map);
+        FragmentHash& Add(const AnimationInfo& info);
+
+        uint64_t Get() const;
+        const std::string& Inputs() const;
+
+    private:
+        std::string inputs;
+
+        FragmentHash& AddEntries(std::vector<std::string>& entries);
+    };
+
+    // lines one animation instance generated, with the node IDs of its own range and of its group's range stored as
+    // slots of those ranges so the lines can be placed on the ranges of a later run
+    struct AnimFragment
+    {
+        enum Range : uint8_t
+        {
+            OWN,
+            GROUP,
+            NONE
+        };
+
+        // "#ID" in a line
+        struct NodeSlot
+        {
+            uint32_t line;
+            uint32_t pos; // first digit
+            uint32_t length;
+            uint8_t range;
+            uint32_t slot;
+        };
+
+        // format or group function ID entry, the value is a slot unless range is NONE
+        struct Entry
+        {
+            std::string key;
+            std::string value;
+            uint8_t range = NONE;
+            uint32_t slot = 0;
+        };
+
+        struct Import
+        {
+            std::string file;
+            std::string keyword;
+            uint32_t slot; // of the own range
+        };
+
+        std::string inputs; // of the key, a hit has to match them byte for byte
+        VecStr lines;
+        std::vector<NodeSlot> nodes;
+        std::vector<Entry> format;   // entries the instance added to its format map
+        std::vector<Entry> groupIDs; // format_group$N the instance registered
+        std::vector<Entry> existIDs; // MID$N and imports, the animation data lines refer to them again
+        std::vector<Import> imports;
+        BehaviorReferences references; // replayed on a hit, the nodes are not generated again
+
+        // false when the instance used an ID the ranges do not cover, generated at or above floorID
+        static bool Capture(const VecStr& lines,
+                            const std::vector<std::pair<std::string, std::string>>& format,
+                            const std::vector<std::pair<std::string, std::string>>& groupIDs,
+                            const std::vector<std::pair<std::string, std::string>>& existIDs,
+                            const IDRange& own,
+                            const IDRange& group,
+                            const BehaviorReferences& references,
+                            int floorID,
+                            AnimFragment& fragment);
+
+        // fragment with the slots replaced by the IDs of the given ranges, false when a slot is beyond a range
+        bool Relocate(const IDRange& own, const IDRange& group, AnimFragment& placed) const;
+
+        // slots of the own range the instance used, the range goes on after them on a hit
+        size_t OwnSlots() const;
+    };
+
+    // cache\animation_fragments\<template code>~<behavior file>
+    // fragments of the single animations of one template in one behavior, from the last run that generated them
+    // event and variable indexes and imports are part of the context, only node IDs are relocated
+    class FragmentCache
+    {
+    public:
+        FragmentCache(const std::string& behaviorFile,
+                      const std::string& templateCode,
+                      const FragmentHash& context,
+                      int floorID);
+
+        uint64_t GetContext() const;
+        int GetFloorID() const;
+
+        // nullptr when not cached, safe to call from the animation threads
+        const AnimFragment* Find(const FragmentHash& key);
+        void Add(const FragmentHash& key, AnimFragment&& fragment);
+
+        // only the fragments found or added in this run are kept
+        bool Save();
+
+        size_t GetHitCount() const;
+        size_t GetAddCount() const;
+
+    private:
+        std::filesystem::path cachefile;
+        std::string contextInputs;
+        uint64_t context;
+        int floorID;
+
+        std::unordered_map<uint64_t, AnimFragment> cached; // not modified once loaded
+        std::unordered_map<uint64_t, AnimFragment> added;
+        std::unordered_set<uint64_t> used;
+        mutable std::mutex lock;
+
+        void Load();
+    };
+} // namespace nemesis
+
+#endif
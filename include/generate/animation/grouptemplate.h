@@ -63,6 +63,8 @@ private:
     ImportContainer* newImport;
     std::string filename, format;
     int* nextFunctionID;
+    std::shared_ptr<nemesis::IDRange> idRange = std::make_shared<nemesis::IDRange>();
+    std::shared_ptr<nemesis::BehaviorReferences> references = std::make_shared<nemesis::BehaviorReferences>();
     SSMap IDExist;
     std::shared_ptr<master> subFunctionIDs;
     std::shared_ptr<AnimTemplate> grouptemplate;
@@ -75,7 +77,7 @@ private:
                            int groupCount,
                            VecStr templatelines,
                            std::unordered_map<int, bool>& IsConditionOpened,
-                           std::vector<std::vector<std::unordered_map<std::string, bool>>> masterOptionPicked,
+                           std::vector<std::vector<nemesis::OptionSet>> masterOptionPicked,
                            std::vector<int> fixedStateID);
 
 public:
@@ -113,6 +115,9 @@ public:
                     int animMulti           = -1,
                     std::string multiOption = "");
     std::string newID();
+    std::string importID(const std::string& file, const std::string& keyword);
+    void setIDRange(std::shared_ptr<nemesis::IDRange> range);
+    void setReferences(std::shared_ptr<nemesis::BehaviorReferences> target);
     void setZeroEvent(std::string eventname);
     void setZeroVariable(std::string variablename);
 };
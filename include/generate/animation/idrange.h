@@ -0,0 +1,104 @@
+#ifndef IDRANGE_H_
+#define IDRANGE_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef std::unordered_map<std::string, std::unordered_map<std::string, std::string>> ImportContainer;
+
+struct group;
+struct master;
+
+namespace nemesis
+{
+    // node IDs of one generated template instance
+    // the ranges are reserved in template order before the instances run, so an instance numbers its nodes the same
+    // way no matter which thread runs it or when
+    class IDRange
+    {
+    public:
+        // takes count IDs from lastID, 9216 is never given out
+        void Reserve(int& lastID, size_t count, std::atomic_flag& lock);
+
+        // next ID of the range; once the range is used up, a placeholder that ResolveOverflow numbers after the phase
+        // count is only an estimate when an import repeats with the animation's data, e.g. once per event
+        std::string Next();
+
+        // moves past the first slots of the range, which an instance restored from the fragment cache used
+        void Skip(size_t slots);
+
+        // slot-th ID of the range, for the IDs every animation of a group shares
+        std::string At(size_t slot) const;
+        size_t Size() const;
+
+        // inverse of At, false when the ID is not in the range
+        bool SlotOf(int ID, size_t& slot) const;
+
+        // true once the range was used up and placeholders were given out
+        bool Overflowed() const;
+
+        // import the instance creates, numbered from its own range until ResolveImports picks one ID per import
+        std::string ClaimImport(const std::string& file, const std::string& keyword);
+
+        // import claimed by an earlier run of the same instance, see FragmentCache
+        void AddImport(const std::string& file, const std::string& keyword, const std::string& ID);
+
+        template <typename Func>
+        void ForEachImport(Func func) const
+        {
+            for (auto& claim : imports)
+            {
+                func(claim.file, claim.keyword, claim.ID);
+            }
+        }
+
+        // 4 digits, zero padded
+        static std::string ToString(int ID);
+
+    private:
+        struct ImportClaim
+        {
+            std::string file;
+            std::string keyword;
+            std::string ID;
+        };
+
+        int base = 0;
+        int next = 0;
+        int end  = 0;
+        std::vector<std::string> overflowIDs;
+        std::vector<ImportClaim> imports;
+
+        friend std::unordered_map<std::string, std::string> ResolveOverflow(
+            const std::vector<std::pair<std::shared_ptr<IDRange>, std::shared_ptr<std::vector<std::string>>>>&
+                instances,
+            int& lastID);
+
+        friend void ResolveImports(
+            const std::vector<std::pair<std::shared_ptr<IDRange>, std::shared_ptr<std::vector<std::string>>>>&
+                instances,
+            ImportContainer& exportID);
+    };
+
+    // once the instances of a phase are done, the placeholders of the instances that used up their range are given IDs
+    // from lastID in template order and their lines are rewritten, so the numbering does not depend on timing
+    // returns placeholder -> ID for ReplaceIDs; call before ResolveImports
+    std::unordered_map<std::string, std::string> ResolveOverflow(
+        const std::vector<std::pair<std::shared_ptr<IDRange>, std::shared_ptr<std::vector<std::string>>>>& instances,
+        int& lastID);
+
+    // placeholders left in the ID maps of the templates generated so far
+    void ReplaceIDs(master& functionIDs, const std::unordered_map<std::string, std::string>& replacement);
+    void ReplaceIDs(group& functionIDs, const std::unordered_map<std::string, std::string>& replacement);
+
+    // once the instances of a phase are done, the first instance in template order keeps the ID of each import it
+    // created and the others have their claimed ID replaced by it in their lines
+    void ResolveImports(
+        const std::vector<std::pair<std::shared_ptr<IDRange>, std::shared_ptr<std::vector<std::string>>>>& instances,
+        ImportContainer& exportID);
+} // namespace nemesis
+
+#endif
@@ -11,12 +11,14 @@
 
 #include "generate/AnimationUtility.h"
 
-#include "utilities/alphanum.hpp"
+#include "utilities/naturalkey.h"
 #include "utilities/regex.h"
 
 #include "generate/AnimationUtility.h"
 
 #include "generate/animation/animthreadinfo.h"
+#include "generate/animation/conditionexpr.h"
+#include "generate/animation/idrange.h"
 #include "generate/animation/animationthread.h"
 #include "generate/animation/registeranimation.h"
 
@@ -33,6 +35,8 @@ namespace nemesis
 {
 	template<typename T>
 	struct CondVar;
+
+	class FragmentHash;
 }
 
 struct MDException
@@ -54,7 +58,6 @@ private:
     VecStr eventID;
     VecStr variableID;
     SSMap IDExist;
-    SSMap mixOptRegis;
     ImportContainer* newImport;
     NewAnimLock* atomicLock;
     ImportContainer addition;
@@ -68,26 +71,27 @@ private:
     size_t templatesize;
     int furnitureCount = 0;
     int* nextFunctionID;
+    std::shared_ptr<nemesis::IDRange> idRange;
+    std::shared_ptr<nemesis::BehaviorReferences> references;
     int order       = 0;
     int lastOrder   = 0;
     double duration = 0;
 
-    const std::vector<std::unordered_map<std::string, bool>> groupOptionPicked;
+    const std::vector<nemesis::OptionSet> groupOptionPicked;
     std::unordered_map<int, VecStr> AnimObject;
-    std::unordered_map<std::string, bool> optionPicked;
+    nemesis::OptionSet optionPicked;
     std::unordered_map<std::string, int> optionPickedCount;
-    std::unordered_map<std::string, VecStr> addOn;
-    std::unordered_map<std::string, VecStr> linkedOption;
-    std::unordered_map<std::string, VecStr> mixOptRever;
+    std::shared_ptr<const AnimOptionData> options; // add-on and mixed options of the template
     std::unordered_map<std::string, VecStr> rawtemplate;
-    //std::unordered_map<std::string, std::map<std::string, VecStr, alphanum_less>> asdlines;
+    //std::unordered_map<std::string, nemesis::NaturalMap<VecStr>> asdlines;
     //std::unordered_map<std::string, std::unordered_map<std::string, VecStr>> animdatalines;
     std::unordered_map<std::string, std::unordered_map<std::string, VecStr>> groupAddition;
     std::vector<std::shared_ptr<AnimationInfo>> groupAnimInfo;
+    std::vector<std::pair<std::string, std::string>> groupIDs; // format_group$N this instance registered
 
     std::shared_ptr<std::unordered_map<std::string, AnimTemplate>> animtemplate;
     std::unordered_map<std::string, std::unordered_map<std::string, AnimTemplate>> animdatatemplate;
-    std::unordered_map<std::string, std::map<std::string, AnimTemplate, alphanum_less>> asdtemplate;
+    std::unordered_map<std::string, nemesis::NaturalMap<AnimTemplate>> asdtemplate;
 
 public:
     std::shared_ptr<single> subFunctionIDs;
@@ -95,37 +99,20 @@ public:
     std::string coreModID;
 
 private:
-    bool singleCondition(std::string condition,
-                         VecStr& storeline,
-                         int numline,
-                         AnimationUtility utility);
-    bool andLoop(std::string condition,
-                 VecStr& storeline,
-                 int numline,
-                 AnimationUtility utility);
-    bool andOrParenthesis(size_t c_and,
-                          size_t c_or,
-                          std::string condition,
-                          VecStr& storeline,
-                          int numline,
-                          AnimationUtility utility);
-    bool andParenthesis(std::string condition,
-                        VecStr& storeline,
-                        int numline,
-                        AnimationUtility utility);
-    bool newCondition(std::string condition,
+    bool newCondition(const std::string& condition,
                       VecStr& storeline,
                       int numline,
-                      AnimationUtility utility);
-    bool specialCondition(std::string condition, VecStr& storeline, int linecount, AnimationUtility utility);
-    bool GetFirstCondition(std::string firstCondition,
-                           VecStr optionInfo,
-                           int numline,
-                           bool isNot);
-    bool conditionProcess(std::string condition,
-                          bool isNot,
+                      const AnimationUtility& utility);
+    void OptionSignature(nemesis::ConditionExpr::Signature& signature, const AnimationUtility& utility) const;
+    void FragmentKey(nemesis::FragmentHash& key, const NewAnimArgs& args, uint64_t context) const;
+    bool specialCondition(const nemesis::ConditionExpr::Operand& condition,
+                          VecStr& storeline,
+                          int linecount,
+                          const AnimationUtility& utility);
+    bool GetFirstCondition(const nemesis::ConditionExpr::Operand& operand, const VecStr& optionInfo, int numline);
+    bool conditionProcess(const nemesis::ConditionExpr::Operand& operand,
                           int numline,
-                          AnimationUtility utility);
+                          const AnimationUtility& utility);
     void stateReplacer(std::string& line,
                        std::string statenum,
                        int stateID,
@@ -208,25 +195,27 @@ public:
     std::string GetFormatName();
     VecStr GetEventID();
     VecStr GetVariableID();
-    SSMap GetMixOpt();
+    const SSMap& GetMixOpt();
     ImportContainer GetAddition();
     std::vector<std::shared_ptr<AnimationInfo>> GetGroupAnimInfo();
     std::unordered_map<std::string, std::unordered_map<std::string, VecStr>> GetGroupAddition();
 
     std::string newID();
+    std::string importID(const std::string& file, const std::string& keyword);
+    void groupIDRegis(const std::string& oldID, const std::string& ID);
 
     void GetNewAnimationLine(std::shared_ptr<NewAnimArgs> args);
     void GetAnimSetData(
-        std::unordered_map<std::string, std::map<std::string, VecStr, alphanum_less>>& newASDLines);
+        std::unordered_map<std::string, nemesis::NaturalMap<VecStr>>& newASDLines);
     void GetAnimData(std::unordered_map<std::string, std::map<std::string, VecStr>>& newAnimDataLines);
     void existingASDProcess(VecStr ASDLines, std::map<int, VecStr>& extract, std::vector<int> ASD = {0});
 
     //void addAnimData(std::unordered_map<std::string, std::unordered_map<std::string, VecStr>> animdata);
     void addAnimData(std::unordered_map<std::string, std::unordered_map<std::string, AnimTemplate>> animdata);
 
-    //void addAnimSetData(std::unordered_map<std::string, std::map<std::string, VecStr, alphanum_less>> animsetdata);
+    //void addAnimSetData(std::unordered_map<std::string, nemesis::NaturalMap<VecStr>> animsetdata);
     void addAnimSetData(
-        std::unordered_map<std::string, std::map<std::string, AnimTemplate, alphanum_less>> animsetdata);
+        std::unordered_map<std::string, nemesis::NaturalMap<AnimTemplate>> animsetdata);
 
     void storeAnimObject(VecStr animobjects, std::string listFilename, int lineCount);
     void addGroupAnimInfo(std::vector<std::shared_ptr<AnimationInfo>> animInfo);
@@ -238,6 +227,13 @@ public:
     int getOrder();
     int getNextID(std::string behavior);
 
+    // node IDs one generation of the behavior takes, to reserve its ID range
+    size_t getIDDemand(const std::string& behavior, bool core);
+    // format_group$N the animation shares with the rest of its group
+    size_t getGroupIDDemand(const std::string& behavior);
+    // a cached fragment of the behavior does everything its generation would
+    bool isReplayable(const std::string& behavior);
+
     bool isLast();
     bool isKnown();
 };
@@ -255,9 +251,9 @@ inline bool isPassed(int condition, std::unordered_map<int, bool> IsConditionOpe
 template <class T>
 int numDigits(T number);
 bool clearGroupNum(std::string option2,
-                   const std::unordered_map<std::string, bool>& optionPicked,
+                   const nemesis::OptionSet& optionPicked,
                    bool isNot,
-                   const std::unordered_map<std::string, bool>& groupOption);
+                   const nemesis::OptionSet& groupOption);
 void motionDataReplacer(std::string& change,
                         std::string format,
                         std::string filename,
@@ -290,10 +286,10 @@ int openEndBracket(std::string& line,
 void CRC32Replacer(std::string& line, std::string format, std::string behaviorFile, int linecount);
 void addOnReplacer(std::string& line,
                    std::string filename,
-                   std::unordered_map<std::string, VecStr> addOn,
-                   ImportContainer addition,
-                   std::unordered_map<std::string, std::unordered_map<std::string, VecStr>> groupAddition,
-                   SSMap mixOpt,
+                   const std::unordered_map<std::string, VecStr>& addOn,
+                   const ImportContainer& addition,
+                   const std::unordered_map<std::string, std::unordered_map<std::string, VecStr>>& groupAddition,
+                   const SSMap& mixOpt,
                    uint count,
                    std::string format,
                    int numline);
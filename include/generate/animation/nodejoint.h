@@ -8,12 +8,19 @@
 #include <unordered_map>
 #include <vector>
 
+#include "generate/animation/optionset.h"
+
 using ID              = std::unordered_map<std::string, int>;
 using VecStr          = std::vector<std::string>;
 using SetStr          = std::set<std::string>;
 using SSMap           = std::unordered_map<std::string, std::string>;
 using ImportContainer = std::unordered_map<std::string, SSMap>;
 
+namespace nemesis
+{
+    class BehaviorReferences;
+}
+
 struct master;
 struct NodeJoint;
 struct JointTemplate;
@@ -55,7 +62,7 @@ struct NodePackedParameters
     int optionMulti;
     bool hasGroup;
     std::string multiOption;
-    std::vector<std::vector<std::unordered_map<std::string, bool>>>& optionPicked;
+    std::vector<std::vector<nemesis::OptionSet>>& optionPicked;
     unsigned __int64& openRange;
     uint& elementCount;
     std::string& line;
@@ -81,7 +88,7 @@ struct NodePackedParameters
                          int _optionMulti,
                          bool _hasGroup,
                          std::string _multiOption,
-                         std::vector<std::vector<std::unordered_map<std::string, bool>>>& _optionPicked,
+                         std::vector<std::vector<nemesis::OptionSet>>& _optionPicked,
                          unsigned __int64& _openRange,
                          uint& _elementCount,
                          std::string& _line,
@@ -129,7 +136,7 @@ struct NodeJoint
 
     void insertData(std::string format,
                     std::string filename,
-                    std::vector<std::vector<std::unordered_map<std::string, bool>>>& optionPicked,
+                    std::vector<std::vector<nemesis::OptionSet>>& optionPicked,
                     const std::vector<std::vector<std::shared_ptr<AnimationInfo>>>& groupAnimInfo,
                     int groupMulti,
                     int animMulti,
@@ -158,7 +165,7 @@ struct NodeJoint
                         uint sect,
                         std::string format,
                         std::string filename,
-                        std::vector<std::vector<std::unordered_map<std::string, bool>>>& optionPicked,
+                        std::vector<std::vector<nemesis::OptionSet>>& optionPicked,
                         const std::vector<std::vector<std::shared_ptr<AnimationInfo>>>& groupAnimInfo,
                         int groupMulti,
                         int animMulti,
@@ -183,7 +190,7 @@ struct NodeJoint
     static void optionMultiLoop(std::vector<LineCheck>& output,
                                 std::string format,
                                 std::string filename,
-                                std::vector<std::vector<std::unordered_map<std::string, bool>>>& optionPicked,
+                                std::vector<std::vector<nemesis::OptionSet>>& optionPicked,
                                 const std::vector<std::vector<std::shared_ptr<AnimationInfo>>>& groupAnimInfo,
                                 int groupMulti,
                                 int animMulti,
@@ -205,7 +212,8 @@ struct NodeJoint
                                 bool& negative,
                                 LineCheck temp);
 
-    VecStr unpack(); // output all stored outputs in different layers
+    // output all stored outputs in different layers, the clips and behaviors of the nodes go to references
+    VecStr unpack(nemesis::BehaviorReferences* references = nullptr);
 
 private:
     void dataBake(VecStr& node,
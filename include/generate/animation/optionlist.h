@@ -1,12 +1,25 @@
 #ifndef OPTIONLIST_H_
 #define OPTIONLIST_H_
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "generate/animation/optionset.h"
+
 typedef std::vector<std::string> VecStr;
 
+// option data every animation registered to a template reads, shared instead of copied into each of them
+struct AnimOptionData
+{
+    std::unordered_map<std::string, VecStr> addOn; // option, list of add-on
+    std::unordered_map<std::string, std::string> mixOptRegis;
+
+    // empty data when the template has none
+    static const AnimOptionData& Of(const std::shared_ptr<const AnimOptionData>& data);
+};
+
 struct OptionList
 {
     bool core        = false;
@@ -27,7 +40,7 @@ struct OptionList
     std::unordered_map<std::string, std::unordered_map<int, int>>
         multiState; // behavior, state number, node/function ID
     std::unordered_map<std::string, bool> storelist;
-    std::unordered_map<std::string, bool> groupOption;
+    nemesis::OptionSet groupOption;
     std::unordered_map<std::string, std::string> mixOptRegis;
     std::unordered_map<std::string, VecStr> mixOptRever;
     std::unordered_map<std::string, VecStr> joint;
@@ -35,6 +48,8 @@ struct OptionList
     std::unordered_map<std::string, std::unordered_map<std::string, std::string>>
         modAddOn; // option, addon, modifier; use to modify add on, not always needed but can be useful especially for event/variable
 
+    std::shared_ptr<const AnimOptionData> animOptions; // set once the list has been read
+
     std::vector<VecStr> eleEvent;
     VecStr eleEventLine;
     std::vector<VecStr> eleEventGroupF;
@@ -51,6 +66,7 @@ struct OptionList
     OptionList(std::string filepath, std::string format);
     OptionList();
     void setDebug(bool isDebug);
+    void ShareAnimOptions();
 };
 
 bool optionMatching(std::string option1, std::string option2);
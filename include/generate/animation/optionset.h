@@ -0,0 +1,49 @@
+#ifndef OPTIONSET_H_
+#define OPTIONSET_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nemesis
+{
+    // dense index of every option name used by the templates
+    // the options of an option list are interned when the list is loaded, so the common options get the lowest
+    // indexes and the picked option bitsets stay a word or two wide
+    struct OptionIndex
+    {
+        static constexpr uint32_t npos = UINT32_MAX;
+
+        static uint32_t Intern(const std::string& name);
+
+        // npos when the option has never been interned, i.e. it cannot have been picked
+        static uint32_t Find(const std::string& name);
+    };
+
+    // picked options of an animation, one bit per option index
+    class OptionSet
+    {
+    public:
+        void set(uint32_t id);
+        void set(const std::string& name);
+        void reset(uint32_t id);
+        bool test(uint32_t id) const;
+        bool test(const std::string& name) const;
+        bool any() const;
+
+        // appends the same bytes for sets with the same options, whatever their word count
+        void AppendKey(std::string& key) const;
+
+        OptionSet& operator|=(const OptionSet& other);
+        OptionSet& operator&=(const OptionSet& other);
+
+        // options picked by every set of the list / by at least one set of the list
+        static OptionSet All(const std::vector<OptionSet>& list);
+        static OptionSet Any(const std::vector<OptionSet>& list);
+
+    private:
+        std::vector<uint64_t> words;
+    };
+} // namespace nemesis
+
+#endif
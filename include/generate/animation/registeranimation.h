@@ -32,7 +32,7 @@ public:
 
     registerAnimation(std::filesystem::path filepath,
                       std::filesystem::path shortfilepath,
-                      TemplateInfo behaviortemplate,
+                      const TemplateInfo& behaviortemplate,
                       std::filesystem::path bhvrPath,
                       bool fstP,
                       bool isNemesis = false);
@@ -22,6 +22,7 @@ class AnimTemplate
 {
     std::string format;
     std::string behaviorFile;
+    bool clipNode = false; // the lines being examined belong to an hkbClipGenerator
 
     void Process(const std::string& line,
                  const std::string& multiOption,
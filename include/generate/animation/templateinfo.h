@@ -4,7 +4,7 @@
 #include <map>
 #include <unordered_set>
 
-#include "utilities/alphanum.hpp"
+#include "utilities/naturalkey.h"
 
 typedef std::set<std::string> SetStr;
 typedef std::unordered_set<std::string> USetStr;
@@ -33,7 +33,7 @@ struct TemplateInfo
 
     // AnimData
     std::unordered_map<std::string,
-                       std::unordered_map<std::string, std::map<std::string, VecStr, alphanum_less>>>
+                       std::unordered_map<std::string, nemesis::NaturalMap<VecStr>>>
         asdtemplate; // animation code, project, header, template file; animationsetdatasinglefile template by header
     std::unordered_map<std::string, std::unordered_map<std::string, std::unordered_map<std::string, VecStr>>>
         animdatatemplate; // animation code, character, header, template file; animationdatasinglefile template by header
@@ -1,6 +1,8 @@
 #ifndef TEMPLATETREE_H_
 #define TEMPLATETERE_H_
 
+#include "generate/animation/idrange.h"
+
 struct single
 {
     std::unordered_map<std::string, std::string> format;
@@ -9,6 +11,7 @@ struct single
 struct group
 {
     std::unordered_map<std::string, std::string> functionIDs;
+    nemesis::IDRange IDs; // format_group$N shared by the animations of the group
     std::vector<std::shared_ptr<single>> singlelist;
 };
 
@@ -20,9 +20,4 @@ public:
     void SetOrder(int _order);
 };
 
-extern std::map<std::string, std::map<std::string, std::vector<std::shared_ptr<AnimationDataTracker>>>>
-    clipPtrAnimData; // character path, clip name, list of animdata
-extern std::map<std::string, std::map<std::string, std::shared_ptr<AnimationDataTracker>>>
-    charAnimDataInfo; // character path, file name, animdata
-
 #endif
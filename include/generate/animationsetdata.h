@@ -1,7 +1,7 @@
 #ifndef ANIMATIONSETDATA_H_
 #define ANIMATIONSETDATA_H_
 
-#include "utilities/alphanum.hpp"
+#include "utilities/naturalkey.h"
 #include "utilities/writetextfile.h"
 
 #include "generate/generator_utility.h"
@@ -18,17 +18,35 @@ struct datapack
     std::vector<crc32> crc32list;   // anim data set, crc32 list
 };
 
+struct ASDCRC32Entry
+{
+    bool isFirstPerson = false;
+    std::string animCRC32; // crc32 of the lowercase animation file name
+    VecStr animlist;       // alternate animations or pcea animation paths linked to the animation
+};
+
+// crc32 entries of every alternate and pcea animation
+// computed once per generation and shared by all projects of the animationsetdatasinglefile
+struct ASDCRC32List
+{
+    std::vector<ASDCRC32Entry> alternate;
+    std::vector<ASDCRC32Entry> pcea;
+
+    ASDCRC32List();
+};
+
 struct AnimationDataProject
 {
     bool isNew = false;                                      // is this new set of animdata data
     std::string mod;                                         // modcode
-    std::map<std::string, datapack, alphanum_less> datalist; // anim data set
+    nemesis::NaturalMap<datapack> datalist; // anim data set
 
     AnimationDataProject()
     {}
     AnimationDataProject(int& startline,
                          VecStr& animdatafile,
                          std::string projectname,
+                         const ASDCRC32List& crc32list,
                          const NemesisInfo* nemesisInfo);
 };
 
@@ -69,10 +87,14 @@ namespace ASDFormat
 struct MasterAnimSetData
 {
     VecStr projectList; // order of the project
-    std::unordered_map<std::string, std::map<std::string, VecStr, alphanum_less>>
+    std::unordered_map<std::string, nemesis::NaturalMap<VecStr>>
         newAnimSetData; // project, header, vector<string>; memory to access each node
 };
 
+void WriteAnimSetData(FileWriter& output,
+                      const VecStr& projectList,
+                      const std::unordered_map<std::string, std::unique_ptr<AnimationDataProject>>& ASDData);
+
 extern void
 combineExtraction(VecStr& storeline, std::map<int, VecStr> extract, std::string project, std::string header);
 
@@ -0,0 +1,59 @@
+#ifndef BEHAVIORBATCH_H_
+#define BEHAVIORBATCH_H_
+
+#include <filesystem>
+
+#include "Global.h"
+
+#include "utilities/threadpool.h"
+#include "utilities/pathinterner.h"
+
+#include "generate/generationcontext.h"
+
+#include "generate/animation/templateinfo.h"
+#include "generate/animation/registeranimation.h"
+
+class NemesisInfo;
+
+namespace nemesis
+{
+    // mod selection of one output of a batch
+    struct GenerationProfile
+    {
+        std::wstring stageDirectory;
+        VecStr behaviorPriority; // mod code, highest priority first
+        std::unordered_map<std::string, bool> chosenBehavior;
+    };
+
+    // inputs every profile of a batch generates from
+    // they are read once before the profiles start and only read after that
+    class GenerationBatch
+    {
+    public:
+        GenerationContext context; // behavior paths and projects, AA and PCEA registries, hkx check
+        ThreadPool scheduler;      // compiles the behavior files of every profile
+
+        GenerationBatch(size_t profileCount);
+
+        void ReadInputs(const NemesisInfo* nemesisInfo);
+
+        const TemplateInfo& GetTemplate() const;
+        std::vector<std::unique_ptr<registerAnimation>> CopyAnimationList() const;
+        const VecStr* GetBehaviorLines(const std::wstring& filepath) const; // nullptr when the file was not read
+
+    private:
+        TemplateInfo behaviorTemplate;
+        std::vector<std::unique_ptr<registerAnimation>> animationList;
+        PathMap<VecStr> behaviorLines; // temp behavior file, lines
+
+        void ReadBehaviorLines(const std::wstring& directory);
+    };
+
+    // [staging directory] followed by the mod codes of that profile, in the order of the -generate arguments
+    std::vector<std::pair<std::wstring, VecStr>> ReadBatchFile(const std::filesystem::path& filepath);
+
+    // generates every profile into its own staging directory, blocks until all of them are done
+    void GenerateBatch(const std::vector<GenerationProfile>& profiles, const NemesisInfo* nemesisInfo);
+} // namespace nemesis
+
+#endif
@@ -10,6 +10,7 @@
 #include "ui/ProgressUp.h"
 
 #include "generate/behaviorgenerator.h"
+#include "generate/generationcontext.h"
 
 typedef std::unordered_set<std::string> USetStr;
 typedef std::unordered_set<std::wstring> USetWstr;
@@ -22,6 +23,11 @@ class NemesisInfo;
 struct TemplateInfo;
 struct registerAnimation;
 
+namespace nemesis
+{
+    class GenerationBatch;
+}
+
 class BehaviorStart : public QObject
 {
     Q_OBJECT
@@ -39,6 +45,7 @@ public:
                          VecStr behaviorOrder,
                          std::unordered_map<std::string, bool> behaviorPick);
     void addBehaviorPick(VecStr behaviorOrder, std::unordered_map<std::string, bool> behaviorPick);
+    void setBatch(nemesis::GenerationBatch* _batch);
     void message(std::string input);
     void message(std::wstring input);
     void GenerateBehavior(std::thread*& checkThread);
@@ -82,6 +89,7 @@ private:
     std::unordered_map<std::string, std::unordered_map<int, bool>>* ignoreFunction2;
 
     std::atomic_flag upFlag{};
+    std::atomic_flag endFlag{};
     std::atomic_flag newAnimFlag{};
 
     // timer
@@ -91,6 +99,12 @@ public:
     std::atomic_flag postBehaviorFlag{};
     std::unordered_map<std::wstring, USetWstr> postBhvrRefBy;
 
+    // state of this generation, bound to every thread working on it
+    nemesis::GenerationContext context;
+
+    // inputs shared with the other profiles, nullptr when this generation is not part of a batch
+    nemesis::GenerationBatch* batch = nullptr;
+
     // nemesis ini
     const NemesisInfo* nemesisInfo;
     const HkxCompiler hkxCompiler = HkxCompiler();
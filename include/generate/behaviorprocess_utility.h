@@ -3,6 +3,7 @@
 
 #include <map>
 #include <memory>
+#include <functional>
 #include <filesystem>
 
 struct master;
@@ -18,11 +19,22 @@ struct NewAnimArgs;
 struct newGroupArgs;
 struct NodeJoint;
 
+namespace nemesis
+{
+    class BehaviorReferences;
+}
+
 void animThreadStart(std::shared_ptr<NewAnimArgs> args);
 void groupThreadStart(std::shared_ptr<newGroupArgs> args);
 void elementUpdate(size_t& elementLine, int& counter, int& curID, std::map<int, VecStr>& catalystMap);
+// runs tasks that each touch a different node of one behavior file, concurrently once there are enough of them
+// the helper threads come from one process wide allowance of a thread per core
+void runNodeTasks(std::vector<std::function<void()>>& tasks, const std::string& behaviorFile);
+// the references of an unpacked node replace the ones recorded for it when the catalyst was read
 void unpackToCatalyst(std::map<int, VecStr>& catalystMap,
-                      std::unordered_map<int, std::shared_ptr<NodeJoint>>& existingNodes);
+                      std::map<int, nemesis::BehaviorReferences>& nodeReferences,
+                      std::unordered_map<int, std::shared_ptr<NodeJoint>>& existingNodes,
+                      const std::string& behaviorFile);
 int bonePatch(std::filesystem::path rigfile, int oribone, bool& newBone, const HkxCompiler& hkxCompiler);
 
 void processExistFuncID(std::vector<int>& funcIDs,
@@ -44,5 +56,6 @@ void processExistFuncID(std::vector<int>& funcIDs,
                         std::unordered_map<int, std::shared_ptr<NodeJoint>>& existingNodes);
 void redirToStageDir(std::filesystem::path& outpath, const NemesisInfo* nemesisInfo);
 std::filesystem::path getTempBhvrPath(const NemesisInfo* nemesisInfo);
+std::filesystem::path getTempXmlPath(const NemesisInfo* nemesisInfo);
 
 #endif
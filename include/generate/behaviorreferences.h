@@ -0,0 +1,56 @@
+#ifndef BEHAVIORREFERENCES_H_
+#define BEHAVIORREFERENCES_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nemesis
+{
+    // behaviors and clips the nodes of a generated behavior refer to
+    // recorded by the code that generates each node, BehaviorWriter only publishes them
+    class BehaviorReferences
+    {
+    public:
+        struct Clip
+        {
+            std::string clipName;
+            std::string animationName; // as written in the node, Animations\idle.hkx
+        };
+
+        // behaviorName of an hkbBehaviorReferenceGenerator, behaviorFilename of an hkbCharacterStringData
+        void AddBehavior(std::string_view behavior);
+
+        // name and animationName of an hkbClipGenerator
+        void AddClip(std::string_view clipName, std::string_view animationName);
+
+        void Merge(const BehaviorReferences& other);
+
+        // for code that puts nodes together line by line without a compiled template: every line of the nodes, in
+        // order. Only node headers and the single line params of the node classes above are looked at
+        void Track(const std::string& line);
+
+        const std::vector<std::string>& GetBehaviors() const;
+        const std::vector<Clip>& GetClips() const;
+        bool Empty() const;
+
+    private:
+        enum class Node : uint8_t
+        {
+            Other,
+            CharacterData,
+            Clip,
+            BehaviorReference,
+        };
+
+        std::vector<std::string> behaviors;
+        std::vector<Clip> clips;
+
+        // state of Track
+        Node node = Node::Other;
+        std::string clipName;
+    };
+} // namespace nemesis
+
+#endif
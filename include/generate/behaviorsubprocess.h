@@ -9,6 +9,8 @@
 
 #include "generate/animation/newanimation.h"
 
+#include "utilities/pathinterner.h"
+
 class BehaviorStart;
 
 struct var;
@@ -24,6 +26,7 @@ public:
 
     void addInfo(const std::wstring& newDirectory,
                  const std::string& curfile,
+                 nemesis::PathHandle newBehaviorHandle,
                  std::shared_ptr<TemplateInfo> newBehaviorTemplate,
                  std::unordered_map<std::string, std::vector<std::shared_ptr<NewAnimation>>> addAnimation,
                  std::unordered_map<std::string, var> newAnimVar,
@@ -47,6 +50,8 @@ public:
         std::vector<std::pair<uint, std::string>>& modLine,
         bool& hasDeleted);
     void CompilingBehavior();
+    size_t EstimateFootprint() const; // bytes a behavior compilation holds at its peak, roughly
+    void ReleaseInputs();
     void CompilingAnimData();
     void CompilingASD();
 
@@ -67,6 +72,7 @@ private:
     int animCounter = 0;
 
     std::string modID, curfilefromlist;
+    nemesis::PathHandle behaviorHandle; // curfilefromlist without its extension, interned when the file was listed
     std::wstring directory;
     std::shared_ptr<TemplateInfo> BehaviorTemplate;
     std::unordered_map<std::string, std::vector<std::shared_ptr<NewAnimation>>> newAnimation;
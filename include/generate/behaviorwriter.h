@@ -0,0 +1,45 @@
+#ifndef BEHAVIORWRITER_H_
+#define BEHAVIORWRITER_H_
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+typedef std::vector<std::string> VecStr;
+
+class BehaviorStart;
+
+namespace nemesis
+{
+    class BehaviorReferences;
+
+    // generated behavior xml, written in one pass over the line blocks it is made of
+    class BehaviorWriter
+    {
+    public:
+        // the block is kept by reference and has to stay unchanged until Write
+        void Add(const VecStr& lines);
+        void Add(std::string text);
+
+        bool Write(const std::filesystem::path& filename) const;
+
+        // puts the references the generators recorded for the file into the shared tables, each lock taken once
+        // filepath is the output path without extension
+        static void Publish(const BehaviorReferences& references,
+                            const std::filesystem::path& filepath,
+                            const std::filesystem::path& projectdir,
+                            const VecStr& characterFiles,
+                            BehaviorStart* process);
+
+    private:
+        struct Block
+        {
+            const VecStr* lines;
+            std::string text;
+        };
+
+        std::vector<Block> blocks;
+    };
+} // namespace nemesis
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef GENERATIONCONTEXT_H_
+#define GENERATIONCONTEXT_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+
+#include "Global.h"
+
+#include "utilities/pathinterner.h"
+#include "utilities/shardedmap.h"
+#include "utilities/threadpool.h"
+
+#include "generate/hkxscanner.h"
+#include "generate/playerexclusive.h"
+#include "generate/animationdatatracker.h"
+
+namespace nemesis
+{
+    // state of one generation or update run
+    // code reaches the run it works for through Current(), which a run binds to its thread with Scope;
+    // a task queued on a ThreadPool runs in the context of the thread that queued it
+    // the run's error flag is its own, so a failing run stops its threads and leaves the others alone
+    // containers that worker threads write into are sharded, the rest are filled before the workers start
+    struct GenerationContext
+    {
+        // update patcher
+        PathMap<std::wstring> behaviorPath; // hkx file name, file path
+
+        // behavior generator
+        std::unordered_map<std::string, bool>
+            activatedBehavior; // behavior file, true/false; check if the behavior is needed to be edited to character for animationdatasinglefile
+        PathMap<std::wstring> behaviorProjectPath; // project, project's path; project that has been installed
+        PathMap<VecStr> behaviorProject; // character hkx file name, list of project hkx file name; link the project
+        ShardedMap<std::string, VecStr> behaviorJoints; // lower lvl behavior file, higher lvl behavior file
+        ShardedMap<PathHandle, std::set<std::string>>
+            usedAnim; // behavior name, animation path; animation used in behavior file
+        ShardedMap<PathHandle, std::set<std::string>>
+            registeredAnim; // characters hkx file name, animation name; is registered in that behavior file?
+        ShardedMap<PathHandle, std::unordered_map<std::string, std::vector<std::set<std::string>>>>
+            animModMatch; // characters hkx file name, animation file, animation paths & mod name; match conflicting mod (duplicated anim file)
+
+        // Alternate Animation data
+        std::unordered_map<std::string, VecStr> alternateAnim; // original animation name, list of AA animations
+        std::unordered_map<std::string, VecStr> groupAA;       // animation group name, list of animations
+        std::unordered_map<std::string, VecStr>
+            groupAAPrefix; // animation group name, list of AA prefix's group; for scripting
+        std::unordered_map<std::string, VecStr> AAEvent; // AA animation, list of animEvent
+        std::unordered_map<std::string, VecStr>
+            AAHasEvent; // original animation name, AA with event; which original animation associated with AA has new event name?
+        std::unordered_map<std::string, std::string> AAGroup; // AA file name, animation group name
+        std::unordered_map<std::string, std::unordered_map<std::string, int>>
+            AAGroupCount;                        // AA prefix, animation group name, count; animation group picked count
+        std::set<std::string> groupNameList;     // list of animation group name; for scripting
+        std::unordered_map<std::string, int> AAgroup_Counter; // animation group name, ID counter
+
+        // PCEA data
+        std::vector<PCEA> pcealist; // list of mods with pcea
+        std::unordered_map<std::string, std::vector<PCEAData>>
+            animReplaced; // animation file, list of ordered mod + animation path
+
+        // animation data
+        ShardedMap<std::string, std::map<std::string, std::vector<std::shared_ptr<AnimationDataTracker>>>>
+            clipPtrAnimData; // character path, clip name, list of animdata
+        ShardedMap<std::string, std::map<std::string, std::shared_ptr<AnimationDataTracker>>>
+            charAnimDataInfo;                         // character path, file name, animdata
+        ShardedMap<std::string, std::string> crc32Cache; // line, crc32 of the line
+
+        // background hkx architecture check
+        std::vector<HkxFile> hkxFiles;
+        std::atomic_flag hkxFilesLock{};
+        VecWstr fileCheckMsg;
+
+        // progress of the run
+        std::atomic<bool> cancelled{false};  // set by the first error of the run, read through the error global
+        std::atomic<int> runningThread{0}; // threads working on the run, the last one to end finishes it
+        std::atomic<int> behaviorRun{0};   // behavior compilations in progress, animation data waits for them
+        std::mutex behaviorRunLock;
+        std::condition_variable behaviorRunDone;
+        VecWstr failedBehaviors; // xml file, hkx file; behaviors to compile again once the workers are done
+        std::atomic_flag failedBehaviorsLock{};
+        VecWstr deployedBehaviors;              // hkx files the run changed
+        std::atomic<int> unchangedBehaviors{0}; // hkx files that already held the compiled output
+        std::atomic_flag deployedBehaviorsLock{};
+
+        GenerationContext() = default;
+        GenerationContext(const GenerationContext&) = delete;
+        GenerationContext& operator=(const GenerationContext&) = delete;
+
+        // lookups that never insert, for the maps worker threads only read
+        bool IsActivated(const std::string& behavior) const;
+        const std::wstring& GetBehaviorPath(PathHandle file) const; // empty when the file is not installed
+
+        // behaviorJoints and the animation registries survive a partial reset
+        void Clear(bool all = true);
+
+        // takes the behavior paths, joints, AA and PCEA registries from a context that has already read them
+        void CopyInputs(const GenerationContext& inputs);
+
+        // context bound to the calling thread
+        // throws std::logic_error on a thread without one, as sharing a context between runs corrupts both
+        static GenerationContext& Current();
+
+        // binds a context to the calling thread through TaskLocal, so ThreadPool tasks queued under it inherit it
+        class Scope
+        {
+        public:
+            explicit Scope(GenerationContext& context);
+
+        private:
+            TaskLocal::Scope scope;
+        };
+    };
+} // namespace nemesis
+
+#endif
@@ -10,6 +10,7 @@
 #include "generate/animation/registeranimation.h"
 
 #include "utilities/regex.h"
+#include "utilities/changemanifest.h"
 
 typedef std::vector<std::string> VecStr;
 
@@ -22,11 +23,6 @@ bool isEdited(TemplateInfo* BehaviorTemplate,
               bool isCharacter,
               std::string modID);
 bool newAnimSkip(std::vector<std::shared_ptr<NewAnimation>> newAnim, std::string modID);
-void checkBehaviorJoint(std::filesystem::path filename,
-                        std::filesystem::path projectdir,
-                        std::string& line,
-                        BehaviorStart* process,
-                        bool& isBehavior);
 bool GetStateCount(
     std::vector<int>& count, VecStr templatelines, std::string format, std::string filename, bool hasGroup);
 int getTemplateNextID(VecStr& templatelines);
@@ -50,23 +46,16 @@ bool FolderCreate(std::filesystem::path curBehaviorPath);
 
 std::vector<std::unique_ptr<registerAnimation>> openFile(TemplateInfo* behaviortemplate,
                                                          const NemesisInfo* nemesisInfo);
-void checkClipAnimData(std::filesystem::path filename,
-                       std::filesystem::path projectdir,
-                       std::string& line,
-                       VecStr& characterFiles,
-                       std::string& clipName,
-                       bool& isClip,
-                       BehaviorStart* process,
-                       bool& isBehavior);
 void checkAllFiles(std::filesystem::path filepath);
 void checkAllStoredHKX();
 
 bool isEngineUpdated(std::string& versionCodem, const NemesisInfo* nemesisInfo);
+bool isUpdateTrackedFile(const std::wstring& directory, const std::wstring& file);
+// files and mods changed since the last engine update; outdated when the update has to be run in full
+nemesis::ChangeManifest::ChangeSet GetEngineChanges(bool stopAtFirst = false);
 void ClearGlobal(bool all = true);
 void GetAnimData();
-void characterHKX();
-void GetBehaviorPath();
-void GetBehaviorProject();
-void GetBehaviorProjectPath();
+// behavior joints, paths, projects and project paths from cache\behavior_manifest
+void GetBehaviorManifest();
 
 #endif
\ No newline at end of file
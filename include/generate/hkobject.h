@@ -0,0 +1,114 @@
+#ifndef HKOBJECT_H_
+#define HKOBJECT_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+typedef std::vector<std::string> VecStr;
+
+namespace nemesis
+{
+    // <hkparam name="generators" numelements="2">
+    struct HkParamHeader
+    {
+        size_t nameBegin;
+        size_t nameLength;
+        size_t countBegin  = std::string::npos; // npos when the param is not an array
+        size_t countLength = 0;
+        bool closed        = false;             // value and </hkparam> on the same line
+    };
+
+    // <hkobject name="#0001" class="hkbClipGenerator" signature="0x333b85b9">
+    struct HkObjectHeader
+    {
+        std::string_view name;
+        std::string_view className;
+        std::string_view signature;
+        int ID = -1; // -1 when the name is not #<number> or the number does not fit an int
+    };
+
+    // param of a packfile node, either a single line value or a block of lines
+    // an array recounts its elements when serialized, so its numelements never has to be kept up to date by hand
+    class HkParam
+    {
+    public:
+        HkParam(std::string name, std::string value);
+
+        static HkParam Array(std::string name);
+
+        const std::string& GetName() const;
+        bool IsArray() const;
+
+        // the text between the tags of a single line param
+        std::string GetValue() const;
+        void SetValue(std::string value);
+
+        // one line per element, a node reference, a value or an <hkcstring>
+        void AddElement(const std::string& element);
+        // a nested <hkobject> element, from its opening to its closing tag
+        void AddElement(const VecStr& element);
+
+        size_t GetElementCount() const;
+
+        // #0001 node references in the value or the elements
+        std::vector<int> GetReferences() const;
+
+        void Serialize(VecStr& lines) const;
+
+        static bool ReadHeader(const std::string& line, HkParamHeader& header);
+
+    private:
+        std::string name;
+        std::string indent = "\t\t\t";
+        bool isArray       = false;
+        bool isBlock       = false;
+        std::string value; // single line
+        VecStr body;       // lines between the tags of a block
+
+        // lines as read, written back as they are until the param is changed
+        VecStr original;
+
+        HkParam() = default;
+
+        friend class HkObject;
+    };
+
+    // node of a behavior packfile
+    // parsing keeps every line it does not change, header and closing tag included, so an untouched node is written
+    // back byte for byte. Renaming the node renders its header again
+    class HkObject
+    {
+    public:
+        HkObject(std::string name, std::string className, std::string signature);
+
+        // lines of a single node, the header first; lines after </hkobject> are dropped
+        static HkObject Parse(const VecStr& lines);
+
+        const std::string& GetName() const;
+        void SetName(std::string name);
+        const std::string& GetClass() const;
+
+        HkParam* Find(const std::string& name);
+        const HkParam* Find(const std::string& name) const;
+        HkParam& Add(HkParam param);
+
+        std::vector<int> GetReferences() const;
+
+        // header to </hkobject>, without the blank line that separates nodes
+        void Serialize(VecStr& lines) const;
+
+        static bool ReadHeader(const std::string& line, HkObjectHeader& header);
+
+    private:
+        std::string name;
+        std::string className;
+        std::string signature;
+        std::string indent = "\t\t";
+        std::string open;  // header as read, empty once the node is renamed or when it was not parsed
+        std::string close; // </hkobject> line as read
+        std::vector<HkParam> params; // a param without name holds a line that is not part of any param
+    };
+} // namespace nemesis
+
+#endif
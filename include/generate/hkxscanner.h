@@ -0,0 +1,50 @@
+#ifndef HKXSCANNER_H_
+#define HKXSCANNER_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nemesis
+{
+    struct HkxFile
+    {
+        std::wstring path;
+        uint64_t size;
+        int64_t mtime;
+        unsigned char charcode = 0; // byte 0x10 of the hkx header, 0x4 for 32bit and 0x8 for 64bit
+    };
+
+    // background architecture check of every hkx file under a directory
+    // the directory tree is walked by all threads at once, and the header byte of a file is only read
+    // when its (path, size, mtime) is not in the cache file from the previous run
+    class HkxScanner
+    {
+    public:
+        HkxScanner(std::filesystem::path cachefile);
+
+        std::vector<HkxFile> Scan(const std::filesystem::path& directory);
+        bool SaveCache(const std::vector<HkxFile>& files) const;
+
+        size_t GetCacheHitCount() const;
+
+    private:
+        struct CacheEntry
+        {
+            uint64_t size;
+            int64_t mtime;
+            unsigned char charcode;
+        };
+
+        std::filesystem::path cachefile;
+        std::unordered_map<std::wstring, CacheEntry> cache;
+        size_t cacheHit = 0;
+
+        void LoadCache();
+        void ReadHeaders(std::vector<HkxFile*>& files) const;
+    };
+} // namespace nemesis
+
+#endif
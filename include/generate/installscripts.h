@@ -5,12 +5,17 @@
 
 class NemesisInfo;
 
+namespace nemesis
+{
+    struct GenerationContext;
+}
+
 class InstallScripts : public QObject
 {
     Q_OBJECT
 
 public:
-    InstallScripts(const NemesisInfo* _ini);
+    InstallScripts(const NemesisInfo* _ini, nemesis::GenerationContext& _context);
 
 public slots:
     void Run();
@@ -20,6 +25,7 @@ signals:
 
 private:
     const NemesisInfo* nemesisInfo;
+    nemesis::GenerationContext* context;
 };
 
 #endif
@@ -17,10 +17,6 @@ struct PCEAData
     std::string animPath; // animation path
 };
 
-extern std::vector<PCEA> pcealist; // list of mods with pcea
-extern std::unordered_map<std::string, std::vector<PCEAData>>
-    animReplaced; // animation file, list of ordered mod + animation path
-
 void ReadPCEA(const NemesisInfo* nemesisInfo);
 bool PCEAInstallation(const NemesisInfo* nemesisInfo);
 
@@ -33,6 +33,7 @@ public:
     const std::wstring& GetStagePath() const;
     const std::string& GetDataPathA() const;
     const std::string& GetStagePathA() const;
+    bool IsStaged() const; // generated files go to a staging directory instead of the data directory
     const uint& GetMaxAnim() const;
     const bool& IsFirst() const;
     const uint& GetWidth() const;
@@ -42,6 +43,7 @@ public:
     const uint& GetPriorityWidth() const;
 
     void setFirst(bool _first);
+    void setStagePath(const std::wstring& path);
     void setWidth(uint _width);
     void setHeight(uint _height);
     void setModNameWidth(uint _width);
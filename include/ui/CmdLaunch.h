@@ -4,6 +4,7 @@
 class NemesisInfo;
 
 void CmdGenerateInitialize(VecStr modlist, const NemesisInfo* nemesisInfo);
+void CmdBatchInitialize(const std::wstring& batchfile, const NemesisInfo* nemesisInfo);
 void CmdUpdateInitialize(const NemesisInfo* nemesisInfo);
 
 #endif
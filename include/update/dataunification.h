@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "utilities/regex.h"
+#include "utilities/pathmanifest.h"
 #include "utilities/writetextfile.h"
 
 #include "update/functionupdate.h"
@@ -11,7 +12,7 @@
 #include "generate/animationdata.h"
 #include "generate/animationsetdata.h"
 
-void behaviorJointsOutput();
+void behaviorJointsOutput(nemesis::PathManifest::Builder& manifest);
 
 bool animDataHeaderUpdate(std::string folderpath,
                           std::string modcode,
@@ -20,7 +21,7 @@ bool animDataHeaderUpdate(std::string folderpath,
 bool newAnimUpdateExt(std::string folderpath,
                       std::string modcode,
                       std::string behaviorfile,
-                      std::map<std::string, VecStr, alphanum_less>& newFile,
+                      nemesis::NodeTable& newFile,
                       std::map<std::string, VecStr>& newAnimAddition,
                       std::unordered_map<std::wstring, std::wstring>& lastUpdate);
 bool newAnimDataUpdateExt(std::string folderpath,
@@ -0,0 +1,83 @@
+#ifndef DISASSEMBLYSNAPSHOT_H_
+#define DISASSEMBLYSNAPSHOT_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef std::vector<std::string> VecStr;
+typedef std::unordered_map<std::string, std::string> SSMap;
+
+namespace nemesis
+{
+    class NodeTable;
+
+    // what AnimDataDisassemble built from the animation data file, in the order it was built
+    struct AnimDataRecord
+    {
+        struct Block
+        {
+            std::string key; // first line, the name aadd and iadd file the block under
+            VecStr lines;
+            uint32_t linenum;
+        };
+
+        struct Project
+        {
+            VecStr header;
+            uint32_t linenum;
+            std::vector<Block> anims;
+            std::vector<Block> infos;
+        };
+
+        VecStr projectNames; // added as projects 1 to N
+        std::vector<Project> projects;
+    };
+
+    // what AnimSetDataDisassemble added to the animation set data
+    struct AnimSetDataRecord
+    {
+        struct Entry
+        {
+            std::string project;
+            std::string header;
+            VecStr lines;
+        };
+
+        VecStr projectList;
+        std::vector<Entry> entries; // in the order they were assigned, a later entry replaces an earlier one
+    };
+
+    // cache\disassembly\<name>
+    // parsed form of a base file the update disassembles on every run, the base files under cached_behaviors and
+    // the vanilla animation data do not change between runs
+    // a snapshot is only used while the content hash of its source file matches the one it was taken from
+    class DisassemblySnapshot
+    {
+    public:
+        DisassemblySnapshot(const std::filesystem::path& source, const std::string& name);
+
+        bool Load(NodeTable& nodes,
+                  std::map<std::string, std::unordered_map<std::string, bool>>& childrenState,
+                  SSMap& stateID,
+                  SSMap& parent) const;
+        bool Load(AnimDataRecord& record) const;
+        bool Load(AnimSetDataRecord& record) const;
+
+        bool Save(NodeTable& nodes,
+                  const std::map<std::string, std::unordered_map<std::string, bool>>& childrenState,
+                  const SSMap& stateID,
+                  const SSMap& parent) const;
+        bool Save(const AnimDataRecord& record) const;
+        bool Save(const AnimSetDataRecord& record) const;
+
+    private:
+        std::filesystem::path cachefile;
+        uint64_t sourceHash;
+    };
+} // namespace nemesis
+
+#endif
@@ -8,6 +8,8 @@
 #include "utilities/regex.h"
 #include "utilities/writetextfile.h"
 
+#include "update/nodetable.h"
+
 #include "update/animdata/animdatacond.h"
 
 #include "generate/animationsetdata.h"
@@ -21,7 +23,7 @@ class NodeU
     bool NodeUpdate(std::string modcode,
                     std::string f2,
                     std::string f3,
-                    std::unique_ptr<std::map<std::string, VecStr, alphanum_less>>& newFile,
+                    std::unique_ptr<nemesis::NodeTable>& newFile,
                     std::unique_ptr<SSMap>& stateID,
                     std::unique_ptr<SSMap>& parent,
                     std::unique_ptr<std::unordered_map<std::string, VecStr>>& statelist,
@@ -38,7 +40,7 @@ public:
     bool FunctionUpdate(std::string modcode,
                         std::string f2,
                         std::string f3,
-                        std::unique_ptr<std::map<std::string, VecStr, alphanum_less>>& newFile,
+                        std::unique_ptr<nemesis::NodeTable>& newFile,
                         std::unique_ptr<SSMap>& stateID,
                         std::unique_ptr<SSMap>& parent,
                         std::unique_ptr<std::unordered_map<std::string, VecStr>>& statelist,
@@ -0,0 +1,61 @@
+#ifndef NODETABLE_H_
+#define NODETABLE_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "utilities/naturalkey.h"
+
+typedef std::vector<std::string> VecStr;
+
+namespace nemesis
+{
+    // nodes of a single behavior file, keyed by (mod index, numeric ID) packed into 64 bits
+    // "#0123" is vanilla node 123 and is addressed by direct index, up to a fixed maximum ID
+    // "#modcode$45" is node 45 of modcode, mod index is assigned on first sight of the mod code
+    // IDs are equal when they are equal ignoring case, as in the map the table replaced; an ID whose number is
+    // zero padded in any other way ("#123", "#00123", "#modcode$045") is a different node and is kept by name
+    class NodeTable
+    {
+    public:
+        using Key = uint64_t;
+
+        struct Node
+        {
+            const std::string* name; // ID as it was first spelled
+            VecStr* lines;
+        };
+
+        VecStr& operator[](std::string_view nodeID);
+        VecStr* find(std::string_view nodeID);
+        size_t size() const;
+
+        // all nodes in output order, the order of their IDs under alphanum_less
+        std::vector<Node> GetSortedNodes();
+
+        // text between "#" and "$" of the node ID, empty for vanilla nodes
+        std::string_view GetModCode(const Node& node) const;
+        const std::string& GetNodeName(const Node& node) const;
+
+    private:
+        struct Entry
+        {
+            std::string name; // empty while the node does not exist
+            VecStr lines;
+        };
+
+        std::vector<Entry> vanillaNodes;
+        std::unordered_map<Key, Entry> modNodes;
+        nemesis::NaturalMap<VecStr> namedNodes;
+
+        std::unordered_map<std::string, uint32_t> modIndexes; // lowercase mod code, mod index
+
+        bool GetKey(std::string_view nodeID, Key& key, bool create);
+        Entry* Create(std::string_view nodeID);
+    };
+} // namespace nemesis
+
+#endif
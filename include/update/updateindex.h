@@ -0,0 +1,38 @@
+#ifndef UPDATEINDEX_H_
+#define UPDATEINDEX_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef std::vector<std::string> VecStr;
+
+namespace nemesis
+{
+    // cache\update_index
+    // merged output state of every behavior from the last engine update and the behaviors each patch mod touched
+    // lets an update re-merge only the behaviors touched by the mods that changed since then
+    struct UpdateIndex
+    {
+        struct BehaviorState
+        {
+            uint32_t crc32 = 0; // crc of the merged output, summed into the engine version code
+            VecStr joints;      // lower behavior files referenced by the merged output
+        };
+
+        static constexpr wchar_t defaultFile[] = L"cache\\update_index";
+
+        std::unordered_map<std::string, BehaviorState> behaviors;           // lower behavior file, merged state
+        std::unordered_map<std::string, std::set<std::string>> modBehaviors; // mod code, behaviors touched
+        uint32_t animSetDataCrc32 = 0;
+
+        bool Load(const std::filesystem::path& filepath);
+        bool Save(const std::filesystem::path& filepath) const;
+        void Clear();
+    };
+} // namespace nemesis
+
+#endif
@@ -5,10 +5,15 @@
 
 #include "ui/ProgressUp.h"
 
+#include "utilities/pathmanifest.h"
+
+#include "update/nodetable.h"
+#include "update/updateindex.h"
 #include "update/animdata/animdatacond.h"
 
 #include "generate/behaviortype.h"
 #include "generate/animationdata.h"
+#include "generate/generationcontext.h"
 #include "generate/behaviortype.h"
 
 #include "generate/animation/import.h"
@@ -56,6 +61,8 @@ public:
     virtual ~UpdateFilesStart();
     void startUpdatingFile();
     void milestoneStart(std::string directory);
+    bool PlanPartialUpdate(const std::string& directory);
+    bool isMergeTarget(const std::string& behavior) const;
     void message(std::string input);
     void message(std::wstring input);
     void GetFileLoop(std::string newPath);
@@ -64,7 +71,7 @@ public:
     void RegisterBehavior(std::shared_ptr<RegisterQueue> curBehavior);
     bool VanillaDisassemble(
         const std::wstring& path,
-        std::unique_ptr<std::map<std::string, VecStr, alphanum_less>>& newFile,
+        std::unique_ptr<nemesis::NodeTable>& newFile,
         std::unique_ptr<std::map<std::string, std::unordered_map<std::string, bool>>>& childrenState,
         std::unique_ptr<SSMap>& stateID,
         std::unique_ptr<SSMap>& n_parent);
@@ -122,7 +129,7 @@ private:
 #endif
 
 	// update data container
-	std::map<std::string, std::unique_ptr<std::map<std::string, VecStr, alphanum_less>>> newFile;
+	std::map<std::string, std::unique_ptr<nemesis::NodeTable>> newFile;
 	// behavior file, node ID, node data lines; memory to access each node
 #if MULTITHREADED_UPDATE
     std::atomic_flag newFileLock{};
@@ -142,12 +149,23 @@ private:
 
     std::map<std::string, VecStr> newAnimAddition;
     std::unordered_map<std::wstring, std::wstring> lastUpdate;
+    nemesis::PathManifest::Builder behaviorManifest;
+
+    // partial update; only the behaviors touched by the changed mods are merged again, the merged state of the
+    // rest is carried over from the update index
+    bool partialUpdate = false;
+    std::set<std::string> changedMods;
+    std::unordered_set<std::string> mergeTargets;
+    nemesis::UpdateIndex updateIndex;
     std::unordered_map<std::string, std::unordered_map<std::string, size_t>>
         modFileCounter; // modcode, behavior, number of files
     std::unordered_map<std::string, std::unordered_map<std::string, VecStr>>
         modFileList; // modcode, behavior, node files
     std::atomic_flag fileCountLock{};
 
+    // state of this update, bound to every thread working on it
+    nemesis::GenerationContext context;
+
     // global container locker
 #if MULTITHREADED_UPDATE
     std::atomic_flag behaviorPathLock       {};
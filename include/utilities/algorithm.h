@@ -1,11 +1,25 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace nemesis
 {
-    const char* to_lower_copy(const char* data);
-    const wchar_t* to_lower_copy(const wchar_t* data);
+    // case folding is ascii only and never allocates, except for the *_copy functions returning a new string
+    // the names the generator folds (files, nodes, events, variables, mod codes) are ascii
+    constexpr char ascii_lower(char ch) noexcept
+    {
+        return ch >= 'A' && ch <= 'Z' ? char(ch + ('a' - 'A')) : ch;
+    }
+
+    constexpr wchar_t ascii_lower(wchar_t ch) noexcept
+    {
+        return ch >= L'A' && ch <= L'Z' ? wchar_t(ch + (L'a' - L'A')) : ch;
+    }
+
+    std::string to_lower_copy(const char* data);
+    std::wstring to_lower_copy(const wchar_t* data);
 
     std::string to_lower_copy(const std::string& data);
     std::wstring to_lower_copy(const std::wstring& data);
@@ -13,8 +27,8 @@ namespace nemesis
     void to_lower(std::string& data);
     void to_lower(std::wstring& data);
 
-    const char* to_upper_copy(const char* data);
-    const wchar_t* to_upper_copy(const wchar_t* data);
+    std::string to_upper_copy(const char* data);
+    std::wstring to_upper_copy(const wchar_t* data);
 
     std::string to_upper_copy(const std::string& data);
     std::wstring to_upper_copy(const std::wstring& data);
@@ -22,21 +36,43 @@ namespace nemesis
     void to_upper(std::string& data);
     void to_upper(std::wstring& data);
 
-    bool iequals(const char* l, const char* r);
-    bool iequals(const wchar_t* l, const wchar_t* r);
-    bool iequals(const char* l, const std::string& r);
-    bool iequals(const wchar_t* l, const std::wstring& r);
-    bool iequals(const std::string& l, const char* r);
-    bool iequals(const std::wstring& l, const wchar_t* r);
-    bool iequals(const std::string& l, const std::string& r);
-    bool iequals(const std::wstring& l, const std::wstring& r);
+    bool iequals(std::string_view l, std::string_view r) noexcept;
+    bool iequals(std::wstring_view l, std::wstring_view r) noexcept;
+
+    // case insensitive string::find and string::rfind, npos when word is not in text
+    size_t ifind(std::string_view text, std::string_view word, size_t pos = 0) noexcept;
+    size_t ifind(std::wstring_view text, std::wstring_view word, size_t pos = 0) noexcept;
+    size_t irfind(std::string_view text, std::string_view word) noexcept;
+    size_t irfind(std::wstring_view text, std::wstring_view word) noexcept;
 
+    bool has_alpha(std::string_view text) noexcept;
+    bool has_alpha(std::wstring_view text) noexcept;
+
+    // a narrow byte widens to the code point of the same value and a wide character narrows to its low byte,
+    // so names up to U+00FF survive the round trip
     template <typename T, typename F>
     inline T transform_to(const F& str) noexcept
     {
         if (str.empty()) return {};
 
-        return {std::begin(str), std::end(str)};
+        using From = std::decay_t<decltype(*std::begin(str))>;
+
+        if constexpr (sizeof(From) == 1 && sizeof(typename T::value_type) > 1)
+        {
+            T result;
+            result.reserve(str.size());
+
+            for (unsigned char ch : str)
+            {
+                result.push_back(typename T::value_type(ch));
+            }
+
+            return result;
+        }
+        else
+        {
+            return {std::begin(str), std::end(str)};
+        }
     };
 
 } // namespace nemesis
@@ -0,0 +1,123 @@
+#ifndef BINARYIO_H_
+#define BINARYIO_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+class QFile;
+
+namespace nemesis
+{
+    // binary cache file writer
+    // content is buffered and written to "<file>.tmp", which replaces the target only on Commit
+    // so an interrupted run never leaves a half written cache behind
+    class BinaryWriter
+    {
+    public:
+        BinaryWriter(const std::filesystem::path& filepath, uint32_t magic, uint32_t version);
+
+        template <typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "BinaryWriter::Write requires trivially copyable type");
+            WriteBytes(&value, sizeof(T));
+        }
+
+        void WriteBytes(const void* data, size_t size);
+        void WriteString(std::string_view str);
+        void WriteString(std::wstring_view str);
+
+        size_t Size() const;
+        bool Commit();
+
+    private:
+        std::filesystem::path filepath;
+        std::vector<char> buffer;
+    };
+
+    class MappedFile;
+
+    // binary cache file reader; the whole file is read in one go and validated against magic and version
+    class BinaryReader
+    {
+    public:
+        BinaryReader(const std::filesystem::path& filepath, uint32_t magic, uint32_t version);
+
+        // reads the mapped file in place, the file has to stay open while the reader is used
+        BinaryReader(const MappedFile& file, uint32_t magic, uint32_t version);
+
+        bool IsValid() const;
+        bool AtEnd() const;
+
+        template <typename T>
+        bool Read(T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "BinaryReader::Read requires trivially copyable type");
+            return ReadBytes(&value, sizeof(T));
+        }
+
+        // element count of a list that follows, failed when count elements of at least minSize bytes each
+        // cannot fit in the rest of the file, so a corrupted count is a failed read instead of a huge allocation
+        template <typename T>
+        bool ReadCount(T& count, size_t minSize)
+        {
+            static_assert(std::is_unsigned_v<T>, "BinaryReader::ReadCount requires unsigned type");
+
+            if (!Read(count)) return false;
+
+            if (count > Remaining() / (std::max)(minSize, size_t(1)))
+            {
+                valid = false;
+                return false;
+            }
+
+            return true;
+        }
+
+        bool ReadBytes(void* data, size_t size);
+        bool ReadString(std::string& str);
+        bool ReadString(std::wstring& str);
+
+        size_t Remaining() const;
+
+    private:
+        std::vector<char> buffer;
+        const char* data = nullptr;
+        size_t size      = 0;
+        size_t pos       = 0;
+        bool valid       = false;
+
+        void Validate(uint32_t magic, uint32_t version);
+    };
+
+    // read only memory mapped view of a whole file, unmapped on Close or destruction
+    class MappedFile
+    {
+    public:
+        MappedFile();
+        MappedFile(MappedFile&&) noexcept;
+        MappedFile& operator=(MappedFile&&) noexcept;
+        ~MappedFile();
+
+        bool Open(const std::filesystem::path& filepath);
+        void Close();
+
+        bool IsOpen() const;
+        const char* Data() const;
+        size_t Size() const;
+
+    private:
+        std::unique_ptr<QFile> file;
+        const char* data = nullptr;
+        size_t size      = 0;
+    };
+} // namespace nemesis
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef CHANGEMANIFEST_H_
+#define CHANGEMANIFEST_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace nemesis
+{
+    // cache\engine_update
+    // size, modified time and content hash of every file read by the last engine update, plus the modified time of
+    // every folder under the tracked roots so new files are found without listing the folders that did not change
+    class ChangeManifest
+    {
+    public:
+        struct ChangeSet
+        {
+            bool outdated = false;           // manifest missing, unreadable or from another nemesis version
+            std::vector<std::wstring> files; // changed, removed and new files
+            std::set<std::wstring> added;    // the files that were not recorded
+            std::set<std::string> mods;      // mod codes under "mod\" that have changed files
+            std::set<std::string> templates; // template folders under "behavior templates\" that have changed files
+
+            bool IsChanged() const
+            {
+                return outdated || !files.empty();
+            }
+        };
+
+        // lowercase directory and file name of a file found in a changed folder; true if an update would have read it
+        using TrackFilter = std::function<bool(const std::wstring& directory, const std::wstring& file)>;
+
+        static constexpr wchar_t defaultFile[] = L"cache\\engine_update";
+
+        void SetVersion(const std::string& nemesisVersion, const std::string& engineVersion);
+        void AddFile(const std::wstring& filepath);
+        void AddRoot(const std::wstring& directory);
+
+        // drops the recorded files that match, to carry the rest of a loaded manifest over to a partial update
+        void RemoveFiles(const std::function<bool(const std::wstring& filepath)>& match);
+
+        // file states are taken here, in parallel
+        bool Save(const std::filesystem::path& filepath, bool hashContent = true);
+        bool Load(const std::filesystem::path& filepath);
+
+        const std::string& GetNemesisVersion() const;
+        const std::string& GetEngineVersion() const;
+
+        // compares every recorded file in parallel; with stopAtFirst the comparison ends at the first change
+        ChangeSet GetChanges(const TrackFilter& isTracked, bool stopAtFirst) const;
+
+        static uint64_t HashFile(const std::wstring& filepath);
+
+    private:
+        struct FileRecord
+        {
+            std::wstring path;
+            uint64_t size;
+            int64_t mtime;
+            uint64_t hash; // 0 when not hashed
+        };
+
+        struct FolderRecord
+        {
+            std::wstring path;
+            int64_t mtime;
+        };
+
+        std::string nemesisVersion;
+        std::string engineVersion;
+        std::vector<FileRecord> files;
+        std::vector<FolderRecord> folders;
+        std::vector<std::wstring> roots;
+
+        void RecordFolder(const std::filesystem::path& directory);
+    };
+} // namespace nemesis
+
+#endif
@@ -67,6 +67,7 @@ namespace nemesis
 		std::map<int, std::vector<std::shared_ptr<nemesis::scope>>> cmp2_block;
 
 		std::shared_ptr<VecStr> optioncondt;
+		std::vector<uint32_t> optionIDs;		// option index of every optioncondt element
 		std::shared_ptr<Condt> nestedcond;
 		std::shared_ptr<Condt> next;
 
@@ -5,6 +5,6 @@ class NemesisInfo;
 
 bool FileCheck(bool isUpdate = false);				// Check the existence of required files
 bool PCEACheck(const NemesisInfo* nemesisInfo);		// Check if PCEA is installed
-void behaviorActivateMod(VecStr behaviorPriority);	// Check which behavior file will be edited by mod
+void behaviorActivateMod(const VecStr& behaviorPriority);	// Check which behavior file will be edited by mod
 
 #endif
\ No newline at end of file
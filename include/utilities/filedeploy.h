@@ -0,0 +1,18 @@
+#ifndef FILEDEPLOY_H_
+#define FILEDEPLOY_H_
+
+#include <filesystem>
+
+namespace nemesis
+{
+    // puts a copy of source at target unless target already holds the same bytes
+    // a changed target is written next to it first and renamed over it, the game and the mod manager never see a
+    // half written file and a target hard linked to another file is replaced instead of written through
+    // returns false when target was left as it was
+    bool DeployFile(const std::filesystem::path& source, const std::filesystem::path& target);
+
+    // true when both files exist and their content is the same
+    bool SameContent(const std::filesystem::path& file1, const std::filesystem::path& file2);
+} // namespace nemesis
+
+#endif
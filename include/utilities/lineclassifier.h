@@ -0,0 +1,75 @@
+#ifndef LINECLASSIFIER_H_
+#define LINECLASSIFIER_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace nemesis
+{
+    // literals the behavior scanners probe each line for
+    enum class LineMarker : uint8_t
+    {
+        Comment,     // <!--
+        ModCode,     // <!-- *
+        NewMod,      // <!-- NEW *
+        NewTemplate, // <!-- NEW ^
+        ForEach,     // <!-- FOREACH ^
+        Original,    // <!-- ORIGINAL -->
+        Close,       // <!-- CLOSE -->
+        Condition,   // <!-- CONDITION
+        Object,      // <hkobject name="
+        Param,       // <hkparam name="
+        NumElements, // numelements=" of an <hkparam
+        ParamClose,  // </hkparam>
+        CString,     // <hkcstring>
+        Reference,   // >#
+        TemplateID,  // $ after the first #, a node ID that still holds a template placeholder
+        EventID,     // $eventID[
+        VariableID,  // $variableID[
+        Count,
+    };
+
+    // every marker of a line and the position of its first occurrence
+    class LineClass
+    {
+    public:
+        bool Has(LineMarker marker) const noexcept
+        {
+            return (mask & Bit(marker)) != 0;
+        }
+
+        // std::string::npos when the line does not have the marker
+        size_t Find(LineMarker marker) const noexcept
+        {
+            return Has(marker) ? positions[static_cast<size_t>(marker)] : std::string::npos;
+        }
+
+        bool Empty() const noexcept
+        {
+            return mask == 0;
+        }
+
+        // name of the first <hkparam of the classified line, empty when it has none
+        std::string_view ParamName(std::string_view line) const noexcept;
+
+        static constexpr uint32_t Bit(LineMarker marker) noexcept
+        {
+            return uint32_t(1) << static_cast<uint32_t>(marker);
+        }
+
+    private:
+        uint32_t mask = 0;
+        uint32_t positions[static_cast<size_t>(LineMarker::Count)];
+
+        void Set(LineMarker marker, size_t pos) noexcept;
+
+        friend LineClass ClassifyLine(std::string_view line);
+    };
+
+    // single pass over the line, 16 bytes at a time where SSE2 is available
+    // only '<', '$' and '#' can start a marker, every other byte is skipped without a comparison
+    LineClass ClassifyLine(std::string_view line);
+} // namespace nemesis
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef MEMORYBUDGET_H_
+#define MEMORYBUDGET_H_
+
+#include <condition_variable>
+#include <mutex>
+
+namespace nemesis
+{
+    // admits work while the estimated footprint of everything admitted stays under the limit
+    // a limit of 0 admits everything, work larger than the whole limit is admitted once nothing else is
+    class MemoryBudget
+    {
+    public:
+        // holds the admitted bytes until destroyed
+        class Ticket
+        {
+        public:
+            Ticket() = default;
+            Ticket(Ticket&& other) noexcept;
+            Ticket& operator=(Ticket&& other) noexcept;
+            ~Ticket();
+
+            Ticket(const Ticket&) = delete;
+            Ticket& operator=(const Ticket&) = delete;
+
+        private:
+            MemoryBudget* budget = nullptr;
+            size_t bytes         = 0;
+
+            Ticket(MemoryBudget* _budget, size_t _bytes);
+
+            friend class MemoryBudget;
+        };
+
+        static MemoryBudget& Instance();
+
+        void SetLimit(size_t limit_bytes);
+        size_t GetLimit() const;
+
+        // blocks until bytes fit in the limit, returns right away once an error has been raised
+        Ticket Acquire(size_t bytes);
+
+    private:
+        mutable std::mutex lock;
+        std::condition_variable released;
+        size_t limit = 0;
+        size_t used  = 0;
+        size_t count = 0; // tickets admitted
+
+        MemoryBudget() = default;
+
+        void Release(size_t bytes);
+    };
+} // namespace nemesis
+
+#endif
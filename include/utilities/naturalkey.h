@@ -0,0 +1,411 @@
+#ifndef NATURALKEY_H_
+#define NATURALKEY_H_
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nemesis
+{
+    // sort key of a node ID or header, built once on insertion
+    // alphanum_less compares with lstrcmpiA, which uses the word sort of the user locale; for ascii the key follows
+    // that order: case is ignored, hyphens, apostrophes and control characters only break ties, the other
+    // punctuation sorts before + < = >, then digits, then letters
+    // bytes above 0x7f keep their code page order after the letters, where lstrcmpiA would sort accented letters
+    // next to their base letter; the names stored in these containers are ascii
+    // each comparison is a single memcmp instead of a locale aware comparison of both strings
+    class NaturalKey
+    {
+    public:
+        NaturalKey() = default;
+        explicit NaturalKey(std::string_view str);
+
+        bool operator<(const NaturalKey& rhs) const noexcept
+        {
+            return packed < rhs.packed;
+        }
+
+        bool operator==(const NaturalKey& rhs) const noexcept
+        {
+            return packed == rhs.packed;
+        }
+
+        bool operator!=(const NaturalKey& rhs) const noexcept
+        {
+            return packed != rhs.packed;
+        }
+
+        struct Hash
+        {
+            size_t operator()(const NaturalKey& key) const noexcept
+            {
+                return std::hash<std::string>()(key.packed);
+            }
+        };
+
+    private:
+        std::string packed;
+    };
+
+    // nemesis::NaturalMap<T> replacement stored as a sorted flat vector
+    // keys are parsed into NaturalKey once, lookups are binary searches over the packed keys
+    // insertion in ascending order (the order files are disassembled in) is an append, a key below the last one is
+    // buffered and the buffer is sorted and merged in one go before the next lookup, iteration or erasure
+    // iterators and references are invalidated by insertion and erasure, unlike std::map
+    // like the std::map it replaces, concurrent reads are safe once nothing inserts any more
+    template <typename T>
+    class NaturalMap
+    {
+    public:
+        using key_type               = std::string;
+        using mapped_type            = T;
+        using value_type             = std::pair<std::string, T>;
+        using iterator               = typename std::vector<value_type>::iterator;
+        using const_iterator         = typename std::vector<value_type>::const_iterator;
+        using reverse_iterator       = typename std::vector<value_type>::reverse_iterator;
+        using const_reverse_iterator = typename std::vector<value_type>::const_reverse_iterator;
+
+        NaturalMap() = default;
+
+        NaturalMap(const NaturalMap& other)
+        {
+            other.merge();
+            keys  = other.keys;
+            items = other.items;
+        }
+
+        NaturalMap(NaturalMap&& other) noexcept
+            : keys(std::move(other.keys))
+            , items(std::move(other.items))
+            , pendingKeys(std::move(other.pendingKeys))
+            , pendingItems(std::move(other.pendingItems))
+            , pendingIndex(std::move(other.pendingIndex))
+            , dirty(other.dirty.load())
+        {
+            other.dirty = false;
+        }
+
+        NaturalMap& operator=(const NaturalMap& other)
+        {
+            if (this != &other) *this = NaturalMap(other);
+
+            return *this;
+        }
+
+        NaturalMap& operator=(NaturalMap&& other) noexcept
+        {
+            keys         = std::move(other.keys);
+            items        = std::move(other.items);
+            pendingKeys  = std::move(other.pendingKeys);
+            pendingItems = std::move(other.pendingItems);
+            pendingIndex = std::move(other.pendingIndex);
+            dirty        = other.dirty.load();
+            other.dirty  = false;
+            return *this;
+        }
+
+        iterator begin()
+        {
+            merge();
+            return items.begin();
+        }
+
+        iterator end()
+        {
+            merge();
+            return items.end();
+        }
+
+        const_iterator begin() const
+        {
+            merge();
+            return items.begin();
+        }
+
+        const_iterator end() const
+        {
+            merge();
+            return items.end();
+        }
+
+        reverse_iterator rbegin()
+        {
+            merge();
+            return items.rbegin();
+        }
+
+        reverse_iterator rend()
+        {
+            merge();
+            return items.rend();
+        }
+
+        const_reverse_iterator rbegin() const
+        {
+            merge();
+            return items.rbegin();
+        }
+
+        const_reverse_iterator rend() const
+        {
+            merge();
+            return items.rend();
+        }
+
+        size_t size() const noexcept
+        {
+            return items.size() + pendingItems.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        void clear() noexcept
+        {
+            keys.clear();
+            items.clear();
+            pendingKeys.clear();
+            pendingItems.clear();
+            pendingIndex.clear();
+            dirty = false;
+        }
+
+        void reserve(size_t n)
+        {
+            keys.reserve(n);
+            items.reserve(n);
+        }
+
+        iterator find(std::string_view key)
+        {
+            merge();
+            NaturalKey nkey(key);
+            size_t index = lowerIndex(nkey);
+            return index < keys.size() && keys[index] == nkey ? items.begin() + index : items.end();
+        }
+
+        const_iterator find(std::string_view key) const
+        {
+            merge();
+            NaturalKey nkey(key);
+            size_t index = lowerIndex(nkey);
+            return index < keys.size() && keys[index] == nkey ? items.begin() + index : items.end();
+        }
+
+        size_t count(std::string_view key) const
+        {
+            return find(key) == end() ? 0 : 1;
+        }
+
+        T& at(std::string_view key)
+        {
+            auto itr = find(key);
+
+            if (itr == end()) throw std::out_of_range("NaturalMap::at");
+
+            return itr->second;
+        }
+
+        const T& at(std::string_view key) const
+        {
+            auto itr = find(key);
+
+            if (itr == end()) throw std::out_of_range("NaturalMap::at");
+
+            return itr->second;
+        }
+
+        T& operator[](const std::string& key)
+        {
+            return tryEmplace(key, T()).first->second;
+        }
+
+        std::pair<iterator, bool> insert(value_type item)
+        {
+            return tryEmplace(std::move(item.first), std::move(item.second));
+        }
+
+        std::pair<iterator, bool> emplace(std::string key, T value)
+        {
+            return tryEmplace(std::move(key), std::move(value));
+        }
+
+        // bulk insertion; incoming items are keyed and sorted once, then merged with the existing items
+        // like std::map::insert, keys that already exist keep their current value
+        template <typename InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            merge();
+            std::vector<std::pair<NaturalKey, value_type>> incoming;
+
+            for (; first != last; ++first)
+            {
+                incoming.emplace_back(NaturalKey(first->first), value_type(first->first, first->second));
+            }
+
+            std::stable_sort(incoming.begin(), incoming.end(), [](const auto& l, const auto& r) {
+                return l.first < r.first;
+            });
+
+            std::vector<NaturalKey> newKeys;
+            std::vector<value_type> newItems;
+            newKeys.reserve(keys.size() + incoming.size());
+            newItems.reserve(keys.size() + incoming.size());
+            size_t i = 0;
+            size_t j = 0;
+
+            while (i < keys.size() || j < incoming.size())
+            {
+                if (j == incoming.size() || (i < keys.size() && !(incoming[j].first < keys[i])))
+                {
+                    // existing key wins over an equal incoming key
+                    while (j < incoming.size() && i < keys.size() && incoming[j].first == keys[i])
+                    {
+                        ++j;
+                    }
+
+                    newKeys.push_back(std::move(keys[i]));
+                    newItems.push_back(std::move(items[i]));
+                    ++i;
+                }
+                else
+                {
+                    if (newKeys.empty() || newKeys.back() != incoming[j].first)
+                    {
+                        newKeys.push_back(std::move(incoming[j].first));
+                        newItems.push_back(std::move(incoming[j].second));
+                    }
+
+                    ++j;
+                }
+            }
+
+            keys  = std::move(newKeys);
+            items = std::move(newItems);
+        }
+
+        size_t erase(std::string_view key)
+        {
+            auto itr = find(key);
+
+            if (itr == end()) return 0;
+
+            erase(itr);
+            return 1;
+        }
+
+        // pos comes from find or iteration, which have merged the buffer
+        iterator erase(const_iterator pos)
+        {
+            size_t index = pos - items.cbegin();
+            keys.erase(keys.begin() + index);
+            return items.erase(items.begin() + index);
+        }
+
+    private:
+        // sorted
+        mutable std::vector<NaturalKey> keys;
+        mutable std::vector<value_type> items;
+
+        // inserted below the last sorted key, in insertion order
+        mutable std::vector<NaturalKey> pendingKeys;
+        mutable std::vector<value_type> pendingItems;
+        mutable std::unordered_map<NaturalKey, size_t, NaturalKey::Hash> pendingIndex;
+        mutable std::atomic<bool> dirty{false};
+        mutable std::mutex mergeLock;
+
+        size_t lowerIndex(const NaturalKey& key) const
+        {
+            return std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+        }
+
+        // a const lookup may be the one to merge, the lock keeps two readers from merging at once
+        void merge() const
+        {
+            if (!dirty.load(std::memory_order_acquire)) return;
+
+            std::lock_guard<std::mutex> guard(mergeLock);
+
+            if (!dirty.load(std::memory_order_relaxed)) return;
+
+            std::vector<size_t> order(pendingKeys.size());
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+                return pendingKeys[l] < pendingKeys[r];
+            });
+
+            // the buffered keys are in neither list twice, so the merge only interleaves
+            std::vector<NaturalKey> newKeys;
+            std::vector<value_type> newItems;
+            newKeys.reserve(keys.size() + order.size());
+            newItems.reserve(keys.size() + order.size());
+            size_t i = 0;
+
+            for (size_t index : order)
+            {
+                while (i < keys.size() && keys[i] < pendingKeys[index])
+                {
+                    newKeys.push_back(std::move(keys[i]));
+                    newItems.push_back(std::move(items[i]));
+                    ++i;
+                }
+
+                newKeys.push_back(std::move(pendingKeys[index]));
+                newItems.push_back(std::move(pendingItems[index]));
+            }
+
+            for (; i < keys.size(); ++i)
+            {
+                newKeys.push_back(std::move(keys[i]));
+                newItems.push_back(std::move(items[i]));
+            }
+
+            keys  = std::move(newKeys);
+            items = std::move(newItems);
+            pendingKeys.clear();
+            pendingItems.clear();
+            pendingIndex.clear();
+            dirty.store(false, std::memory_order_release);
+        }
+
+        std::pair<iterator, bool> tryEmplace(std::string key, T value)
+        {
+            NaturalKey nkey(key);
+
+            // appending in ascending order is the common case, every buffered key is below the last sorted one
+            if (keys.empty() || keys.back() < nkey)
+            {
+                keys.push_back(std::move(nkey));
+                items.emplace_back(std::move(key), std::move(value));
+                return std::make_pair(items.end() - 1, true);
+            }
+
+            size_t index = lowerIndex(nkey);
+
+            if (keys[index] == nkey) return std::make_pair(items.begin() + index, false);
+
+            auto pending = pendingIndex.find(nkey);
+
+            if (pending != pendingIndex.end()) return std::make_pair(pendingItems.begin() + pending->second, false);
+
+            // a key out of order would move every item after it, it waits for the next merge instead
+            pendingIndex.emplace(nkey, pendingKeys.size());
+            pendingKeys.push_back(std::move(nkey));
+            pendingItems.emplace_back(std::move(key), std::move(value));
+            dirty = true;
+            return std::make_pair(pendingItems.end() - 1, true);
+        }
+    };
+} // namespace nemesis
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef PATHINTERNER_H_
+#define PATHINTERNER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace nemesis
+{
+    // 32 bit handle of a path or file name interned in PathInterner, 0 is the empty path
+    // spellings that only differ in case or in the separator ('/' or '\') share one handle, and so do a wide name,
+    // its UTF-8 form and, for names up to U+00FF, its transform_to narrowing
+    class PathHandle
+    {
+    public:
+        PathHandle() = default;
+
+        // UTF-8 as first interned, with '\' as separator; narrow bytes that are not UTF-8 are re-encoded
+        const std::string& Utf8() const;
+        // lower case UTF-8, the form every spelling is matched by
+        const std::string& Lower() const;
+        const std::wstring& Wide() const;
+
+        uint32_t Id() const noexcept
+        {
+            return id;
+        }
+
+        bool Empty() const noexcept
+        {
+            return id == 0;
+        }
+
+        bool operator==(PathHandle rhs) const noexcept
+        {
+            return id == rhs.id;
+        }
+
+        bool operator!=(PathHandle rhs) const noexcept
+        {
+            return id != rhs.id;
+        }
+
+    private:
+        uint32_t id = 0;
+
+        explicit PathHandle(uint32_t _id) noexcept
+            : id(_id)
+        {
+        }
+
+        friend class PathInterner;
+    };
+
+    // process wide table of every path and file name the generator looks up
+    // a path is converted and folded once, when it is interned; handles stay valid until the process ends
+    // entries are never moved, so reading one through a handle takes no lock
+    class PathInterner
+    {
+    public:
+        static PathInterner& Instance();
+
+        PathHandle Intern(std::string_view utf8);
+        PathHandle Intern(std::wstring_view wide);
+
+        size_t Size() const noexcept;
+
+    private:
+        struct Entry
+        {
+            std::string utf8;
+            std::string lower;
+            std::wstring wide;
+        };
+
+        struct FoldedHash
+        {
+            size_t operator()(std::string_view lower) const noexcept;
+        };
+
+        static constexpr size_t chunkBits = 12;
+        static constexpr size_t chunkSize = size_t(1) << chunkBits;
+        static constexpr size_t maxChunks = 4096;
+
+        std::atomic<Entry*> chunks[maxChunks] = {};
+        std::atomic<uint32_t> count{0};
+
+        std::unordered_map<std::string_view, uint32_t, FoldedHash> index; // keys view Entry::lower
+        mutable std::shared_mutex indexLock;
+
+        PathInterner();
+        ~PathInterner();
+
+        // utf8 is valid UTF-8
+        PathHandle InternEncoded(std::string_view utf8);
+        PathHandle Insert(std::string_view normalized, std::string_view lower);
+        const Entry& Get(uint32_t id) const noexcept;
+
+        friend class PathHandle;
+    };
+
+    inline PathHandle InternPath(std::string_view utf8)
+    {
+        return PathInterner::Instance().Intern(utf8);
+    }
+
+    inline PathHandle InternPath(std::wstring_view wide)
+    {
+        return PathInterner::Instance().Intern(wide);
+    }
+
+    template <typename T>
+    using PathMap = std::unordered_map<PathHandle, T>;
+} // namespace nemesis
+
+namespace std
+{
+    template <>
+    struct hash<nemesis::PathHandle>
+    {
+        // handles are dense, so the ID itself spreads over the buckets
+        size_t operator()(nemesis::PathHandle handle) const noexcept
+        {
+            return handle.Id();
+        }
+    };
+} // namespace std
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef PATHMANIFEST_H_
+#define PATHMANIFEST_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "utilities/binaryio.h"
+
+namespace nemesis
+{
+    // cache\behavior_manifest
+    // behavior path, behavior project, behavior project path and behavior joints lists of the last update in one
+    // file. Every string is stored once in a shared table, in the character type its list is used with, and every
+    // list has a minimal perfect hash index over its keys. Loading maps the file and reads the section offsets, no
+    // line is parsed and no string is converted
+    class PathManifest
+    {
+    public:
+        enum Table : uint32_t
+        {
+            BehaviorPath,        // hkx file name, file path
+            BehaviorProject,     // character hkx file name, project hkx file names
+            BehaviorProjectPath, // project, project path
+            BehaviorJoints,      // lower lvl behavior file, higher lvl behavior files
+            TableCount
+        };
+
+        static constexpr wchar_t defaultFile[] = L"cache\\behavior_manifest";
+
+        class Builder
+        {
+        public:
+            template <typename CharT>
+            void Add(Table table, std::basic_string_view<CharT> key, std::basic_string_view<CharT> value)
+            {
+                AddEntry(table, Intern(AsBytes(key)), {Intern(AsBytes(value))});
+            }
+
+            template <typename CharT>
+            void Add(Table table,
+                     std::basic_string_view<CharT> key,
+                     const std::vector<std::basic_string<CharT>>& values)
+            {
+                std::vector<uint32_t> ids;
+                ids.reserve(values.size());
+
+                for (auto& value : values)
+                {
+                    ids.push_back(Intern(AsBytes(std::basic_string_view<CharT>(value))));
+                }
+
+                AddEntry(table, Intern(AsBytes(key)), std::move(ids));
+            }
+
+            bool Save(const std::filesystem::path& filepath) const;
+
+        private:
+            struct Entry
+            {
+                uint32_t key;
+                std::vector<uint32_t> values;
+            };
+
+            std::vector<std::string> strings;
+            std::unordered_map<std::string, uint32_t> stringIndex;
+            std::vector<Entry> entries[TableCount];
+            std::unordered_map<uint32_t, size_t> entryIndex[TableCount];
+
+            uint32_t Intern(std::string_view bytes);
+            void AddEntry(Table table, uint32_t key, std::vector<uint32_t> values);
+        };
+
+        bool Load(const std::filesystem::path& filepath);
+        bool IsLoaded() const;
+        uint32_t Size(Table table) const;
+
+        // values of the key, false when the key is not in the list
+        template <typename CharT>
+        bool Find(Table table,
+                  std::basic_string_view<CharT> key,
+                  std::vector<std::basic_string_view<CharT>>& values) const
+        {
+            uint32_t entry = FindEntry(table, AsBytes(key));
+
+            if (entry == npos) return false;
+
+            GetValues(table, entry, values);
+            return true;
+        }
+
+        // func(key, values) for every entry of the list, in storage order
+        template <typename CharT, typename F>
+        void ForEach(Table table, F&& func) const
+        {
+            std::vector<std::basic_string_view<CharT>> values;
+
+            for (uint32_t i = 0; i < Size(table); ++i)
+            {
+                GetValues(table, i, values);
+                func(GetString<CharT>(tables[table].entries[i * 3]), values);
+            }
+        }
+
+    private:
+        static constexpr uint32_t npos = UINT32_MAX;
+
+        struct TableView
+        {
+            uint32_t entryCount  = 0;
+            uint32_t bucketCount = 0;
+            uint32_t valueCount  = 0;
+            const uint32_t* displacements; // per bucket, hash seed that sends its keys to free slots
+            const uint32_t* slots;         // entry index of each slot
+            const uint32_t* entries;       // key string, first value, value count
+            const uint32_t* values;        // value strings
+        };
+
+        MappedFile file;
+        uint32_t stringCount = 0;
+        uint32_t blobSize    = 0;
+        const uint32_t* stringRanges;
+        const char* blob;
+        TableView tables[TableCount];
+
+        template <typename CharT>
+        static std::string_view AsBytes(std::basic_string_view<CharT> str)
+        {
+            return std::string_view(reinterpret_cast<const char*>(str.data()), str.length() * sizeof(CharT));
+        }
+
+        std::string_view GetBytes(uint32_t id) const;
+
+        template <typename CharT>
+        std::basic_string_view<CharT> GetString(uint32_t id) const
+        {
+            std::string_view bytes = GetBytes(id);
+            return std::basic_string_view<CharT>(reinterpret_cast<const CharT*>(bytes.data()),
+                                                 bytes.length() / sizeof(CharT));
+        }
+
+        template <typename CharT>
+        void GetValues(Table table, uint32_t entry, std::vector<std::basic_string_view<CharT>>& values) const
+        {
+            const TableView& view = tables[table];
+            uint32_t first        = view.entries[entry * 3 + 1];
+            uint32_t count        = view.entries[entry * 3 + 2];
+            values.clear();
+
+            for (uint32_t i = first; i < first + count && i < view.valueCount; ++i)
+            {
+                values.push_back(GetString<CharT>(view.values[i]));
+            }
+        }
+
+        uint32_t FindEntry(Table table, std::string_view key) const;
+    };
+} // namespace nemesis
+
+#endif
@@ -11,7 +11,7 @@ namespace nemesis
 {
 	struct scope
 	{
-		using funcptr = void (proc::*)(scope, VecStr&, AnimThreadInfo&) const;
+		using funcptr = void (proc::*)(const scope&, VecStr&, AnimThreadInfo&) const;
 
 		size_t front;
 		size_t back;
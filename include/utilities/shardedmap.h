@@ -0,0 +1,131 @@
+#ifndef SHARDEDMAP_H_
+#define SHARDEDMAP_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include "utilities/atomiclock.h"
+
+namespace nemesis
+{
+    // unordered_map split into independently locked shards, for the containers that worker threads write into
+    // elements of an unordered_map are never moved by a rehash, so a pointer returned by Find stays valid until
+    // the map is cleared
+    template <typename Key, typename Value, typename Hash = std::hash<Key>, size_t Shards = 16>
+    class ShardedMap
+    {
+    public:
+        // runs func on the element of key while its shard is locked, the element is default constructed if it
+        // does not exist yet
+        template <typename F>
+        decltype(auto) Update(const Key& key, F&& func)
+        {
+            Shard& shard = shards[ShardOf(key)];
+            Lockless lock(shard.lock);
+            return func(shard.map[key]);
+        }
+
+        // element of key, default constructed if it does not exist yet
+        // only the insertion is locked, the caller must be the only thread that changes the element
+        Value& operator[](const Key& key)
+        {
+            return Update(key, [](Value& value) -> Value& { return value; });
+        }
+
+        // nullptr when key has no element
+        Value* Find(const Key& key)
+        {
+            Shard& shard = shards[ShardOf(key)];
+            Lockless lock(shard.lock);
+            auto itr = shard.map.find(key);
+            return itr == shard.map.end() ? nullptr : &itr->second;
+        }
+
+        const Value* Find(const Key& key) const
+        {
+            const Shard& shard = shards[ShardOf(key)];
+            Lockless lock(shard.lock);
+            auto itr = shard.map.find(key);
+            return itr == shard.map.end() ? nullptr : &itr->second;
+        }
+
+        // func(const Key&, Value&) for every element, one shard is locked at a time
+        // func must not touch the same map
+        template <typename F>
+        void ForEach(F&& func)
+        {
+            for (auto& shard : shards)
+            {
+                Lockless lock(shard.lock);
+
+                for (auto& each : shard.map)
+                {
+                    func(each.first, each.second);
+                }
+            }
+        }
+
+        template <typename F>
+        void ForEach(F&& func) const
+        {
+            for (auto& shard : shards)
+            {
+                Lockless lock(shard.lock);
+
+                for (auto& each : shard.map)
+                {
+                    func(each.first, each.second);
+                }
+            }
+        }
+
+        size_t Size() const
+        {
+            size_t size = 0;
+
+            for (auto& shard : shards)
+            {
+                Lockless lock(shard.lock);
+                size += shard.map.size();
+            }
+
+            return size;
+        }
+
+        bool Empty() const
+        {
+            return Size() == 0;
+        }
+
+        void Clear()
+        {
+            for (auto& shard : shards)
+            {
+                Lockless lock(shard.lock);
+                shard.map = std::unordered_map<Key, Value, Hash>();
+            }
+        }
+
+    private:
+        struct Shard
+        {
+            mutable std::atomic_flag lock{};
+            std::unordered_map<Key, Value, Hash> map;
+        };
+
+        std::array<Shard, Shards> shards;
+
+        // the high bits of a multiplicative hash pick the shard, so the buckets inside a shard still get every
+        // low bit of the key hash
+        static size_t ShardOf(const Key& key) noexcept
+        {
+            uint64_t mixed = uint64_t(Hash{}(key)) * 0x9e3779b97f4a7c15ull;
+            return size_t(mixed >> 32) % Shards;
+        }
+    };
+} // namespace nemesis
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef THREAD_POOL_H_
 #define THREAD_POOL_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <future>
@@ -15,6 +16,34 @@ namespace nemesis
 {
     using uint = unsigned int;
 
+    // one pointer and one cancellation flag per thread that a ThreadPool task takes over from the thread that queued it
+    // the layers above keep their per-run state behind it, so the pool does not need to know what it points to
+    class TaskLocal
+    {
+    public:
+        static void* Get() noexcept;
+
+        // flag of the run bound to the calling thread, the process wide flag on a thread without one
+        static std::atomic<bool>& Cancelled() noexcept;
+        static std::atomic<bool>& ProcessCancelled() noexcept;
+
+        // binds value and its cancellation flag to the calling thread until the scope ends
+        // a null flag binds the process wide one
+        class Scope
+        {
+        public:
+            Scope(void* value, std::atomic<bool>* cancelled) noexcept;
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            void* previous;
+            std::atomic<bool>* previousCancelled;
+        };
+    };
+
     class ThreadPool
     {
     public:
@@ -32,6 +61,7 @@ namespace nemesis
         std::vector<std::thread> workers;
         std::queue<std::function<void()>> tasks;
         void newWorker();
+        void push(std::function<void()> task);
 
         std::condition_variable condition;
         std::mutex queue_mutex;
@@ -39,6 +69,13 @@ namespace nemesis
         bool sync = false;
     };
 
+    // runs task(0) to task(count - 1) on the calling thread and on idle threads of one pool shared by the process,
+    // at most one helper per grain tasks
+    // the pool has a thread per core, and a loop only takes the threads nothing else is using, so loops nested in
+    // pool tasks never run more threads than there are cores
+    // the first exception a task throws stops the loop and is rethrown once the tasks in progress are done
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t)>& task);
+
     // add new work item to the pool
     template <class F, class... Args>
     decltype(auto) ThreadPool::enqueue(F&& f, Args&&... args)
@@ -49,19 +86,7 @@ namespace nemesis
             std::bind(std::forward<F>(f), std::forward<Args>(args)...));
 
         std::future<return_type> res = task->get_future();
-
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex);
-
-            if (error) return res;
-
-            // don't allow enqueueing after stopping the pool
-            if (abort) throw std::runtime_error("enqueue on stopped ThreadPool");
-
-            tasks.emplace([task]() { (*task)(); });
-        }
-
-        condition.notify_one();
+        push([task]() { (*task)(); });
         return res;
     }
 }
@@ -0,0 +1,27 @@
+#ifndef XXHASH64_H_
+#define XXHASH64_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nemesis
+{
+    // streaming XXH64, for telling apart file contents of the same size
+    class XXHash64
+    {
+    public:
+        explicit XXHash64(uint64_t seed = 0);
+
+        void Update(const void* data, size_t length);
+        uint64_t Digest() const;
+
+    private:
+        uint64_t lanes[4];
+        unsigned char buffer[32];
+        size_t buffered = 0;
+        uint64_t total  = 0;
+        uint64_t seed;
+    };
+}
+
+#endif
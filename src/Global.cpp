@@ -6,38 +6,19 @@
 #include "utilities/readtextfile.h"
 #include "utilities/writetextfile.h"
 
+#include "generate/generationcontext.h"
+
 #pragma warning(disable:4503)
 
 using namespace std;
 namespace sf = filesystem;
 
-atomic_flag atomLock{};
-
 bool debug = false;
-int memory = 100;
 int fixedkey[257];
 
 chrono::steady_clock::time_point time1;
 
-unordered_map<wstring, wstring> behaviorPath;
-
-unordered_map<string, bool> activatedBehavior;
-unordered_map<wstring, wstring> behaviorProjectPath;
-unordered_map<string, VecStr> behaviorJoints;
-unordered_map<string, VecStr> behaviorProject;
-unordered_map<string, set<string>> usedAnim;
-unordered_map<string, set<string>> registeredAnim;
 unordered_map<string, unordered_map<string, VecStr>> animList;
-unordered_map<string, unordered_map<string, vector<set<string>>>> animModMatch;
-
-unordered_map<string, string> AAGroup;
-unordered_map<string, VecStr> AAEvent;
-unordered_map<string, VecStr> AAHasEvent;
-unordered_map<string, VecStr> groupAA;
-unordered_map<string, VecStr> groupAAPrefix;
-unordered_map<string, VecStr> alternateAnim;
-unordered_map<string, unordered_map<string, int>> AAGroupCount;
-set<string> groupNameList;
 
 void read_directory(const sf::path& name, VecStr& fv)
 {
@@ -55,7 +36,7 @@ void read_directory(const sf::path& name, VecStr& fv)
 
 	for (unsigned int i = 0; i < fv.size(); ++i)
 	{
-		if (nemesis::to_lower_copy(fv[i]).find("folder_managed_by_vortex") != NOT_FOUND)
+		if (nemesis::ifind(fv[i], "folder_managed_by_vortex") != NOT_FOUND)
 		{
 			fv.erase(fv.begin() + i);
 			--i;
@@ -79,7 +60,7 @@ void read_directory(const sf::path& name, vector<wstring>& fv)
 
 	for (unsigned int i = 0; i < fv.size(); ++i)
 	{
-		if (nemesis::to_lower_copy(fv[i]).find(L"folder_managed_by_vortex") != NOT_FOUND)
+		if (nemesis::ifind(fv[i], L"folder_managed_by_vortex") != NOT_FOUND)
 		{
 			fv.erase(fv.begin() + i);
 			--i;
@@ -133,7 +114,7 @@ size_t fileLineCount(const char* filepath)
 	return linecount;
 }
 
-int sameWordCount(string line, string word)
+int sameWordCount(string_view line, string_view word)
 {
 	size_t nextWord = -1;
 	int wordCount = 0;
@@ -156,7 +137,7 @@ int sameWordCount(string line, string word)
 	return wordCount;
 }
 
-int sameWordCount(wstring line, wstring word)
+int sameWordCount(wstring_view line, wstring_view word)
 {
     size_t nextWord = -1;
     int wordCount   = 0;
@@ -260,48 +241,47 @@ bool GetFunctionLines(sf::path filename, vector<wstring>& functionlines, bool em
 	return true;
 }
 
-size_t wordFind(string line, string word, bool isLast)
+size_t wordFind(string_view line, string_view word, bool isLast)
 {
-	nemesis::to_lower(line);
-	nemesis::to_lower(word);
-
-	return isLast ? line.rfind(word) : line.find(word);
+	return isLast ? nemesis::irfind(line, word) : nemesis::ifind(line, word);
 }
 
-size_t wordFind(wstring line, wstring word, bool isLast)
+size_t wordFind(wstring_view line, wstring_view word, bool isLast)
 {
-    nemesis::to_lower(line);
-    nemesis::to_lower(word);
-
-    return isLast ? line.rfind(word) : line.find(word);
+    return isLast ? nemesis::irfind(line, word) : nemesis::ifind(line, word);
 }
 
-bool isOnlyNumber(string line)
+bool isOnlyNumber(const string& line)
 {
 	char* end = nullptr;
 	double val = strtod(line.c_str(), &end);
 	return end != line.c_str() && *end == '\0' && val != HUGE_VAL;
 }
 
-bool hasAlpha(string line)
+bool hasAlpha(string_view line)
 {
-	return nemesis::to_lower_copy(line) != nemesis::to_upper_copy(line);
+	return nemesis::has_alpha(line);
 }
 
-bool isOnlyNumber(wstring line)
+bool isOnlyNumber(const wstring& line)
 {
     wchar_t* end  = nullptr;
     double val = wcstod(line.c_str(), &end);
     return end != line.c_str() && *end == '\0' && val != HUGE_VAL;
 }
 
-bool hasAlpha(wstring line)
+bool hasAlpha(wstring_view line)
 {
-    return nemesis::to_lower_copy(line) != nemesis::to_upper_copy(line);
+    return nemesis::has_alpha(line);
 }
 
 void addUsedAnim(string behaviorFile, string animPath)
 {
-	Lockless lock(atomLock);
-	usedAnim[nemesis::to_lower_copy(behaviorFile)].insert(nemesis::to_lower_copy(animPath));
+	addUsedAnim(nemesis::InternPath(behaviorFile), animPath);
+}
+
+void addUsedAnim(nemesis::PathHandle behavior, const string& animPath)
+{
+	nemesis::GenerationContext::Current().usedAnim.Update(
+		behavior, [&](set<string>& used) { used.insert(nemesis::to_lower_copy(animPath)); });
 }
@@ -5,13 +5,14 @@
 #include "debugmsg.h"
 
 #include "utilities/algorithm.h"
+#include "utilities/threadpool.h"
 #include "utilities/readtextfile.h"
 #include "utilities/writetextfile.h"
 
 using namespace std;
 
 int filenum;
-bool error = false;
+nemesis::ErrorFlag error;
 
 mutex err_Mutex;
 
@@ -24,6 +25,20 @@ VecWstr readUTF8File(wstring filename);
 
 void writeUTF8File(string filename, VecStr storeline);
 
+nemesis::ErrorFlag::operator bool() const noexcept
+{
+    return nemesis::TaskLocal::Cancelled();
+}
+
+nemesis::ErrorFlag& nemesis::ErrorFlag::operator=(bool value) noexcept
+{
+    nemesis::TaskLocal::Cancelled() = value;
+
+    if (value) nemesis::TaskLocal::ProcessCancelled() = true;
+
+    return *this;
+}
+
 void NewDebugMessage(DebugMsg NewLog)
 {
     if (!EnglishLog) EnglishLog = new DebugMsg("english");
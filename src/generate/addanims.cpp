@@ -2,35 +2,33 @@
 
 #include "generate/addanims.h"
 #include "generate/generator_utility.h"
+#include "generate/generationcontext.h"
 #include "generate/animationdatatracker.h"
-#include "generate/generator_utility.h"
-
-#include "utilities/atomiclock.h"
 
 using namespace std;
 
 namespace sf = std::filesystem;
 
-extern atomic_flag animdata_lock;
-
 bool AddAnims(string& line,
               const string& _animPath,
               const wstring& outputdir,
               const string& behaviorFile,
               const string& lowerBehaviorFile,
+              nemesis::PathHandle behaviorHandle,
               const string& _newMod,
               vector<string>& storeline,
               int& counter,
               unordered_map<string, bool>& isAdded,
               bool& addAnim)
 {
-    string animPath = _animPath;
+    nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
+    string animPath                     = _animPath;
 
     if (!isAdded[nemesis::to_lower_copy(animPath)])
     {
         string animFile = GetFileName(animPath) + ".hkx";
 
-        if (activatedBehavior["gender*"])
+        if (context.IsActivated("gender*"))
         {
             if (lowerBehaviorFile == "defaultfemale")
             {
@@ -81,9 +79,8 @@ bool AddAnims(string& line,
         nemesis::to_lower(animFile);
         isAdded[animPath] = true;
 
-        {
-            Lockless lock(animdata_lock);
-            shared_ptr<AnimationDataTracker>& animData = charAnimDataInfo[lowerBehaviorFile][animFile];
+        context.charAnimDataInfo.Update(lowerBehaviorFile, [&](map<string, shared_ptr<AnimationDataTracker>>& list) {
+            shared_ptr<AnimationDataTracker>& animData = list[animFile];
 
             if (animData == nullptr)
             {
@@ -93,28 +90,29 @@ bool AddAnims(string& line,
             {
                 animData->SetOrder(counter);
             }
-        }
+        });
 
-        string newMod                    = animPath.substr(11, animPath.find("\\", 11) - 11);
-        vector<SetStr>* match_ptr = &animModMatch[lowerBehaviorFile][animFile];
-        size_t matchSize          = match_ptr->size();
-        addAnim                   = true;
-        registeredAnim[lowerBehaviorFile].insert(animFile);
+        string newMod = animPath.substr(11, animPath.find("\\", 11) - 11);
+        addAnim       = true;
+        context.registeredAnim.Update(behaviorHandle, [&](SetStr& registered) { registered.insert(animFile); });
+        context.animModMatch.Update(behaviorHandle, [&](unordered_map<string, vector<SetStr>>& matchList) {
+            vector<SetStr>& match = matchList[animFile];
 
-        if (matchSize == 0)
-        {
-            match_ptr->push_back(SetStr{animPath});
-            match_ptr->push_back(SetStr{newMod});
-        }
-        else if (matchSize == 2)
-        {
-            match_ptr->at(0).insert(animPath);
-            match_ptr->at(1).insert(newMod);
-        }
-        else
-        {
-            ErrorMessage(1058);
-        }
+            if (match.empty())
+            {
+                match.push_back(SetStr{animPath});
+                match.push_back(SetStr{newMod});
+            }
+            else if (match.size() == 2)
+            {
+                match[0].insert(animPath);
+                match[1].insert(newMod);
+            }
+            else
+            {
+                ErrorMessage(1058);
+            }
+        });
 
         ++counter;
     }
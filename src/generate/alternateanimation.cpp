@@ -6,6 +6,7 @@
 #include "generate/papyruscompile.h"
 #include "generate/generator_utility.h"
 #include "generate/alternateanimation.h"
+#include "generate/generationcontext.h"
 
 #include "utilities/crc32.h"
 #include "utilities/algorithm.h"
@@ -18,8 +19,6 @@
 using namespace std;
 namespace sf = filesystem;
 
-unordered_map<string, int> AAgroup_Counter;
-
 bool AACoreCompile(sf::path pscfile,
                    sf::path import,
                    sf::path destination,
@@ -49,6 +48,7 @@ struct ModIDByGroup
 
 void AAInitialize(string AAList)
 {
+    nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
     VecStr groupList;
     unordered_map<string, string>
         existAAAnim; // animation name, animation group name; has the animation been registered for AA?
@@ -76,11 +76,11 @@ void AAInitialize(string AAList)
                         if (existAAAnim[lowerAnimFile].length() == 0)
                         {
                             string lowerGroupName = nemesis::to_lower_copy(AAGroupName);
-                            groupAA[lowerGroupName].push_back(lowerAnimFile);
-                            AAGroup[lowerAnimFile]     = lowerGroupName;
+                            context.groupAA[lowerGroupName].push_back(lowerAnimFile);
+                            context.AAGroup[lowerAnimFile]     = lowerGroupName;
                             existAAAnim[lowerAnimFile] = lowerGroupName;
-                            groupNameList.insert(lowerGroupName);
-                            groupNameList.insert(lowerGroupName + "_1p*");
+                            context.groupNameList.insert(lowerGroupName);
+                            context.groupNameList.insert(lowerGroupName + "_1p*");
                         }
                         else
                         {
@@ -101,7 +101,9 @@ void AAInitialize(string AAList)
 
 bool AAInstallation(const NemesisInfo* nemesisInfo)
 {
-    if (AAGroup.size() == 0) return true;
+    nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
+
+    if (context.AAGroup.size() == 0) return true;
 
     uint uniquekey;
     wstring cachedir = papyrusTempCompile();
@@ -202,7 +204,8 @@ bool AACoreCompile(sf::path pscfile,
                    uint& uniquekey,
                    sf::path compilerpath)
 {
-    bool prefixDone = false;
+    nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
+    bool prefixDone                     = false;
     VecStr prefixList;
     unordered_map<string, bool> prefixCheck;
     unordered_map<string, int> prefixID;
@@ -222,10 +225,10 @@ bool AACoreCompile(sf::path pscfile,
     int AACounter = 0;
     maxGroup      = 0;
 
-    for (auto& groupName : groupNameList)
+    for (auto& groupName : context.groupNameList)
     {
         for (
-            auto& AAprefixGroup : groupAAPrefix
+            auto& AAprefixGroup : context.groupAAPrefix
                 [groupName]) // list of group aa prefix categorized by animation group name while eliminating duplicates using set container
         {
             if (!prefixCheck[AAprefixGroup])
@@ -261,18 +264,18 @@ bool AACoreCompile(sf::path pscfile,
     maxGroup = 0;
     DebugLogging("AA prefix script complete");
 
-    if (groupNameList.size() > 0) // Assign base value
+    if (context.groupNameList.size() > 0) // Assign base value
     {
         VecStr groupID;
         groupIDFunction.push_back("int Function GetGroupID(string groupName) global");
 
-        for (auto& groupName : groupNameList)
+        for (auto& groupName : context.groupNameList)
         {
             string adjGN = groupName;
 
             if (groupName.length() > 4 && groupName.rfind("_1p*") == groupName.length() - 4) adjGN.pop_back();
 
-            for (auto& prefix : groupAAPrefix[groupName])
+            for (auto& prefix : context.groupAAPrefix[groupName])
             {
                 int maxG        = prefixID[prefix];
                 string templine = "	AASet[num] = ";
@@ -290,16 +293,16 @@ bool AACoreCompile(sf::path pscfile,
                 mod.modID     = to_string(maxG / 10) + to_string(maxG % 10);
                 GetModByGroupValue[AAgroupID].push_back(mod);
 
-                if (AAGroupCount[prefix][groupName] == 0) ErrorMessage(3013, prefix, groupName);
+                if (context.AAGroupCount[prefix][groupName] == 0) ErrorMessage(3013, prefix, groupName);
 
-                groupIDCounter[adjGN] += AAGroupCount[prefix][groupName];
+                groupIDCounter[adjGN] += context.AAGroupCount[prefix][groupName];
 
                 while (counter.length() < 3)
                 {
                     counter = "0" + counter;
                 }
 
-                baseOrder["AAgroupID == " + AAgroupID] = "		return " + to_string(++AAgroup_Counter[adjGN]);
+                baseOrder["AAgroupID == " + AAgroupID] = "		return " + to_string(++context.AAgroup_Counter[adjGN]);
                 baseMatch.push_back("DataCode == " + number + "000");
                 baseMatch.push_back("		return " + base);
                 number = number + counter.substr(0, 3);
@@ -496,7 +499,7 @@ bool AACoreCompile(sf::path pscfile,
         }
         else if (line.find("$GroupCount$") != NOT_FOUND)
         {
-            line.replace(line.find("$GroupCount$"), 12, to_string(groupNameList.size()));
+            line.replace(line.find("$GroupCount$"), 12, to_string(context.groupNameList.size()));
         }
 
         if (!skip) newline.push_back(line);
@@ -14,7 +14,7 @@ namespace sf = std::filesystem;
 
 AnimationInfo::AnimationInfo(VecStr newAnimInfo,
                              sf::path curFilename,
-                             OptionList behaviorOption,
+                             const OptionList& behaviorOption,
                              int linecount,
                              bool& isOExist,
                              bool noOption)
@@ -27,16 +27,14 @@ AnimationInfo::AnimationInfo(VecStr newAnimInfo,
 
     if (animInfo.size() < 3) ErrorMessage(1142, curFilename, linecount);
 
-    optionPicked[behaviorOption.templatecode]             = true;
-    optionPicked[behaviorOption.templatecode + "_group"]  = true;
-    optionPicked[behaviorOption.templatecode + "_master"] = true;
+    optionPicked.set(behaviorOption.templatecode);
+    optionPicked.set(behaviorOption.templatecode + "_group");
+    optionPicked.set(behaviorOption.templatecode + "_master");
     ++optionPickedCount[behaviorOption.templatecode];
     ++optionPickedCount[behaviorOption.templatecode + "_group"];
     ++optionPickedCount[behaviorOption.templatecode + "_master"];
 
-    addOn       = behaviorOption.addOn;
-    mixOptRegis = behaviorOption.mixOptRegis;
-    mixOptRever = behaviorOption.mixOptRever;
+    options = behaviorOption.animOptions;
 
     if (!noOption)
     {
@@ -44,9 +42,9 @@ AnimationInfo::AnimationInfo(VecStr newAnimInfo,
         string anim = line.substr(1);
         VecStr options;
         StringSplit(line.substr(1), options, ",");
-        unordered_map<string, bool> optionList = behaviorOption.storelist;
-        unordered_map<string, VecStr> joint    = behaviorOption.joint;
-        VecStr optionOrder                     = behaviorOption.optionOrder;
+        const unordered_map<string, bool>& optionList = behaviorOption.storelist;
+        const VecStr& optionOrder                     = behaviorOption.optionOrder;
+        static const VecStr noJoint;
 
         for (auto& option : options)
         {
@@ -76,15 +74,17 @@ AnimationInfo::AnimationInfo(VecStr newAnimInfo,
                 {
                     duration          = stod(time);
                     hasDuration       = true;
-                    optionPicked["D"] = true;
+                    optionPicked.set("D");
                     optionPickedCount["D"]++;
                     continue;
                 }
             }
 
-            if (optionList[option] && !groupOption[option])
+            auto listed = optionList.find(option);
+
+            if (listed != optionList.end() && listed->second && !groupOption.test(option))
             {
-                if (optionPicked[option])
+                if (optionPicked.test(option))
                 {
                     string totalline = "";
 
@@ -97,7 +97,7 @@ AnimationInfo::AnimationInfo(VecStr newAnimInfo,
                     ErrorMessage(1178, behaviorOption.templatecode, curFilename, linecount, totalline);
                 }
 
-                optionPicked[option] = true;
+                optionPicked.set(option);
                 optionPickedCount[option]++;
             }
             else
@@ -127,22 +127,29 @@ AnimationInfo::AnimationInfo(VecStr newAnimInfo,
 
                                 if (group.length() != 0 && option == header + group && group != nonHeader)
                                 {
-                                    optionPicked[option] = true;
+                                    optionPicked.set(option);
                                     optionPickedCount[option]++;
                                     loose = true;
                                 }
-                                else if (addOn[header].size() != 0)
+                                else if (GetOptions().addOn.find(header) != GetOptions().addOn.end()
+                                         && GetOptions().addOn.at(header).size() != 0)
                                 {
+                                    const VecStr& addOn = GetOptions().addOn.at(header);
+                                    auto jointItr       = behaviorOption.joint.find(header);
+                                    const VecStr& joint = jointItr != behaviorOption.joint.end()
+                                                              ? jointItr->second
+                                                              : noJoint;
+
                                     if (option.length() > header.length())
                                     {
                                         // Eligibility test
                                         bool isPassed  = true;
                                         string section = nonHeader;
 
-                                        for (uint k = 0; k < joint[header].size(); ++k)
+                                        for (uint k = 0; k < joint.size(); ++k)
                                         {
                                             string newSection
-                                                = section.substr(section.find(joint[header][k]) + 1);
+                                                = section.substr(section.find(joint[k]) + 1);
 
                                             if (newSection.length() < section.length())
                                             {
@@ -159,18 +166,18 @@ AnimationInfo::AnimationInfo(VecStr newAnimInfo,
 
                                         isPassed = false;
 
-                                        for (uint k = 0; k < addOn[header].size(); ++k)
+                                        for (uint k = 0; k < addOn.size(); ++k)
                                         {
                                             if (nonHeader.length() != 0)
                                             {
-                                                string addOnName = addOn[header][k];
+                                                string addOnName = addOn[k];
 
-                                                if (k != addOn[header].size() - 1)
+                                                if (k != addOn.size() - 1)
                                                 {
-                                                    size_t pos = nonHeader.find(joint[header][k], 0)
-                                                                 + joint[header][k].length();
+                                                    size_t pos = nonHeader.find(joint[k], 0)
+                                                                 + joint[k].length();
                                                     string name = nonHeader.substr(
-                                                        0, pos - joint[header][k].length());
+                                                        0, pos - joint[k].length());
                                                     groupAdditionProcess(header,
                                                                          addOnName,
                                                                          name,
@@ -198,7 +205,7 @@ AnimationInfo::AnimationInfo(VecStr newAnimInfo,
 
                                         if (isPassed)
                                         {
-                                            optionPicked[header] = true;
+                                            optionPicked.set(header);
                                             optionPickedCount[header]++;
                                             loose = true;
                                             break;
@@ -243,6 +250,11 @@ AnimationInfo::AnimationInfo(VecStr newAnimInfo,
     optionPickedCount[behaviorOption.templatecode] = 1;
 }
 
+const AnimOptionData& AnimationInfo::GetOptions() const
+{
+    return AnimOptionData::Of(options);
+}
+
 void AnimationInfo::addFilename(string curFilename)
 {
     filename = curFilename;
@@ -256,7 +268,7 @@ void AnimationInfo::storeAnimObject(VecStr animobjects, sf::path listFilename, i
     {
         if (animobjects[i].find("/") == NOT_FOUND)
         {
-            optionPicked["AnimObject/1"] = true;
+            optionPicked.set("AnimObject/1");
             AnimObject[1].push_back(animobjects[i]);
             ++optionPickedCount["AnimObject/1"];
         }
@@ -270,7 +282,7 @@ void AnimationInfo::storeAnimObject(VecStr animobjects, sf::path listFilename, i
             if (temp == 0 || temp > animObjectCount) ErrorMessage(1144, listFilename, linecount);
 
             string AO        = "AnimObject/" + to_string(temp);
-            optionPicked[AO] = true;
+            optionPicked.set(AO);
             AnimObject[temp].push_back(ObjectName);
             ++optionPickedCount[AO];
         }
@@ -280,26 +292,33 @@ void AnimationInfo::storeAnimObject(VecStr animobjects, sf::path listFilename, i
 void AnimationInfo::groupAdditionProcess(string header,
                                          string addOnName,
                                          string name,
-                                         unordered_map<string, bool> groupOption,
-                                         unordered_map<string, unordered_map<string, string>> modAddOn)
+                                         const nemesis::OptionSet& groupOption,
+                                         const unordered_map<string, unordered_map<string, string>>& modAddOn)
 {
     string newName = name;
+    auto modHeader = modAddOn.find(header);
 
-    if (modAddOn[header][addOnName].length() != 0)
+    if (modHeader != modAddOn.end())
     {
-        string newAddOn = modAddOn[header][addOnName];
-        newName         = newAddOn.replace(newAddOn.find("$$$"), 3, newName);
+        auto modifier = modHeader->second.find(addOnName);
+
+        if (modifier != modHeader->second.end() && modifier->second.length() != 0)
+        {
+            string newAddOn = modifier->second;
+            newName         = newAddOn.replace(newAddOn.find("$$$"), 3, newName);
+        }
     }
 
-    if (groupOption[header])
+    if (groupOption.test(header))
     {
         string reheader = header;
+        auto mixed      = GetOptions().mixOptRegis.find(header);
 
-        if (mixOptRegis[header].length() != 0)
+        if (mixed != GetOptions().mixOptRegis.end() && mixed->second.length() != 0)
         {
-            reheader                                                      = mixOptRegis[header];
-            optionPicked[header + to_string(optionPickedCount[reheader])] = true;
-            optionPicked[reheader]                                        = true;
+            reheader = mixed->second;
+            optionPicked.set(header + to_string(optionPickedCount[reheader]));
+            optionPicked.set(reheader);
             optionPickedCount[reheader]++;
             groupAddition[reheader][addOnName].push_back(newName);
         }
@@ -4,6 +4,23 @@
 
 using namespace std;
 
+namespace
+{
+    vector<nemesis::OptionSet> PerGroup(const vector<vector<nemesis::OptionSet>>& masterOptionPicked,
+                                        nemesis::OptionSet (*aggregate)(const vector<nemesis::OptionSet>&))
+    {
+        vector<nemesis::OptionSet> list;
+        list.reserve(masterOptionPicked.size());
+
+        for (auto& groupOptionPicked : masterOptionPicked)
+        {
+            list.push_back(aggregate(groupOptionPicked));
+        }
+
+        return list;
+    }
+} // namespace
+
 AnimThreadInfo::AnimThreadInfo(
     const std::string& _filepath,
     const std::string& _filename,
@@ -32,8 +49,8 @@ AnimThreadInfo::AnimThreadInfo(
     const ImportContainer& _addition,
     ImportContainer* _newImport,
     const std::unordered_map<std::string, std::unordered_map<std::string, VecStr>>& _groupAddition,
-    const std::vector<std::unordered_map<std::string, bool>>& _groupOptionPicked,
-    const std::vector<std::vector<std::unordered_map<std::string, bool>>>& _masterOptionPicked,
+    const std::vector<nemesis::OptionSet>& _groupOptionPicked,
+    const std::vector<std::vector<nemesis::OptionSet>>& _masterOptionPicked,
     std::shared_ptr<group> _groupFunction,
     std::shared_ptr<VecStr> _generatedlines,
     NewAnimation* _curAnim,
@@ -67,6 +84,10 @@ AnimThreadInfo::AnimThreadInfo(
     , groupAddition(_groupAddition)
     , groupOptionPicked(_groupOptionPicked)
     , masterOptionPicked(_masterOptionPicked)
+    , groupOptionAll(nemesis::OptionSet::All(_groupOptionPicked))
+    , groupOptionAny(nemesis::OptionSet::Any(_groupOptionPicked))
+    , masterOptionAll(PerGroup(_masterOptionPicked, &nemesis::OptionSet::All))
+    , masterOptionAny(PerGroup(_masterOptionPicked, &nemesis::OptionSet::Any))
     , groupFunction(_groupFunction)
 {
     generatedlines = _generatedlines;
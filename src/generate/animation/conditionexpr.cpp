@@ -0,0 +1,324 @@
+#include "Global.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+#include "generate/animation/conditionexpr.h"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t memoLimit = 1024;
+
+    shared_mutex cacheMutex;
+    unordered_map<string, unique_ptr<nemesis::ConditionExpr>> cache;
+} // namespace
+
+namespace nemesis
+{
+    class ConditionParser
+    {
+    public:
+        ConditionParser(ConditionExpr& _expr,
+                        const string& _condition,
+                        const string& _format,
+                        const string& _filename,
+                        int _numline,
+                        const string& _original)
+            : expr(_expr)
+            , condition(_condition)
+            , format(_format)
+            , filename(_filename)
+            , numline(_numline)
+            , original(_original)
+        {
+        }
+
+        void Parse()
+        {
+            if (count(condition.begin(), condition.end(), '(') != count(condition.begin(), condition.end(), ')'))
+            {
+                ErrorMessage(1105, format, filename, numline);
+            }
+
+            // a node is added after its children, so the root is the last node
+            ParseOr();
+
+            if (pos != condition.length()) ErrorMessage(1106, format, filename, numline, original);
+        }
+
+    private:
+        ConditionExpr& expr;
+        const string& condition;
+        const string& format;
+        const string& filename;
+        int numline;
+        const string& original;
+        size_t pos = 0;
+
+        // bool1 | bool2 & bool3 | (bool4...
+        // ^-----^---------------^
+        // a condition starting with a group takes the rest as the other side of the group's operator, so
+        // (bool1) & bool2 | bool3 is bool1 & (bool2 | bool3)
+        uint32_t ParseOr()
+        {
+            vector<uint32_t> list;
+
+            if (pos < condition.length() && condition[pos] == '(')
+            {
+                uint32_t group = ParseFactor();
+
+                if (pos >= condition.length() || (condition[pos] != '&' && condition[pos] != '|')) return group;
+
+                ConditionExpr::Kind kind = condition[pos++] == '&' ? ConditionExpr::Kind::And : ConditionExpr::Kind::Or;
+                return AddList(kind, {group, ParseOr()});
+            }
+
+            list.push_back(ParseAnd());
+
+            while (pos < condition.length() && condition[pos] == '|')
+            {
+                ++pos;
+
+                if (pos < condition.length() && condition[pos] == '(')
+                {
+                    list.push_back(ParseOr());
+                    break;
+                }
+
+                list.push_back(ParseAnd());
+            }
+
+            return AddList(ConditionExpr::Kind::Or, list);
+        }
+
+        // bool1 & (bool2 | bool3) & bool4
+        // ^-------^---------------^
+        uint32_t ParseAnd()
+        {
+            vector<uint32_t> list = {ParseFactor()};
+
+            while (pos < condition.length() && condition[pos] == '&')
+            {
+                ++pos;
+                list.push_back(ParseFactor());
+            }
+
+            return AddList(ConditionExpr::Kind::And, list);
+        }
+
+        uint32_t AddList(ConditionExpr::Kind kind, const vector<uint32_t>& list)
+        {
+            if (list.size() == 1) return list.front();
+
+            uint32_t first = uint32_t(expr.children.size());
+            expr.children.insert(expr.children.end(), list.begin(), list.end());
+            expr.nodes.push_back(ConditionExpr::Node{kind, first, uint32_t(list.size())});
+            return uint32_t(expr.nodes.size() - 1);
+        }
+
+        uint32_t ParseFactor()
+        {
+            if (pos < condition.length() && condition[pos] == '(')
+            {
+                ++pos;
+                uint32_t inner = ParseOr();
+
+                if (pos >= condition.length() || condition[pos] != ')')
+                {
+                    ErrorMessage(1106, format, filename, numline, original);
+                }
+
+                ++pos;
+                return inner;
+            }
+
+            // an operand ends at the next operator or at the bracket closing its group
+            size_t begin = pos;
+            int bracket  = 0;
+
+            for (; pos < condition.length(); ++pos)
+            {
+                char ch = condition[pos];
+
+                if (ch == '&' || ch == '|') break;
+
+                if (ch == '(')
+                {
+                    ++bracket;
+                }
+                else if (ch == ')')
+                {
+                    if (bracket == 0) break;
+
+                    --bracket;
+                }
+            }
+
+            if (pos == begin) ErrorMessage(1106, format, filename, numline, original);
+
+            expr.operands.push_back(ParseOperand(condition.substr(begin, pos - begin)));
+            expr.nodes.push_back(ConditionExpr::Node{ConditionExpr::Kind::Leaf, uint32_t(expr.operands.size() - 1), 0});
+            return uint32_t(expr.nodes.size() - 1);
+        }
+
+        ConditionExpr::Operand ParseOperand(string text)
+        {
+            ConditionExpr::Operand operand;
+
+            if (text.find("<") == 0
+                && (text.find(">") == text.length() - 1 || text.find(">*") == text.length() - 2)
+                && (text.find("!=") != NOT_FOUND || text.find("==") != NOT_FOUND))
+            {
+                ParseComparison(text, operand);
+                expr.canRemember = false;
+            }
+            else if (text[0] == '!')
+            {
+                operand.isNot = true;
+                operand.text  = text.substr(1);
+            }
+            else
+            {
+                operand.text = move(text);
+            }
+
+            if (!operand.isComparison)
+            {
+                // a mixed option resolves to whichever option the animation picked for it
+                if (operand.text.find('*') != NOT_FOUND) expr.canRemember = false;
+
+                ResolveOption(operand);
+            }
+
+            return operand;
+        }
+
+        // format[N][option], a mixed option (name*) and an order (^N^) are only known once evaluated
+        void ResolveOption(ConditionExpr::Operand& operand)
+        {
+            const string& text = operand.text;
+
+            if (text.empty() || text.back() != ']') return;
+
+            size_t open = text.rfind('[');
+
+            if (open == NOT_FOUND) return;
+
+            string name = text.substr(open + 1, text.length() - open - 2);
+
+            if (name.empty() || name.back() == '*' || name[0] == '^' || isOnlyNumber(name)) return;
+
+            operand.option     = OptionIndex::Intern(name);
+            operand.optionName = move(name);
+        }
+
+        // <optionA != optionB>*
+        void ParseComparison(string& text, ConditionExpr::Operand& operand)
+        {
+            size_t equal    = text.find("==");
+            size_t notEqual = text.find("!=");
+
+            if (equal != NOT_FOUND && notEqual != NOT_FOUND) ErrorMessage(1124, format, filename, numline, original);
+
+            operand.isNot = notEqual != NOT_FOUND;
+            size_t opPos  = operand.isNot ? notEqual : equal;
+
+            if (sameWordCount(text, operand.isNot ? "!=" : "==") > 1)
+            {
+                ErrorMessage(1124, format, filename, numline, original);
+            }
+
+            // only need to fulfill the condition once
+            operand.oneTime      = text.back() == '*';
+            operand.isComparison = true;
+            operand.left         = text.substr(1, opPos - 1);
+            operand.right        = text.substr(opPos + 2, text.length() - opPos - (operand.oneTime ? 4 : 3));
+            operand.text         = move(text);
+        }
+    };
+} // namespace nemesis
+
+nemesis::ConditionExpr::Signature& nemesis::ConditionExpr::Signature::operator<<(uint64_t value)
+{
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    return *this;
+}
+
+nemesis::ConditionExpr::Signature& nemesis::ConditionExpr::Signature::operator<<(const string& value)
+{
+    *this << uint64_t(value.length());
+    key.append(value);
+    return *this;
+}
+
+nemesis::ConditionExpr::Signature& nemesis::ConditionExpr::Signature::operator<<(const OptionSet& value)
+{
+    value.AppendKey(key);
+    return *this;
+}
+
+bool nemesis::ConditionExpr::Signature::empty() const
+{
+    return key.empty();
+}
+
+const string& nemesis::ConditionExpr::Signature::value() const
+{
+    return key;
+}
+
+const nemesis::ConditionExpr& nemesis::ConditionExpr::Get(const string& condition,
+                                                          const string& format,
+                                                          const string& filename,
+                                                          int numline,
+                                                          const string& original)
+{
+    {
+        shared_lock<shared_mutex> lock(cacheMutex);
+        auto itr = cache.find(condition);
+
+        if (itr != cache.end()) return *itr->second;
+    }
+
+    auto expr = make_unique<ConditionExpr>();
+    ConditionParser(*expr, condition, format, filename, numline, original).Parse();
+
+    unique_lock<shared_mutex> lock(cacheMutex);
+    return *cache.emplace(condition, move(expr)).first->second;
+}
+
+bool nemesis::ConditionExpr::CanRemember() const
+{
+    return canRemember;
+}
+
+bool nemesis::ConditionExpr::FindMemo(const string& signature, bool& result) const
+{
+    shared_lock<shared_mutex> lock(memoMutex);
+    auto itr = memo.find(signature);
+
+    if (itr == memo.end()) return false;
+
+    result = itr->second;
+    return true;
+}
+
+void nemesis::ConditionExpr::StoreMemo(const string& signature, bool result) const
+{
+    unique_lock<shared_mutex> lock(memoMutex);
+    auto inserted = memo.emplace(signature, result);
+
+    // another thread got here first
+    if (!inserted.second) return;
+
+    memoOrder.push_back(&inserted.first->first);
+
+    if (memoOrder.size() > memoLimit)
+    {
+        memo.erase(memo.find(*memoOrder.front()));
+        memoOrder.pop_front();
+    }
+}
@@ -0,0 +1,681 @@
+#include "Global.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utilities/binaryio.h"
+
+#include "generate/animation/idrange.h"
+#include "generate/animation/animationinfo.h"
+#include "generate/animation/fragmentcache.h"
+
+using namespace std;
+
+namespace
+{
+    constexpr uint32_t cacheMagic   = 0x4346414e; // "NAFC"
+    constexpr uint32_t cacheVersion = 3;
+
+    // plain decimal that fits an int, node IDs never come close to the limit
+    bool ParseID(string_view digits, int& ID)
+    {
+        if (digits.empty() || digits.length() > 9) return false;
+
+        ID = 0;
+
+        for (char ch : digits)
+        {
+            if (ch < '0' || ch > '9') return false;
+
+            ID = ID * 10 + (ch - '0');
+        }
+
+        return true;
+    }
+
+    // range and slot of a generated ID, false when the ID cannot be relocated
+    bool FindSlot(int ID,
+                  const nemesis::IDRange& own,
+                  const nemesis::IDRange& group,
+                  int floorID,
+                  uint8_t& range,
+                  uint32_t& slot)
+    {
+        size_t index;
+
+        if (own.SlotOf(ID, index))
+        {
+            range = nemesis::AnimFragment::OWN;
+        }
+        else if (group.SlotOf(ID, index))
+        {
+            range = nemesis::AnimFragment::GROUP;
+        }
+        else
+        {
+            // nodes of the behavior itself keep their IDs from run to run
+            range = nemesis::AnimFragment::NONE;
+            slot  = 0;
+            return ID < floorID;
+        }
+
+        slot = uint32_t(index);
+        return true;
+    }
+
+    bool CaptureEntries(const vector<pair<string, string>>& source,
+                        const nemesis::IDRange& own,
+                        const nemesis::IDRange& group,
+                        int floorID,
+                        vector<nemesis::AnimFragment::Entry>& entries)
+    {
+        entries.reserve(source.size());
+
+        for (auto& each : source)
+        {
+            nemesis::AnimFragment::Entry entry;
+            entry.key   = each.first;
+            entry.value = each.second;
+            int ID;
+
+            // (S+N) are state numbers, not node IDs
+            if (each.first.rfind("(S", 0) != 0 && ParseID(each.second, ID))
+            {
+                if (!FindSlot(ID, own, group, floorID, entry.range, entry.slot)) return false;
+
+                if (entry.range != nemesis::AnimFragment::NONE) entry.value.clear();
+            }
+
+            entries.push_back(move(entry));
+        }
+
+        return true;
+    }
+
+    const nemesis::IDRange& RangeOf(uint8_t range, const nemesis::IDRange& own, const nemesis::IDRange& group)
+    {
+        return range == nemesis::AnimFragment::OWN ? own : group;
+    }
+
+    bool RelocateEntries(const vector<nemesis::AnimFragment::Entry>& source,
+                         const nemesis::IDRange& own,
+                         const nemesis::IDRange& group,
+                         vector<nemesis::AnimFragment::Entry>& entries)
+    {
+        entries.reserve(source.size());
+
+        for (auto& each : source)
+        {
+            entries.push_back(nemesis::AnimFragment::Entry{each.key, each.value});
+
+            if (each.range == nemesis::AnimFragment::NONE) continue;
+
+            const nemesis::IDRange& range = RangeOf(each.range, own, group);
+
+            if (each.slot >= range.Size()) return false;
+
+            entries.back().value = range.At(each.slot);
+        }
+
+        return true;
+    }
+
+    void WriteEntries(nemesis::BinaryWriter& output, const vector<nemesis::AnimFragment::Entry>& entries)
+    {
+        output.Write(uint32_t(entries.size()));
+
+        for (auto& entry : entries)
+        {
+            output.WriteString(entry.key);
+            output.WriteString(entry.value);
+            output.Write(entry.range);
+            output.Write(entry.slot);
+        }
+    }
+
+    bool ReadEntries(nemesis::BinaryReader& input, vector<nemesis::AnimFragment::Entry>& entries)
+    {
+        uint32_t count;
+
+        // key, value, range, slot
+        if (!input.ReadCount(count, 4 + 4 + 1 + 4)) return false;
+
+        entries.resize(count);
+
+        for (auto& entry : entries)
+        {
+            if (!input.ReadString(entry.key) || !input.ReadString(entry.value) || !input.Read(entry.range)
+                || !input.Read(entry.slot))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void WriteReferences(nemesis::BinaryWriter& output, const nemesis::BehaviorReferences& references)
+    {
+        output.Write(uint32_t(references.GetBehaviors().size()));
+
+        for (auto& behavior : references.GetBehaviors())
+        {
+            output.WriteString(behavior);
+        }
+
+        output.Write(uint32_t(references.GetClips().size()));
+
+        for (auto& clip : references.GetClips())
+        {
+            output.WriteString(clip.clipName);
+            output.WriteString(clip.animationName);
+        }
+    }
+
+    bool ReadReferences(nemesis::BinaryReader& input, nemesis::BehaviorReferences& references)
+    {
+        uint32_t count;
+        string first;
+        string second;
+
+        if (!input.ReadCount(count, 4)) return false;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!input.ReadString(first)) return false;
+
+            references.AddBehavior(first);
+        }
+
+        // clip name, animation name
+        if (!input.ReadCount(count, 4 + 4)) return false;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!input.ReadString(first) || !input.ReadString(second)) return false;
+
+            references.AddClip(first, second);
+        }
+
+        return true;
+    }
+} // namespace
+
+nemesis::FragmentHash& nemesis::FragmentHash::Add(string_view bytes)
+{
+    // length first, so ("ab", "c") and ("a", "bc") differ
+    Add(uint64_t(bytes.length()));
+    inputs.append(bytes.data(), bytes.length());
+    return *this;
+}
+
+nemesis::FragmentHash& nemesis::FragmentHash::Add(uint64_t value)
+{
+    inputs.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    return *this;
+}
+
+nemesis::FragmentHash& nemesis::FragmentHash::Add(const VecStr& lines)
+{
+    Add(uint64_t(lines.size()));
+
+    for (auto& line : lines)
+    {
+        Add(line);
+    }
+
+    return *this;
+}
+
+nemesis::FragmentHash& nemesis::FragmentHash::Add(const vector<int>& values)
+{
+    Add(uint64_t(values.size()));
+
+    for (int value : values)
+    {
+        Add(uint64_t(int64_t(value)));
+    }
+
+    return *this;
+}
+
+nemesis::FragmentHash& nemesis::FragmentHash::Add(const ID& map)
+{
+    vector<string> entries;
+    entries.reserve(map.size());
+
+    for (auto& entry : map)
+    {
+        entries.push_back(FragmentHash().Add(entry.first).Add(uint64_t(int64_t(entry.second))).Inputs());
+    }
+
+    return AddEntries(entries);
+}
+
+nemesis::FragmentHash& nemesis::FragmentHash::Add(const SSMap& map)
+{
+    vector<string> entries;
+    entries.reserve(map.size());
+
+    for (auto& entry : map)
+    {
+        entries.push_back(FragmentHash().Add(entry.first).Add(entry.second).Inputs());
+    }
+
+    return AddEntries(entries);
+}
+
+nemesis::FragmentHash& nemesis::FragmentHash::Add(const ImportContainer& map)
+{
+    vector<string> entries;
+    entries.reserve(map.size());
+
+    for (auto& entry : map)
+    {
+        entries.push_back(FragmentHash().Add(entry.first).Add(entry.second).Inputs());
+    }
+
+    return AddEntries(entries);
+}
+
+nemesis::FragmentHash& nemesis::FragmentHash::Add(const unordered_map<int, VecStr>& map)
+{
+    vector<string> entries;
+    entries.reserve(map.size());
+
+    for (auto& entry : map)
+    {
+        entries.push_back(FragmentHash().Add(uint64_t(int64_t(entry.first))).Add(entry.second).Inputs());
+    }
+
+    return AddEntries(entries);
+}
+
+nemesis::FragmentHash& nemesis::FragmentHash::Add(const unordered_map<string, unordered_map<string, VecStr>>& map)
+{
+    vector<string> entries;
+
+    for (auto& option : map)
+    {
+        for (auto& addon : option.second)
+        {
+            entries.push_back(FragmentHash().Add(option.first).Add(addon.first).Add(addon.second).Inputs());
+        }
+    }
+
+    return AddEntries(entries);
+}
+
+nemesis::FragmentHash& nemesis::FragmentHash::Add(const AnimationInfo& info)
+{
+    uint64_t duration;
+    memcpy(&duration, &info.duration, sizeof(duration));
+
+    // the list line decides the picked options, their bitset is left out as the option IDs are interned in whatever
+    // order the templates happened to be read
+    Add(info.animInfo).Add(info.filename).Add(info.mainAnimEvent).Add(info.eventID).Add(info.variableID);
+    Add(info.motionData).Add(info.rotationData).Add(info.addition).Add(info.optionPickedCount);
+    Add(uint64_t(info.ignoreGroup)).Add(uint64_t(info.known)).Add(uint64_t(info.hasDuration)).Add(duration);
+    return Add(info.groupAddition).Add(info.AnimObject);
+}
+
+uint64_t nemesis::FragmentHash::Get() const
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (unsigned char ch : inputs)
+    {
+        hash ^= ch;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+const string& nemesis::FragmentHash::Inputs() const
+{
+    return inputs;
+}
+
+nemesis::FragmentHash& nemesis::FragmentHash::AddEntries(vector<string>& entries)
+{
+    sort(entries.begin(), entries.end());
+    Add(uint64_t(entries.size()));
+
+    for (auto& entry : entries)
+    {
+        inputs.append(entry);
+    }
+
+    return *this;
+}
+
+bool nemesis::AnimFragment::Capture(const VecStr& lines,
+                                    const vector<pair<string, string>>& format,
+                                    const vector<pair<string, string>>& groupIDs,
+                                    const vector<pair<string, string>>& existIDs,
+                                    const IDRange& own,
+                                    const IDRange& group,
+                                    const BehaviorReferences& references,
+                                    int floorID,
+                                    AnimFragment& fragment)
+{
+    if (own.Overflowed()) return false;
+
+    fragment.lines      = lines;
+    fragment.references = references;
+
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        const string& line = lines[i];
+        size_t pos         = line.find('#');
+
+        while (pos != NOT_FOUND)
+        {
+            size_t digit = pos + 1;
+
+            while (digit < line.length() && isdigit(static_cast<unsigned char>(line[digit])))
+            {
+                ++digit;
+            }
+
+            int ID;
+
+            if (ParseID(string_view(line).substr(pos + 1, digit - pos - 1), ID))
+            {
+                NodeSlot node{uint32_t(i), uint32_t(pos + 1), uint32_t(digit - pos - 1), NONE, 0};
+
+                if (!FindSlot(ID, own, group, floorID, node.range, node.slot)) return false;
+
+                if (node.range != NONE) fragment.nodes.push_back(node);
+            }
+
+            pos = line.find('#', digit);
+        }
+    }
+
+    if (!CaptureEntries(format, own, group, floorID, fragment.format)) return false;
+
+    if (!CaptureEntries(groupIDs, own, group, floorID, fragment.groupIDs)) return false;
+
+    if (!CaptureEntries(existIDs, own, group, floorID, fragment.existIDs)) return false;
+
+    bool relocatable = true;
+
+    own.ForEachImport([&](const string& file, const string& keyword, const string& ID) {
+        int numID;
+        size_t slot;
+
+        if (ParseID(ID, numID) && own.SlotOf(numID, slot))
+        {
+            fragment.imports.push_back(Import{file, keyword, uint32_t(slot)});
+        }
+        else
+        {
+            relocatable = false;
+        }
+    });
+
+    return relocatable;
+}
+
+bool nemesis::AnimFragment::Relocate(const IDRange& own, const IDRange& group, AnimFragment& placed) const
+{
+    placed.lines = lines;
+
+    // right to left, so the positions still to be patched in a line do not move
+    for (auto node = nodes.rbegin(); node != nodes.rend(); ++node)
+    {
+        const IDRange& range = RangeOf(node->range, own, group);
+
+        if (node->slot >= range.Size()) return false;
+
+        placed.lines[node->line].replace(node->pos, node->length, range.At(node->slot));
+    }
+
+    if (!RelocateEntries(format, own, group, placed.format)) return false;
+
+    if (!RelocateEntries(groupIDs, own, group, placed.groupIDs)) return false;
+
+    if (!RelocateEntries(existIDs, own, group, placed.existIDs)) return false;
+
+    for (auto& each : imports)
+    {
+        if (each.slot >= own.Size()) return false;
+    }
+
+    placed.imports = imports;
+    return true;
+}
+
+size_t nemesis::AnimFragment::OwnSlots() const
+{
+    size_t count = 0;
+
+    for (auto& node : nodes)
+    {
+        if (node.range == OWN) count = max(count, size_t(node.slot) + 1);
+    }
+
+    for (auto* entries : {&format, &groupIDs, &existIDs})
+    {
+        for (auto& entry : *entries)
+        {
+            if (entry.range == OWN) count = max(count, size_t(entry.slot) + 1);
+        }
+    }
+
+    for (auto& each : imports)
+    {
+        count = max(count, size_t(each.slot) + 1);
+    }
+
+    return count;
+}
+
+nemesis::FragmentCache::FragmentCache(const string& behaviorFile,
+                                      const string& templateCode,
+                                      const FragmentHash& _context,
+                                      int _floorID)
+    : contextInputs(_context.Inputs())
+    , context(_context.Get())
+    , floorID(_floorID)
+{
+    string filename = templateCode + "~" + behaviorFile;
+
+    for (auto& ch : filename)
+    {
+        if (ch == '\\' || ch == '/') ch = '~';
+    }
+
+    cachefile = "cache\\animation_fragments\\" + filename;
+    Load();
+}
+
+uint64_t nemesis::FragmentCache::GetContext() const
+{
+    return context;
+}
+
+int nemesis::FragmentCache::GetFloorID() const
+{
+    return floorID;
+}
+
+const nemesis::AnimFragment* nemesis::FragmentCache::Find(const FragmentHash& key)
+{
+    auto itr = cached.find(key.Get());
+
+    // two instances whose inputs share a hash
+    if (itr == cached.end() || itr->second.inputs != key.Inputs()) return nullptr;
+
+    lock_guard<mutex> guard(lock);
+    used.insert(itr->first);
+    return &itr->second;
+}
+
+void nemesis::FragmentCache::Add(const FragmentHash& key, AnimFragment&& fragment)
+{
+    fragment.inputs = key.Inputs();
+    lock_guard<mutex> guard(lock);
+    added[key.Get()] = move(fragment);
+}
+
+bool nemesis::FragmentCache::Save()
+{
+    lock_guard<mutex> guard(lock);
+    BinaryWriter output(cachefile, cacheMagic, cacheVersion);
+    vector<pair<uint64_t, const AnimFragment*>> fragments;
+
+    for (auto& key : used)
+    {
+        if (added.find(key) == added.end()) fragments.emplace_back(key, &cached.at(key));
+    }
+
+    for (auto& each : added)
+    {
+        fragments.emplace_back(each.first, &each.second);
+    }
+
+    output.WriteString(contextInputs);
+    output.Write(uint64_t(fragments.size()));
+
+    for (auto& each : fragments)
+    {
+        const AnimFragment& fragment = *each.second;
+        output.Write(each.first);
+        output.WriteString(fragment.inputs);
+        output.Write(uint32_t(fragment.lines.size()));
+
+        for (auto& line : fragment.lines)
+        {
+            output.WriteString(line);
+        }
+
+        output.Write(uint32_t(fragment.nodes.size()));
+
+        for (auto& node : fragment.nodes)
+        {
+            output.Write(node.line);
+            output.Write(node.pos);
+            output.Write(node.length);
+            output.Write(node.range);
+            output.Write(node.slot);
+        }
+
+        WriteEntries(output, fragment.format);
+        WriteEntries(output, fragment.groupIDs);
+        WriteEntries(output, fragment.existIDs);
+        output.Write(uint32_t(fragment.imports.size()));
+
+        for (auto& each : fragment.imports)
+        {
+            output.WriteString(each.file);
+            output.WriteString(each.keyword);
+            output.Write(each.slot);
+        }
+
+        WriteReferences(output, fragment.references);
+    }
+
+    return output.Commit();
+}
+
+size_t nemesis::FragmentCache::GetHitCount() const
+{
+    lock_guard<mutex> guard(lock);
+    return used.size();
+}
+
+size_t nemesis::FragmentCache::GetAddCount() const
+{
+    lock_guard<mutex> guard(lock);
+    return added.size();
+}
+
+void nemesis::FragmentCache::Load()
+{
+    BinaryReader input(cachefile, cacheMagic, cacheVersion);
+    string fileContext;
+    uint64_t count;
+
+    // another template, event list or import set, none of the fragments apply
+    // a fragment is at least its key, inputs and eight counts
+    if (!input.IsValid() || !input.ReadString(fileContext) || fileContext != contextInputs
+        || !input.ReadCount(count, 8 + 4 + 8 * 4))
+    {
+        return;
+    }
+
+    cached.reserve(size_t(count));
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        uint64_t key;
+        uint32_t size;
+        AnimFragment fragment;
+
+        if (!input.Read(key) || !input.ReadString(fragment.inputs) || !input.ReadCount(size, 4))
+        {
+            cached.clear();
+            return;
+        }
+
+        fragment.lines.resize(size);
+
+        for (auto& line : fragment.lines)
+        {
+            if (!input.ReadString(line))
+            {
+                cached.clear();
+                return;
+            }
+        }
+
+        // line, pos, length, range, slot
+        if (!input.ReadCount(size, 4 + 4 + 4 + 1 + 4))
+        {
+            cached.clear();
+            return;
+        }
+
+        fragment.nodes.resize(size);
+
+        for (auto& node : fragment.nodes)
+        {
+            if (!input.Read(node.line) || !input.Read(node.pos) || !input.Read(node.length) || !input.Read(node.range)
+                || !input.Read(node.slot) || node.range > AnimFragment::GROUP || node.line >= fragment.lines.size()
+                || size_t(node.pos) + node.length > fragment.lines[node.line].length())
+            {
+                cached.clear();
+                return;
+            }
+        }
+
+        if (!ReadEntries(input, fragment.format) || !ReadEntries(input, fragment.groupIDs)
+            || !ReadEntries(input, fragment.existIDs) || !input.ReadCount(size, 4 + 4 + 4))
+        {
+            cached.clear();
+            return;
+        }
+
+        fragment.imports.resize(size);
+
+        for (auto& each : fragment.imports)
+        {
+            if (!input.ReadString(each.file) || !input.ReadString(each.keyword) || !input.Read(each.slot))
+            {
+                cached.clear();
+                return;
+            }
+        }
+
+        if (!ReadReferences(input, fragment.references))
+        {
+            cached.clear();
+            return;
+        }
+
+        cached[key] = move(fragment);
+    }
+}
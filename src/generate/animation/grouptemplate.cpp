@@ -18,63 +18,28 @@ using namespace std;
 std::wstring DMLogError(int errorcode);
 void multiChoice(std::string& line,
                  std::string filename,
-                 std::vector<std::vector<std::unordered_map<std::string, bool>>> masterOptionPicked,
+                 std::vector<std::vector<nemesis::OptionSet>> masterOptionPicked,
                  std::vector<std::vector<std::shared_ptr<AnimationInfo>>> groupAnimInfo,
                  int numline,
                  std::string format,
                  std::string masterformat,
                  AnimationUtility utility);
-bool singleCondition(string condition,
-                     string filename,
-                     vector<vector<unordered_map<string, bool>>> curOptionPicked,
-                     vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
-                     int numline,
-                     string format,
-                     string masterformat,
-                     AnimationUtility utility);
-bool andLoop(string condition,
-             string filename,
-             vector<vector<unordered_map<string, bool>>> curOptionPicked,
-             vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
-             int numline,
-             string format,
-             string masterformat,
-             AnimationUtility utility);
-bool andOrParenthesis(size_t c_and,
-                      size_t c_or,
-                      string condition,
-                      string filename,
-                      vector<vector<unordered_map<string, bool>>> curOptionPicked,
-                      vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
-                      int numline,
-                      string format,
-                      string masterformat,
-                      AnimationUtility utility);
-bool andParenthesis(string condition,
-                    string filename,
-                    vector<vector<unordered_map<string, bool>>> curOptionPicked,
-                    vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
-                    int numline,
-                    string format,
-                    string masterformat,
-                    AnimationUtility utility);
-bool newCondition(std::string condition,
-                  std::string filename,
-                  std::vector<std::vector<std::unordered_map<std::string, bool>>> optionPicked,
-                  std::vector<std::vector<std::shared_ptr<AnimationInfo>>> groupAnimInfo,
+bool newCondition(const std::string& condition,
+                  const std::string& filename,
+                  const std::vector<std::vector<nemesis::OptionSet>>& curOptionPicked,
+                  const std::vector<std::vector<std::shared_ptr<AnimationInfo>>>& groupAnimInfo,
                   int numline,
-                  std::string format,
-                  std::string masterformat,
-                  AnimationUtility utility);
-bool conditionProcess(std::string condition,
-                      std::string masterformat,
-                      std::string format,
-                      std::string filename,
+                  const std::string& format,
+                  const std::string& masterformat,
+                  const AnimationUtility& utility);
+bool conditionProcess(const nemesis::ConditionExpr::Operand& operand,
+                      const std::string& masterformat,
+                      const std::string& format,
+                      const std::string& filename,
                       int numline,
-                      std::vector<std::vector<std::unordered_map<std::string, bool>>> curOptionPicked,
-                      std::vector<std::vector<std::shared_ptr<AnimationInfo>>> groupAnimInfo,
-                      bool isNot,
-                      AnimationUtility utility);
+                      const std::vector<std::vector<nemesis::OptionSet>>& curOptionPicked,
+                      const std::vector<std::vector<std::shared_ptr<AnimationInfo>>>& groupAnimInfo,
+                      const AnimationUtility& utility);
 int formatGroupReplace(string& curline,
                        string oriline,
                        int point,
@@ -92,13 +57,13 @@ void OutputCheckGroup(AnimThreadInfo& animthrinfo,
                       const proc& process,
                       nemesis::CondVar<string>* curset);
 void processing(string& line, shared_ptr<NodePackedParameters> parameters);
-bool specialCondition(string condition,
-                      string filename,
-                      vector<vector<unordered_map<string, bool>>> curOptionPicked,
-                      vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
+bool specialCondition(const nemesis::ConditionExpr::Operand& condition,
+                      const string& filename,
+                      const vector<vector<nemesis::OptionSet>>& curOptionPicked,
+                      const vector<vector<shared_ptr<AnimationInfo>>>& groupAnimInfo,
                       int numline,
-                      string format,
-                      string masterformat,
+                      const string& format,
+                      const string& masterformat,
                       AnimationUtility utility);
 
 GroupTemplate::GroupTemplate(VecStr grouptemplateformat, shared_ptr<AnimTemplate> _grouptemplate)
@@ -141,11 +106,11 @@ void GroupTemplate::getFunctionLines(shared_ptr<VecStr> functionline,
 
 	vector<int> fixedStateID = stateID;
 	unordered_map<int, bool> IsConditionOpened;
-	vector<vector<unordered_map<string, bool>>> masterOptionPicked;
+	vector<vector<nemesis::OptionSet>> masterOptionPicked;
 
 	for (auto& groupInfo : groupAnimInfo)
 	{
-		vector<unordered_map<string, bool>> curGroupInfo;
+		vector<nemesis::OptionSet> curGroupInfo;
 
 		for (auto& animInfo : groupInfo)
 		{
@@ -159,7 +124,7 @@ void GroupTemplate::getFunctionLines(shared_ptr<VecStr> functionline,
 	}
 
 	IsConditionOpened[0] = true;
-	functionline->reserve(templatelines.size() + 20 * memory);
+	functionline->reserve(templatelines.size());
 
     AnimThreadInfo animthrinfo("",
                                filename,
@@ -188,7 +153,7 @@ void GroupTemplate::getFunctionLines(shared_ptr<VecStr> functionline,
                                ImportContainer(),
                                newImport,
                                unordered_map<string, unordered_map<string, VecStr>>(),
-                               vector<unordered_map<string, bool>>(),
+                               vector<nemesis::OptionSet>(),
                                masterOptionPicked,
                                nullptr,
                                functionline,
@@ -199,6 +164,7 @@ void GroupTemplate::getFunctionLines(shared_ptr<VecStr> functionline,
     animthrinfo.animLock       = atomicLock;
     animthrinfo.groupMulti     = grouptemplate->process.isMaster ? -1 : groupCount - 1;
     animthrinfo.curGroup       = this;
+    animthrinfo.references     = references.get();
 
     // output
     OutputCheckGroup(animthrinfo, grouptemplate->process, &grouptemplate->lines);
@@ -248,7 +214,7 @@ void GroupTemplate::OutputGroupBackup(shared_ptr<VecStr> functionline,
                                       int groupCount,
                                       VecStr templatelines,
                                       unordered_map<int, bool>& IsConditionOpened,
-                                      vector<vector<unordered_map<string, bool>>> masterOptionPicked,
+                                      vector<vector<nemesis::OptionSet>> masterOptionPicked,
                                       vector<int> fixedStateID)
 {
     unordered_map<string, string> IDExist;
@@ -520,14 +486,14 @@ void GroupTemplate::OutputGroupBackup(shared_ptr<VecStr> functionline,
 						ErrorMessage(1129, format, filename, i + 1);
 					}
 
-                    if (!groupAnimInfo[stoi(optionInfo[1])][stoi(optionInfo[2])]->optionPicked[curOption])
+                    if (!groupAnimInfo[stoi(optionInfo[1])][stoi(optionInfo[2])]->optionPicked.test(curOption))
                     {
                         // clear group number
                         curOption = nemesis::regex_replace(string(optionInfo[2]),
                                                          nemesis::regex("[^A-Za-z\\s]*([A-Za-z\\s]+).*"),
                                                          string("\\1"));
 
-						if (groupAnimInfo[stoi(optionInfo[1])][stoi(optionInfo[2])]->optionPicked[curOption])
+						if (groupAnimInfo[stoi(optionInfo[1])][stoi(optionInfo[2])]->optionPicked.test(curOption))
 						{
 							if (isNot)
 							{
@@ -597,7 +563,7 @@ void GroupTemplate::OutputGroupBackup(shared_ptr<VecStr> functionline,
 
                     if (error) throw nemesis::exception();
 
-                    if (!groupAnimInfo[stoi(optionInfo[1])][stoi(optionInfo[2])]->optionPicked[optionInfo[3]])
+                    if (!groupAnimInfo[stoi(optionInfo[1])][stoi(optionInfo[2])]->optionPicked.test(optionInfo[3]))
                     {
                         // Check if current condition accepts other options that are linked
                         if (isNot)
@@ -1731,7 +1697,7 @@ ExistingFunction::groupExistingFunctionProcess(int curFunctionID,
     int elementLine      = 0;
     unordered_map<int, bool> IsConditionOpened;
     unordered_map<string, bool> otherAnimType;
-    vector<vector<unordered_map<string, bool>>> masterOptionPicked;
+    vector<vector<nemesis::OptionSet>> masterOptionPicked;
 
 	string IDFileName = to_string(curFunctionID);
 
@@ -1744,7 +1710,7 @@ ExistingFunction::groupExistingFunctionProcess(int curFunctionID,
 
 	for (auto& groupInfo : groupAnimInfo)
 	{
-		vector<unordered_map<string, bool>> curGroupInfo;
+		vector<nemesis::OptionSet> curGroupInfo;
 
 		for (auto& animInfo : groupInfo)
 		{
@@ -1769,7 +1735,7 @@ ExistingFunction::groupExistingFunctionProcess(int curFunctionID,
     }
 
 	IsConditionOpened[0] = true;
-	newFunctionLines.reserve(existingFunctionLines.size() + 20 * memory);
+	newFunctionLines.reserve(existingFunctionLines.size());
 
     for (uint i = 0; i < existingFunctionLines.size(); ++i)
     {
@@ -2086,7 +2052,7 @@ ExistingFunction::groupExistingFunctionProcess(int curFunctionID,
 
 								if (formatInfo[2].find("AnimObject") != NOT_FOUND) ErrorMessage(1129, format, IDFileName, i + 1);
 
-								if (masterOptionPicked[stoi(formatInfo[1])][stoi(formatInfo[2])][formatInfo[3]])
+								if (masterOptionPicked[stoi(formatInfo[1])][stoi(formatInfo[2])].test(formatInfo[3]))
 								{
 									if (isNot) skip = true;
 									else open = true;
@@ -4078,7 +4044,7 @@ void ExistingFunction::processing(string& line,
 
 void multiChoice(string& line,
                  string filename,
-                 vector<vector<unordered_map<string, bool>>> masterOptionPicked,
+                 vector<vector<nemesis::OptionSet>> masterOptionPicked,
                  vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
                  int numline,
                  string format,
@@ -4158,65 +4124,22 @@ void multiChoice(string& line,
     line = line.substr(0, line.find("</hkparam>") + 10);
 }
 
-bool specialCondition(string condition,
-                      string filename,
-                      vector<vector<unordered_map<string, bool>>> curOptionPicked,
-                      vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
+bool specialCondition(const nemesis::ConditionExpr::Operand& condition,
+                      const string& filename,
+                      const vector<vector<nemesis::OptionSet>>& curOptionPicked,
+                      const vector<vector<shared_ptr<AnimationInfo>>>& groupAnimInfo,
                       int numline,
-                      string format,
-                      string masterformat,
+                      const string& format,
+                      const string& masterformat,
                       AnimationUtility utility)
 {
-    bool isNot;
-    size_t pos;
-
-    if (condition.find("!=") != NOT_FOUND)
-    {
-        if (condition.find("==") != NOT_FOUND || sameWordCount(condition, "!=") > 1)
-        {
-            ErrorMessage(1124, format, filename, numline, utility.originalCondition);
-        }
-
-        isNot = true;
-        pos   = condition.find("!=");
-    }
-    else if (condition.find("==") != NOT_FOUND)
-    {
-        if (condition.find("!=") != NOT_FOUND || sameWordCount(condition, "==") > 1)
-        {
-            ErrorMessage(1124, format, filename, numline, utility.originalCondition);
-        }
-
-        isNot = false;
-        pos   = condition.find("==");
-    }
-    else
-    {
-        ErrorMessage(1125, format, filename, numline, utility.originalCondition);
-    }
-
-    if (error) throw nemesis::exception();
-
-    bool oneTime;
-    string oriCondition1 = condition.substr(1, pos - 1);
-    string oriCondition2 = condition.substr(pos + 2);
+    bool isNot                  = condition.isNot;
+    bool oneTime                = condition.oneTime;
+    const string& oriCondition1 = condition.left;
+    const string& oriCondition2 = condition.right;
     VecStr optionInfo1;
     VecStr optionInfo2;
 
-    // <optionA != optionB>*
-    // only need to fulfill the condition once
-    if (condition.back() == '*')
-    {
-        oneTime = true;
-        oriCondition2.pop_back();
-        oriCondition2.pop_back();
-    }
-    else
-    {
-        oneTime = false;
-        oriCondition2.pop_back();
-    }
-
     if (oriCondition1.length() > 0)
         optionInfo1 = GetOptionInfo(oriCondition1,
                                     masterformat,
@@ -4357,11 +4280,11 @@ bool specialCondition(string condition,
                         }
                         else if (optionInfo1.size() > 4)
                         {
-                            unordered_map<string, VecStr>* addOnPtr
-                                = &groupAnimInfo[groupMulti1][animMulti1]->addOn;
+                            const unordered_map<string, VecStr>* addOnPtr
+                                = &groupAnimInfo[groupMulti1][animMulti1]->GetOptions().addOn;
 
                             if (addOnPtr->find(optionInfo1[3]) != addOnPtr->end()
-                                && (*addOnPtr)[optionInfo1[3]].size() > 0)
+                                && addOnPtr->at(optionInfo1[3]).size() > 0)
                             {
                                 unordered_map<string, VecStr>* groupAdditionPtr
                                     = &groupAnimInfo[groupMulti1][animMulti1]->groupAddition[optionInfo1[3]];
@@ -4404,11 +4327,11 @@ bool specialCondition(string condition,
                         }
                         else if (optionInfo2.size() > 4)
                         {
-                            unordered_map<string, VecStr>* addOnPtr
-                                = &groupAnimInfo[groupMulti2][animMulti2]->addOn;
+                            const unordered_map<string, VecStr>* addOnPtr
+                                = &groupAnimInfo[groupMulti2][animMulti2]->GetOptions().addOn;
 
                             if (addOnPtr->find(optionInfo2[3]) != addOnPtr->end()
-                                && (*addOnPtr)[optionInfo2[3]].size() > 0)
+                                && addOnPtr->at(optionInfo2[3]).size() > 0)
                             {
                                 unordered_map<string, VecStr>* groupAdditionPtr
                                     = &groupAnimInfo[groupMulti2][animMulti2]->groupAddition[optionInfo2[3]];
@@ -4524,7 +4447,7 @@ bool specialCondition(string condition,
 
                                 if (error) throw nemesis::exception();
 
-                                if (condition.length() == 0) ErrorMessage(1172, format, filename, numline);
+                                if (condition.text.length() == 0) ErrorMessage(1172, format, filename, numline);
                             }
 
                             if (oriCondition2.length() != 0)
@@ -4587,7 +4510,7 @@ bool specialCondition(string condition,
                                     condition2 = history2[groupMulti2][animMulti2][optionMulti1];
                                 }
 
-                                if (condition.length() == 0) ErrorMessage(1172, format, filename, numline);
+                                if (condition.text.length() == 0) ErrorMessage(1172, format, filename, numline);
                             }
 
                             condlist1.insert(condition1);
@@ -4634,1213 +4557,59 @@ bool specialCondition(string condition,
     return true;
 }
 
-bool singleCondition(string condition,
-                     string filename,
-                     vector<vector<unordered_map<string, bool>>> curOptionPicked,
-                     vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
-                     int numline,
-                     string format,
-                     string masterformat,
-                     AnimationUtility utility)
-{
-    if (condition.find("<") == 0
-        && (condition.find(">") == condition.length() - 1 || condition.find(">*") == condition.length() - 2)
-        && (condition.find("!=") != NOT_FOUND || condition.find("==") != NOT_FOUND))
-    {
-        return specialCondition(
-            condition, filename, curOptionPicked, groupAnimInfo, numline, format, masterformat, utility);
-    }
-    else
-    {
-        bool isNot            = false;
-        string conditionOrder = condition;
-
-        if (conditionOrder[0] == '!')
-        {
-            isNot          = true;
-            conditionOrder = conditionOrder.substr(1);
-        }
-
-        return conditionProcess(conditionOrder,
-                                masterformat,
-                                format,
-                                filename,
-                                numline,
-                                curOptionPicked,
-                                groupAnimInfo,
-                                isNot,
-                                utility);
-    }
-}
-
-bool andLoop(string condition,
-             string filename,
-             vector<vector<unordered_map<string, bool>>> curOptionPicked,
-             vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
-             int numline,
-             string format,
-             string masterformat,
-             AnimationUtility utility)
+void GroupOptionSignature(nemesis::ConditionExpr::Signature& signature,
+                          const vector<vector<nemesis::OptionSet>>& curOptionPicked,
+                          const vector<vector<shared_ptr<AnimationInfo>>>& groupAnimInfo,
+                          const string& format,
+                          const string& masterformat,
+                          const AnimationUtility& utility)
 {
-    size_t lastpos = 0;
-    string nextCondition;
+    signature << format << masterformat << utility.multiOption << uint64_t(utility.groupMulti)
+              << uint64_t(utility.animMulti) << uint64_t(utility.optionMulti) << uint64_t(groupAnimInfo.size());
 
-    while (condition.find("&", lastpos) != NOT_FOUND)
+    for (auto& group : groupAnimInfo)
     {
-        string nextCondition = condition.substr(lastpos, condition.find("&", lastpos) - lastpos);
-
-        // bool1 & (bool2 | bool3) & bool4 | bool5...
-        // --------^
-        if (nextCondition[0] == '(')
-        {
-            size_t c_or  = 0;
-            size_t backB = 0;
-
-            for (uint i = 0; i < nextCondition.size(); ++i)
-            {
-                if (nextCondition[i] == '(') 
-                {
-                    ++c_or; 
-                }
-                else if (nextCondition[i] == ')')
-                {
-                    --c_or;
-
-                    if (c_or == 0)
-                    {
-                        backB = i;
-                        break;
-                    }
-                }
-            }
-
-            if (c_or != 0) ErrorMessage(1106, format, filename, numline, utility.originalCondition);
-            if (!newCondition(nextCondition.substr(1, backB - 1),
-                              filename,
-                              curOptionPicked,
-                              groupAnimInfo,
-                              numline,
-                              format,
-                              masterformat,
-                              utility))
-                return false;
-
-            lastpos = condition.find("&", backB + 1) + 1;
-        }
-        else
-        {
-            if (!singleCondition(nextCondition,
-                                 filename,
-                                 curOptionPicked,
-                                 groupAnimInfo,
-                                 numline,
-                                 format,
-                                 masterformat,
-                                 utility))
-                return false;
-
-            lastpos = condition.find("&", lastpos) + 1;
-        }
+        signature << uint64_t(group.size());
     }
 
-    if (error) throw nemesis::exception();
-
-    nextCondition = condition.substr(lastpos);
-
-    if (nextCondition[0] == '(')
+    for (auto& group : curOptionPicked)
     {
-        size_t c_or  = 0;
-        size_t backB = 0;
+        signature << uint64_t(group.size());
 
-        for (uint i = 0; i < nextCondition.size(); ++i)
+        for (auto& curOption : group)
         {
-            if (nextCondition[i] == '(')
-            { 
-                ++c_or; 
-            }
-            else if (nextCondition[i] == ')')
-            {
-                --c_or;
-
-                if (c_or == 0)
-                {
-                    backB = i;
-                    break;
-                }
-            }
+            signature << curOption;
         }
-
-        if (c_or != 0) ErrorMessage(1106, format, filename, numline, utility.originalCondition);
-
-        return newCondition(nextCondition.substr(1, backB - 1),
-                            filename,
-                            curOptionPicked,
-                            groupAnimInfo,
-                            numline,
-                            format,
-                            masterformat,
-                            utility);
-    }
-    else
-    {
-        return singleCondition(
-            nextCondition, filename, curOptionPicked, groupAnimInfo, numline, format, masterformat, utility);
     }
 }
 
-bool andOrParenthesis(size_t c_and,
-                      size_t c_or,
-                      string condition,
-                      string filename,
-                      vector<vector<unordered_map<string, bool>>> curOptionPicked,
-                      vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
-                      int numline,
-                      string format,
-                      string masterformat,
-                      AnimationUtility utility)
-{
-    size_t parent = condition.find("(");
-
-    // PARENT not exist / PARENT after OR
-    // bool1 | (bool2 & bool3)...
-    // ------^
-    if (parent == NOT_FOUND || parent > c_or)
-    {
-        // bool1 & bool2 | (bool3...
-        // ^-----------^
-        string conditionGroup = condition.substr(0, c_or);
-
-        // bool1 & bool2 | (bool3...
-        //				   ^----->
-        string nextCondition = condition.substr(c_or + 1);
-
-        // bool1 & bool2 | bool3... (AND before OR)
-        // --------------^------>
-        if (c_and < c_or)
-        {
-            return andLoop(conditionGroup,
-                           filename,
-                           curOptionPicked,
-                           groupAnimInfo,
-                           numline,
-                           format,
-                           masterformat,
-                           utility)
-                   || newCondition(nextCondition,
-                                   filename,
-                                   curOptionPicked,
-                                   groupAnimInfo,
-                                   numline,
-                                   format,
-                                   masterformat,
-                                   utility);
-        }
-
-        // bool1 | bool2 & bool3... (AND after OR)
-        // ------^-------------->
-        else
-        {
-            return singleCondition(conditionGroup,
-                                   filename,
-                                   curOptionPicked,
-                                   groupAnimInfo,
-                                   numline,
-                                   format,
-                                   masterformat,
-                                   utility)
-                   || newCondition(nextCondition,
-                                   filename,
-                                   curOptionPicked,
-                                   groupAnimInfo,
-                                   numline,
-                                   format,
-                                   masterformat,
-                                   utility);
-        }
-    }
-
-    // PARENT before OR
-    // bool1 & (bool2 | bool3) & bool4 | bool5...
-    // --------^
-    else
-    {
-        return andParenthesis(
-            condition, filename, curOptionPicked, groupAnimInfo, numline, format, masterformat, utility);
-    }
-}
-
-bool andParenthesis(string condition,
-                    string filename,
-                    vector<vector<unordered_map<string, bool>>> curOptionPicked,
-                    vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
-                    int numline,
-                    string format,
-                    string masterformat,
-                    AnimationUtility utility)
-{
-    size_t c_or  = 0;
-    size_t inner = 0;
-
-    for (uint i = 0; i < condition.length(); ++i)
-    {
-        if (condition[i] == '(')
-            ++c_or;
-        else if (condition[i] == ')')
-            --c_or;
-
-        if (c_or == 0)
-        {
-            if (i + 1 == condition.length())
-            {
-                inner = i + 1;
-                break;
-            }
-            else if (condition[i + 1] == '|')
-            {
-                inner = i;
-                break;
-            }
-        }
-    }
-
-    if (c_or != 0) ErrorMessage(1106, format, filename, numline, utility.originalCondition);
-
-    // ... & (bool1 | bool2) & bool3 | (bool4 & ...
-    //		 ^---------------------^
-    string conditionGroup = condition.substr(0, inner);
-
-    // ... & (bool1 | bool2) & bool3
-    // -----------------------------
-    if (inner == condition.length())
-    {
-        return andLoop(
-            conditionGroup, filename, curOptionPicked, groupAnimInfo, numline, format, masterformat, utility);
-    }
-
-    // ... & (bool1 | bool2) & bool3 | bool4...
-    // ------------------------------^
-    else
-    {
-        // ... & (bool1 | bool2) & bool3 | bool4...
-        // ------------------------------------->
-        return newCondition(conditionGroup,
-                            filename,
-                            curOptionPicked,
-                            groupAnimInfo,
-                            numline,
-                            format,
-                            masterformat,
-                            utility)
-               || newCondition(condition.substr(inner + 2),
-                               filename,
-                               curOptionPicked,
-                               groupAnimInfo,
-                               numline,
-                               format,
-                               masterformat,
-                               utility);
-    }
-}
-
-bool newCondition(string condition,
-                  string filename,
-                  vector<vector<unordered_map<string, bool>>> curOptionPicked,
-                  vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
+bool newCondition(const string& condition,
+                  const string& filename,
+                  const vector<vector<nemesis::OptionSet>>& curOptionPicked,
+                  const vector<vector<shared_ptr<AnimationInfo>>>& groupAnimInfo,
                   int numline,
-                  string format,
-                  string masterformat,
-                  AnimationUtility utility)
+                  const string& format,
+                  const string& masterformat,
+                  const AnimationUtility& utility)
 {
-    if (condition[0] == '(')
-    {
-        if (condition.find(")") == NOT_FOUND
-            || count(condition.begin(), condition.end(), '(')
-                   != count(condition.begin(), condition.end(), ')'))
-        {
-            ErrorMessage(1105, format, filename, numline); 
-        }
-
-        size_t c_and = 0;
-        size_t c_or  = 0;
-        size_t backB = 0;
-
-        for (uint i = 0; i < condition.size(); ++i)
-        {
-            if (condition[i] == '(') 
-            {
-                ++c_or; 
-            }
-            else if (condition[i] == ')')
-            {
-                --c_or;
-
-                if (c_or == 0)
-                {
-                    backB = i - 1;
-                    break;
-                }
-            }
-        }
-
-        // (bool1 & bool2) | bool3 ...
-        // --------------^
-        string inHouse = condition.substr(1, backB);
-        bool inHouseResult;
-
-        // if first condition has parentesis
-        // ((bool1 & bool2) | bool 3)
-        // -^
-        if (inHouse[0] == '(')
-        {
-            inHouseResult = newCondition(
-                inHouse, filename, curOptionPicked, groupAnimInfo, numline, format, masterformat, utility);
-        }
-        else
-        {
-            c_and = inHouse.find("&");
-            c_or  = inHouse.find("|");
-
-            if (c_and == NOT_FOUND)
-            {
-                // AND & OR not exist
-                if (c_or == NOT_FOUND)
-                {
-                    inHouseResult = singleCondition(inHouse,
-                                                    filename,
-                                                    curOptionPicked,
-                                                    groupAnimInfo,
-                                                    numline,
-                                                    format,
-                                                    masterformat,
-                                                    utility);
-                }
-
-                // OR exist but not AND
-                else
-                {
-                    inHouseResult = singleCondition(inHouse.substr(0, c_or),
-                                                    filename,
-                                                    curOptionPicked,
-                                                    groupAnimInfo,
-                                                    numline,
-                                                    format,
-                                                    masterformat,
-                                                    utility)
-                                    || newCondition(inHouse.substr(c_or + 1),
-                                                    filename,
-                                                    curOptionPicked,
-                                                    groupAnimInfo,
-                                                    numline,
-                                                    format,
-                                                    masterformat,
-                                                    utility);
-                }
-            }
-
-            // AND exist but not OR
-            else if (c_or == NOT_FOUND)
-            {
-                inHouseResult = andLoop(inHouse,
-                                        filename,
-                                        curOptionPicked,
-                                        groupAnimInfo,
-                                        numline,
-                                        format,
-                                        masterformat,
-                                        utility);
-            }
-
-            // AND & OR exist
-            else
-            {
-                inHouseResult = andOrParenthesis(c_and,
-                                                 c_or,
-                                                 inHouse,
-                                                 filename,
-                                                 curOptionPicked,
-                                                 groupAnimInfo,
-                                                 numline,
-                                                 format,
-                                                 masterformat,
-                                                 utility);
-            }
-        }
-
-        if (error) throw nemesis::exception();
-        if (backB + 2 >= condition.length()) return inHouseResult;
-
-        string outHouse = condition.substr(backB + 2);
-
-        if (outHouse.length() > 0 && outHouse[0] != '|' && outHouse[0] != '&')
-        {
-            ErrorMessage(1106, format, filename, numline, utility.originalCondition);
-        }
-
-        // ... | (bool1 & bool2)...
-        // ----^
-        if (outHouse[0] == '|')
-        {
-            return inHouseResult
-                   || newCondition(outHouse.substr(1),
-                                   filename,
-                                   curOptionPicked,
-                                   groupAnimInfo,
-                                   numline,
-                                   format,
-                                   masterformat,
-                                   utility);
-        }
-
-        c_and = outHouse.find("&");
-        c_or  = outHouse.find("|");
-
-        if (c_and == NOT_FOUND)
-        {
-            // AND & OR not exist
-            if (c_or == NOT_FOUND) 
-            {
-                return inHouseResult; 
-            }
-
-            // OR exist but not AND
-            else
-            {
-                // should have been covered
-                ErrorMessage(1106, format, filename, numline, utility.originalCondition);
-            }
-        }
-
-        // AND exist but not OR
-        else if (c_or == NOT_FOUND)
-        {
-            return inHouseResult
-                   && andLoop(outHouse.substr(c_and + 1),
-                              filename,
-                              curOptionPicked,
-                              groupAnimInfo,
-                              numline,
-                              format,
-                              masterformat,
-                              utility);
-        }
-
-        // AND & OR exist
-        else
-        {
-            c_and         = outHouse.find("&", 1);
-            c_or          = outHouse.find("|", 1);
-            size_t parent = outHouse.find("(", 1);
-
-            // PARENT not exist / PARENT after OR
-            // ... | bool2 & bool3 | (bool4...
-            // ------^
-            if (parent == NOT_FOUND || (c_or != NOT_FOUND && parent > c_or))
-            {
-                // ... & bool1 & bool2 | bool3... (AND before OR)
-                //	     ^-----------^
-                string conditionGroup = outHouse.substr(1, c_or - 1);
+    auto& expr = nemesis::ConditionExpr::Get(condition, format, filename, numline, utility.originalCondition);
+    nemesis::ConditionExpr::Signature signature;
 
-                // ... & bool1 & bool2 | bool3... (AND before OR)
-                // ----^
-                if (outHouse[0] == '&')
-                {
-                    if (inHouseResult
-                        && andLoop(conditionGroup,
-                                   filename,
-                                   curOptionPicked,
-                                   groupAnimInfo,
-                                   numline,
-                                   format,
-                                   masterformat,
-                                   utility))
-                        return true;
-                }
-
-                // ... | bool1 & bool2 | bool3... (AND after OR)
-                // ----^
-                else if (outHouse[0] == '|')
-                {
-                    if (inHouseResult
-                        || andLoop(conditionGroup,
-                                   filename,
-                                   curOptionPicked,
-                                   groupAnimInfo,
-                                   numline,
-                                   format,
-                                   masterformat,
-                                   utility))
-                        return true;
-                }
-                else
-                {
-                    ErrorMessage(1106, format, filename, numline, utility.originalCondition);
-                }
-
-                // ... | bool1 & bool2 | bool3...
-                //						 ^---->
-                return newCondition(outHouse.substr(c_or + 1),
-                                    filename,
-                                    curOptionPicked,
-                                    groupAnimInfo,
-                                    numline,
-                                    format,
-                                    masterformat,
-                                    utility);
-            }
-
-            // PARENT exist
-            else
-            {
-                // ... & (bool1 | bool2) | bool3...
-                // ----^
-                if (outHouse[0] == '&')
-                {
-                    // ... & (bool1 | bool2) | bool3...
-                    // ----< check if false
-                    if (!inHouseResult) return false;
-
-                    // ... & (bool1 | bool2) & bool3...
-                    //		 ^---------------------->
-                    // ... & bool1 | (bool2 & bool3)...
-                    //		 ^---------------------->
-                    return andParenthesis(outHouse.substr(1),
-                                          filename,
-                                          curOptionPicked,
-                                          groupAnimInfo,
-                                          numline,
-                                          format,
-                                          masterformat,
-                                          utility);
-                }
-                else
-                {
-                    ErrorMessage(1106, format, filename, numline, utility.originalCondition);
-                }
-            }
-        }
-    }
-    else
+    if (expr.CanRemember())
     {
-        size_t c_and = condition.find("&");
-        size_t c_or  = condition.find("|");
-
-        if (c_and == NOT_FOUND)
-        {
-            // AND & OR not exist
-            if (c_or == NOT_FOUND)
-            {
-                return singleCondition(condition,
-                                       filename,
-                                       curOptionPicked,
-                                       groupAnimInfo,
-                                       numline,
-                                       format,
-                                       masterformat,
-                                       utility);
-            }
-
-            // OR exist but not AND
-            else
-            {
-                return singleCondition(condition.substr(0, c_or),
-                                       filename,
-                                       curOptionPicked,
-                                       groupAnimInfo,
-                                       numline,
-                                       format,
-                                       masterformat,
-                                       utility)
-                       || newCondition(condition.substr(c_or + 1),
-                                       filename,
-                                       curOptionPicked,
-                                       groupAnimInfo,
-                                       numline,
-                                       format,
-                                       masterformat,
-                                       utility);
-            }
-        }
-
-        // AND exist but not OR
-        else if (c_or == NOT_FOUND)
-            return andLoop(
-                condition, filename, curOptionPicked, groupAnimInfo, numline, format, masterformat, utility);
-
-        // AND & OR exist
-        else
-            return andOrParenthesis(c_and,
-                                    c_or,
-                                    condition,
-                                    filename,
-                                    curOptionPicked,
-                                    groupAnimInfo,
-                                    numline,
-                                    format,
-                                    masterformat,
-                                    utility);
+        GroupOptionSignature(signature, curOptionPicked, groupAnimInfo, format, masterformat, utility);
     }
 
-    return false;
-}
-
-namespace backup
-{
-    bool newCondition(string condition,
-                      string filename,
-                      vector<vector<unordered_map<string, bool>>> curOptionPicked,
-                      vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
-                      int numline,
-                      string format,
-                      string masterformat,
-                      AnimationUtility utility)
-    {
-        if (condition[0] == '(')
+    return expr.Evaluate(signature, [&](const nemesis::ConditionExpr::Operand& operand) {
+        if (operand.isComparison)
         {
-            size_t backB   = condition.find(")", 0);
-            string inHouse = condition.substr(1, backB - 1);
-            size_t x       = inHouse.find("&");
-            size_t y       = inHouse.find("|");
-
-            bool inHouseResult;
-
-            if (x == NOT_FOUND && y == NOT_FOUND)
-            {
-                bool isNot = false;
-
-                if (inHouse[0] == '!')
-                {
-                    isNot   = true;
-                    inHouse = inHouse.substr(1);
-                }
-
-                inHouseResult = conditionProcess(inHouse,
-                                                 masterformat,
-                                                 format,
-                                                 filename,
-                                                 numline,
-                                                 curOptionPicked,
-                                                 groupAnimInfo,
-                                                 isNot,
-                                                 utility);
-            }
-            else if (x == NOT_FOUND || (x > y && y != NOT_FOUND))
-            {
-                string firstCondition  = inHouse.substr(0, inHouse.find("|"));
-                string secondCondition = inHouse.substr(inHouse.find("|") + 1);
-                bool isNot             = false;
-
-                if (firstCondition[0] == '!')
-                {
-                    isNot          = true;
-                    firstCondition = firstCondition.substr(1);
-                }
-
-                inHouseResult = conditionProcess(firstCondition,
-                                                 masterformat,
-                                                 format,
-                                                 filename,
-                                                 numline,
-                                                 curOptionPicked,
-                                                 groupAnimInfo,
-                                                 isNot,
-                                                 utility);
-
-                if (!inHouseResult
-                    && backup::newCondition(secondCondition,
-                                            filename,
-                                            curOptionPicked,
-                                            groupAnimInfo,
-                                            numline,
-                                            format,
-                                            masterformat,
-                                            utility))
-                {
-                    inHouseResult = true; 
-                }
-            }
-            else if (y == NOT_FOUND || (x < y && x != NOT_FOUND))
-            {
-                string firstCondition      = inHouse.substr(0, inHouse.find("&"));
-                string tempSecondCondition = inHouse.substr(inHouse.find("&") + 1);
-                string secondCondition;
-                bool isNot = false;
-
-                if (firstCondition[0] == '!')
-                {
-                    isNot          = true;
-                    firstCondition = firstCondition.substr(1);
-                }
-
-                size_t x = tempSecondCondition.find("&");
-                size_t y = tempSecondCondition.find("|");
-
-                if ((x == NOT_FOUND || x > y) && y != NOT_FOUND)
-                {
-                    secondCondition     = tempSecondCondition.substr(0, tempSecondCondition.find("|"));
-                    tempSecondCondition = tempSecondCondition.substr(tempSecondCondition.find("|") + 1);
-
-                    if (conditionProcess(firstCondition,
-                                         masterformat,
-                                         format,
-                                         filename,
-                                         numline,
-                                         curOptionPicked,
-                                         groupAnimInfo,
-                                         isNot,
-                                         utility))
-                    {
-                        if (error) throw nemesis::exception();
-
-                        inHouseResult = backup::newCondition(secondCondition,
-                                                             filename,
-                                                             curOptionPicked,
-                                                             groupAnimInfo,
-                                                             numline,
-                                                             format,
-                                                             masterformat,
-                                                             utility);
-                    }
-                    else
-                    {
-                        inHouseResult = false;
-                    }
-
-                    if (error) throw nemesis::exception();
-
-                    if (!inHouseResult
-                        && backup::newCondition(tempSecondCondition,
-                                                filename,
-                                                curOptionPicked,
-                                                groupAnimInfo,
-                                                numline,
-                                                format,
-                                                masterformat,
-                                                utility))
-                    {
-                        inHouseResult = true; 
-                    }
-                }
-                else
-                {
-                    secondCondition = tempSecondCondition;
-
-                    if (conditionProcess(firstCondition,
-                                         masterformat,
-                                         format,
-                                         filename,
-                                         numline,
-                                         curOptionPicked,
-                                         groupAnimInfo,
-                                         isNot,
-                                         utility))
-                    {
-                        if (error) throw nemesis::exception();
-
-                        inHouseResult = backup::newCondition(secondCondition,
-                                                             filename,
-                                                             curOptionPicked,
-                                                             groupAnimInfo,
-                                                             numline,
-                                                             format,
-                                                             masterformat,
-                                                             utility);
-                    }
-                    else
-                    {
-                        inHouseResult = false;
-                    }
-
-                    if (error) throw nemesis::exception();
-                }
-            }
-            else
-            {
-                ErrorMessage(1105, format, filename, numline);
-            }
-
-            string outHouse = condition.substr(backB + 1);
-
-            x = outHouse.find("&");
-            y = outHouse.find("|");
-
-            if (x == NOT_FOUND && y == NOT_FOUND) 
-            {
-                return inHouseResult; 
-            }
-            else if (x == NOT_FOUND || (x > y && y != NOT_FOUND))
-            {
-                string secondCondition = outHouse.substr(outHouse.find("|") + 1);
-
-                if (inHouseResult
-                    || backup::newCondition(secondCondition,
-                                            filename,
-                                            curOptionPicked,
-                                            groupAnimInfo,
-                                            numline,
-                                            format,
-                                            masterformat,
-                                            utility))
-                    return true;
-            }
-            else if (y == NOT_FOUND || (x < y && x != NOT_FOUND))
-            {
-                string secondCondition = inHouse.substr(inHouse.find("&") + 1);
-
-                if (inHouseResult
-                    && backup::newCondition(secondCondition,
-                                            filename,
-                                            curOptionPicked,
-                                            groupAnimInfo,
-                                            numline,
-                                            format,
-                                            masterformat,
-                                            utility))
-                    return true;
-            }
-            else
-            {
-                ErrorMessage(1106, format, filename, numline, condition);
-            }
+            return specialCondition(
+                operand, filename, curOptionPicked, groupAnimInfo, numline, format, masterformat, utility);
         }
-        else
-        {
-            size_t x = condition.find("&");
-            size_t y = condition.find("|");
-
-            if (x == NOT_FOUND && y == NOT_FOUND)
-            {
-                string conditionOrder = condition;
-                bool isNot            = false;
 
-                if (conditionOrder[0] == '!')
-                {
-                    isNot          = true;
-                    conditionOrder = conditionOrder.substr(1);
-                }
-
-                return conditionProcess(conditionOrder,
-                                        masterformat,
-                                        format,
-                                        filename,
-                                        numline,
-                                        curOptionPicked,
-                                        groupAnimInfo,
-                                        isNot,
-                                        utility);
-            }
-            else if (x == NOT_FOUND || (x > y && y != NOT_FOUND))
-            {
-                string firstCondition  = condition.substr(0, condition.find("|"));
-                string secondCondition = condition.substr(condition.find("|") + 1);
-                bool isNot             = false;
-
-                if (firstCondition[0] == '!')
-                {
-                    isNot          = true;
-                    firstCondition = firstCondition.substr(1);
-                }
-
-                if (conditionProcess(firstCondition,
-                                     masterformat,
-                                     format,
-                                     filename,
-                                     numline,
-                                     curOptionPicked,
-                                     groupAnimInfo,
-                                     isNot,
-                                     utility))
-                    return true;
-                if (error) throw nemesis::exception();
-                if (backup::newCondition(secondCondition,
-                                         filename,
-                                         curOptionPicked,
-                                         groupAnimInfo,
-                                         numline,
-                                         format,
-                                         masterformat,
-                                         utility))
-                    return true;
-            }
-            else if (y == NOT_FOUND || (x < y && x != NOT_FOUND))
-            {
-                string firstCondition  = condition.substr(0, condition.find("&"));
-                string secondCondition = condition.substr(condition.find("&") + 1);
-                bool isNot             = false;
-
-                if (firstCondition[0] == '!')
-                {
-                    isNot          = true;
-                    firstCondition = firstCondition.substr(1);
-                }
-
-                if (y != NOT_FOUND)
-                {
-                    if (secondCondition[0] == '(')
-                    {
-                        int position;
-                        int openCounter = 0;
-
-                        for (uint i = 0; i < secondCondition.size(); ++i)
-                        {
-                            if (secondCondition[i] == '(') 
-                            {
-                                openCounter++; 
-                            }
-                            else if (secondCondition[i] == ')')
-                            {
-                                openCounter--;
-
-                                if (openCounter == 0)
-                                {
-                                    position = i + 1;
-                                    break;
-                                }
-                            }
-                        }
-
-                        string thirdCondition = secondCondition.substr(position);
-                        secondCondition       = secondCondition.substr(1, position - 2);
-
-                        if (thirdCondition.length() == 0)
-                        {
-                            if (conditionProcess(firstCondition,
-                                                 masterformat,
-                                                 format,
-                                                 filename,
-                                                 numline,
-                                                 curOptionPicked,
-                                                 groupAnimInfo,
-                                                 isNot,
-                                                 utility))
-                            {
-                                if (error) throw nemesis::exception();
-                                if (backup::newCondition(secondCondition,
-                                                         filename,
-                                                         curOptionPicked,
-                                                         groupAnimInfo,
-                                                         numline,
-                                                         format,
-                                                         masterformat,
-                                                         utility))
-                                    return true;
-                            }
-
-                            if (error) throw nemesis::exception();
-                        }
-                        else
-                        {
-                            char logic     = thirdCondition[0];
-                            thirdCondition = thirdCondition.substr(1);
-
-                            if (logic == '&')
-                            {
-                                if (conditionProcess(firstCondition,
-                                                     masterformat,
-                                                     format,
-                                                     filename,
-                                                     numline,
-                                                     curOptionPicked,
-                                                     groupAnimInfo,
-                                                     isNot,
-                                                     utility))
-                                {
-                                    if (error) throw nemesis::exception();
-                                    if (backup::newCondition(secondCondition,
-                                                             filename,
-                                                             curOptionPicked,
-                                                             groupAnimInfo,
-                                                             numline,
-                                                             format,
-                                                             masterformat,
-                                                             utility)
-                                        && backup::newCondition(thirdCondition,
-                                                                filename,
-                                                                curOptionPicked,
-                                                                groupAnimInfo,
-                                                                numline,
-                                                                format,
-                                                                masterformat,
-                                                                utility))
-                                        return true;
-                                }
-                            }
-                            else if (logic == '|')
-                            {
-                                if (conditionProcess(firstCondition,
-                                                     masterformat,
-                                                     format,
-                                                     filename,
-                                                     numline,
-                                                     curOptionPicked,
-                                                     groupAnimInfo,
-                                                     isNot,
-                                                     utility))
-                                {
-                                    if (backup::newCondition(secondCondition,
-                                                             filename,
-                                                             curOptionPicked,
-                                                             groupAnimInfo,
-                                                             numline,
-                                                             format,
-                                                             masterformat,
-                                                             utility))
-                                        return true;
-                                }
-
-                                if (backup::newCondition(thirdCondition,
-                                                         filename,
-                                                         curOptionPicked,
-                                                         groupAnimInfo,
-                                                         numline,
-                                                         format,
-                                                         masterformat,
-                                                         utility))
-                                    return true;
-                            }
-                            else
-                            {
-                                ErrorMessage(1101, format, filename, numline);
-                            }
-                        }
-                    }
-                    else
-                    {
-                        x = secondCondition.find("&");
-                        y = secondCondition.find("|");
-
-                        if (x == NOT_FOUND && y == NOT_FOUND)
-                        {
-                            if (conditionProcess(firstCondition,
-                                                 masterformat,
-                                                 format,
-                                                 filename,
-                                                 numline,
-                                                 curOptionPicked,
-                                                 groupAnimInfo,
-                                                 isNot,
-                                                 utility))
-                            {
-                                if (error) throw nemesis::exception();
-
-                                bool isAnotherNot = false;
-
-                                if (secondCondition[0] == '!')
-                                {
-                                    isAnotherNot    = true;
-                                    secondCondition = secondCondition.substr(1);
-                                }
-
-                                if (conditionProcess(secondCondition,
-                                                     masterformat,
-                                                     format,
-                                                     filename,
-                                                     numline,
-                                                     curOptionPicked,
-                                                     groupAnimInfo,
-                                                     isAnotherNot,
-                                                     utility))
-                                    return true;
-                            }
-                        }
-                        else if (x == NOT_FOUND || (x > y && y != NOT_FOUND))
-                        {
-                            size_t position       = secondCondition.find("|") + 1;
-                            string thirdCondition = secondCondition.substr(position);
-                            secondCondition       = secondCondition.substr(0, position - 1);
-
-                            if (conditionProcess(firstCondition,
-                                                 masterformat,
-                                                 format,
-                                                 filename,
-                                                 numline,
-                                                 curOptionPicked,
-                                                 groupAnimInfo,
-                                                 isNot,
-                                                 utility))
-                            {
-                                if (backup::newCondition(secondCondition,
-                                                         filename,
-                                                         curOptionPicked,
-                                                         groupAnimInfo,
-                                                         numline,
-                                                         format,
-                                                         masterformat,
-                                                         utility))
-                                    return true;
-                            }
-
-                            if (backup::newCondition(thirdCondition,
-                                                     filename,
-                                                     curOptionPicked,
-                                                     groupAnimInfo,
-                                                     numline,
-                                                     format,
-                                                     masterformat,
-                                                     utility))
-                                return true;
-                        }
-                        else if (y == NOT_FOUND || (x < y && x != NOT_FOUND))
-                        {
-                            size_t position       = secondCondition.find("&") + 1;
-                            string thirdCondition = secondCondition.substr(position);
-                            secondCondition       = secondCondition.substr(0, position - 1);
-
-                            if (conditionProcess(firstCondition,
-                                                 masterformat,
-                                                 format,
-                                                 filename,
-                                                 numline,
-                                                 curOptionPicked,
-                                                 groupAnimInfo,
-                                                 isNot,
-                                                 utility))
-                            {
-                                if (backup::newCondition(secondCondition,
-                                                         filename,
-                                                         curOptionPicked,
-                                                         groupAnimInfo,
-                                                         numline,
-                                                         format,
-                                                         masterformat,
-                                                         utility)
-                                    && backup::newCondition(thirdCondition,
-                                                            filename,
-                                                            curOptionPicked,
-                                                            groupAnimInfo,
-                                                            numline,
-                                                            format,
-                                                            masterformat,
-                                                            utility))
-                                    return true;
-                            }
-                        }
-                        else
-                        {
-                            ErrorMessage(1103, format, filename, numline);
-                        }
-                    }
-                }
-                else
-                {
-                    return conditionProcess(firstCondition,
-                                            masterformat,
-                                            format,
-                                            filename,
-                                            numline,
-                                            curOptionPicked,
-                                            groupAnimInfo,
-                                            isNot,
-                                            utility);
-                }
-            }
-            else
-            {
-                ErrorMessage(1102, format, filename, numline);
-            }
-        }
-
-		return false;
-	}
+        return conditionProcess(
+            operand, masterformat, format, filename, numline, curOptionPicked, groupAnimInfo, utility);
+    });
 }
 
 VecStr GetOptionInfo(string line,
@@ -5906,9 +4675,9 @@ VecStr GetOptionInfo(string line,
 			if (optionInfo[3].back() == '*')
 			{
 				string option = optionInfo[3].substr(0, optionInfo[3].length() - 1);
-				SSMap* mapPtr = &groupAnimInfo[curGroup][curOrder]->mixOptRegis;
+				const SSMap* mapPtr = &groupAnimInfo[curGroup][curOrder]->GetOptions().mixOptRegis;
 
-				if (mapPtr->find(option) != mapPtr->end() && (*mapPtr)[option].length() != 0) optionInfo[3] = (*mapPtr)[option];
+				if (mapPtr->find(option) != mapPtr->end() && mapPtr->at(option).length() != 0) optionInfo[3] = mapPtr->at(option);
 				else ErrorMessage(1109, format, filename, numline, line);
 			}
 
@@ -6061,9 +4830,9 @@ void nonGroupOptionInfo(VecStr& optionInfo,
 	if (optionInfo[3].back() == '*')
 	{
 		string option = optionInfo[3].substr(0, optionInfo[3].length() - 1);
-		SSMap* mapPtr = &groupAnimInfo[groupMulti][curOrder]->mixOptRegis;
+		const SSMap* mapPtr = &groupAnimInfo[groupMulti][curOrder]->GetOptions().mixOptRegis;
 
-		if (mapPtr->find(option) != mapPtr->end() && (*mapPtr)[option].length() != 0) optionInfo.back() = (*mapPtr)[option];
+		if (mapPtr->find(option) != mapPtr->end() && mapPtr->at(option).length() != 0) optionInfo.back() = mapPtr->at(option);
 		else ErrorMessage(1109, format, filename, numline, line);
 	}
 }
@@ -6215,16 +4984,18 @@ string optionOrderProcess(string line,
 	return newline;
 }
 
-bool conditionProcess(string condition,
-                      string masterformat,
-                      string format,
-                      string filename,
+bool conditionProcess(const nemesis::ConditionExpr::Operand& operand,
+                      const string& masterformat,
+                      const string& format,
+                      const string& filename,
                       int numline,
-                      vector<vector<unordered_map<string, bool>>> curOptionPicked,
-                      vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
-                      bool isNot,
-                      AnimationUtility utility)
+                      const vector<vector<nemesis::OptionSet>>& curOptionPicked,
+                      const vector<vector<shared_ptr<AnimationInfo>>>& groupAnimInfo,
+                      const AnimationUtility& utility)
 {
+    const string& condition = operand.text;
+    bool isNot              = operand.isNot;
+
 	if (condition.find(masterformat + "_group[][") != NOT_FOUND)
 	{
 		int GOG = 0;
@@ -6279,7 +5050,7 @@ bool conditionProcess(string condition,
 
 				if (error) throw nemesis::exception();
 
-				if (curOptionPicked[stoi(optionInfo[1])][stoi(optionInfo[2])][optionInfo[3]]) conditionResult = !isNot;
+				if (operand.TestOption(curOptionPicked[stoi(optionInfo[1])][stoi(optionInfo[2])], optionInfo[3])) conditionResult = !isNot;
 				else conditionResult = isNot;
 
 				if (!conditionResult) return false;
@@ -6338,9 +5109,10 @@ bool conditionProcess(string condition,
             }
             else
             {
-                conditionResult = curOptionPicked[stoi(optionInfo[1])][stoi(optionInfo[2])][optionInfo[3]]
-                                      ? !isNot
-                                      : isNot;
+                conditionResult
+                    = operand.TestOption(curOptionPicked[stoi(optionInfo[1])][stoi(optionInfo[2])], optionInfo[3])
+                          ? !isNot
+                          : isNot;
             }
 
 			if (!conditionResult) return false;
@@ -6385,7 +5157,7 @@ bool conditionProcess(string condition,
 
 			return utility.animMulti == stoi(conditionOrder) ? !isNot : isNot;
 		}
-		else if (curOptionPicked[stoi(optionInfo[1])][stoi(optionInfo[2])][optionInfo[3]])
+		else if (operand.TestOption(curOptionPicked[stoi(optionInfo[1])][stoi(optionInfo[2])], optionInfo[3]))
 		{
 			return !isNot;
 		}
@@ -6402,18 +5174,22 @@ bool conditionProcess(string condition,
 
 string GroupTemplate::newID()
 {
-    Lockless lock(atomicLock->nodeIDLock);
-    int& refID   = *nextFunctionID;
-    string strID = to_string(refID++);
+    return idRange->Next();
+}
 
-	while (strID.length() < 4)
-	{
-		strID = "0" + strID;
-    }
+string GroupTemplate::importID(const string& file, const string& keyword)
+{
+    return idRange->ClaimImport(file, keyword);
+}
 
-    if (refID == 9216) ++refID;
+void GroupTemplate::setIDRange(shared_ptr<nemesis::IDRange> range)
+{
+    idRange = range;
+}
 
-    return strID;
+void GroupTemplate::setReferences(shared_ptr<nemesis::BehaviorReferences> target)
+{
+    references = target;
 }
 
 void GroupTemplate::setZeroEvent(string eventname)
@@ -6635,15 +5411,15 @@ int formatGroupReplace(string& curline,
         {
             output = (*mapPtr)[input]; 
         }
-        else if (animInfo->addOn.find(groupline[3]) != animInfo->addOn.end()
-                 && animInfo->addOn[groupline[3]].size() > 0 && optionMulti > -1)
+        else if (animInfo->GetOptions().addOn.find(groupline[3]) != animInfo->GetOptions().addOn.end()
+                 && animInfo->GetOptions().addOn.at(groupline[3]).size() > 0 && optionMulti > -1)
         {
             addOnReplacer(input,
                           filename,
-                          animInfo->addOn,
+                          animInfo->GetOptions().addOn,
                           animInfo->addition,
                           animInfo->groupAddition,
-                          animInfo->mixOptRegis,
+                          animInfo->GetOptions().mixOptRegis,
                           optionMulti,
                           format,
                           linecount);
@@ -6707,13 +5483,14 @@ int formatGroupReplace(string& curline,
 
 void OutputCheckGroup(AnimThreadInfo& animthrinfo, const proc& process, nemesis::CondVar<string>* curset)
 {
+    VecStr lineblocks; // working copy of the processed line, reused across lines
+
     for (auto& curstack : curset->rawlist)
     {
         bool uniqueskip          = false;
         bool hasProcess          = false;
         animthrinfo.elementCatch = false;
         string line;
-        VecStr lineblocks;
 
 		if (curstack.nestedcond.size() == 0)
 		{
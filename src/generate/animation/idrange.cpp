@@ -0,0 +1,238 @@
+#include "Global.h"
+
+#include "utilities/atomiclock.h"
+
+#include "generate/animation/idrange.h"
+#include "generate/animation/templatetree.h"
+
+using namespace std;
+
+namespace
+{
+    // placeholders are far above any node ID and unique across the behaviors being generated
+    // 9 digits, so the fragment cache sees them as a node outside of the instance and does not keep the fragment
+    atomic<int> placeholderID{900000000};
+
+    // #0123 -> #0045
+    void ReplaceLineIDs(VecStr& lines, const unordered_map<string, string>& replacement)
+    {
+        for (auto& line : lines)
+        {
+            size_t pos = line.find('#');
+
+            while (pos != NOT_FOUND)
+            {
+                size_t digit = pos + 1;
+
+                while (digit < line.length() && isdigit(static_cast<unsigned char>(line[digit])))
+                {
+                    ++digit;
+                }
+
+                if (digit > pos + 1)
+                {
+                    auto itr = replacement.find(line.substr(pos + 1, digit - pos - 1));
+
+                    if (itr != replacement.end())
+                    {
+                        line.replace(pos + 1, digit - pos - 1, itr->second);
+                        digit = pos + 1 + itr->second.length();
+                    }
+                }
+
+                pos = line.find('#', digit);
+            }
+        }
+    }
+
+    void ReplaceMapIDs(unordered_map<string, string>& IDs, const unordered_map<string, string>& replacement)
+    {
+        for (auto& ID : IDs)
+        {
+            auto itr = replacement.find(ID.second);
+
+            if (itr != replacement.end()) ID.second = itr->second;
+        }
+    }
+}
+
+void nemesis::IDRange::Reserve(int& lastID, size_t count, atomic_flag& lock)
+{
+    Lockless locker(lock);
+
+    if (lastID == 9216) ++lastID;
+
+    base = lastID;
+    next = lastID;
+    end  = lastID + int(count);
+
+    if (base < 9216 && end > 9216) ++end;
+
+    lastID = end;
+
+    if (lastID == 9216) ++lastID;
+}
+
+string nemesis::IDRange::Next()
+{
+    if (next == 9216) ++next;
+
+    if (next < end) return ToString(next++);
+
+    overflowIDs.push_back(to_string(placeholderID++));
+    return overflowIDs.back();
+}
+
+void nemesis::IDRange::Skip(size_t slots)
+{
+    int ID = base + int(slots);
+
+    if (base < 9216 && ID > 9216) ++ID;
+
+    next = max(next, ID);
+}
+
+string nemesis::IDRange::At(size_t slot) const
+{
+    int ID = base + int(slot);
+
+    if (base < 9216 && ID >= 9216) ++ID;
+
+    return ToString(ID);
+}
+
+size_t nemesis::IDRange::Size() const
+{
+    return size_t(end - base - (base < 9216 && end > 9216 ? 1 : 0));
+}
+
+bool nemesis::IDRange::SlotOf(int ID, size_t& slot) const
+{
+    if (ID < base || ID >= end || (ID == 9216 && base < 9216)) return false;
+
+    slot = size_t(ID - base - (base < 9216 && ID > 9216 ? 1 : 0));
+    return true;
+}
+
+bool nemesis::IDRange::Overflowed() const
+{
+    return !overflowIDs.empty();
+}
+
+string nemesis::IDRange::ClaimImport(const string& file, const string& keyword)
+{
+    for (auto& claim : imports)
+    {
+        if (claim.file == file && claim.keyword == keyword) return claim.ID;
+    }
+
+    imports.push_back(ImportClaim{file, keyword, Next()});
+    return imports.back().ID;
+}
+
+void nemesis::IDRange::AddImport(const string& file, const string& keyword, const string& ID)
+{
+    imports.push_back(ImportClaim{file, keyword, ID});
+}
+
+string nemesis::IDRange::ToString(int ID)
+{
+    string strID = to_string(ID);
+
+    if (strID.length() < 4) strID.insert(0, 4 - strID.length(), '0');
+
+    return strID;
+}
+
+unordered_map<string, string> nemesis::ResolveOverflow(const vector<pair<shared_ptr<IDRange>, shared_ptr<VecStr>>>& instances,
+                                                      int& lastID)
+{
+    unordered_map<string, string> replacement;
+
+    for (auto& instance : instances)
+    {
+        if (!instance.first) continue;
+
+        for (auto& placeholder : instance.first->overflowIDs)
+        {
+            if (lastID == 9216) ++lastID;
+
+            replacement[placeholder] = IDRange::ToString(lastID++);
+        }
+
+        if (lastID == 9216) ++lastID;
+    }
+
+    if (replacement.empty()) return replacement;
+
+    // an ID shared through the group's ID map can be another instance's placeholder
+    for (auto& instance : instances)
+    {
+        if (!instance.first) continue;
+
+        for (auto& claim : instance.first->imports)
+        {
+            auto itr = replacement.find(claim.ID);
+
+            if (itr != replacement.end()) claim.ID = itr->second;
+        }
+
+        if (instance.second) ReplaceLineIDs(*instance.second, replacement);
+    }
+
+    return replacement;
+}
+
+void nemesis::ReplaceIDs(master& functionIDs, const unordered_map<string, string>& replacement)
+{
+    if (replacement.empty()) return;
+
+    ReplaceMapIDs(functionIDs.functionIDs, replacement);
+
+    for (auto& curGroup : functionIDs.grouplist)
+    {
+        if (curGroup) ReplaceIDs(*curGroup, replacement);
+    }
+}
+
+void nemesis::ReplaceIDs(group& functionIDs, const unordered_map<string, string>& replacement)
+{
+    if (replacement.empty()) return;
+
+    ReplaceMapIDs(functionIDs.functionIDs, replacement);
+
+    for (auto& curSingle : functionIDs.singlelist)
+    {
+        if (curSingle) ReplaceMapIDs(curSingle->format, replacement);
+    }
+}
+
+void nemesis::ResolveImports(const vector<pair<shared_ptr<IDRange>, shared_ptr<VecStr>>>& instances,
+                             ImportContainer& exportID)
+{
+    for (auto& instance : instances)
+    {
+        if (!instance.first || !instance.second) continue;
+
+        unordered_map<string, string> replacement;
+
+        for (auto& claim : instance.first->imports)
+        {
+            string& kept = exportID[claim.file][claim.keyword];
+
+            if (kept.length() == 0)
+            {
+                kept = claim.ID;
+            }
+            else if (kept != claim.ID)
+            {
+                replacement[claim.ID] = kept;
+            }
+        }
+
+        if (replacement.empty()) continue;
+
+        // the claimed IDs come from the instance's own range so no other node has them
+        ReplaceLineIDs(*instance.second, replacement);
+    }
+}
@@ -4,12 +4,15 @@
 #include "utilities/atomiclock.h"
 #include "utilities/compute.h"
 #include "utilities/conditions.h"
+#include "utilities/lineclassifier.h"
 #include "utilities/stringsplit.h"
 
 #include "generate/alternateanimation.h"
+#include "generate/generationcontext.h"
 
 #include "generate/animation/newanimation.h"
 #include "generate/animation/templatetree.h"
+#include "generate/animation/fragmentcache.h"
 #include "generate/animation/singletemplate.h"
 
 #pragma warning(disable : 4503)
@@ -33,12 +36,26 @@ string linebreakSeparator(string line, VecStr& newlines)
     return line.substr(pos);
 }
 
-bool hasOptionPicked(const vector<unordered_map<string, bool>>& groupOptionPicked, int index, const string& key)
+bool hasOptionPicked(const vector<nemesis::OptionSet>& groupOptionPicked, int index, const string& key)
 {
-    auto& opt  = groupOptionPicked[index];
-    auto& pick = opt.find(key);
+    return groupOptionPicked[index].test(key);
+}
+
+// a cached fragment is not interpreted, so the animations and behaviors its lines refer to are registered here
+// what regisAnim and regisBehavior did when the fragment was generated
+void fragmentRegis(const nemesis::BehaviorReferences& references, const string& behaviorFile)
+{
+    for (auto& clip : references.GetClips())
+    {
+        addUsedAnim(behaviorFile, clip.animationName);
+    }
 
-    return pick != opt.end();
+    for (auto& behavior : references.GetBehaviors())
+    {
+        string behaviorName = nemesis::to_lower_copy(behavior);
+        nemesis::GenerationContext::Current().behaviorJoints.Update(
+            behaviorName, [&](VecStr& joints) { joints.push_back(behaviorFile); });
+    }
 }
 
 NewAnimation::NewAnimation(shared_ptr<unordered_map<string, AnimTemplate>> animlines,
@@ -49,14 +66,11 @@ NewAnimation::NewAnimation(shared_ptr<unordered_map<string, AnimTemplate>> animl
                            AnimationInfo& animationinfo)
 {
     // import registerAnimation information
-    addOn             = animationinfo.addOn;
-    linkedOption      = animationinfo.linkedOption;
+    options           = animationinfo.options;
     optionPicked      = animationinfo.optionPicked;
     optionPickedCount = animationinfo.optionPickedCount;
     addition          = animationinfo.addition;
     groupAddition     = animationinfo.groupAddition;
-    mixOptRegis       = animationinfo.mixOptRegis;
-    mixOptRever       = animationinfo.mixOptRever;
     eventID           = animationinfo.eventID;
     variableID        = animationinfo.variableID;
     hasDuration       = animationinfo.hasDuration;
@@ -87,6 +101,8 @@ void NewAnimation::GetNewAnimationLine(shared_ptr<NewAnimArgs> args)
     newImport      = const_cast<ImportContainer*>(&args->exportID);
     atomicLock     = const_cast<NewAnimLock*>(&args->atomicLock);
     nextFunctionID = args->lastID;
+    idRange        = args->idRange;
+    references     = args->references;
     subFunctionIDs = args->singleFunctionIDs;
 
     bool negative      = false;
@@ -102,7 +118,7 @@ void NewAnimation::GetNewAnimationLine(shared_ptr<NewAnimArgs> args)
         fixedStateID.push_back(ID);
     }
 
-    auto optPickPtr = (std::vector<unordered_map<string, bool>>*) &groupOptionPicked;
+    auto optPickPtr = (std::vector<nemesis::OptionSet>*) &groupOptionPicked;
     optPickPtr->reserve(groupAnimInfo.size());
 
     for (unsigned int i = 0; i < groupAnimInfo.size(); ++i)
@@ -110,7 +126,7 @@ void NewAnimation::GetNewAnimationLine(shared_ptr<NewAnimArgs> args)
         optPickPtr->push_back(groupAnimInfo[i]->optionPicked);
     }
 
-    generatedlines->reserve((*animtemplate)[behaviorFile].size + 10 * memory);
+    generatedlines->reserve((*animtemplate)[behaviorFile].size);
     AnimThreadInfo curAnimInfo(filepath,
                                filename,
                                mainAnimEvent,
@@ -139,14 +155,92 @@ void NewAnimation::GetNewAnimationLine(shared_ptr<NewAnimArgs> args)
                                newImport,
                                groupAddition,
                                groupOptionPicked,
-                               std::vector<std::vector<std::unordered_map<std::string, bool>>>(),
+                               std::vector<std::vector<nemesis::OptionSet>>(),
                                args->subFunctionIDs,
                                generatedlines,
                                this,
                                atomicLock);
-    proc process = (*animtemplate)[behaviorFile].process;
+    curAnimInfo.references = references.get();
+    const proc& process = (*animtemplate)[behaviorFile].process;
+    nemesis::FragmentHash fragmentKey;
+    bool fragmentFound = false;
+    SSMap formatBefore;
+    groupIDs.clear();
+
+    if (args->fragments)
+    {
+        nemesis::AnimFragment placed;
+        FragmentKey(fragmentKey, *args, args->fragments->GetContext());
+        const nemesis::AnimFragment* cached = args->fragments->Find(fragmentKey);
+
+        // same instance in the same template context as a former run, only its node IDs move to this run's ranges
+        bool applies = cached && cached->Relocate(*idRange, args->subFunctionIDs->IDs, placed);
+
+        if (applies && !placed.groupIDs.empty())
+        {
+            Lockless lock(atomicLock->subIDLock);
+            auto& functionIDs = args->subFunctionIDs->functionIDs;
+
+            // an ID another animation of the group registered first is the one this instance would have used
+            for (auto& entry : placed.groupIDs)
+            {
+                auto itr = functionIDs.find(entry.key);
+
+                if (itr != functionIDs.end() && itr->second != entry.value)
+                {
+                    applies = false;
+                    break;
+                }
+            }
+
+            if (applies)
+            {
+                for (auto& entry : placed.groupIDs)
+                {
+                    functionIDs.emplace(entry.key, entry.value);
+                }
+            }
+        }
+
+        if (applies)
+        {
+            idRange->Skip(cached->OwnSlots());
+            fragmentRegis(cached->references, behaviorFile);
+            references->Merge(cached->references);
+
+            for (auto& line : placed.lines)
+            {
+                generatedlines->push_back(move(line));
+            }
+
+            for (auto& entry : placed.format)
+            {
+                subFunctionIDs->format[entry.key] = entry.value;
+            }
+
+            for (auto& entry : placed.existIDs)
+            {
+                IDExist[entry.key] = entry.value;
+            }
 
-    if (args->core)
+            for (auto& each : placed.imports)
+            {
+                idRange->AddImport(each.file, each.keyword, idRange->At(each.slot));
+            }
+
+            fragmentFound = true;
+        }
+        else
+        {
+            formatBefore = subFunctionIDs->format;
+        }
+    }
+
+    if (fragmentFound)
+    {
+        // nothing left to interpret
+    }
+    else if (args->core)
     {
         for (unsigned int i = 0; i < rawtemplate[behaviorFile].size(); ++i)
         {
@@ -170,6 +264,7 @@ void NewAnimation::GetNewAnimationLine(shared_ptr<NewAnimArgs> args)
 
             if (error) throw nemesis::exception();
 
+            references->Track(line);
             generatedlines->push_back(line);
 
             if (elementCatch) elementLine = generatedlines->size() - 1;
@@ -194,7 +289,35 @@ void NewAnimation::GetNewAnimationLine(shared_ptr<NewAnimArgs> args)
                     args->subFunctionIDs);
     }
 
-    for (auto it = addOn.begin(); it != addOn.end(); ++it)
+    if (args->fragments && !fragmentFound)
+    {
+        nemesis::AnimFragment fragment;
+        vector<pair<string, string>> formatAdded;
+
+        for (auto& entry : subFunctionIDs->format)
+        {
+            auto itr = formatBefore.find(entry.first);
+
+            if (itr == formatBefore.end() || itr->second != entry.second) formatAdded.push_back(entry);
+        }
+
+        if (nemesis::AnimFragment::Capture(*generatedlines,
+                                           formatAdded,
+                                           groupIDs,
+                                           vector<pair<string, string>>(IDExist.begin(), IDExist.end()),
+                                           *idRange,
+                                           args->subFunctionIDs->IDs,
+                                           *references,
+                                           args->fragments->GetFloorID(),
+                                           fragment))
+        {
+            args->fragments->Add(fragmentKey, move(fragment));
+        }
+    }
+
+    const AnimOptionData& animOptions = AnimOptionData::Of(options);
+
+    for (auto it = animOptions.addOn.begin(); it != animOptions.addOn.end(); ++it)
     {
         for (auto& elementName : it->second)
         {
@@ -208,9 +331,11 @@ void NewAnimation::GetNewAnimationLine(shared_ptr<NewAnimArgs> args)
             }
             else
             {
-                if (mixOptRegis[it->first].length() != 0)
+                auto mixed = animOptions.mixOptRegis.find(it->first);
+
+                if (mixed != animOptions.mixOptRegis.end() && mixed->second.length() != 0)
                 {
-                    optionName = mixOptRegis[it->first];
+                    optionName = mixed->second;
 
                     for (int k = 0; k < optionPickedCount[optionName]; ++k)
                     {
@@ -306,9 +431,9 @@ VecStr NewAnimation::GetVariableID()
     return variableID;
 }
 
-SSMap NewAnimation::GetMixOpt()
+const SSMap& NewAnimation::GetMixOpt()
 {
-    return mixOptRegis;
+    return AnimOptionData::Of(options).mixOptRegis;
 }
 
 vector<shared_ptr<AnimationInfo>> NewAnimation::GetGroupAnimInfo()
@@ -328,18 +453,35 @@ unordered_map<string, unordered_map<string, VecStr>> NewAnimation::GetGroupAddit
 
 string NewAnimation::newID()
 {
-    Lockless lock(atomicLock->nodeIDLock);
-    int& refID   = *nextFunctionID;
-    string strID = to_string(refID++);
+    return idRange->Next();
+}
 
-    while (strID.length() < 4)
-    {
-        strID = "0" + strID;
-    }
+string NewAnimation::importID(const string& file, const string& keyword)
+{
+    return idRange->ClaimImport(file, keyword);
+}
 
-    if (refID == 9216) ++refID;
+void NewAnimation::groupIDRegis(const string& oldID, const string& ID)
+{
+    groupIDs.emplace_back(oldID, ID);
+}
+
+void NewAnimation::FragmentKey(nemesis::FragmentHash& key, const NewAnimArgs& args, uint64_t context) const
+{
+    uint64_t durationBits;
+    memcpy(&durationBits, &duration, sizeof(durationBits));
 
-    return strID;
+    key.Add(context).Add(uint64_t(args.core)).Add(args.stateID).Add(format);
+    key.Add(filepath).Add(filename).Add(mainAnimEvent).Add(eventID).Add(variableID);
+    key.Add(uint64_t(order)).Add(uint64_t(lastOrder)).Add(uint64_t(furnitureCount));
+    key.Add(uint64_t(hasDuration)).Add(durationBits).Add(uint64_t(known));
+    key.Add(optionPickedCount).Add(addition).Add(groupAddition).Add(AnimObject);
+    key.Add(uint64_t(groupAnimInfo.size()));
+
+    for (auto& info : groupAnimInfo)
+    {
+        key.Add(*info);
+    }
 }
 
 void NewAnimation::addGroupAnimInfo(vector<shared_ptr<AnimationInfo>> animInfo)
@@ -365,7 +507,7 @@ void NewAnimation::storeAnimObject(VecStr animobjects, string listFilename, int
             ErrorMessage(1144, listFilename, linecount);
         }
 
-        optionPicked["AnimObject/" + to_string(temp)] = true;
+        optionPicked.set("AnimObject/" + to_string(temp));
         AnimObject[temp].push_back(ObjectName);
     }
 }
@@ -435,6 +577,26 @@ int NewAnimation::getNextID(string behavior)
     return IDUsed;
 }
 
+size_t NewAnimation::getIDDemand(const string& behavior, bool core)
+{
+    if (core) return size_t(getNextID(behavior));
+
+    auto itr = animtemplate->find(behavior);
+    return itr != animtemplate->end() ? itr->second.process.idDemand : 0;
+}
+
+size_t NewAnimation::getGroupIDDemand(const string& behavior)
+{
+    auto itr = animtemplate->find(behavior);
+    return itr != animtemplate->end() ? itr->second.process.groupIDSlots.size() : 0;
+}
+
+bool NewAnimation::isReplayable(const string& behavior)
+{
+    auto itr = animtemplate->find(behavior);
+    return itr != animtemplate->end() && itr->second.process.replayable;
+}
+
 bool NewAnimation::isLast()
 {
     return isLastOrder;
@@ -517,315 +679,37 @@ void NewAnimation::multiChoice(string& line, VecStr& storeline, int numline, Ani
     }
 }
 
-bool NewAnimation::singleCondition(string condition, VecStr& storeline, int numline, AnimationUtility utility)
-{
-    if (condition.find("<") == 0
-        && (condition.find(">") == condition.length() - 1 || condition.find(">*") == condition.length() - 2)
-        && (condition.find("!=") != NOT_FOUND || condition.find("==") != NOT_FOUND))
-    {
-        return specialCondition(condition, storeline, numline, utility);
-    }
-    else
-    {
-        bool isNot            = false;
-        string conditionOrder = condition;
-
-        if (conditionOrder[0] == '!')
-        {
-            isNot          = true;
-            conditionOrder = conditionOrder.substr(1);
-        }
-
-        return conditionProcess(conditionOrder, isNot, numline, utility);
-    }
-}
-
-bool NewAnimation::andLoop(string condition, VecStr& storeline, int numline, AnimationUtility utility)
-{
-    size_t lastpos = 0;
-    string nextCondition;
-
-    while (condition.find("&", lastpos) != NOT_FOUND)
-    {
-        string nextCondition = condition.substr(lastpos);
-        size_t c_or          = 0;
-        size_t backB         = 0;
-
-        for (unsigned int i = 0; i < nextCondition.size(); ++i)
-        {
-            if (nextCondition[i] == '(')
-                ++c_or;
-            else if (nextCondition[i] == ')')
-                --c_or;
-
-            if (nextCondition[i] == '&' && c_or == 0)
-            {
-                backB = i;
-                break;
-            }
-        }
-
-        if (nextCondition[backB] != '&') break;
-
-        nextCondition = nextCondition.substr(0, backB);
-
-        // bool1 & (bool2 | bool3) & bool4 | bool5...
-        // --------^
-        if (nextCondition[0] == '(')
-        {
-            c_or  = 0;
-            backB = nextCondition.size() - 1;
-
-            for (unsigned int i = 0; i < nextCondition.size(); ++i)
-            {
-                if (nextCondition[i] == '(')
-                {
-                    ++c_or;
-                }
-                else if (nextCondition[i] == ')')
-                {
-                    --c_or;
-                }
-
-                if ((nextCondition[i] == '&') && c_or == 0)
-                {
-                    backB = i;
-                    break;
-                }
-            }
-
-            if (c_or != 0) ErrorMessage(1106, format, behaviorFile, numline, utility.originalCondition);
-
-            if (!newCondition(nextCondition.substr(1, backB - 1), storeline, numline, utility)) return false;
-
-            lastpos = condition.find("&", backB + 1);
-
-            if (lastpos != NOT_FOUND) ++lastpos;
-        }
-        else
-        {
-            if (!singleCondition(nextCondition, storeline, numline, utility)) return false;
-
-            lastpos = condition.find("&", lastpos) + 1;
-        }
-    }
-
-    nextCondition = condition.substr(lastpos);
-
-    if (nextCondition[0] == '(')
-    {
-        size_t c_or  = 0;
-        size_t backB = 0;
-
-        for (unsigned int i = 0; i < nextCondition.size(); ++i)
-        {
-            if (nextCondition[i] == '(')
-            {
-                ++c_or;
-            }
-            else if (nextCondition[i] == ')')
-            {
-                --c_or;
-
-                if (c_or == 0)
-                {
-                    backB = i;
-                    break;
-                }
-            }
-        }
-
-        if (c_or != 0) ErrorMessage(1106, format, behaviorFile, numline, utility.originalCondition);
-
-        return newCondition(nextCondition.substr(1, backB - 1), storeline, numline, utility);
-    }
-    else
-    {
-        return singleCondition(nextCondition, storeline, numline, utility);
-    }
-}
-
-bool NewAnimation::andOrParenthesis(
-    size_t c_and, size_t c_or, string condition, VecStr& storeline, int numline, AnimationUtility utility)
+bool NewAnimation::newCondition(const string& condition,
+                                VecStr& storeline,
+                                int numline,
+                                const AnimationUtility& utility)
 {
-    size_t parent = condition.find("(");
+    auto& expr = nemesis::ConditionExpr::Get(condition, format, behaviorFile, numline, utility.originalCondition);
+    nemesis::ConditionExpr::Signature signature;
 
-    // PARENT not exist / PARENT after OR
-    // bool1 | (bool2 & bool3)...
-    // ------^
-    if (parent == NOT_FOUND || parent > c_or)
-    {
-        // bool1 & bool2 | (bool3...
-        // ^-----------^
-        string conditionGroup = condition.substr(0, c_or);
-
-        // bool1 & bool2 | (bool3...
-        //				   ^----->
-        string nextCondition = condition.substr(c_or + 1);
-
-        // bool1 & bool2 | bool3... (AND before OR)
-        // --------------^------>
-        if (c_and < c_or)
-            return andLoop(conditionGroup, storeline, numline, utility)
-                   || newCondition(nextCondition, storeline, numline, utility);
-
-        // bool1 | bool2 & bool3... (AND after OR)
-        // ------^-------------->
-        else
-            return singleCondition(conditionGroup, storeline, numline, utility)
-                   || newCondition(nextCondition, storeline, numline, utility);
-    }
+    if (expr.CanRemember()) OptionSignature(signature, utility);
 
-    // PARENT before OR
-    // bool1 & (bool2 | bool3) & bool4 | bool5...
-    // --------^
-    else
-        return andParenthesis(condition, storeline, numline, utility);
+    return expr.Evaluate(signature, [&](const nemesis::ConditionExpr::Operand& operand) {
+        return operand.isComparison ? specialCondition(operand, storeline, numline, utility)
+                                    : conditionProcess(operand, numline, utility);
+    });
 }
 
-bool NewAnimation::andParenthesis(string condition, VecStr& storeline, int numline, AnimationUtility utility)
+void NewAnimation::OptionSignature(nemesis::ConditionExpr::Signature& signature,
+                                   const AnimationUtility& utility) const
 {
-    size_t c_or  = 0;
-    size_t inner = 0;
+    signature << format << uint64_t(order) << uint64_t(lastOrder) << uint64_t(isLastOrder)
+              << uint64_t(utility.animMulti) << uint64_t(groupAnimInfo.size());
 
-    for (unsigned int i = 0; i < condition.length(); ++i)
+    for (auto& curOption : groupOptionPicked)
     {
-        if (condition[i] == '(')
-        {
-            ++c_or;
-        }
-        else if (condition[i] == ')')
-        {
-            --c_or;
-        }
-
-        if (c_or == 0)
-        {
-            if (i + 1 == condition.length())
-            {
-                inner = i + 1;
-                break;
-            }
-            else if (condition[i + 1] == '|')
-            {
-                inner = i;
-                break;
-            }
-        }
+        signature << curOption;
     }
 
-    if (c_or != 0) ErrorMessage(1106, format, behaviorFile, numline, utility.originalCondition);
-
-    // ... & (bool1 | bool2) & bool3 | (bool4 & ...
-    //		 ^---------------------^
-    string conditionGroup = condition.substr(0, inner);
-
-    // ... & (bool1 | bool2) & bool3
-    // -----------------------------
-    if (inner == condition.length()) return andLoop(conditionGroup, storeline, numline, utility);
-
-    // ... & (bool1 | bool2) & bool3 | bool4...
-    // ------------------------------^
-    else
-    {
-        // ... & (bool1 | bool2) & bool3 | bool4...
-        // ----------------------------^
-        return newCondition(conditionGroup, storeline, numline, utility) ||
-
-               // ... & (bool1 | bool2) & bool3 | bool4...
-               //								   ^----->
-               newCondition(condition.substr(inner + 2), storeline, numline, utility);
-    }
-}
-
-bool NewAnimation::newCondition(string condition,
-                                VecStr& storeline,
-                                int numline,
-                                AnimationUtility utility)
-{
-    if (condition[0] == '(')
-    {
-        if (condition.find(")") == NOT_FOUND
-            || count(condition.begin(), condition.end(), '(')
-                   != count(condition.begin(), condition.end(), ')'))
-        {
-            ErrorMessage(1105, format, behaviorFile, numline);
-        }
-
-        size_t c_and = 0;
-        size_t c_or  = 0;
-        size_t backB = 0;
-
-        for (unsigned int i = 0; i < condition.size(); ++i)
-        {
-            if (condition[i] == '(')
-            {
-                ++c_or;
-            }
-            else if (condition[i] == ')')
-            {
-                --c_or;
-
-                if (c_or == 0)
-                {
-                    backB = i - 1;
-                    break;
-                }
-            }
-        }
-
-        // (bool1 & bool2) | bool3 ...
-        // --------------^
-        string inHouse     = condition.substr(1, backB);
-        bool inHouseResult = newCondition(inHouse, storeline, numline, utility);
-
-        if (error) throw nemesis::exception();
-
-        if (backB + 2 >= condition.length()) return inHouseResult;
-
-        string outHouse = condition.substr(backB + 2);
-
-        if (outHouse.length() == 0 || (outHouse[0] != '|' && outHouse[0] != '&'))
-        {
-            ErrorMessage(1106, format, behaviorFile, numline, utility.originalCondition);
-        }
-
-        // ... | (bool1 & bool2)...
-        // ----^
-        if (outHouse[0] == '|')
-            return inHouseResult || newCondition(outHouse.substr(1), storeline, numline, utility);
-
-        // ... & (bool1 | bool2)...
-        // ----^
-        else
-            return inHouseResult && newCondition(outHouse.substr(1), storeline, numline, utility);
-    }
-    else
+    for (auto& animInfo : groupAnimInfo)
     {
-        size_t c_and = condition.find("&");
-        size_t c_or  = condition.find("|");
-
-        if (c_and == NOT_FOUND)
-        {
-            // AND & OR not exist
-            if (c_or == NOT_FOUND) return singleCondition(condition, storeline, numline, utility);
-
-            // OR exist but not AND
-            else
-                return singleCondition(condition.substr(0, c_or), storeline, numline, utility)
-                       || newCondition(condition.substr(c_or + 1), storeline, numline, utility);
-        }
-
-        // AND exist but not OR
-        else if (c_or == NOT_FOUND)
-            return andLoop(condition, storeline, numline, utility);
-
-        // AND & OR exist
-        else
-            return andOrParenthesis(c_and, c_or, condition, storeline, numline, utility);
+        signature << animInfo->groupOption;
     }
-
-    return false;
 }
 
 void NewAnimation::processing(string& line,
@@ -1635,10 +1519,10 @@ void NewAnimation::processing(string& line,
             {
                 addOnReplacer(change,
                               behaviorFile,
-                              addOn,
+                              AnimOptionData::Of(options).addOn,
                               addition,
                               groupAddition,
-                              mixOptRegis,
+                              AnimOptionData::Of(options).mixOptRegis,
                               optionMulti,
                               masterFormat,
                               linecount);
@@ -1778,16 +1662,22 @@ void NewAnimation::processing(string& line,
                     }
 
                     Lockless_s lock(atomicLock->exportLock);
+                    auto fileitr = newImport->find(file);
 
-                    if ((*newImport)[file][keyword].length() > 0)
+                    if (fileitr != newImport->end())
                     {
-                        tempID = (*newImport)[file][keyword];
+                        auto keyitr = fileitr->second.find(keyword);
+
+                        if (keyitr != fileitr->second.end()) tempID = keyitr->second;
                     }
-                    else
+
+                    lock.Unlock();
+
+                    // imports created in this phase are registered once every instance is done
+                    if (tempID.length() == 0)
                     {
-                        tempID                      = newID();
-                        IDExist[importer]           = tempID;
-                        (*newImport)[file][keyword] = tempID;
+                        tempID            = importID(file, keyword);
+                        IDExist[importer] = tempID;
                     }
 
                     change.replace(nextpos, importer.length(), tempID);
@@ -1855,12 +1745,40 @@ void NewAnimation::processing(string& line,
     }
 }
 
+namespace
+{
+    // the add-on data can be shared between threads, so reading it must not insert anything
+    const string& AdditionOf(const ImportContainer& addition, const string& option, const string& name)
+    {
+        static const string none;
+        auto header = addition.find(option);
+
+        if (header == addition.end()) return none;
+
+        auto itr = header->second.find(name);
+        return itr != header->second.end() ? itr->second : none;
+    }
+
+    const VecStr& GroupAdditionOf(const unordered_map<string, unordered_map<string, VecStr>>& groupAddition,
+                                  const string& option,
+                                  const string& name)
+    {
+        static const VecStr none;
+        auto header = groupAddition.find(option);
+
+        if (header == groupAddition.end()) return none;
+
+        auto itr = header->second.find(name);
+        return itr != header->second.end() ? itr->second : none;
+    }
+} // namespace
+
 void addOnReplacer(string& line,
                    string filename,
-                   unordered_map<string, VecStr> addOn,
-                   ImportContainer addition,
-                   unordered_map<string, unordered_map<string, VecStr>> groupAddition,
-                   SSMap mixOpt,
+                   const unordered_map<string, VecStr>& addOn,
+                   const ImportContainer& addition,
+                   const unordered_map<string, unordered_map<string, VecStr>>& groupAddition,
+                   const SSMap& mixOpt,
                    uint optionMulti,
                    string format,
                    int numline)
@@ -1878,26 +1796,26 @@ void addOnReplacer(string& line,
                 {
                     size_t pos = line.find(add, 0);
 
-                    if (groupAddition[it->first][it->second[j]].size() == 0 || optionMulti == -1)
+                    if (GroupAdditionOf(groupAddition, it->first, it->second[j]).size() == 0 || optionMulti == -1)
                     {
-                        if (addition[it->first][it->second[j]].length() == 0)
+                        if (AdditionOf(addition, it->first, it->second[j]).length() == 0)
                         {
                             ErrorMessage(1117, format + "_group", filename, numline, line);
                         }
 
-                        line.replace(pos, add.length(), addition[it->first][it->second[j]]);
+                        line.replace(pos, add.length(), AdditionOf(addition, it->first, it->second[j]));
                     }
                     else
                     {
-                        if (int(groupAddition[it->first][it->second[j]].size()) > optionMulti)
+                        if (int(GroupAdditionOf(groupAddition, it->first, it->second[j]).size()) > optionMulti)
                         {
-                            if (groupAddition[it->first][it->second[j]][optionMulti].length() == 0)
+                            if (GroupAdditionOf(groupAddition, it->first, it->second[j])[optionMulti].length() == 0)
                             {
                                 ErrorMessage(1117, format + "_group", filename, numline, line);
                             }
 
                             line.replace(
-                                pos, add.length(), groupAddition[it->first][it->second[j]][optionMulti]);
+                                pos, add.length(), GroupAdditionOf(groupAddition, it->first, it->second[j])[optionMulti]);
                         }
                         else
                         {
@@ -1914,29 +1832,30 @@ void addOnReplacer(string& line,
 
                 for (int i = 0; i < counter; ++i)
                 {
-                    string option = mixOpt[it->first];
+                    auto mixed    = mixOpt.find(it->first);
+                    string option = mixed != mixOpt.end() ? mixed->second : "";
                     size_t pos    = line.find(add, 0);
 
-                    if (groupAddition[option][it->second[j]].size() == 0 || optionMulti == -1)
+                    if (GroupAdditionOf(groupAddition, option, it->second[j]).size() == 0 || optionMulti == -1)
                     {
-                        if (addition[option][it->second[j]].length() == 0)
+                        if (AdditionOf(addition, option, it->second[j]).length() == 0)
                         {
                             ErrorMessage(1117, format + "_group", filename, numline, line);
                         }
 
-                        line.replace(pos, add.length(), addition[option][it->second[j]]);
+                        line.replace(pos, add.length(), AdditionOf(addition, option, it->second[j]));
                     }
                     else
                     {
-                        if (int(groupAddition[option][it->second[j]].size()) > optionMulti)
+                        if (int(GroupAdditionOf(groupAddition, option, it->second[j]).size()) > optionMulti)
                         {
-                            if (groupAddition[option][it->second[j]][optionMulti].length() == 0)
+                            if (GroupAdditionOf(groupAddition, option, it->second[j])[optionMulti].length() == 0)
                             {
                                 ErrorMessage(1117, format + "_group", filename, numline, line);
                             }
 
                             line.replace(
-                                pos, add.length(), groupAddition[option][it->second[j]][optionMulti]);
+                                pos, add.length(), GroupAdditionOf(groupAddition, option, it->second[j])[optionMulti]);
                         }
                         else
                         {
@@ -2064,9 +1983,9 @@ void NewAnimation::stateReplacer(
 bool NewAnimation::addOnConverter(
     int& optionMulti, int& endMulti, VecStr& optionInfo, shared_ptr<AnimationInfo> animInfo, bool second)
 {
-    unordered_map<string, VecStr>* addOnPtr = &animInfo->addOn;
+    const unordered_map<string, VecStr>* addOnPtr = &animInfo->GetOptions().addOn;
 
-    if (addOnPtr->find(optionInfo[2]) != addOnPtr->end() && (*addOnPtr)[optionInfo[2]].size() > 0)
+    if (addOnPtr->find(optionInfo[2]) != addOnPtr->end() && addOnPtr->at(optionInfo[2]).size() > 0)
     {
         unordered_map<string, VecStr>* groupAdditionPtr = &animInfo->groupAddition[optionInfo[2]];
 
@@ -2277,12 +2196,15 @@ VecStr GetOptionInfo(string line,
         {
             string option = optionInfo[2].substr(0, optionInfo[2].length() - 1);
 
-            if (groupAnimInfo[stoi(optionInfo[1])]->mixOptRegis[option].length() == 0)
+            const SSMap& mixOpt = groupAnimInfo[stoi(optionInfo[1])]->GetOptions().mixOptRegis;
+            auto mixed          = mixOpt.find(option);
+
+            if (mixed == mixOpt.end() || mixed->second.length() == 0)
             {
                 ErrorMessage(1109, format, filename, numline, line);
             }
 
-            optionInfo[2] = groupAnimInfo[stoi(optionInfo[1])]->mixOptRegis[option];
+            optionInfo[2] = mixed->second;
         }
 
         if (error) throw nemesis::exception();
@@ -2342,12 +2264,15 @@ VecStr GetOptionInfo(string line,
         {
             string option = line.substr(0, line.length() - 1);
 
-            if (groupAnimInfo[stoi(optionInfo[1])]->mixOptRegis[option].length() == 0)
+            const SSMap& mixOpt = groupAnimInfo[stoi(optionInfo[1])]->GetOptions().mixOptRegis;
+            auto mixed          = mixOpt.find(option);
+
+            if (mixed == mixOpt.end() || mixed->second.length() == 0)
             {
                 ErrorMessage(1109, format, filename, numline, line);
             }
 
-            optionInfo.push_back(groupAnimInfo[stoi(optionInfo[1])]->mixOptRegis[option]);
+            optionInfo.push_back(mixed->second);
         }
         else
         {
@@ -2377,77 +2302,30 @@ int numDigits(T number)
 }
 
 bool clearGroupNum(string option2,
-                   const unordered_map<string, bool>& optionPicked,
+                   const nemesis::OptionSet& optionPicked,
                    bool isNot,
-                   const unordered_map<string, bool>& groupOption)
+                   const nemesis::OptionSet& groupOption)
 {
     string templine = nemesis::regex_replace(
         string(option2), nemesis::regex("[^A-Za-z\\s]*([A-Za-z\\s]+).*"), string("\\1"));
 
-    auto grpopt = groupOption.find(templine);
-
-    if (grpopt != groupOption.end()) return isNot;
+    if (groupOption.test(templine)) return isNot;
 
-    auto& pick = optionPicked.find(templine);
-
-    return isNot ? pick == optionPicked.end() : pick != optionPicked.end();
+    return optionPicked.test(templine) != isNot;
 }
 
-bool NewAnimation::specialCondition(string condition,
+bool NewAnimation::specialCondition(const nemesis::ConditionExpr::Operand& condition,
                                     VecStr& storeline,
                                     int linecount,
-                                    AnimationUtility utility)
+                                    const AnimationUtility& utility)
 {
-    bool isNot;
-    size_t pos;
-
-    if (condition.find("!=") != NOT_FOUND)
-    {
-        if (condition.find("==") != NOT_FOUND || sameWordCount(condition, "!=") > 1)
-        {
-            ErrorMessage(1124, format, behaviorFile, linecount, utility.originalCondition);
-        }
-
-        isNot = true;
-        pos   = condition.find("!=");
-    }
-    else if (condition.find("==") != NOT_FOUND)
-    {
-        if (condition.find("!=") != NOT_FOUND || sameWordCount(condition, "==") > 1)
-        {
-            ErrorMessage(1124, format, behaviorFile, linecount, utility.originalCondition);
-        }
-
-        isNot = false;
-        pos   = condition.find("==");
-    }
-    else
-    {
-        ErrorMessage(1125, format, behaviorFile, linecount, utility.originalCondition);
-    }
-
-    bool oneTime;
-    string oriCondition1 = condition.substr(1, pos - 1);
-    string oriCondition2 = condition.substr(pos + 2);
+    bool isNot                  = condition.isNot;
+    bool oneTime                = condition.oneTime;
+    const string& oriCondition1 = condition.left;
+    const string& oriCondition2 = condition.right;
     VecStr optionInfo1;
     VecStr optionInfo2;
 
-    // <optionA != optionB>*
-    // only need to fulfill the condition once
-    if (condition.back() == '*')
-    {
-        oneTime = true;
-        oriCondition2.pop_back();
-        oriCondition2.pop_back();
-    }
-    else
-    {
-        oneTime = false;
-        oriCondition2.pop_back();
-    }
-
-    if (error) throw nemesis::exception();
-
     if (oriCondition1.length() > 0)
     {
         optionInfo1 = GetOptionInfo(
@@ -2611,7 +2489,7 @@ bool NewAnimation::specialCondition(string condition,
 
                         if (error) throw nemesis::exception();
 
-                        if (condition.length() == 0) ErrorMessage(1172, format, behaviorFile, linecount);
+                        if (condition.text.length() == 0) ErrorMessage(1172, format, behaviorFile, linecount);
                     }
 
                     if (condition2.length() != 0)
@@ -2636,7 +2514,7 @@ bool NewAnimation::specialCondition(string condition,
                             condition2 = history2[animMulti2][optionMulti1];
                         }
 
-                        if (condition.length() == 0) ErrorMessage(1172, format, behaviorFile, linecount);
+                        if (condition.text.length() == 0) ErrorMessage(1172, format, behaviorFile, linecount);
                     }
 
                     condlist1.insert(condition1);
@@ -2675,11 +2553,11 @@ bool NewAnimation::specialCondition(string condition,
     return true;
 }
 
-bool NewAnimation::conditionProcess(string condition,
-                                    bool isNot,
+bool NewAnimation::conditionProcess(const nemesis::ConditionExpr::Operand& operand,
                                     int numline,
-                                    AnimationUtility utility)
+                                    const AnimationUtility& utility)
 {
+    const string& condition = operand.text;
     VecStr optionInfo;
 
     if (condition.find(format + "[][") != NOT_FOUND)
@@ -2712,7 +2590,7 @@ bool NewAnimation::conditionProcess(string condition,
                                            order,
                                            utility.animMulti);
 
-            conditionResult = GetFirstCondition(condition, optionInfo, numline, isNot);
+            conditionResult = GetFirstCondition(operand, optionInfo, numline);
             ++formatGroup;
 
             if (error) throw nemesis::exception();
@@ -2742,7 +2620,7 @@ bool NewAnimation::conditionProcess(string condition,
                                                              order,
                                                              utility.animMulti);
 
-        return GetFirstCondition(condition, optionInfo, numline, isNot);
+        return GetFirstCondition(operand, optionInfo, numline);
 
         if (error) throw nemesis::exception();
     }
@@ -2750,11 +2628,13 @@ bool NewAnimation::conditionProcess(string condition,
     return true;
 }
 
-bool NewAnimation::GetFirstCondition(string firstCondition,
-                                     VecStr optionInfo,
-                                     int numline,
-                                     bool isNot)
+bool NewAnimation::GetFirstCondition(const nemesis::ConditionExpr::Operand& operand,
+                                     const VecStr& optionInfo,
+                                     int numline)
 {
+    const string& firstCondition = operand.text;
+    bool isNot                   = operand.isNot;
+
     if (optionInfo[2][0] == '^' && optionInfo[2].back() == '^')
     {
         string conditionOrder;
@@ -2791,10 +2671,9 @@ bool NewAnimation::GetFirstCondition(string firstCondition,
     }
     else
     {
-        auto& opt  = groupOptionPicked[stoi(optionInfo[1])];
-        auto& pick = opt.find(optionInfo[2]);
+        auto& opt = groupOptionPicked[stoi(optionInfo[1])];
 
-        if (pick != opt.end())
+        if (operand.TestOption(opt, optionInfo[2]))
         {
             return !isNot;
         }
@@ -2815,12 +2694,12 @@ void NewAnimation::addAnimData(unordered_map<string, unordered_map<string, AnimT
     animdatatemplate = animdata;
 }
 
-//void NewAnimation::addAnimSetData(unordered_map<string, map<string, VecStr, alphanum_less>> animsetdata)
+//void NewAnimation::addAnimSetData(unordered_map<string, nemesis::NaturalMap<VecStr>> animsetdata)
 //{
 //	asdlines = animsetdata;
 //}
 
-void NewAnimation::addAnimSetData(unordered_map<string, map<string, AnimTemplate, alphanum_less>> animsetdata)
+void NewAnimation::addAnimSetData(unordered_map<string, nemesis::NaturalMap<AnimTemplate>> animsetdata)
 {
     asdtemplate = animsetdata;
 }
@@ -2828,7 +2707,7 @@ void NewAnimation::addAnimSetData(unordered_map<string, map<string, AnimTemplate
 void NewAnimation::GetAnimData(unordered_map<string, map<string, VecStr>>& newAnimDataLines)
 {
     unordered_map<int, bool> IsConditionOpened;
-    auto optPickPtr = (std::vector<unordered_map<string, bool>>*) &groupOptionPicked;
+    auto optPickPtr = (std::vector<nemesis::OptionSet>*) &groupOptionPicked;
     optPickPtr->clear();
     optPickPtr->reserve(groupAnimInfo.size());
 
@@ -2881,10 +2760,10 @@ void NewAnimation::GetAnimData(unordered_map<string, map<string, VecStr>>& newAn
     return;
 }
 
-void NewAnimation::GetAnimSetData(unordered_map<string, map<string, VecStr, alphanum_less>>& newASDLines)
+void NewAnimation::GetAnimSetData(unordered_map<string, nemesis::NaturalMap<VecStr>>& newASDLines)
 {
     unordered_map<int, bool> IsConditionOpened;
-    vector<unordered_map<string, bool>> groupOptionPicked;
+    vector<nemesis::OptionSet> groupOptionPicked;
     groupOptionPicked.reserve(groupAnimInfo.size());
 
     for (uint i = 0; i < groupAnimInfo.size(); ++i)
@@ -2931,7 +2810,7 @@ void NewAnimation::AnimDataLineProcess(VecStr originallines,
 
     unordered_map<int, bool> IsConditionOpened;
     VecStr recorder;
-    newlines.reserve(originallines.size() + 10 * memory);
+    newlines.reserve(originallines.size());
     bool skip         = false; // mainly used by NEW
     bool freeze       = false; // mainly used by CONDITION to freeze following CONDITION
     bool open         = false;
@@ -3078,7 +2957,7 @@ void NewAnimation::AnimDataLineProcess(VecStr originallines,
 
                     if (optionInfo[2] != "AnimObject")
                     {
-                        if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked[optionInfo[2]])
+                        if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked.test(optionInfo[2]))
                         {
                             if (isNot)
                                 skip = true;
@@ -3094,7 +2973,7 @@ void NewAnimation::AnimDataLineProcess(VecStr originallines,
                                                          nemesis::regex("[^A-Za-z\\s]*([A-Za-z\\s]+).*"),
                                                          string("\\1"));
 
-                            if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked[templine])
+                            if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked.test(templine))
                             {
                                 if (isNot)
                                     skip = true;
@@ -3109,7 +2988,7 @@ void NewAnimation::AnimDataLineProcess(VecStr originallines,
                                 // animobject bypass
                                 if (previous == "AnimObject/" + ID)
                                 {
-                                    if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked[previous])
+                                    if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked.test(previous))
                                     {
                                         if (isNot)
                                             skip = true;
@@ -3728,7 +3607,7 @@ void NewAnimation::AnimDataLineProcess(AnimTemplate* originaltemplate,
     int openRange   = 0;
     size_t elementLine;
 
-    generatedlines->reserve(originaltemplate->size + 10 * memory);
+    generatedlines->reserve(originaltemplate->size);
 
     ID tmpId;
     ID tmpId2;
@@ -3761,7 +3640,7 @@ void NewAnimation::AnimDataLineProcess(AnimTemplate* originaltemplate,
                                newImport,
                                groupAddition,
                                groupOptionPicked,
-                               std::vector<std::vector<std::unordered_map<std::string, bool>>>(),
+                               std::vector<std::vector<nemesis::OptionSet>>(),
                                nullptr,
                                generatedlines,
                                this,
@@ -3789,7 +3668,7 @@ void NewAnimation::AnimDataLineProcess(AnimTemplate* originaltemplate,
 void NewAnimation::existingASDProcess(VecStr ASDLines, map<int, VecStr>& extract, vector<int> ASD)
 {
     unordered_map<int, bool> IsConditionOpened;
-    auto optPickPtr = (std::vector<unordered_map<string, bool>>*) &groupOptionPicked;
+    auto optPickPtr = (std::vector<nemesis::OptionSet>*) &groupOptionPicked;
     optPickPtr->reserve(groupAnimInfo.size());
 
     for (unsigned int i = 0; i < groupAnimInfo.size(); ++i)
@@ -3814,7 +3693,7 @@ void NewAnimation::existingASDProcess(VecStr ASDLines, map<int, VecStr>& extract
     IsConditionOpened[0] = true;
 
     VecStr newlines;
-    newlines.reserve(ASDLines.size() + 10 * memory);
+    newlines.reserve(ASDLines.size());
     string line;
 
     for (uint i = 0; i < ASDLines.size(); ++i)
@@ -3976,7 +3855,7 @@ void NewAnimation::existingASDProcess(VecStr ASDLines, map<int, VecStr>& extract
 
                         if (optionInfo[2] != "AnimObject")
                         {
-                            if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked[optionInfo[2]])
+                            if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked.test(optionInfo[2]))
                             {
                                 if (isNot)
                                     skip = true;
@@ -3992,7 +3871,7 @@ void NewAnimation::existingASDProcess(VecStr ASDLines, map<int, VecStr>& extract
                                                              nemesis::regex("[^A-Za-z\\s]*([A-Za-z\\s]+).*"),
                                                              string("\\1"));
 
-                                if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked[templine])
+                                if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked.test(templine))
                                 {
                                     if (isNot)
                                         skip = true;
@@ -4007,7 +3886,7 @@ void NewAnimation::existingASDProcess(VecStr ASDLines, map<int, VecStr>& extract
                                     // animobject bypass
                                     if (previous == "AnimObject/" + ID)
                                     {
-                                        if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked[previous])
+                                        if (groupAnimInfo[stoi(optionInfo[1])]->optionPicked.test(previous))
                                         {
                                             if (isNot)
                                                 skip = true;
@@ -4993,13 +4872,14 @@ void NewAnimation::OutputCheck(shared_ptr<VecStr> generatedlines,
                                int optionMulti,
                                int animMulti)
 {
+    VecStr lineblocks; // working copy of the processed line, reused across lines
+
     for (auto& curstack : curset->rawlist)
     {
         bool uniqueskip = false;
         bool hasProcess = false;
         elementCatch    = false;
         string line;
-        VecStr lineblocks;
 
         if (curstack.nestedcond.size() == 0)
         {
@@ -5314,16 +5194,17 @@ void NewAnimation::hasProcessing(string& line,
         }
     }
 
+    nemesis::LineClass lineClass = nemesis::ClassifyLine(line);
+
     // compute numelements
-    if (line.find("<hkparam name=\"") != NOT_FOUND && line.find("numelements=\"") != NOT_FOUND
-        && line.find("</hkparam>") == NOT_FOUND
-        && line.find("<!-- COMPUTE -->", line.find("numelements=\"")) != NOT_FOUND)
+    if (lineClass.Has(nemesis::LineMarker::NumElements) && !lineClass.Has(nemesis::LineMarker::ParamClose)
+        && line.find("<!-- COMPUTE -->", lineClass.Find(nemesis::LineMarker::NumElements)) != NOT_FOUND)
     {
         if (!norElement)
         {
             norElement      = true;
             elementCatch    = true;
-            string templine = line.substr(0, line.find("<hkparam name=\"", 0));
+            string templine = line.substr(0, lineClass.Find(nemesis::LineMarker::Param));
             openRange       = count(templine.begin(), templine.end(), '\t');
         }
         else
@@ -5331,9 +5212,9 @@ void NewAnimation::hasProcessing(string& line,
             ErrorMessage(1136, format, behaviorFile, numline);
         }
     }
-    else if (line.find("</hkparam>") != NOT_FOUND && norElement)
+    else if (lineClass.Has(nemesis::LineMarker::ParamClose) && norElement)
     {
-        string templine   = line.substr(0, line.find("</hkparam>"));
+        string templine   = line.substr(0, lineClass.Find(nemesis::LineMarker::ParamClose));
         __int64 t_counter = count(templine.begin(), templine.end(), '\t');
 
         if (openRange == t_counter)
@@ -5431,6 +5312,7 @@ void NewAnimation::hasProcessing(string& line,
                     {
                         string strID                      = newID();
                         groupFunction->functionIDs[oldID] = strID;
+                        groupIDs.emplace_back(oldID, strID);
                         line.replace(pos, format.length() + 7 + ID.length(), strID);
                     }
                 }
@@ -5486,35 +5368,39 @@ void NewAnimation::hasProcessing(string& line,
         if (error) throw nemesis::exception();
 
         if (line.length() == 0) ErrorMessage(1172, format, behaviorFile, numline);
+
+        lineClass = nemesis::ClassifyLine(line);
     }
 
     if (error) throw nemesis::exception();
 
+    string_view param = lineClass.ParamName(line);
+
+    if (param.empty()) return;
+
+    // <hkparam name="animationName">Animations\idle.hkx</hkparam>
+    size_t pos = lineClass.Find(nemesis::LineMarker::Param) + 15 + param.length() + 2;
+
     // get animation file to check for duplicates and whether the animation has been registered or not
-    if (line.find("<hkparam name=\"animationName\">") != NOT_FOUND)
+    if (param == "animationName")
     {
-        size_t pos      = line.find("animationName\">") + 15;
         string animPath = line.substr(pos, line.find("</hkparam>", pos) - pos);
         addUsedAnim(behaviorFile, animPath);
     }
-    else if (line.find("<hkparam name=\"behaviorName\">") != NOT_FOUND)
+    else if (param == "behaviorName")
     {
-        size_t pos          = line.find("behaviorName\">") + 14;
         string behaviorName = line.substr(pos, line.find("</hkparam>", pos) - pos);
         nemesis::to_lower(behaviorName);
-        behaviorJoints[behaviorName].push_back(behaviorFile);
+        nemesis::GenerationContext::Current().behaviorJoints.Update(
+            behaviorName, [&](VecStr& joints) { joints.push_back(behaviorFile); });
     }
-    else if (line.find("<hkparam name=\"localTime\">-") != NOT_FOUND)
+    else if (param == "localTime" && line.compare(pos, 1, "-") == 0)
     {
         negative = true;
     }
-    else if (negative && line.find("<hkparam name=\"relativeToEndOfClip\">") != NOT_FOUND)
+    else if (negative && param == "relativeToEndOfClip")
     {
-        if (line.find("<hkparam name=\"relativeToEndOfClip\">true</hkparam>") == NOT_FOUND)
-        {
-            size_t pos = line.find("<hkparam name=\"relativeToEndOfClip\">") + 36;
-            line.replace(pos, line.find("</hkparam>", pos) - pos, "true");
-        }
+        if (line.compare(pos, 4, "true") != 0) line.replace(pos, line.find("</hkparam>", pos) - pos, "true");
 
         negative = false;
     }
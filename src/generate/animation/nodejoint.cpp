@@ -6,6 +6,7 @@
 #include "utilities/stringsplit.h"
 
 #include "generate/AnimationUtility.h"
+#include "generate/behaviorreferences.h"
 
 #include "generate/animation/animationinfo.h"
 #include "generate/animation/nodejoint.h"
@@ -15,7 +16,7 @@ using namespace std;
 
 bool newCondition(string condition,
                   string filename,
-                  vector<vector<unordered_map<string, bool>>> optionPicked,
+                  vector<vector<nemesis::OptionSet>> optionPicked,
                   vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
                   int numline,
                   string format,
@@ -60,7 +61,7 @@ void variableIDReplacer(string& line,
 void CRC32Replacer(string& line, string format, string behaviorFile, int linecount);
 void multiChoice(string& line,
                  string filename,
-                 vector<vector<unordered_map<string, bool>>> masterOptionPicked,
+                 vector<vector<nemesis::OptionSet>> masterOptionPicked,
                  vector<vector<shared_ptr<AnimationInfo>>> groupAnimInfo,
                  int numline,
                  string format,
@@ -90,7 +91,7 @@ void processing(string& line,
                 int optionMulti,
                 bool hasGroup,
                 string multiOption,
-                vector<vector<unordered_map<string, bool>>>& optionPicked,
+                vector<vector<nemesis::OptionSet>>& optionPicked,
                 unsigned __int64& openRange,
                 uint& elementCount,
                 string& templateLine,
@@ -163,7 +164,7 @@ NodePackedParameters::NodePackedParameters(string _format,
                                            int _optionMulti,
                                            bool _hasGroup,
                                            string _multiOption,
-                                           vector<vector<unordered_map<string, bool>>>& _optionPicked,
+                                           vector<vector<nemesis::OptionSet>>& _optionPicked,
                                            unsigned __int64& _openRange,
                                            uint& _elementCount,
                                            string& _line,
@@ -244,7 +245,7 @@ NodeJoint::NodeJoint(VecStr& node,
 
 void NodeJoint::insertData(string format,
                            string filename,
-                           vector<vector<unordered_map<string, bool>>>& optionPicked,
+                           vector<vector<nemesis::OptionSet>>& optionPicked,
                            const vector<vector<shared_ptr<AnimationInfo>>>& groupAnimInfo,
                            int groupMulti,
                            int animMulti,
@@ -420,7 +421,7 @@ void NodeJoint::insertData(string format,
                                 ErrorMessage(1129, format, filename, storeTemplate[sect].nested->row);
                             }
 
-                            if (optionPicked[stoi(formatInfo[1])][stoi(formatInfo[2])][formatInfo[3]])
+                            if (optionPicked[stoi(formatInfo[1])][stoi(formatInfo[2])].test(formatInfo[3]))
                             {
                                 if (!isNot)
                                 {
@@ -828,7 +829,7 @@ void NodeJoint::forEachProcess(vector<vector<LineCheck>>& output,
                                uint sect,
                                string format,
                                string filename,
-                               vector<vector<unordered_map<string, bool>>>& optionPicked,
+                               vector<vector<nemesis::OptionSet>>& optionPicked,
                                const vector<vector<shared_ptr<AnimationInfo>>>& groupAnimInfo,
                                int groupMulti,
                                int animMulti,
@@ -1328,7 +1329,7 @@ void NodeJoint::forEachProcess(vector<vector<LineCheck>>& output,
 void NodeJoint::optionMultiLoop(vector<LineCheck>& output,
                                 string format,
                                 string filename,
-                                vector<vector<unordered_map<string, bool>>>& optionPicked,
+                                vector<vector<nemesis::OptionSet>>& optionPicked,
                                 const vector<vector<shared_ptr<AnimationInfo>>>& groupAnimInfo,
                                 int groupMulti,
                                 int animMulti,
@@ -1396,7 +1397,7 @@ void NodeJoint::optionMultiLoop(vector<LineCheck>& output,
     }
 }
 
-VecStr NodeJoint::unpack()
+VecStr NodeJoint::unpack(nemesis::BehaviorReferences* references)
 {
     VecStr storeline;
 
@@ -1428,6 +1429,8 @@ VecStr NodeJoint::unpack()
     {
         string& line = storeline[i];
 
+        if (references) references->Track(line);
+
         // compute numelements
         if (line.find("<hkparam name=\"") != NOT_FOUND && line.find("numelements=\"") != NOT_FOUND
             && line.find("</hkparam>") == NOT_FOUND)
@@ -1747,7 +1750,7 @@ void processing(string& lineRef,
                 int optionMulti,
                 bool hasGroup,
                 string multiOption,
-                vector<vector<unordered_map<string, bool>>>& optionPicked,
+                vector<vector<nemesis::OptionSet>>& optionPicked,
                 unsigned __int64& openRange,
                 uint& elementCount,
                 string& templateLine,
@@ -10,6 +10,8 @@
 #include "utilities/stringsplit.h"
 #include "utilities/readtextfile.h"
 
+#include "generate/generationcontext.h"
+
 #include "generate/animation/optionlist.h"
 
 #pragma warning(disable : 4503)
@@ -605,9 +607,9 @@ OptionList::OptionList(string filepath, string format)
 
                         if (AnimInfo[2] != "#" + functionID) ErrorMessage(1071, format, filepath, linecount);
 
-                        if (behaviorPath[nemesis::transform_to<wstring>(nemesis::to_lower_copy(AnimInfo[1]))]
-                                .length()
-                            == 0)
+                        if (nemesis::GenerationContext::Current()
+                                .GetBehaviorPath(nemesis::InternPath(AnimInfo[1]))
+                                .empty())
                         {
                             ErrorMessage(1083, AnimInfo[1], format, filepath, linecount);
                         }
@@ -699,8 +701,8 @@ OptionList::OptionList(string filepath, string format)
 
                                 if (strline.length() > 2 && strline.substr(strline.length() - 2) == "[]")
                                 {
-                                    groupOption[tempOption] = true;
-                                    recontext               = recontext + "[]";
+                                    groupOption.set(tempOption);
+                                    recontext = recontext + "[]";
                                 }
                             }
                             else
@@ -850,7 +852,7 @@ OptionList::OptionList(string filepath, string format)
 
             for (uint i = 0; i < it->second.size(); ++i)
             {
-                if (groupOption[it->first] != groupOption[it->second[i]]
+                if (groupOption.test(it->first) != groupOption.test(it->second[i])
                     || addOn[it->first] != addOn[it->second[i]])
                     l_error = true;
 
@@ -903,12 +905,27 @@ OptionList::OptionList(string filepath, string format)
         }
     }
 
+    // the options of the template get their indexes here, ahead of the ones named by each animation
+    nemesis::OptionIndex::Intern(templatecode);
+    nemesis::OptionIndex::Intern(templatecode + "_group");
+    nemesis::OptionIndex::Intern(templatecode + "_master");
+
+    for (auto& option : storelist)
+    {
+        nemesis::OptionIndex::Intern(option.first);
+    }
+
+    for (auto& option : addOn)
+    {
+        nemesis::OptionIndex::Intern(option.first);
+    }
+
     // throw error
     if (core)
     {
         if (ignoreGroup || groupMin != -1 || startStateID.length() != 0 || ruleOne.size() != 0
             || ruleTwo.size() != 0 || compulsory.size() != 0 || optionOrder.size() != 0
-            || multiState.size() != 0 || storelist.size() != 0 || groupOption.size() != 0
+            || multiState.size() != 0 || storelist.size() != 0 || groupOption.any()
             || mixOptRegis.size() != 0 || mixOptRever.size() != 0 || addOn.size() != 0 || joint.size() != 0
             || eleEvent.size() != 0 || eleEventGroupF.size() != 0 || eleEventGroupL.size() != 0
             || eleVar.size() != 0 || eleVarGroupF.size() != 0 || eleVarGroupL.size() != 0)
@@ -944,6 +961,20 @@ void OptionList::setDebug(bool isDebug)
     Debug = isDebug;
 }
 
+void OptionList::ShareAnimOptions()
+{
+    auto data         = make_shared<AnimOptionData>();
+    data->addOn       = addOn;
+    data->mixOptRegis = mixOptRegis;
+    animOptions       = data;
+}
+
+const AnimOptionData& AnimOptionData::Of(const shared_ptr<const AnimOptionData>& data)
+{
+    static const AnimOptionData none;
+    return data ? *data : none;
+}
+
 bool optionMatching(string option1, string option2)
 {
     string shorter;
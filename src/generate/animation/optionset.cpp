@@ -0,0 +1,140 @@
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "generate/animation/optionset.h"
+
+using namespace std;
+
+namespace
+{
+    shared_mutex indexMutex;
+    unordered_map<string, uint32_t> indexTable;
+} // namespace
+
+uint32_t nemesis::OptionIndex::Intern(const string& name)
+{
+    {
+        shared_lock<shared_mutex> lock(indexMutex);
+        auto itr = indexTable.find(name);
+
+        if (itr != indexTable.end()) return itr->second;
+    }
+
+    unique_lock<shared_mutex> lock(indexMutex);
+    return indexTable.emplace(name, uint32_t(indexTable.size())).first->second;
+}
+
+uint32_t nemesis::OptionIndex::Find(const string& name)
+{
+    shared_lock<shared_mutex> lock(indexMutex);
+    auto itr = indexTable.find(name);
+    return itr == indexTable.end() ? npos : itr->second;
+}
+
+void nemesis::OptionSet::set(uint32_t id)
+{
+    size_t word = id >> 6;
+
+    if (word >= words.size()) words.resize(word + 1);
+
+    words[word] |= uint64_t(1) << (id & 63);
+}
+
+void nemesis::OptionSet::set(const string& name)
+{
+    set(OptionIndex::Intern(name));
+}
+
+void nemesis::OptionSet::reset(uint32_t id)
+{
+    size_t word = id >> 6;
+
+    if (word < words.size()) words[word] &= ~(uint64_t(1) << (id & 63));
+}
+
+bool nemesis::OptionSet::test(uint32_t id) const
+{
+    size_t word = id >> 6;
+    return word < words.size() && ((words[word] >> (id & 63)) & 1) != 0;
+}
+
+bool nemesis::OptionSet::test(const string& name) const
+{
+    uint32_t id = OptionIndex::Find(name);
+    return id != OptionIndex::npos && test(id);
+}
+
+bool nemesis::OptionSet::any() const
+{
+    for (auto word : words)
+    {
+        if (word != 0) return true;
+    }
+
+    return false;
+}
+
+void nemesis::OptionSet::AppendKey(string& key) const
+{
+    size_t size = words.size();
+
+    while (size > 0 && words[size - 1] == 0)
+    {
+        --size;
+    }
+
+    uint64_t count = size;
+    key.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    key.append(reinterpret_cast<const char*>(words.data()), size * sizeof(uint64_t));
+}
+
+nemesis::OptionSet& nemesis::OptionSet::operator|=(const OptionSet& other)
+{
+    if (other.words.size() > words.size()) words.resize(other.words.size());
+
+    for (size_t i = 0; i < other.words.size(); ++i)
+    {
+        words[i] |= other.words[i];
+    }
+
+    return *this;
+}
+
+nemesis::OptionSet& nemesis::OptionSet::operator&=(const OptionSet& other)
+{
+    if (words.size() > other.words.size()) words.resize(other.words.size());
+
+    for (size_t i = 0; i < words.size(); ++i)
+    {
+        words[i] &= other.words[i];
+    }
+
+    return *this;
+}
+
+nemesis::OptionSet nemesis::OptionSet::All(const vector<OptionSet>& list)
+{
+    if (list.empty()) return OptionSet();
+
+    OptionSet result = list.front();
+
+    for (size_t i = 1; i < list.size(); ++i)
+    {
+        result &= list[i];
+    }
+
+    return result;
+}
+
+nemesis::OptionSet nemesis::OptionSet::Any(const vector<OptionSet>& list)
+{
+    OptionSet result;
+
+    for (auto& set : list)
+    {
+        result |= set;
+    }
+
+    return result;
+}
@@ -10,13 +10,32 @@
 #include "utilities/stringsplit.h"
 #include "utilities/readtextfile.h"
 
+#include "generate/generationcontext.h"
+
 #include "generate/animation/registeranimation.h"
 
 using namespace std;
 
 namespace sf = std::filesystem;
 
-bool ruleCheck(VecStr rules, VecStr curList, TemplateInfo& behaviortemplate, string lowerformat)
+namespace
+{
+    // the template is shared by every list file, so looking it up must not insert anything
+    const OptionList& GetOptionList(const TemplateInfo& behaviortemplate, const string& code)
+    {
+        static const OptionList none;
+        auto itr = behaviortemplate.optionlist.find(code);
+        return itr != behaviortemplate.optionlist.end() ? itr->second : none;
+    }
+
+    bool IsTemplate(const TemplateInfo& behaviortemplate, const string& code)
+    {
+        auto itr = behaviortemplate.templatelist.find(code);
+        return itr != behaviortemplate.templatelist.end() && itr->second;
+    }
+} // namespace
+
+bool ruleCheck(VecStr rules, VecStr curList, const TemplateInfo& behaviortemplate, string lowerformat)
 {
     for (auto& rule : rules)
     {
@@ -29,7 +48,9 @@ bool ruleCheck(VecStr rules, VecStr curList, TemplateInfo& behaviortemplate, str
                 = nemesis::regex_replace(string(cur), nemesis::regex("[^0-9]*([0-9]+).*"), string("\\1"));
 
             if (cur.length() == rule.length()
-                || (behaviortemplate.optionlist[lowerformat].addOn[rule].size() != 0
+                || (GetOptionList(behaviortemplate, lowerformat).addOn.find(rule)
+                        != GetOptionList(behaviortemplate, lowerformat).addOn.end()
+                    && GetOptionList(behaviortemplate, lowerformat).addOn.at(rule).size() != 0
                     && cur.length() > rule.length())
                 || cur == rule + number)
             {
@@ -73,11 +94,12 @@ bool ruleCheck(VecStr rules, VecStr curList, TemplateInfo& behaviortemplate, str
 
 registerAnimation::registerAnimation(sf::path curDirectory,
                                      sf::path filename,
-                                     TemplateInfo behaviortemplate,
+                                     const TemplateInfo& behaviortemplate,
                                      sf::path bhvrPath,
                                      bool fstP,
                                      bool isNemesis)
 {
+    nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
     int linecount   = isNemesis ? 8 : 5;
     modID           = filename.string().substr(linecount, filename.string().find("_List.txt") - linecount);
     wstring filepath = curDirectory.wstring() + filename.wstring();
@@ -164,7 +186,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                 if (newAnimInfo.size() != 3) ErrorMessage(4003, filename, linecount, line);
 
                 string lowGroupName = nemesis::to_lower_copy(newAnimInfo[1]);
-                size_t groupSize    = groupAA[lowGroupName].size();
+                size_t groupSize    = context.groupAA[lowGroupName].size();
 
                 if (groupSize == 0) ErrorMessage(4004, filename, linecount, line);
 
@@ -175,12 +197,12 @@ registerAnimation::registerAnimation(sf::path curDirectory,
 
                 int num                          = stoi(newAnimInfo[2]);
                 string lowGN                     = fstP ? lowGroupName + "_1p*" : lowGroupName;
-                AAGroupCount[curAAprefix][lowGN] = num;
-                groupAAPrefix[lowGN].push_back(curAAprefix);
+                context.AAGroupCount[curAAprefix][lowGN] = num;
+                context.groupAAPrefix[lowGN].push_back(curAAprefix);
 
                 for (uint i = 0; i < groupSize; ++i) // list of animations in the animation group
                 {
-                    string lowAnim       = groupAA[lowGroupName][i];
+                    string lowAnim       = context.groupAA[lowGroupName][i];
                     string lowAnimPerson = (fstP ? lowAnim + "_1p*" : lowAnim);
 
                     for (int j = 0; j < num; ++j) // number of variation of the specific animation
@@ -190,17 +212,17 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                         if (!isFileExist(curDirectory.wstring() + nemesis::transform_to<wstring>(animFile)))
                         {
                             WarningMessage(1003, modID, animFile);
-                            alternateAnim[lowAnimPerson].push_back("x");
+                            context.alternateAnim[lowAnimPerson].push_back("x");
                         }
                         else
                         {
-                            alternateAnim[lowAnimPerson].push_back(modID + "\\" + animFile);
+                            context.alternateAnim[lowAnimPerson].push_back(modID + "\\" + animFile);
                             AAAnimFileExist[nemesis::to_lower_copy(fstP ? animFile + "_1p*" : animFile)]
                                 = true;
                         }
                     }
 
-                    if (alternateAnim[lowAnimPerson].size() > 128)
+                    if (context.alternateAnim[lowAnimPerson].size() > 128)
                         ErrorMessage(4008, filename, linecount, line);
                 }
 
@@ -222,13 +244,13 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                 {
                     string originalAnim = lowerAnimName.substr(lowerAnimName.find("_") + 1);
 
-                    if (newAnimInfo.size() > 2) AAHasEvent[originalAnim].push_back(lowerAnimName);
+                    if (newAnimInfo.size() > 2) context.AAHasEvent[originalAnim].push_back(lowerAnimName);
 
                     for (uint j = 2; j < newAnimInfo.size(); ++j)
                     {
-                        AAEvent[lowerAnimName].push_back(newAnimInfo[j]);
+                        context.AAEvent[lowerAnimName].push_back(newAnimInfo[j]);
 
-                        if (j == 2) AAHasEvent[originalAnim].push_back(lowerAnimName);
+                        if (j == 2) context.AAHasEvent[originalAnim].push_back(lowerAnimName);
                     }
                 }
             }
@@ -277,11 +299,10 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                 shared_ptr<AnimationInfo> animInfo_ptr = animInfo[previousShortline].back();
                 animInfo_ptr->motionData.push_back(newAnimInfo[1] + " " + newAnimInfo[2] + " "
                                                    + newAnimInfo[3] + " " + newAnimInfo[4]);
-                animInfo_ptr->optionPicked["motion"] = true;
+                animInfo_ptr->optionPicked.set("motion");
 
                 if (animInfo_ptr->duration < timer
-                    && (animInfo_ptr->optionPicked.find("D") == animInfo_ptr->optionPicked.end()
-                        || !animInfo_ptr->optionPicked["D"]))
+                    && !animInfo_ptr->optionPicked.test("D"))
                 {
                     animInfo_ptr->duration    = timer;
                     animInfo_ptr->hasDuration = true;
@@ -319,11 +340,10 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                 animInfo_ptr->rotationData.push_back(newAnimInfo[1] + " " + newAnimInfo[2] + " "
                                                      + newAnimInfo[3] + " " + newAnimInfo[4] + " "
                                                      + newAnimInfo[5]);
-                animInfo_ptr->optionPicked["rotation"] = true;
+                animInfo_ptr->optionPicked.set("rotation");
 
                 if (animInfo_ptr->duration < timer
-                    && (animInfo_ptr->optionPicked.find("D") == animInfo_ptr->optionPicked.end()
-                        || !animInfo_ptr->optionPicked["D"]))
+                    && !animInfo_ptr->optionPicked.test("D"))
                 {
                     animInfo_ptr->duration    = timer;
                     animInfo_ptr->hasDuration = true;
@@ -333,7 +353,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
             {
                 if (previousShortline.length() > 0)
                 {
-                    if (behaviortemplate.templatelist[previousShortline])
+                    if (IsTemplate(behaviortemplate, previousShortline))
                     {
                         bool isOExist = true;
                         string anim   = newAnimInfo[newAnimInfo.size() - 1];
@@ -345,10 +365,11 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                             && anim.rfind(number) == anim.length() - number.length())
                         {
                             isOExist                   = false;
-                            OptionList* behaviorOption = &behaviortemplate.optionlist[previousShortline];
+                            const OptionList* behaviorOption
+                                = &GetOptionList(behaviortemplate, previousShortline);
 
                             if (behaviorOption->storelist.find("o") == behaviorOption->storelist.end()
-                                || !behaviorOption->storelist["o"])
+                                || !behaviorOption->storelist.at("o"))
                             {
                                 if (behaviorOption->animObjectCount > 0) isOExist = true;
                             }
@@ -359,7 +380,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                             animInfo[previousShortline].push_back(
                                 make_shared<AnimationInfo>(newAnimInfo,
                                                            filename,
-                                                           behaviortemplate.optionlist[previousShortline],
+                                                           GetOptionList(behaviortemplate, previousShortline),
                                                            linecount,
                                                            isOExist));
                             animInfo[previousShortline].back()->addFilename(newAnimInfo[3]);
@@ -376,7 +397,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                             animInfo[previousShortline].push_back(
                                 make_shared<AnimationInfo>(newAnimInfo,
                                                            filename,
-                                                           behaviortemplate.optionlist[previousShortline],
+                                                           GetOptionList(behaviortemplate, previousShortline),
                                                            linecount,
                                                            isOExist,
                                                            true));
@@ -391,7 +412,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
 
                         if (behaviortemplate.behaviortemplate.find(previousShortline + "_group")
                                 != behaviortemplate.behaviortemplate.end()
-                            && behaviortemplate.behaviortemplate[previousShortline + "_group"].size() != 0)
+                            && behaviortemplate.behaviortemplate.at(previousShortline + "_group").size() != 0)
                         {
                             animInfo[previousShortline]
                                 .back()
@@ -401,7 +422,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
 
                         if (behaviortemplate.behaviortemplate.find(previousShortline + "_master")
                                 != behaviortemplate.behaviortemplate.end()
-                            && behaviortemplate.behaviortemplate[previousShortline + "_master"].size() != 0)
+                            && behaviortemplate.behaviortemplate.at(previousShortline + "_master").size() != 0)
                         {
                             animInfo[previousShortline]
                                 .back()
@@ -421,7 +442,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                     ErrorMessage(1065, filename, linecount);
                 }
             }
-            else if (behaviortemplate.templatelist[lowerformat])
+            else if (IsTemplate(behaviortemplate, lowerformat))
             {
                 string anim   = newAnimInfo[newAnimInfo.size() - 1];
                 bool isOExist = true;
@@ -436,7 +457,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                     animInfo[lowerformat].push_back(
                         make_shared<AnimationInfo>(newAnimInfo,
                                                    filename,
-                                                   behaviortemplate.optionlist[lowerformat],
+                                                   GetOptionList(behaviortemplate, lowerformat),
                                                    linecount,
                                                    isOExist));
                     animInfo[lowerformat].back()->addFilename(newAnimInfo[3]);
@@ -452,7 +473,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                     animInfo[lowerformat].push_back(
                         make_shared<AnimationInfo>(newAnimInfo,
                                                    filename,
-                                                   behaviortemplate.optionlist[lowerformat],
+                                                   GetOptionList(behaviortemplate, lowerformat),
                                                    linecount,
                                                    isOExist,
                                                    true));
@@ -469,14 +490,14 @@ registerAnimation::registerAnimation(sf::path curDirectory,
 
                 if (behaviortemplate.behaviortemplate.find(lowerformat + "_group")
                         != behaviortemplate.behaviortemplate.end()
-                    && behaviortemplate.behaviortemplate[lowerformat + "_group"].size() != 0)
+                    && behaviortemplate.behaviortemplate.at(lowerformat + "_group").size() != 0)
                 {
                     animInfo[lowerformat].back()->optionPickedCount[lowerformat + "_group"] = 1;
                 }
 
                 if (behaviortemplate.behaviortemplate.find(lowerformat + "_master")
                         != behaviortemplate.behaviortemplate.end()
-                    && behaviortemplate.behaviortemplate[lowerformat + "_master"].size() != 0)
+                    && behaviortemplate.behaviortemplate.at(lowerformat + "_master").size() != 0)
                 {
                     animInfo[lowerformat].back()->optionPickedCount[lowerformat + "_master"] = 1;
                 }
@@ -485,10 +506,10 @@ registerAnimation::registerAnimation(sf::path curDirectory,
 
                 if (previousShortline.length() > 0)
                 {
-                    if (behaviortemplate.optionlist[previousShortline].groupMin > multiCount)
+                    if (GetOptionList(behaviortemplate, previousShortline).groupMin > multiCount)
                     {
                         ErrorMessage(1034,
-                                     behaviortemplate.optionlist[previousShortline].groupMin,
+                                     GetOptionList(behaviortemplate, previousShortline).groupMin,
                                      previousShortline,
                                      filename,
                                      linecount - 1);
@@ -500,7 +521,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
 
                         if (i == multiCount - 1 && i != 0)
                         {
-                            if (behaviortemplate.optionlist[previousShortline].ruleTwo.size() != 0)
+                            if (GetOptionList(behaviortemplate, previousShortline).ruleTwo.size() != 0)
                             {
                                 VecStr AnimInfo;
                                 StringSplit(previousLine, AnimInfo);
@@ -529,7 +550,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                                         }
                                     }
 
-                                    if (!ruleCheck(behaviortemplate.optionlist[previousShortline].ruleTwo,
+                                    if (!ruleCheck(GetOptionList(behaviortemplate, previousShortline).ruleTwo,
                                                    curList,
                                                    behaviortemplate,
                                                    previousShortline))
@@ -548,8 +569,8 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                     if (error) throw nemesis::exception();
                 }
 
-                if (behaviortemplate.optionlist[lowerformat].ruleOne.size() != 0
-                    || behaviortemplate.optionlist[lowerformat].compulsory.size() != 0)
+                if (GetOptionList(behaviortemplate, lowerformat).ruleOne.size() != 0
+                    || GetOptionList(behaviortemplate, lowerformat).compulsory.size() != 0)
                 {
                     if (newAnimInfo.size() > 3 && newAnimInfo[1].length() > 0 && newAnimInfo[1][0] == '-')
                     {
@@ -575,7 +596,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                             }
                         }
 
-                        if (!ruleCheck(behaviortemplate.optionlist[lowerformat].compulsory,
+                        if (!ruleCheck(GetOptionList(behaviortemplate, lowerformat).compulsory,
                                        curList,
                                        behaviortemplate,
                                        lowerformat))
@@ -583,7 +604,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                             ErrorMessage(1035, filename, linecount);
                         }
 
-                        if (!ruleCheck(behaviortemplate.optionlist[lowerformat].ruleOne,
+                        if (!ruleCheck(GetOptionList(behaviortemplate, lowerformat).ruleOne,
                                        curList,
                                        behaviortemplate,
                                        lowerformat))
@@ -622,10 +643,10 @@ registerAnimation::registerAnimation(sf::path curDirectory,
 
     ++linecount;
 
-    if (behaviortemplate.optionlist[previousShortline].groupMin > multiCount)
+    if (GetOptionList(behaviortemplate, previousShortline).groupMin > multiCount)
     {
         ErrorMessage(1034,
-                     behaviortemplate.optionlist[previousShortline].groupMin,
+                     GetOptionList(behaviortemplate, previousShortline).groupMin,
                      previousShortline,
                      filename,
                      linecount - 1);
@@ -637,7 +658,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
 
         if (i == multiCount - 1 && i != 0)
         {
-            if (behaviortemplate.optionlist[previousShortline].ruleTwo.size() != 0)
+            if (GetOptionList(behaviortemplate, previousShortline).ruleTwo.size() != 0)
             {
                 string tempPreviousShortline = multiCount > 1 ? "+" : previousShortline;
 
@@ -667,7 +688,7 @@ registerAnimation::registerAnimation(sf::path curDirectory,
                         }
                     }
 
-                    if (!ruleCheck(behaviortemplate.optionlist[previousShortline].ruleTwo,
+                    if (!ruleCheck(GetOptionList(behaviortemplate, previousShortline).ruleTwo,
                                    curList,
                                    behaviortemplate,
                                    previousShortline))
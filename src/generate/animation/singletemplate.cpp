@@ -16,7 +16,7 @@ void stateInstall(string line,
                   bool isMC,
                   map<int, vector<nemesis::scope>>& lineblocks,
                   proc& process,
-                  void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const);
+                  void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const);
 void mainAnimEventInstall(string format,
                           string behaviorFile,
                           string change,
@@ -58,6 +58,7 @@ void AnimTemplate::ExamineTemplate(
     int openRange   = 0;
     format          = _format;
     behaviorFile    = _file;
+    clipNode        = false;
 
     string elementline;
     unordered_map<int, VecStr> conditionStore;
@@ -311,6 +312,7 @@ void AnimTemplate::ExamineTemplate(
 
     if (condition > 0) ErrorMessage(1145, format, behaviorFile);
 
+    process.Compile();
     size = templatelines.size();
 }
 
@@ -541,7 +543,7 @@ void AnimTemplate::Process(const string& line,
                 isEnd = false;
             }
 
-            void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const;
+            void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const;
 
             if (isMaster)
             {
@@ -594,6 +596,24 @@ void AnimTemplate::Process(const string& line,
         }
     }
 
+    if (line.find("<hkobject name=\"") != NOT_FOUND)
+    {
+        clipNode = line.find("class=\"hkbClipGenerator\"") != NOT_FOUND;
+    }
+    else if (clipNode)
+    {
+        for (auto& itr = nemesis::regex_iterator(
+                 line, nemesis::regex("<hkparam name\\=\"name\">(.+?)<\\/hkparam>"));
+             itr != nemesis::regex_iterator();
+             ++itr)
+        {
+            hasProcess = true;
+            size_t pos = itr->position(1);
+            process.installBlock(nemesis::scope(pos, pos + itr->str(1).length(), &proc::regisClipName),
+                                 numline);
+        }
+    }
+
     for (auto& itr = nemesis::regex_iterator(
              line, nemesis::regex("<hkparam name\\=\"animationName\">(.+?)<\\/hkparam>"));
          itr != nemesis::regex_iterator();
@@ -650,7 +670,7 @@ void stateInstall(string line,
                   bool isMC,
                   map<int, vector<shared_ptr<nemesis::scope>>>& lineblocks,
                   proc& process,
-                  void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const)
+                  void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const)
 {
     int intID;
     nemesis::regex expr(format + "\\[" + animOrder + "\\]\\[\\(S([0-9]*)\\+([0-9]+)\\)\\]");
@@ -734,7 +754,7 @@ void mainAnimEventInstall(string format,
         bool num     = false;
         string first = itr->str(1);
         size_t post  = curPos + itr->position();
-        void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const;
+        void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const;
 
         if (first.length() == 0)
         {
@@ -903,7 +923,7 @@ void ProcessFunction(string change,
         {
             bool number  = false;
             string first = itr->str(1);
-            void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const;
+            void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const;
 
             if (first.length() == 0)
             {
@@ -1000,7 +1020,7 @@ void ProcessFunction(string change,
              ++itr)
         {
             string first = itr->str(1);
-            void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const;
+            void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const;
 
             if (first.length() == 0)
             {
@@ -1140,7 +1160,7 @@ void ProcessFunction(string change,
             bool number  = false;
             size_t post  = curPos + itr->position();
             string first = itr->str(1);
-            void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const;
+            void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const;
 
             if (first.length() == 0)
             {
@@ -1221,7 +1241,7 @@ void ProcessFunction(string change,
             bool number  = false;
             size_t post  = curPos + itr->position();
             string first = itr->str(1);
-            void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const;
+            void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const;
 
             if (first.length() == 0)
             {
@@ -1337,7 +1357,7 @@ void ProcessFunction(string change,
             string optionMulti = itr->str(3);
             string full        = itr->str();
             size_t post        = curPos + itr->position();
-            void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const;
+            void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const;
             vector<int> container;
             ++counter;
             string templine;
@@ -1589,7 +1609,7 @@ void ProcessFunction(string change,
                     string header;
                     string first  = itr->str(1);
                     size_t addpos = curPos + itr->position();
-                    void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const;
+                    void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const;
 
                     if (first.length() == 0)
                     {
@@ -1971,7 +1991,7 @@ void ProcessFunction(string change,
             bool number  = false;
             string first = itr->str(1);
             size_t post  = curPos + itr->position();
-            void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const;
+            void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const;
 
             if (first.length() == 0)
             {
@@ -2057,7 +2077,7 @@ void ProcessFunction(string change,
             bool number  = false;
             string first = itr->str(1);
             size_t post  = curPos + itr->position();
-            void (proc::*func)(nemesis::scope, VecStr&, AnimThreadInfo&) const;
+            void (proc::*func)(const nemesis::scope&, VecStr&, AnimThreadInfo&) const;
 
             if (first.length() == 0)
             {
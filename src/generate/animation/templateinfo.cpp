@@ -2,6 +2,8 @@
 
 #include "utilities/algorithm.h"
 
+#include "generate/generationcontext.h"
+
 #include "generate/animation/optionlist.h"
 #include "generate/animation/templateinfo.h"
 
@@ -55,6 +57,7 @@ TemplateInfo::TemplateInfo()
                     {
                         OptionList option(newpath, code);
                         option.setDebug(debug);
+                        option.ShareAnimOptions();
                         optionlist[code]   = option;
                         templatelist[code] = true;
                         isOptionExist      = true;
@@ -84,13 +87,15 @@ TemplateInfo::TemplateInfo()
 
                         if (isCore)
                         {
-                            if (behaviorJoints[lowerBehaviorFolder].size() == 0)
+                            auto& behaviorJoints = nemesis::GenerationContext::Current().behaviorJoints;
+                            const VecStr* joints = behaviorJoints.Find(lowerBehaviorFolder);
+
+                            if (!joints || joints->size() == 0)
                             {
                                 ErrorMessage(1182, code, templateDirectory + code + "\\option_list.txt");
                             }
 
-                            behaviorJoints[nemesis::to_lower_copy(optionlist[code].coreBehavior)]
-                                = behaviorJoints[lowerBehaviorFolder];
+                            behaviorJoints[nemesis::to_lower_copy(optionlist[code].coreBehavior)] = *joints;
                         }
 
                         for (uint i = 0; i < filelist.size(); ++i)
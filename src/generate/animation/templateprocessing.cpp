@@ -5,6 +5,8 @@
 
 #include "generate/alternateanimation.h"
 #include "generate/animationdatatracker.h"
+#include "generate/behaviorreferences.h"
+#include "generate/generationcontext.h"
 
 #include "generate/animation/grouptemplate.h"
 #include "generate/animation/singletemplate.h"
@@ -71,13 +73,13 @@ void stateInput(string& state,
     }
 }
 
-void proc::installBlock(nemesis::scope blok, int curline)
+void proc::installBlock(const nemesis::scope& blok, int curline)
 {
     blockCheck(blok.front, blok.back, curline);
     lineblocks[curline].blocksize[blok.size].push_back(blok);
 }
 
-void proc::installBlock(nemesis::scope blok, int curline, vector<nemesis::MultiChoice> m_condiiton)
+void proc::installBlock(const nemesis::scope& blok, int curline, const vector<nemesis::MultiChoice>& m_condiiton)
 {
     blockCheck(blok.front, blok.back, curline);
     hasMC.insert(curline);
@@ -85,7 +87,138 @@ void proc::installBlock(nemesis::scope blok, int curline, vector<nemesis::MultiC
     choiceblocks[curline].push_back(blok);
 }
 
-void proc::relativeNegative(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::Compile()
+{
+    int lastline = 0;
+
+    for (auto& line : brackets)
+    {
+        lastline = max(lastline, line.first);
+    }
+
+    for (auto& line : lineblocks)
+    {
+        lastline = max(lastline, line.first);
+    }
+
+    for (auto& line : hasMC)
+    {
+        lastline = max(lastline, line);
+    }
+
+    lineEntry.assign(lastline + 1, noProgram);
+    program.clear();
+    scopes.clear();
+    bracketPositions.clear();
+    choices.clear();
+
+    for (int numline = 1; numline <= lastline; ++numline)
+    {
+        auto bkitr = brackets.find(numline);
+        auto lbitr = lineblocks.find(numline);
+        auto mcitr = hasMC.find(numline);
+
+        if (bkitr == brackets.end() && lbitr == lineblocks.end() && mcitr == hasMC.end()) continue;
+
+        lineEntry[numline] = uint32_t(program.size());
+
+        if (bkitr != brackets.end())
+        {
+            program.push_back(Instruction{Opcode::ClearBrackets,
+                                          uint32_t(bracketPositions.size()),
+                                          uint32_t(bkitr->second.size())});
+            bracketPositions.insert(bracketPositions.end(), bkitr->second.begin(), bkitr->second.end());
+        }
+
+        if (mcitr != hasMC.end())
+        {
+            auto choiceitr = multiChoice.find(numline);
+            uint32_t first = uint32_t(choices.size());
+
+            if (choiceitr != multiChoice.end())
+            {
+                choices.insert(choices.end(), choiceitr->second.begin(), choiceitr->second.end());
+            }
+
+            program.push_back(Instruction{Opcode::Choose, first, uint32_t(choices.size()) - first});
+        }
+
+        if (lbitr != lineblocks.end())
+        {
+            uint32_t first = uint32_t(scopes.size());
+
+            // smaller blocks first, so the blocks nested in a larger block are resolved before it
+            for (auto& bloklist : lbitr->second.blocksize)
+            {
+                scopes.insert(scopes.end(), bloklist.second.begin(), bloklist.second.end());
+            }
+
+            program.push_back(Instruction{Opcode::Call, first, uint32_t(scopes.size()) - first});
+        }
+
+        if (mcitr != hasMC.end())
+        {
+            auto cbitr     = choiceblocks.find(numline);
+            uint32_t first = uint32_t(scopes.size());
+
+            if (cbitr != choiceblocks.end())
+            {
+                scopes.insert(scopes.end(), cbitr->second.begin(), cbitr->second.end());
+            }
+
+            program.push_back(Instruction{Opcode::Call, first, uint32_t(scopes.size()) - first});
+            program.push_back(Instruction{Opcode::EndChoice, 0, 0});
+        }
+
+        program.push_back(Instruction{Opcode::End, 0, 0});
+    }
+
+    // an import that repeats with a different keyword can take more IDs than counted, those are numbered by
+    // ResolveOverflow once the phase is done
+    unordered_set<string> IDs;
+    idDemand = 0;
+    groupIDSlots.clear();
+    replayable = true;
+
+    for (auto& blok : scopes)
+    {
+        // master and group registries are filled outside of the instance, animOrder reads this run's animation data
+        if (blok.func == &proc::IDRegisAnim || blok.func == &proc::IDRegisGroup || blok.func == &proc::IDRegisMaster
+            || blok.func == &proc::animOrder)
+        {
+            replayable = false;
+        }
+
+        if (blok.func == &proc::import)
+        {
+            ++idDemand;
+        }
+        else if (blok.func == &proc::groupIDRegis)
+        {
+            groupIDSlots.emplace(blok.olddata[0], groupIDSlots.size());
+        }
+        else if (blok.func == &proc::IDRegis || blok.func == &proc::IDRegisAnim)
+        {
+            if (IDs.insert("$" + blok.olddata[0]).second) ++idDemand;
+        }
+        else if (blok.func == &proc::IDRegisGroup)
+        {
+            if (IDs.insert("_group$" + blok.olddata[0]).second) ++idDemand;
+        }
+        else if (blok.func == &proc::IDRegisMaster)
+        {
+            if (IDs.insert("_master$" + blok.olddata[0]).second) ++idDemand;
+        }
+    }
+
+    hasMC.clear();
+    brackets.clear();
+    lineblocks.clear();
+    choiceblocks.clear();
+    multiChoice.clear();
+}
+
+void proc::relativeNegative(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -103,13 +236,13 @@ void proc::relativeNegative(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     }
 }
 
-void proc::compute(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::compute(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     curAnimInfo.elementCatch = true;
     curAnimInfo.norElement   = true;
 }
 
-void proc::rangeCompute(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rangeCompute(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     (*curAnimInfo.generatedlines)[curAnimInfo.elementLine]
         = nemesis::regex_replace(string((*curAnimInfo.generatedlines)[curAnimInfo.elementLine]),
@@ -120,23 +253,23 @@ void proc::rangeCompute(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     curAnimInfo.elementLine = -1;
 }
 
-void proc::upCounter(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::upCounter(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     ++curAnimInfo.counter;
 }
 
-void proc::upCounterPlus(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::upCounterPlus(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     string full = combineBlocks(0, blocks.size() - 1, blocks);
     curAnimInfo.counter += count(full.begin(), full.end(), '#');
 }
 
-void proc::animCount(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::animCount(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo)) blocks[blok.front] = to_string(curAnimInfo.furnitureCount);
 }
 
-void proc::multiChoiceRegis(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::multiChoiceRegis(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     string result = !curAnimInfo.captured
                         ? "null"
@@ -146,28 +279,32 @@ void proc::multiChoiceRegis(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     blocks[blok.front] = result;
 }
 
-void proc::groupIDRegis(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::groupIDRegis(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
         string oldID = masterformat + "_group$" + blok.olddata[0];
+        group& curGroup = *curAnimInfo.groupFunction;
+        size_t slot     = groupIDSlots.at(blok.olddata[0]);
+
+        // every animation of the group works out the same ID from the range reserved for the group
+        string strID = slot < curGroup.IDs.Size() ? curGroup.IDs.At(slot) : "";
         Lockless lock(curAnimInfo.animLock->subIDLock);
 
-        if (curAnimInfo.groupFunction->functionIDs.find(oldID)
-            != curAnimInfo.groupFunction->functionIDs.end())
+        if (strID.length() == 0)
         {
-            blocks[blok.front] = curAnimInfo.groupFunction->functionIDs[oldID];
-        }
-        else
-        {
-            string strID                                  = curAnimInfo.curAnim->newID();
-            curAnimInfo.groupFunction->functionIDs[oldID] = strID;
-            blocks[blok.front]                            = strID;
+            auto itr = curGroup.functionIDs.find(oldID);
+            strID    = itr != curGroup.functionIDs.end() ? itr->second : curAnimInfo.curAnim->newID();
         }
+
+        curGroup.functionIDs[oldID] = strID;
+        blocks[blok.front]          = strID;
+
+        if (curAnimInfo.curAnim) curAnimInfo.curAnim->groupIDRegis(oldID, strID);
     }
 }
 
-void proc::IDRegis(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::IDRegis(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -189,7 +326,7 @@ void proc::IDRegis(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimI
     }
 }
 
-void proc::IDRegisAnim(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::IDRegisAnim(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -243,7 +380,7 @@ void proc::IDRegisAnim(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curA
     }
 }
 
-void proc::IDRegisGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::IDRegisGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -283,7 +420,7 @@ void proc::IDRegisGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::IDRegisMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::IDRegisMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -315,7 +452,7 @@ void proc::IDRegisMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::computation(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::computation(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     string equation       = combineBlocks(blok, blocks);
     size_t equationLength = equation.length();
@@ -402,7 +539,7 @@ void proc::computation(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curA
     }
 }
 
-void proc::endMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::endMultiGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -424,7 +561,7 @@ void proc::endMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::endFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::endFirstGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -440,7 +577,7 @@ void proc::endFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::endNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::endNextGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -460,7 +597,7 @@ void proc::endNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::endBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::endBackGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -480,7 +617,7 @@ void proc::endBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::endLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::endLastGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -498,7 +635,7 @@ void proc::endLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::endNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::endNumGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     size_t num = blok.olddataint[0];
 
@@ -521,7 +658,7 @@ void proc::endNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curA
     }
 }
 
-void proc::endMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::endMultiMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1)
     {
@@ -548,7 +685,7 @@ void proc::endMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::endFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::endFirstMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -570,7 +707,7 @@ void proc::endFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::endLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::endLastMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -595,7 +732,7 @@ void proc::endLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::endNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::endNumMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -624,7 +761,7 @@ void proc::endNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::endSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::endSingle(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -640,7 +777,7 @@ void proc::endSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAni
     }
 }
 
-void proc::stateMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateMultiGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
         blocks[blok.front] = to_string(curAnimInfo.fixedStateID[blok.olddataint[0]]
@@ -649,7 +786,7 @@ void proc::stateMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
                                        + blok.olddataint[1]);
 }
 
-void proc::stateFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateFirstGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
         blocks[blok.front]
@@ -658,7 +795,7 @@ void proc::stateFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
                         + blok.olddataint[1]);
 }
 
-void proc::stateNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateNextGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -671,7 +808,7 @@ void proc::stateNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::stateBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateBackGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -684,7 +821,7 @@ void proc::stateBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::stateLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateLastGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -695,7 +832,7 @@ void proc::stateLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::stateNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateNumGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     size_t num = blok.olddataint[0];
 
@@ -713,7 +850,7 @@ void proc::stateNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::stateMultiMasterToGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateMultiMasterToGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -734,7 +871,7 @@ void proc::stateMultiMasterToGroup(nemesis::scope blok, VecStr& blocks, AnimThre
     }
 }
 
-void proc::stateMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateMultiMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -755,7 +892,7 @@ void proc::stateMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     }
 }
 
-void proc::stateFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateFirstMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -776,7 +913,7 @@ void proc::stateFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     }
 }
 
-void proc::stateLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateLastMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -797,7 +934,7 @@ void proc::stateLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     }
 }
 
-void proc::stateNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateNumMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     size_t num = blok.olddataint[2];
 
@@ -825,7 +962,7 @@ void proc::stateNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::stateSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::stateSingle(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -841,7 +978,7 @@ void proc::stateSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curA
     }
 }
 
-void proc::filepathMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filepathMultiGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1)
     {
@@ -855,7 +992,7 @@ void proc::filepathMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInf
     }
 }
 
-void proc::filepathFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filepathFirstGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -863,7 +1000,7 @@ void proc::filepathFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInf
     }
 }
 
-void proc::filepathNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filepathNextGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -874,7 +1011,7 @@ void proc::filepathNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo
     }
 }
 
-void proc::filepathBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filepathBackGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -885,7 +1022,7 @@ void proc::filepathBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo
     }
 }
 
-void proc::filepathLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filepathLastGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -894,7 +1031,7 @@ void proc::filepathLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo
     }
 }
 
-void proc::filepathNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filepathNumGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     size_t num = blok.olddataint[0];
 
@@ -907,7 +1044,7 @@ void proc::filepathNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
         blocks[blok.front] = curAnimInfo.filepath + curAnimInfo.curAnim->GetGroupAnimInfo()[num]->filename;
 }
 
-void proc::filepathMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filepathMultiMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1) ErrorMessage(1146, format, behaviorFile, curAnimInfo.numline);
 
@@ -922,7 +1059,7 @@ void proc::filepathMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadIn
                                  ->format["FilePath"];
 }
 
-void proc::filepathFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filepathFirstMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -935,7 +1072,7 @@ void proc::filepathFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadIn
                                  ->format["FilePath"];
 }
 
-void proc::filepathLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filepathLastMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -948,7 +1085,7 @@ void proc::filepathLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInf
                                  ->format["FilePath"];
 }
 
-void proc::filepathNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filepathNumMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -961,7 +1098,7 @@ void proc::filepathNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo
                                  ->format["FilePath"];
 }
 
-void proc::filepathSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filepathSingle(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.filename == combineBlocks(blok, blocks))
     {
@@ -972,7 +1109,7 @@ void proc::filepathSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
         blocks[blok.front] = curAnimInfo.filepath + curAnimInfo.filename;
 }
 
-void proc::filenameMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filenameMultiGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1) ErrorMessage(1146, format, behaviorFile, curAnimInfo.numline);
 
@@ -983,7 +1120,7 @@ void proc::filenameMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInf
     }
 }
 
-void proc::filenameFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filenameFirstGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -992,7 +1129,7 @@ void proc::filenameFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInf
     }
 }
 
-void proc::filenameNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filenameNextGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1008,7 +1145,7 @@ void proc::filenameNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo
     }
 }
 
-void proc::filenameBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filenameBackGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1024,7 +1161,7 @@ void proc::filenameBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo
     }
 }
 
-void proc::filenameLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filenameLastGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1033,7 +1170,7 @@ void proc::filenameLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo
     }
 }
 
-void proc::filenameNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filenameNumGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     size_t num = blok.olddataint[0];
 
@@ -1049,7 +1186,7 @@ void proc::filenameNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     }
 }
 
-void proc::filenameMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filenameMultiMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -1070,7 +1207,7 @@ void proc::filenameMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadIn
     }
 }
 
-void proc::filenameFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filenameFirstMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -1086,7 +1223,7 @@ void proc::filenameFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadIn
     }
 }
 
-void proc::filenameLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filenameLastMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -1102,7 +1239,7 @@ void proc::filenameLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInf
     }
 }
 
-void proc::filenameNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filenameNumMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -1118,13 +1255,13 @@ void proc::filenameNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo
     }
 }
 
-void proc::filenameSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::filenameSingle(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
         blocks[blok.front] = curAnimInfo.filename.substr(0, curAnimInfo.filename.find_last_of("."));
 }
 
-void proc::pathSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::pathSingle(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1137,7 +1274,7 @@ void proc::pathSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAn
     }
 }
 
-void proc::AOMultiGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOMultiGroupA(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1 || curAnimInfo.optionMulti == -1)
     {
@@ -1151,7 +1288,7 @@ void proc::AOMultiGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::AOMultiGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOMultiGroupB(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1)
     {
@@ -1165,7 +1302,7 @@ void proc::AOMultiGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::AOFirstGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOFirstGroupA(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.optionMulti == -1)
     {
@@ -1179,7 +1316,7 @@ void proc::AOFirstGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::AOFirstGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOFirstGroupB(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1188,7 +1325,7 @@ void proc::AOFirstGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::AONextGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AONextGroupA(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.optionMulti == -1)
     {
@@ -1209,7 +1346,7 @@ void proc::AONextGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::AONextGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AONextGroupB(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1227,7 +1364,7 @@ void proc::AONextGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::AOBackGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOBackGroupA(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.optionMulti == -1)
     {
@@ -1247,7 +1384,7 @@ void proc::AOBackGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::AOBackGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOBackGroupB(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1262,7 +1399,7 @@ void proc::AOBackGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::AOLastGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOLastGroupA(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.optionMulti == -1)
     {
@@ -1276,7 +1413,7 @@ void proc::AOLastGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::AOLastGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOLastGroupB(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1285,7 +1422,7 @@ void proc::AOLastGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::AONumGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AONumGroupA(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.optionMulti == -1)
     {
@@ -1306,7 +1443,7 @@ void proc::AONumGroupA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curA
     }
 }
 
-void proc::AONumGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AONumGroupB(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     size_t num = blok.olddataint[0];
 
@@ -1322,7 +1459,7 @@ void proc::AONumGroupB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curA
     }
 }
 
-void proc::AOMultiMasterA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOMultiMasterA(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1 || curAnimInfo.optionMulti == -1)
     {
@@ -1342,7 +1479,7 @@ void proc::AOMultiMasterA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::AOMultiMasterB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOMultiMasterB(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1)
     {
@@ -1362,7 +1499,7 @@ void proc::AOMultiMasterB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::AOFirstMasterA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOFirstMasterA(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.optionMulti == -1)
     {
@@ -1381,7 +1518,7 @@ void proc::AOFirstMasterA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::AOFirstMasterB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOFirstMasterB(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -1395,7 +1532,7 @@ void proc::AOFirstMasterB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::AOLastMasterA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOLastMasterA(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.optionMulti == -1)
     {
@@ -1415,7 +1552,7 @@ void proc::AOLastMasterA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::AOLastMasterB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOLastMasterB(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -1430,7 +1567,7 @@ void proc::AOLastMasterB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::AONumMasterA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AONumMasterA(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.optionMulti == -1)
     {
@@ -1456,7 +1593,7 @@ void proc::AONumMasterA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::AONumMasterB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AONumMasterB(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     size_t num = blok.olddataint[0];
 
@@ -1477,7 +1614,7 @@ void proc::AONumMasterB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::AOSingleA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOSingleA(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.optionMulti == -1)
     {
@@ -1495,7 +1632,7 @@ void proc::AOSingleA(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAni
     }
 }
 
-void proc::AOSingleB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::AOSingleB(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1508,7 +1645,7 @@ void proc::AOSingleB(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAni
     }
 }
 
-void proc::MAEMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::MAEMultiGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1) ErrorMessage(1146, format, behaviorFile, curAnimInfo.numline);
 
@@ -1516,13 +1653,13 @@ void proc::MAEMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
         blocks[blok.front] = curAnimInfo.curAnim->GetGroupAnimInfo()[curAnimInfo.animMulti]->mainAnimEvent;
 }
 
-void proc::MAEFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::MAEFirstGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
         blocks[blok.front] = curAnimInfo.curAnim->GetGroupAnimInfo()[0]->mainAnimEvent;
 }
 
-void proc::MAENextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::MAENextGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1533,7 +1670,7 @@ void proc::MAENextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::MAEBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::MAEBackGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1544,7 +1681,7 @@ void proc::MAEBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::MAELastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::MAELastGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1552,7 +1689,7 @@ void proc::MAELastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::MAENumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::MAENumGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     size_t num = blok.olddataint[0];
 
@@ -1567,7 +1704,7 @@ void proc::MAENumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curA
     }
 }
 
-void proc::MAEMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::MAEMultiMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1)
     {
@@ -1587,7 +1724,7 @@ void proc::MAEMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::MAEFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::MAEFirstMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -1600,7 +1737,7 @@ void proc::MAEFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::MAELastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::MAELastMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -1615,7 +1752,7 @@ void proc::MAELastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::MAENumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::MAENumMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -1635,12 +1772,12 @@ void proc::MAENumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cur
     }
 }
 
-void proc::MAESingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::MAESingle(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo)) blocks[blok.front] = curAnimInfo.mainAnimEvent;
 }
 
-void proc::addOnMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::addOnMultiGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1) ErrorMessage(1146, format, behaviorFile, curAnimInfo.numline);
 
@@ -1677,7 +1814,7 @@ void proc::addOnMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     }
 }
 
-void proc::addOnFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::addOnFirstGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1712,7 +1849,7 @@ void proc::addOnFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     }
 }
 
-void proc::addOnNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::addOnNextGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1751,7 +1888,7 @@ void proc::addOnNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::addOnBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::addOnBackGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1790,7 +1927,7 @@ void proc::addOnBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::addOnLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::addOnLastGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -1826,7 +1963,7 @@ void proc::addOnLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::addOnNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::addOnNumGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     size_t num = blok.olddataint[0];
 
@@ -1868,7 +2005,7 @@ void proc::addOnNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& cu
     }
 }
 
-void proc::addOnMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::addOnMultiMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.animMulti == -1) ErrorMessage(1146, format, behaviorFile, curAnimInfo.numline);
 
@@ -1910,7 +2047,7 @@ void proc::addOnMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     }
 }
 
-void proc::addOnFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::addOnFirstMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -1950,7 +2087,7 @@ void proc::addOnFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     }
 }
 
-void proc::addOnLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::addOnLastMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.groupMulti == -1)
     {
@@ -1990,7 +2127,7 @@ void proc::addOnLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     }
 }
 
-void proc::addOnNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::addOnNumMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     size_t num = blok.olddataint[0];
 
@@ -2032,7 +2169,7 @@ void proc::addOnNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& c
     }
 }
 
-void proc::addOnSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::addOnSingle(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -2083,7 +2220,7 @@ void proc::addOnSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curA
     }
 }
 
-void proc::lastState(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::lastState(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
@@ -2108,7 +2245,7 @@ void proc::lastState(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAni
     }
 }
 
-void proc::eventID(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::eventID(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     string eventname = combineBlocks(blok.olddataint[0], blok.olddataint[1], blocks);
 
@@ -2127,7 +2264,7 @@ void proc::eventID(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimI
     }
 }
 
-void proc::variableID(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::variableID(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     string variablename = combineBlocks(blok.olddataint[0], blok.olddataint[1], blocks);
 
@@ -2146,14 +2283,14 @@ void proc::variableID(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAn
     }
 }
 
-void proc::crc32(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::crc32(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     string crc32line = nemesis::to_lower_copy(combineBlocks(blok, blocks));
 
     if (clearBlocks(blok, blocks, curAnimInfo)) blocks[blok.front] = to_string(CRC32Convert(crc32line));
 }
 
-void proc::import(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::import(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     string import = combineBlocks(blok, blocks);
 
@@ -2199,21 +2336,24 @@ void proc::import(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimIn
                     : keyword = keyword.substr(0, keyword.length() - 4);
             }
 
-            Lockless lock(curAnimInfo.animLock->exportLock);
-
-            try
-            {
-                tempID = curAnimInfo.newImport->at(file).at(keyword);
-            }
-            catch (const std::exception&)
             {
+                Lockless lock(curAnimInfo.animLock->exportLock);
+
+                try
+                {
+                    tempID = curAnimInfo.newImport->at(file).at(keyword);
+                }
+                catch (const std::exception&)
+                {
+                }
             }
 
+            // imports created in this phase are registered once every instance is done
             if (tempID.length() == 0)
             {
-                tempID = (isMaster || isGroup ? curAnimInfo.curGroup->newID() : curAnimInfo.curAnim->newID());
-                curAnimInfo.IDExist[import]             = tempID;
-                (*curAnimInfo.newImport)[file][keyword] = tempID;
+                tempID = isMaster || isGroup ? curAnimInfo.curGroup->importID(file, keyword)
+                                             : curAnimInfo.curAnim->importID(file, keyword);
+                curAnimInfo.IDExist[import] = tempID;
             }
 
             blocks[blok.front] = tempID;
@@ -2225,7 +2365,7 @@ void proc::import(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimIn
     }
 }
 
-void proc::motionDataMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::motionDataMultiGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2263,7 +2403,7 @@ void proc::motionDataMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadI
     }
 }
 
-void proc::motionDataFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::motionDataFirstGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2296,7 +2436,7 @@ void proc::motionDataFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadI
     }
 }
 
-void proc::motionDataNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::motionDataNextGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2331,7 +2471,7 @@ void proc::motionDataNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadIn
     }
 }
 
-void proc::motionDataBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::motionDataBackGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2366,7 +2506,7 @@ void proc::motionDataBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadIn
     }
 }
 
-void proc::motionDataLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::motionDataLastGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2399,7 +2539,7 @@ void proc::motionDataLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadIn
     }
 }
 
-void proc::motionDataNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::motionDataNumGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2439,7 +2579,7 @@ void proc::motionDataNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInf
     }
 }
 
-void proc::motionDataMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::motionDataMultiMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2483,7 +2623,7 @@ void proc::motionDataMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThread
     }
 }
 
-void proc::motionDataFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::motionDataFirstMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2521,7 +2661,7 @@ void proc::motionDataFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThread
     }
 }
 
-void proc::motionDataLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::motionDataLastMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2560,7 +2700,7 @@ void proc::motionDataLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadI
     }
 }
 
-void proc::motionDataNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::motionDataNumMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2605,7 +2745,7 @@ void proc::motionDataNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadIn
     }
 }
 
-void proc::motionDataSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::motionDataSingle(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2643,7 +2783,7 @@ void proc::motionDataSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo&
     }
 }
 
-void proc::rotationDataMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rotationDataMultiGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2678,7 +2818,7 @@ void proc::rotationDataMultiGroup(nemesis::scope blok, VecStr& blocks, AnimThrea
     }
 }
 
-void proc::rotationDataFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rotationDataFirstGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2711,7 +2851,7 @@ void proc::rotationDataFirstGroup(nemesis::scope blok, VecStr& blocks, AnimThrea
     }
 }
 
-void proc::rotationDataNextGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rotationDataNextGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2746,7 +2886,7 @@ void proc::rotationDataNextGroup(nemesis::scope blok, VecStr& blocks, AnimThread
     }
 }
 
-void proc::rotationDataBackGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rotationDataBackGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2781,7 +2921,7 @@ void proc::rotationDataBackGroup(nemesis::scope blok, VecStr& blocks, AnimThread
     }
 }
 
-void proc::rotationDataLastGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rotationDataLastGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2814,7 +2954,7 @@ void proc::rotationDataLastGroup(nemesis::scope blok, VecStr& blocks, AnimThread
     }
 }
 
-void proc::rotationDataNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rotationDataNumGroup(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2854,7 +2994,7 @@ void proc::rotationDataNumGroup(nemesis::scope blok, VecStr& blocks, AnimThreadI
     }
 }
 
-void proc::rotationDataMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rotationDataMultiMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2898,7 +3038,7 @@ void proc::rotationDataMultiMaster(nemesis::scope blok, VecStr& blocks, AnimThre
     }
 }
 
-void proc::rotationDataFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rotationDataFirstMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2936,7 +3076,7 @@ void proc::rotationDataFirstMaster(nemesis::scope blok, VecStr& blocks, AnimThre
     }
 }
 
-void proc::rotationDataLastMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rotationDataLastMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -2975,7 +3115,7 @@ void proc::rotationDataLastMaster(nemesis::scope blok, VecStr& blocks, AnimThrea
     }
 }
 
-void proc::rotationDataNumMaster(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rotationDataNumMaster(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -3020,7 +3160,7 @@ void proc::rotationDataNumMaster(nemesis::scope blok, VecStr& blocks, AnimThread
     }
 }
 
-void proc::rotationDataSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::rotationDataSingle(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.fixedStateID.size() != 0 || curAnimInfo.eventid.size() != 0
         || curAnimInfo.variableid.size() != 0)
@@ -3058,21 +3198,20 @@ void proc::rotationDataSingle(nemesis::scope blok, VecStr& blocks, AnimThreadInf
     }
 }
 
-void proc::animOrder(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::animOrder(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     string animPath = combineBlocks(blok.olddataint[0], blok.olddataint[1], blocks);
 
     if (clearBlocks(blok, blocks, curAnimInfo))
     {
-        auto& ptr = charAnimDataInfo.find(
+        const auto* ptr = nemesis::GenerationContext::Current().charAnimDataInfo.Find(
             nemesis::to_lower_copy(curAnimInfo.project.substr(0, curAnimInfo.project.rfind(".txt"))));
 
-        if (ptr != charAnimDataInfo.end())
+        if (ptr)
         {
-            auto& ptr2 = ptr->second.find(
-                nemesis::to_lower_copy(std::filesystem::path(animPath).filename().string()));
+            auto ptr2 = ptr->find(nemesis::to_lower_copy(std::filesystem::path(animPath).filename().string()));
 
-            if (ptr2 != ptr->second.end())
+            if (ptr2 != ptr->end())
             {
                 blocks[blok.front] = to_string(ptr2->second->GetOrder());
             }
@@ -3080,89 +3219,105 @@ void proc::animOrder(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAni
     }
 }
 
-void proc::regisAnim(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::regisAnim(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     string animPath = combineBlocks(blok, blocks);
     addUsedAnim(behaviorFile, animPath);
+
+    if (curAnimInfo.references) curAnimInfo.references->AddClip(curAnimInfo.clipName, animPath);
+}
+
+void proc::regisClipName(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+{
+    curAnimInfo.clipName = combineBlocks(blok, blocks);
 }
 
-void proc::regisBehavior(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::regisBehavior(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     string behaviorName = combineBlocks(blok, blocks);
+
+    if (curAnimInfo.references) curAnimInfo.references->AddBehavior(behaviorName);
+
     nemesis::to_lower(behaviorName);
-    behaviorJoints[behaviorName].push_back(nemesis::to_lower_copy(behaviorFile));
+    nemesis::GenerationContext::Current().behaviorJoints.Update(
+        behaviorName, [&](VecStr& joints) { joints.push_back(nemesis::to_lower_copy(behaviorFile)); });
 }
 
-void proc::localNegative(nemesis::scope blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+void proc::localNegative(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (combineBlocks(blok, blocks)[0] == '-') curAnimInfo.negative = true;
 }
 
-void proc::blocksCompile(VecStr blocks, AnimThreadInfo& curAnimInfo) const
+void proc::blocksCompile(VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
-    auto bkitr = brackets.find(curAnimInfo.numline);
+    uint32_t pc = size_t(curAnimInfo.numline) < lineEntry.size() ? lineEntry[curAnimInfo.numline] : noProgram;
 
-    if (bkitr != brackets.end())
+    for (; pc != noProgram && program[pc].op != Opcode::End; ++pc)
     {
-        for (auto& bracket : bkitr->second)
-        {
-            blocks[bracket] = "";
-        }
-    }
-
-    auto mcitr = hasMC.find(curAnimInfo.numline);
+        const Instruction& inst = program[pc];
 
-    if (mcitr != hasMC.end())
-    {
-        bool done = false;
-
-        for (auto& choice : multiChoice.at(curAnimInfo.numline))
+        switch (inst.op)
         {
-            if (done)
+            case Opcode::ClearBrackets:
             {
-                curAnimInfo.failed.push_back(choice_c(choice.locateA, choice.locateB));
+                for (uint32_t i = inst.operand; i < inst.operand + inst.count; ++i)
+                {
+                    blocks[bracketPositions[i]].clear();
+                }
+
+                break;
             }
-            else
+            case Opcode::Choose:
             {
-                if (choice.condition->isTrue(
-                        curAnimInfo, *this, format, behaviorFile, curAnimInfo.numline, isGroup, isMaster))
+                bool done = false;
+
+                for (uint32_t i = inst.operand; i < inst.operand + inst.count; ++i)
                 {
-                    done                 = true;
-                    curAnimInfo.captured = make_shared<choice_c>(choice.locateA, choice.locateB);
+                    const nemesis::MultiChoice& choice = choices[i];
+
+                    if (!done
+                        && choice.condition->isTrue(
+                            curAnimInfo, *this, format, behaviorFile, curAnimInfo.numline, isGroup, isMaster))
+                    {
+                        done                 = true;
+                        curAnimInfo.captured = make_shared<choice_c>(choice.locateA, choice.locateB);
+                    }
+                    else
+                    {
+                        curAnimInfo.failed.push_back(choice_c(choice.locateA, choice.locateB));
+                    }
                 }
-                else
+
+                break;
+            }
+            case Opcode::Call:
+            {
+                for (uint32_t i = inst.operand; i < inst.operand + inst.count; ++i)
                 {
-                    curAnimInfo.failed.push_back(choice_c(choice.locateA, choice.locateB));
+                    (this->*scopes[i].func)(scopes[i], blocks, curAnimInfo);
                 }
-            }
-        }
-    }
-
-    auto lbitr = lineblocks.find(curAnimInfo.numline);
 
-    if (lbitr != lineblocks.end())
-    {
-        for (auto& bloklist : lbitr->second.blocksize)
-        {
-            for (auto& blok : bloklist.second)
+                break;
+            }
+            case Opcode::EndChoice:
             {
-                (this->*blok.func)(blok, blocks, curAnimInfo);
+                curAnimInfo.failed.clear();
+                curAnimInfo.captured.reset();
+                break;
             }
+            default: break;
         }
     }
 
-    if (mcitr != hasMC.end())
-    {
-        for (auto& blok : choiceblocks.at(curAnimInfo.numline))
-        {
-            (this->*blok.func)(blok, blocks, curAnimInfo);
-        }
+    size_t length = 0;
 
-        curAnimInfo.failed.clear();
-        curAnimInfo.captured.reset();
+    for (auto& each : blocks)
+    {
+        length += each.length();
     }
 
     curAnimInfo.line->clear();
+    curAnimInfo.line->reserve(length);
 
     for (auto& each : blocks)
     {
@@ -3175,7 +3330,7 @@ bool proc::isThisMaster()
     return isMaster;
 }
 
-bool proc::clearBlocks(nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
+bool proc::clearBlocks(const nemesis::scope& blok, VecStr& blocks, AnimThreadInfo& curAnimInfo) const
 {
     if (curAnimInfo.failed.size() > 0)
     {
@@ -3214,7 +3369,7 @@ void proc::blockCheck(size_t front, size_t back, int numline)
     }
 }
 
-string proc::combineBlocks(nemesis::scope& blok, VecStr& blocks) const
+string proc::combineBlocks(const nemesis::scope& blok, VecStr& blocks) const
 {
     string option;
 
@@ -1,4 +1,5 @@
 #include "generate/animationdata.h"
+#include "generate/generationcontext.h"
 #include "generate/animationdatatracker.h"
 
 #pragma warning(disable:4503)
@@ -78,7 +79,14 @@ AnimDataProject::AnimDataProject(VecStr animdatafile, string project, string mod
         characterFile = nemesis::to_lower_copy(std::filesystem::path(each).stem().string());
 	}
 
-	AnimDataProcess(animdatalist, startline, animdatafile, project, modcode, exchange, clipPtrAnimData[characterFile], codeTracker);
+	AnimDataProcess(animdatalist,
+					startline,
+					animdatafile,
+					project,
+					modcode,
+					exchange,
+					nemesis::GenerationContext::Current().clipPtrAnimData[characterFile],
+					codeTracker);
 
 	if (error) throw nemesis::exception();
 
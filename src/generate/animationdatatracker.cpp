@@ -5,9 +5,6 @@
 
 using namespace std;
 
-map<string, map<string, vector<shared_ptr<AnimationDataTracker>>>> clipPtrAnimData;
-map<string, map<string, shared_ptr<AnimationDataTracker>>> charAnimDataInfo;
-
 AnimationDataTracker::AnimationDataTracker(int _order, string _filename)
 {
     order    = _order;
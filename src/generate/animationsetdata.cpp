@@ -4,13 +4,14 @@
 
 #include "generate/animationdatatracker.h"
 #include "generate/animationsetdata.h"
+#include "generate/generationcontext.h"
 #include "generate/playerexclusive.h"
 
 using namespace std;
 
-unordered_map<string, string> crc32Cache;
+using AAListType = unordered_map<string, vector<const VecStr*>>;
 
-void DataPackProcess(map<string, datapack, alphanum_less>& storeline, int& startline, VecStr& animdatafile);
+void DataPackProcess(nemesis::NaturalMap<datapack>& storeline, int& startline, VecStr& animdatafile);
 void EquipPackProcess(
     vector<equip>& storeline, int& startline, VecStr& animdatafile, string projectname, string header);
 void TypePackProcess(
@@ -22,12 +23,42 @@ void CRC32Process(vector<crc32>& storeline,
                   VecStr& animdatafile,
                   string projectname,
                   string header,
-                  unordered_map<string, shared_ptr<VecStr>>& AAList,
+                  const AAListType& AAList,
                   string projectPath);
+string GetCRC32Cache(const string& line);
+
+ASDCRC32List::ASDCRC32List()
+{
+    nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
+    alternate.reserve(context.alternateAnim.size());
+
+    for (auto& anim : context.alternateAnim)
+    {
+        size_t pos      = anim.first.rfind("_1p*");
+        bool fp         = pos == anim.first.length() - 4;
+        string animFile = fp ? anim.first.substr(0, pos) : anim.first;
+
+        alternate.emplace_back();
+        alternate.back().isFirstPerson = fp;
+        alternate.back().animCRC32     = to_string(CRC32Convert(nemesis::to_lower_copy(GetFileName(animFile))));
+        alternate.back().animlist      = anim.second;
+    }
+
+    for (auto& each : context.pcealist)
+    {
+        for (auto& animPath : each.animPathList)
+        {
+            pcea.emplace_back();
+            pcea.back().animCRC32 = to_string(CRC32Convert(nemesis::to_lower_copy(GetFileName(animPath.first))));
+            pcea.back().animlist.push_back(animPath.second.substr(wordFind(animPath.second, "Nemesis_PCEA")));
+        }
+    }
+}
 
 AnimationDataProject::AnimationDataProject(int& startline,
                                            VecStr& animdatafile,
                                            string projectname,
+                                           const ASDCRC32List& crc32list,
                                            const NemesisInfo* nemesisInfo)
 {
     try
@@ -37,14 +68,15 @@ AnimationDataProject::AnimationDataProject(int& startline,
         ++startline;
         wstring projectPath;
         wstring projectPath_fp;
-        unordered_map<string, shared_ptr<VecStr>> AAList;
-        wstring projectFileName = nemesis::to_lower_copy(std::filesystem::path(projectname).stem().wstring());
+        AAListType AAList;
+        const auto& behaviorProjectPath = nemesis::GenerationContext::Current().behaviorProjectPath;
+        auto projItr
+            = behaviorProjectPath.find(nemesis::InternPath(std::filesystem::path(projectname).stem().wstring()));
 
         // assume current project has new alternate animation installed
-        if (behaviorProjectPath[projectFileName].length() > 0)
+        if (projItr != behaviorProjectPath.end() && projItr->second.length() > 0)
         {
-            projectPath
-                = nemesis::to_lower_copy(behaviorProjectPath[projectFileName] + L"\\animations");
+            projectPath     = nemesis::to_lower_copy(projItr->second + L"\\animations");
             projectPath_fp  = projectPath + L"\\_1stperson";
             VecWstr pathList = {projectPath,
                                 projectPath + L"\\male",
@@ -73,55 +105,24 @@ AnimationDataProject::AnimationDataProject(int& startline,
                 pathCRC32_fp.push_back(to_string(CRC32Convert(path)));
             }
 
-            VecWstr* pathListPoint;
-            VecStr* pathCRC32Point;
-
-            // cache all alternate animations
-            for (auto& anim : alternateAnim)
+            // link all alternate animations
+            for (auto& anim : crc32list.alternate)
             {
-                size_t pos       = anim.first.rfind("_1p*");
-                bool fp          = pos == anim.first.length() - 4;
-                string animFile  = fp ? anim.first.substr(0, pos) : anim.first;
-                string animCRC32 = to_string(CRC32Convert(nemesis::to_lower_copy(GetFileName(animFile))));
-
-                if (fp)
-                {
-                    pathListPoint  = &pathList_fp;
-                    pathCRC32Point = &pathCRC32_fp;
-                }
-                else
-                {
-                    pathListPoint  = &pathList;
-                    pathCRC32Point = &pathCRC32;
-                }
-
-                for (uint i = 0; i < pathCRC32Point->size(); ++i)
+                for (auto& path : anim.isFirstPerson ? pathCRC32_fp : pathCRC32)
                 {
-                    AAList[pathCRC32Point->at(i) + "," + animCRC32 + ",7891816"]
-                        = make_shared<VecStr>(anim.second);
+                    AAList[path + "," + anim.animCRC32 + ",7891816"] = {&anim.animlist};
                 }
             }
 
-            if (isFileExist(nemesisInfo->GetDataPath() + nemesis::transform_to<wstring>(projectPath) + L"\\nemesis_pcea\\pcea_animations")
-                && pcealist.size() > 0)
+            if (crc32list.pcea.size() > 0
+                && isFileExist(nemesisInfo->GetDataPath() + projectPath + L"\\nemesis_pcea\\pcea_animations"))
             {
-                // cache all pcea animations
-                for (auto& pcea : pcealist)
+                // link all pcea animations
+                for (auto& anim : crc32list.pcea)
                 {
-                    for (auto& animPath : pcea.animPathList)
+                    for (auto& path : pathCRC32)
                     {
-                        string animCRC32
-                            = to_string(CRC32Convert(nemesis::to_lower_copy(GetFileName(animPath.first))));
-                        string pathline = animPath.second.substr(wordFind(animPath.second, "Nemesis_PCEA"));
-
-                        for (uint i = 0; i < pathCRC32.size(); ++i)
-                        {
-                            string crc32line = pathCRC32[i] + "," + animCRC32 + ",7891816";
-
-                            if (!AAList[crc32line]) AAList[crc32line] = make_shared<VecStr>();
-
-                            AAList[crc32line]->push_back(pathline);
-                        }
+                        AAList[path + "," + anim.animCRC32 + ",7891816"].push_back(&anim.animlist);
                     }
                 }
             }
@@ -158,7 +159,7 @@ AnimationDataProject::AnimationDataProject(int& startline,
     }
 }
 
-void DataPackProcess(map<string, datapack, alphanum_less>& storeline, int& startline, VecStr& animdatafile)
+void DataPackProcess(nemesis::NaturalMap<datapack>& storeline, int& startline, VecStr& animdatafile)
 {
     if (startline >= int(animdatafile.size()))
     {
@@ -406,13 +407,13 @@ void AnimPackProcess(
 
         for (auto& atkData : tempAP.attackClip)
         {
-            const auto& ptr = clipPtrAnimData.find(projectname);
+            const auto* ptr = nemesis::GenerationContext::Current().clipPtrAnimData.Find(projectname);
 
-            if (ptr != clipPtrAnimData.end())
+            if (ptr)
             {
-                const auto& ptr2 = ptr->second.find(atkData.data);
+                const auto& ptr2 = ptr->find(atkData.data);
 
-                if (ptr2 != ptr->second.end())
+                if (ptr2 != ptr->end())
                 {
                     if (ptr2->second.size() > 0)
                     {
@@ -448,7 +449,7 @@ void CRC32Process(vector<crc32>& storeline,
                   VecStr& animdatafile,
                   string projectname,
                   string header,
-                  unordered_map<string, shared_ptr<VecStr>>& AAList,
+                  const AAListType& AAList,
                   string projectPath)
 {
     if (startline >= int(animdatafile.size()))
@@ -512,55 +513,127 @@ void CRC32Process(vector<crc32>& storeline,
 
         if (it != AAList.end())
         {
-            for (auto& anim : *it->second)
+            for (auto& animlist : it->second)
             {
-                if (anim != "x")
+                for (auto& anim : *animlist)
                 {
-                    crc32 newCRC32;
-                    string line;
-                    string combined;
-                    string modID = GetFileDirectory(anim);
-                    modID.pop_back();
-                    modID   = nemesis::to_lower_copy(projectPath + "\\" + modID);
-                    auto it = crc32Cache.find(modID);
-
-                    if (it != crc32Cache.end())
-                        line = it->second;
-                    else
+                    if (anim != "x")
                     {
-                        line              = to_string(CRC32Convert(modID));
-                        crc32Cache[modID] = line;
+                        crc32 newCRC32;
+                        string modID = GetFileDirectory(anim);
+                        modID.pop_back();
+                        newCRC32.filepath   = GetCRC32Cache(nemesis::to_lower_copy(projectPath + "\\" + modID));
+                        newCRC32.filename   = GetCRC32Cache(nemesis::to_lower_copy(GetFileName(anim)));
+                        newCRC32.fileformat = "7891816";
+                        string combined     = newCRC32.filepath + "," + newCRC32.filename + ",7891816";
+
+                        if (isExisted.find(combined) == isExisted.end())
+                        {
+                            newCRC.push_back(newCRC32);
+                            isExisted.insert(combined);
+                        }
                     }
+                }
+            }
+        }
+    }
 
-                    combined.append(line + ",");
-                    newCRC32.filepath = line;
+    storeline.insert(storeline.end(), newCRC.begin(), newCRC.end());
+}
 
-                    modID = nemesis::to_lower_copy(GetFileName(anim));
-                    it    = crc32Cache.find(modID);
+string GetCRC32Cache(const string& line)
+{
+    return nemesis::GenerationContext::Current().crc32Cache.Update(line, [&](string& crc32line) {
+        if (crc32line.empty()) crc32line = to_string(CRC32Convert(line));
 
-                    if (it != crc32Cache.end())
-                        line = it->second;
-                    else
-                    {
-                        line              = to_string(CRC32Convert(modID));
-                        crc32Cache[modID] = line;
-                    }
+        return crc32line;
+    });
+}
 
-                    combined.append(line + ",7891816");
-                    newCRC32.filename   = line;
-                    newCRC32.fileformat = "7891816";
+void WriteAnimSetData(FileWriter& output,
+                      const VecStr& projectList,
+                      const unordered_map<string, unique_ptr<AnimationDataProject>>& ASDData)
+{
+    // flush threshold of the output buffer
+    const size_t chunksize = 1 << 20;
 
-                    if (isExisted.find(combined) == isExisted.end())
-                    {
-                        newCRC.push_back(newCRC32);
-                        isExisted.insert(combined);
-                    }
+    string buffer;
+    buffer.reserve(chunksize + 4096);
+
+    const auto append = [&](const string& line) {
+        buffer.append(line);
+        buffer.push_back('\n');
+
+        if (buffer.length() < chunksize) return;
+
+        output << buffer;
+        buffer.clear();
+    };
+
+    append(to_string(projectList.size()));
+
+    for (auto& curProject : projectList)
+    {
+        append(curProject);
+    }
+
+    for (auto& curProject : projectList)
+    {
+        auto& datalist = ASDData.at(curProject)->datalist;
+        append(to_string(datalist.size()));
+
+        for (auto& data : datalist)
+        {
+            append(data.first);
+        }
+
+        for (auto& data : datalist)
+        {
+            append("V3");
+            append(to_string(data.second.equiplist.size()));
+
+            for (auto& equip : data.second.equiplist)
+            {
+                append(equip.name);
+            }
+
+            append(to_string(data.second.typelist.size()));
+
+            for (auto& type : data.second.typelist)
+            {
+                append(type.name);
+                append(type.equiptype1);
+                append(type.equiptype2);
+            }
+
+            append(to_string(data.second.animlist.size()));
+
+            for (auto& anim : data.second.animlist)
+            {
+                append(anim.eventname);
+                append(anim.unknown);
+                append(to_string(anim.attackClip.size()));
+
+                for (auto& atk : anim.attackClip)
+                {
+                    append(atk.data);
                 }
             }
+
+            append(to_string(data.second.crc32list.size()));
+
+            for (auto& crc32 : data.second.crc32list)
+            {
+                append(crc32.filepath);
+                append(crc32.filename);
+                append(crc32.fileformat);
+            }
+
+            if (error) throw nemesis::exception();
         }
     }
 
-    storeline.insert(storeline.end(), newCRC.begin(), newCRC.end());
+    if (buffer.length() > 0) output << buffer;
 }
 
 ASDFormat::position
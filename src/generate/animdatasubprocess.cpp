@@ -5,6 +5,7 @@
 #include "ui/Terminator.h"
 
 #include "utilities/conditions.h"
+#include "utilities/lineclassifier.h"
 #include "utilities/readtextfile.h"
 
 #include "generate/animationdata.h"
@@ -17,10 +18,6 @@
 using namespace std;
 
 extern Terminator* p_terminate;
-extern atomic<int> m_RunningThread;
-extern atomic<int> behaviorRun;
-extern mutex cv2_m;
-extern condition_variable cv2;
 
 struct invertInt
 {
@@ -59,7 +56,7 @@ void BehaviorSub::AnimDataCompilation()
 {
     try
     {
-        ++m_RunningThread;
+        ++process->context.runningThread;
 
         try
         {
@@ -158,14 +155,15 @@ void BehaviorSub::CompilingAnimData()
                     catalyst.push_back(make_pair(numline, line));
                 };
 
-                bool skip = false;
+                bool skip                    = false;
+                nemesis::LineClass lineClass = nemesis::ClassifyLine(line);
                 ++numline;
 
-                if (line.find("<!-- ") != NOT_FOUND)
+                if (lineClass.Has(nemesis::LineMarker::Comment))
                 {
-                    if (line.find("<!-- NEW *") != NOT_FOUND)
+                    if (lineClass.Has(nemesis::LineMarker::NewMod))
                     {
-                        size_t tempint = line.find("<!-- NEW *") + 10;
+                        size_t tempint = lineClass.Find(nemesis::LineMarker::NewMod) + 10;
                         string modID   = line.substr(tempint, line.find("* -->", tempint + 1) - tempint);
 
                         if (process->chosenBehavior.find(modID) == process->chosenBehavior.end())
@@ -182,7 +180,7 @@ void BehaviorSub::CompilingAnimData()
                         skip  = true;
 
                     }
-                    else if (line.find("<!-- ORIGINAL -->") != NOT_FOUND)
+                    else if (lineClass.Has(nemesis::LineMarker::Original))
                     {
                         if (!modif) ErrorMessage(1211, filepath, numline);
 
@@ -190,7 +188,7 @@ void BehaviorSub::CompilingAnimData()
                         orig   = true;
                         skip   = true;
                     }
-                    else if (line.find("<!-- CLOSE -->") != NOT_FOUND)
+                    else if (lineClass.Has(nemesis::LineMarker::Close))
                     {
                         if (modif)
                         {
@@ -568,11 +566,12 @@ void BehaviorSub::CompilingAnimData()
         process->newMilestone();
 
         {
-            unique_lock<mutex> ulock(cv2_m);
+            nemesis::GenerationContext& context = process->context;
+            unique_lock<mutex> ulock(context.behaviorRunLock);
 
-            if (behaviorRun > 0)
+            if (context.behaviorRun > 0)
             {
-                cv2.wait(ulock, [] { return error || behaviorRun == 0; });
+                context.behaviorRunDone.wait(ulock, [&] { return error || context.behaviorRun == 0; });
             }
         }
 
@@ -937,10 +936,10 @@ void BehaviorSub::CompilingAnimData()
 
     // final output
 #ifdef DEBUG
-    string outpath = "new_behaviors\\"
-               + behaviorPath[lowerBehaviorFile].substr(behaviorPath[lowerBehaviorFile].find("\\") + 1);
+    const wstring& behaviorPath = process->context.GetBehaviorPath(behaviorHandle);
+    string outpath = "new_behaviors\\" + behaviorPath.substr(behaviorPath.find("\\") + 1);
 #else
-    filesystem::path outpath = behaviorPath[nemesis::transform_to<wstring>(lowerBehaviorFile)];
+    filesystem::path outpath = process->context.GetBehaviorPath(behaviorHandle);
 #endif
     outpath.replace_extension(".txt");
     redirToStageDir(outpath, nemesisInfo);
@@ -6,8 +6,10 @@
 
 #include "utilities/conditions.h"
 #include "utilities/readtextfile.h"
+#include "utilities/threadpool.h"
 
 #include "generate/animationdata.h"
+#include "generate/animationsetdata.h"
 #include "generate/behaviorprocess.h"
 #include "generate/behaviorprocess_utility.h"
 #include "generate/behaviorsubprocess.h"
@@ -16,13 +18,18 @@
 using namespace std;
 
 extern Terminator* p_terminate;
-extern atomic<int> m_RunningThread;
+
+struct ASDAnimResult
+{
+    unordered_map<string, nemesis::NaturalMap<VecStr>> generated; // project, header, ASD lines
+    vector<map<int, VecStr>> extracts; // edits to existing headers, in existingASDHeader order
+};
 
 void BehaviorSub::ASDCompilation()
 {
     try
     {
-        ++m_RunningThread;
+        ++process->context.runningThread;
 
         try
         {
@@ -63,7 +70,7 @@ void BehaviorSub::CompilingASD()
     int headercounter  = 0;
     string project     = "	";
     string header      = project;
-    unordered_map<string, map<string, VecStr, alphanum_less>> ASDPack;
+    unordered_map<string, nemesis::NaturalMap<VecStr>> ASDPack;
     unordered_map<string, unique_ptr<AnimationDataProject>> ASDData;
 
     process->newMilestone();
@@ -433,7 +440,6 @@ void BehaviorSub::CompilingASD()
 
             for (auto& templateCode : BehaviorTemplate->grouplist[lowerBehaviorFile])
             {
-                unordered_map<string, unordered_map<string, int>> ASDCount;
                 bool hasGroup    = false;
                 bool hasMaster   = false;
                 bool ignoreGroup = false;
@@ -446,73 +452,119 @@ void BehaviorSub::CompilingASD()
                     auto newAnimCopy = aitr->second;
                     nalock.Unlock();
 
-                    for (uint k = 0; k < newAnimCopy.size(); ++k)
+                    auto& existingHeader = BehaviorTemplate->existingASDHeader[templateCode];
+
+                    // existing headers are read concurrently by the animations below
+                    for (auto& proj : existingHeader)
                     {
-                        unordered_map<string, map<string, VecStr, alphanum_less>> generatedASD;
-                        newAnimCopy[k]->GetAnimSetData(generatedASD);
+                        auto pitr = ASDPack.find(proj.first);
 
-                        for (auto it = generatedASD.begin(); it != generatedASD.end(); ++it)
+                        for (auto& interheader : proj.second)
                         {
-                            string interproject = it->first;
+                            if (pitr == ASDPack.end() || pitr->second.find(interheader) == pitr->second.end()
+                                || pitr->second[interheader].size() == 0)
+                            {
+                                ErrorMessage(5011, templateCode, proj.first, interheader);
+                            }
+                        }
+                    }
 
-                            if (ASDPack.find(interproject) == ASDPack.end())
-                                projectList.push_back(interproject);
+                    DebugLogging(L"Processing behavior: " + filepath + L" (Check point 3.5, Mod code: "
+                                 + nemesis::transform_to<wstring>(templateCode) + L", Animation count: "
+                                 + to_wstring(newAnimCopy.size()) + L")");
 
-                            for (auto iter = it->second.begin(); iter != it->second.end(); ++iter)
-                            {
-                                string interheader = iter->first.substr(1, iter->first.length() - 2);
-                                interheader.append("_" + to_string(++ASDCount[interproject][interheader])
-                                                   + ".txt");
+                    vector<ASDAnimResult> results(newAnimCopy.size());
 
-                                if (ASDPack[interproject][interheader].size() > 0)
-                                {
-                                    ErrorMessage(5012, templateCode, interproject, interheader);
-                                }
+                    // this already runs on a pool thread, so the animations share the idle threads of the process
+                    nemesis::ParallelFor(newAnimCopy.size(), 1, [&](size_t k) {
+                        newAnimCopy[k]->GetAnimSetData(results[k].generated);
 
-                                if (error) throw nemesis::exception();
+                        for (auto& proj : existingHeader)
+                        {
+                            auto& headerPack = ASDPack.find(proj.first)->second;
 
-                                ASDPack[interproject][interheader] = iter->second;
+                            for (auto& interheader : proj.second)
+                            {
+                                results[k].extracts.emplace_back();
+                                newAnimCopy[k]->existingASDProcess(
+                                    headerPack.find(interheader)->second, results[k].extracts.back(), vector<int>(1));
+
+                                if (error) throw nemesis::exception();
                             }
                         }
+                    });
+
+                    if (error) throw nemesis::exception();
 
-                        DebugLogging(
-                            L"Processing behavior: " + filepath + L" (Check point 3.5, Mod code: "
-                            + nemesis::transform_to<wstring>(templateCode) + L", Existing AnimData"
-                            + to_wstring(
-                                BehaviorTemplate->existingFunctionID[templateCode][lowerBehaviorFile].size())
-                            + L")");
+                    // project, generated ASD of each animation in animation order
+                    unordered_map<string, vector<nemesis::NaturalMap<VecStr>*>> generatedProject;
 
-                        for (auto it = BehaviorTemplate->existingASDHeader[templateCode].begin();
-                             it != BehaviorTemplate->existingASDHeader[templateCode].end();
-                             ++it)
+                    for (auto& result : results)
+                    {
+                        for (auto& proj : result.generated)
                         {
-                            string interproject = it->first;
+                            if (ASDPack.find(proj.first) == ASDPack.end())
+                            {
+                                projectList.push_back(proj.first);
+                                ASDPack[proj.first];
+                            }
+
+                            generatedProject[proj.first].push_back(&proj.second);
+                        }
+
+                        uint counter = 0;
 
-                            for (auto iter = it->second.begin(); iter != it->second.end(); ++iter)
+                        for (auto& proj : existingHeader)
+                        {
+                            for (auto& interheader : proj.second)
                             {
-                                string interheader = *iter;
+                                editExtract[proj.first][interheader].push_back(move(result.extracts[counter++]));
+                            }
+                        }
+                    }
+
+                    // each project is numbered independently, so projects are merged in parallel
+                    {
+                        vector<decltype(generatedProject)::value_type*> merges;
+                        merges.reserve(generatedProject.size());
 
-                                if (ASDPack[interproject][interheader].size() == 0)
+                        for (auto& proj : generatedProject)
+                        {
+                            merges.push_back(&proj);
+                        }
+
+                        // every generated project got its ASDPack entry above, so the lookups do not insert
+                        nemesis::ParallelFor(merges.size(), 1, [&](size_t i) {
+                            const string& project = merges[i]->first;
+                            auto& headerPack      = ASDPack.find(project)->second;
+                            unordered_map<string, int> ASDCount;
+
+                            for (auto& generated : merges[i]->second)
+                            {
+                                for (auto& header : *generated)
                                 {
-                                    ErrorMessage(5011, templateCode, interproject, interheader);
-                                }
+                                    string interheader = header.first.substr(1, header.first.length() - 2);
+                                    interheader.append("_" + to_string(++ASDCount[interheader]) + ".txt");
+                                    VecStr& storeline = headerPack[interheader];
 
-                                map<int, VecStr> extract;
-                                newAnimCopy[k]->existingASDProcess(
-                                    ASDPack[interproject][interheader], extract, vector<int>(1));
-                                editExtract[interproject][interheader].push_back(extract);
+                                    if (storeline.size() > 0)
+                                    {
+                                        ErrorMessage(5012, templateCode, project, interheader);
+                                    }
 
-                                if (error) throw nemesis::exception();
+                                    if (error) throw nemesis::exception();
+
+                                    storeline = move(header.second);
+                                }
                             }
-                        }
+                        });
 
-                        DebugLogging(
-                            L"Processing behavior: " + filepath + L" (Check point 3.5, Mod code: "
-                            + nemesis::transform_to<wstring>(templateCode) + L", Existing AnimData"
-                            + to_wstring(
-                                BehaviorTemplate->existingFunctionID[templateCode][lowerBehaviorFile].size())
-                            + L" COMPLETE)");
+                        if (error) throw nemesis::exception();
                     }
+
+                    DebugLogging(L"Processing behavior: " + filepath + L" (Check point 3.5, Mod code: "
+                                 + nemesis::transform_to<wstring>(templateCode) + L", Animation count: "
+                                 + to_wstring(newAnimCopy.size()) + L" COMPLETE)");
                 }
                 else
                 {
@@ -577,33 +629,48 @@ void BehaviorSub::CompilingASD()
                      + L" (Check point 4, AnimSetData new animations complete)");
         process->newMilestone();
 
-        for (string& curProject : projectList)
         {
-            int startline = 0;
-            VecStr projectline;
-            projectline.push_back(to_string(ASDPack[curProject].size()));
+            ASDCRC32List crc32list;
 
-            for (auto it : ASDPack[curProject])
+            for (string& curProject : projectList)
             {
-                if (it.first.find("<!--") != NOT_FOUND) continue;
-
-                projectline.push_back(it.first);
+                ASDData[curProject];
+                ASDPack[curProject];
             }
 
-            for (auto it : ASDPack[curProject])
-            {
-                for (string& each : it.second)
+            // each project is parsed into its own typed data pack
+            nemesis::ParallelFor(projectList.size(), 1, [&](size_t i) {
+                const string& curProject = projectList[i];
+                auto& headerPack         = ASDPack.find(curProject)->second;
+                auto& data               = ASDData.find(curProject)->second;
+                int startline            = 0;
+                VecStr projectline;
+                projectline.push_back(to_string(headerPack.size()));
+
+                for (auto& it : headerPack)
                 {
-                    if (each.find("<!--") != NOT_FOUND) continue;
+                    if (it.first.find("<!--") != NOT_FOUND) continue;
 
-                    projectline.push_back(each);
+                    projectline.push_back(it.first);
                 }
-            }
 
-            if (error) throw nemesis::exception();
+                for (auto& it : headerPack)
+                {
+                    for (string& each : it.second)
+                    {
+                        if (each.find("<!--") != NOT_FOUND) continue;
+
+                        projectline.push_back(each);
+                    }
+                }
 
-            ASDData[curProject]
-                = make_unique<AnimationDataProject>(startline, projectline, curProject, nemesisInfo);
+                if (error) throw nemesis::exception();
+
+                data = make_unique<AnimationDataProject>(
+                    startline, projectline, curProject, crc32list, nemesisInfo);
+
+                if (error) throw nemesis::exception();
+            });
 
             if (error) throw nemesis::exception();
         }
@@ -614,12 +681,10 @@ void BehaviorSub::CompilingASD()
 
         // final output
 #ifdef DEBUG
-        filesystem::path outpath
-            = L"new_behaviors\\"
-                          + behaviorPath[nemesis::transform_to<wstring>(lowerBehaviorFile)].substr(
-                  behaviorPath[nemesis::transform_to<wstring>(lowerBehaviorFile)].find(L"\\") + 1);
+        const wstring& behaviorPath = process->context.GetBehaviorPath(behaviorHandle);
+        filesystem::path outpath    = L"new_behaviors\\" + behaviorPath.substr(behaviorPath.find(L"\\") + 1);
 #else
-        filesystem::path outpath = behaviorPath[nemesis::transform_to<wstring>(lowerBehaviorFile)];
+        filesystem::path outpath = process->context.GetBehaviorPath(behaviorHandle);
 #endif
         outpath.replace_extension(".txt");
         redirToStageDir(outpath, nemesisInfo);
@@ -630,69 +695,7 @@ void BehaviorSub::CompilingASD()
 
         if (output.is_open())
         {
-            output << to_string(projectList.size()) + "\n";
-
-            for (string& curProject : projectList)
-            {
-                output << curProject + "\n";
-            }
-
-            for (string& curProject : projectList)
-            {
-                output << to_string(ASDData[curProject]->datalist.size()) + "\n";
-
-                for (auto& data : ASDData[curProject]->datalist)
-                {
-                    output << data.first + "\n";
-                }
-
-                for (auto& data : ASDData[curProject]->datalist)
-                {
-                    output << "V3\n";
-                    output << to_string(data.second.equiplist.size()) + "\n";
-
-                    for (auto& equip : data.second.equiplist)
-                    {
-                        output << equip.name + "\n";
-                    }
-
-                    output << to_string(data.second.typelist.size()) + "\n";
-
-                    for (auto& type : data.second.typelist)
-                    {
-                        output << type.name + "\n";
-                        output << type.equiptype1 + "\n";
-                        output << type.equiptype2 + "\n";
-                    }
-
-                    output << to_string(data.second.animlist.size()) + "\n";
-
-                    for (auto& anim : data.second.animlist)
-                    {
-                        output << anim.eventname + "\n";
-                        output << anim.unknown + "\n";
-                        output << to_string(anim.attackClip.size()) + "\n";
-
-                        for (auto& atk : anim.attackClip)
-                        {
-                            output << atk.data + "\n";
-                        }
-                    }
-
-                    output << to_string(data.second.crc32list.size()) + "\n";
-
-                    for (auto& crc32 : data.second.crc32list)
-                    {
-                        output << crc32.filepath + "\n";
-                        output << crc32.filename + "\n";
-                        output << crc32.fileformat + "\n";
-                    }
-
-                    if (error) throw nemesis::exception();
-                }
-
-                if (error) throw nemesis::exception();
-            }
+            WriteAnimSetData(output, projectList, ASDData);
         }
         else
         {
@@ -0,0 +1,329 @@
+#include "Global.h"
+
+#include <QtCore/QThreadPool>
+
+#include "connector.h"
+#include "debuglog.h"
+#include "nemesisinfo.h"
+#include "externalscript.h"
+
+#include "ui/MessageHandler.h"
+
+#include "utilities/filechecker.h"
+#include "utilities/readtextfile.h"
+
+#include "generate/behaviorbatch.h"
+#include "generate/papyruscompile.h"
+#include "generate/behaviorprocess.h"
+#include "generate/playerexclusive.h"
+#include "generate/generator_utility.h"
+#include "generate/behaviorprocess_utility.h"
+
+using namespace std;
+namespace sf = filesystem;
+
+extern atomic<int> extraCore;
+
+nemesis::GenerationBatch::GenerationBatch(size_t profileCount)
+    : scheduler(thread::hardware_concurrency() + uint(profileCount))
+{
+    // every profile parks one worker in its animation data compilation until its behaviors are done,
+    // the extra workers keep the behaviors going meanwhile
+}
+
+void nemesis::GenerationBatch::ReadInputs(const NemesisInfo* nemesisInfo)
+{
+    GenerationContext::Scope scope(context);
+
+    animationList = openFile(&behaviorTemplate, nemesisInfo);
+
+    if (error) throw nemesis::exception();
+
+    if (PCEACheck(nemesisInfo)) ReadPCEA(nemesisInfo);
+
+    ReadBehaviorLines(getTempBhvrPath(nemesisInfo).wstring() + L"\\");
+}
+
+const TemplateInfo& nemesis::GenerationBatch::GetTemplate() const
+{
+    return behaviorTemplate;
+}
+
+vector<unique_ptr<registerAnimation>> nemesis::GenerationBatch::CopyAnimationList() const
+{
+    vector<unique_ptr<registerAnimation>> list;
+    list.reserve(animationList.size());
+
+    for (auto& each : animationList)
+    {
+        list.emplace_back(make_unique<registerAnimation>(*each));
+
+        // the animation infos are shared pointers, generation writes into them
+        for (auto& group : list.back()->animInfo)
+        {
+            for (auto& info : group.second)
+            {
+                info = make_shared<AnimationInfo>(*info);
+            }
+        }
+    }
+
+    return list;
+}
+
+const VecStr* nemesis::GenerationBatch::GetBehaviorLines(const wstring& filepath) const
+{
+    auto itr = behaviorLines.find(InternPath(filepath));
+    return itr != behaviorLines.end() ? &itr->second : nullptr;
+}
+
+void nemesis::GenerationBatch::ReadBehaviorLines(const wstring& directory)
+{
+    VecWstr filelist;
+    VecWstr fpfilelist;
+    read_directory(directory, filelist);
+
+    for (auto& file : filelist)
+    {
+        if (wordFind(file, L"_1stperson") != NOT_FOUND && sf::is_directory(directory + file))
+        {
+            read_directory(directory + file, fpfilelist);
+
+            for (auto& fpfile : fpfilelist)
+            {
+                fpfile = file + L"\\" + fpfile;
+            }
+        }
+    }
+
+    filelist.insert(filelist.end(), fpfilelist.begin(), fpfilelist.end());
+
+    // the map elements are created before the workers start, so each worker only writes into its own element
+    vector<pair<wstring, VecStr*>> files;
+
+    for (auto& file : filelist)
+    {
+        wstring lowerFileName = nemesis::to_lower_copy(file);
+
+        if (lowerFileName == L"animationdatasinglefile.txt" || lowerFileName == L"animationsetdatasinglefile.txt")
+        {
+            continue;
+        }
+
+        wstring filepath = directory + file;
+
+        if (sf::is_directory(filepath) || lowerFileName.rfind(L".txt") != lowerFileName.length() - 4) continue;
+
+        files.emplace_back(filepath, &behaviorLines[InternPath(filepath)]);
+    }
+
+    vector<future<void>> tasks;
+
+    for (auto& file : files)
+    {
+        tasks.push_back(scheduler.enqueue([&file]() {
+            // same line splitting as a behavior compilation reading the file itself
+            FileReader BehaviorFormat(file.first);
+
+            if (!BehaviorFormat.GetFile()) ErrorMessage(3002, file.first);
+
+            string line;
+            file.second->reserve(fileLineCount(file.first));
+
+            while (BehaviorFormat.GetLines(line))
+            {
+                file.second->push_back(line);
+            }
+        }));
+    }
+
+    for (auto& task : tasks)
+    {
+        task.wait();
+    }
+
+    DebugLogging("Batch behaviors read: " + to_string(files.size()));
+}
+
+vector<pair<wstring, VecStr>> nemesis::ReadBatchFile(const sf::path& filepath)
+{
+    VecWstr storeline;
+    vector<pair<wstring, VecStr>> profiles;
+
+    GetFunctionLines(filepath, storeline, false);
+
+    for (auto& line : storeline)
+    {
+        if (line.length() == 0 || line[0] == L';') continue;
+
+        if (line[0] == L'[' && line.back() == L']')
+        {
+            profiles.emplace_back(line.substr(1, line.length() - 2), VecStr());
+        }
+        else if (!profiles.empty())
+        {
+            profiles.back().second.push_back(nemesis::transform_to<string>(line));
+        }
+    }
+
+    return profiles;
+}
+
+void nemesis::GenerateBatch(const vector<GenerationProfile>& profiles, const NemesisInfo* nemesisInfo)
+{
+    DummyLog log;
+    GenerationBatch batch(profiles.size());
+    auto start_time = chrono::high_resolution_clock::now();
+    connectProcess(&log);
+
+    // profiles report from their worker threads, there is no event loop to queue the messages to
+    QObject::connect(&log,
+                     &DummyLog::incomingMessage,
+                     &log,
+                     [](QString msg) { wcout << msg.toStdWString() + L"\n"; },
+                     Qt::DirectConnection);
+
+    PatchReset();
+    extraCore = 0;
+
+    try
+    {
+        GenerationContext::Scope scope(batch.context);
+        DebugLogging("Batch profiles: " + to_string(profiles.size()));
+
+        // Check the existence of required files
+        FileCheck();
+
+        // Script Run
+        RunScript("scripts\\launcher\\start\\");
+        ClearGlobal();
+        GetBehaviorManifest();
+        batch.ReadInputs(nemesisInfo);
+        checkAllFiles(nemesisInfo->GetDataPath() + L"meshes\\actors");
+    }
+    catch (std::exception& ex)
+    {
+        try
+        {
+            ErrorMessage(6002, "None", ex.what());
+        }
+        catch (nemesis::exception&)
+        {
+            // resolved exception
+        }
+    }
+    catch (nemesis::exception&)
+    {
+        // resolved exception
+    }
+
+    if (!error)
+    {
+        vector<NemesisInfo> infos(profiles.size(), *nemesisInfo);
+        vector<unique_ptr<BehaviorStart>> workers;
+        vector<thread> drivers;
+        mutex endLock;
+        condition_variable endSignal;
+        vector<bool> profileEnded(profiles.size(), false);
+        size_t ended = 0;
+
+        // a profile can end both through its end signal and through its driver failing, it is counted once
+        auto endProfile = [&](size_t profile) {
+            lock_guard<mutex> lock(endLock);
+
+            if (profileEnded[profile]) return;
+
+            profileEnded[profile] = true;
+            ++ended;
+            endSignal.notify_one();
+        };
+
+        for (size_t i = 0; i < profiles.size(); ++i)
+        {
+            infos[i].setStagePath(profiles[i].stageDirectory);
+            DebugLogging(L"Batch profile stage directory: " + infos[i].GetStagePath());
+
+            workers.emplace_back(make_unique<BehaviorStart>(&infos[i]));
+            BehaviorStart* worker = workers.back().get();
+            worker->addBehaviorPick(profiles[i].behaviorPriority, profiles[i].chosenBehavior);
+            worker->setBatch(&batch);
+
+            // a profile ends on whichever thread finishes its last task
+            // each profile has its own context and error flag, a failing profile does not stop the others
+            QObject::connect(worker,
+                             &BehaviorStart::end,
+                             worker,
+                             [&endProfile, i]() { endProfile(i); },
+                             Qt::DirectConnection);
+
+            drivers.emplace_back([&endProfile, worker, i]() {
+                try
+                {
+                    worker->InitializeGeneration();
+                }
+                catch (...)
+                {
+                    // the profile never reached its end signal
+                    error = true;
+                    endProfile(i);
+                }
+            });
+        }
+
+        {
+            unique_lock<mutex> lock(endLock);
+            endSignal.wait(lock, [&] { return ended == profiles.size(); });
+        }
+
+        for (auto& driver : drivers)
+        {
+            driver.join();
+        }
+
+        // script installs still unwind after their profile has ended
+        QThreadPool::globalInstance()->waitForDone();
+    }
+
+    // a failed profile has raised the process wide error flag, the batch context has a flag of its own
+    bool failed = error;
+
+    {
+        GenerationContext::Scope scope(batch.context);
+        checkAllStoredHKX();
+
+        for (auto& msg : batch.context.fileCheckMsg)
+        {
+            interMsg(msg);
+        }
+
+        if (isFileExist(papyrusTempCompile())) sf::remove_all(papyrusTempCompile());
+
+        if (!failed && !error)
+        {
+            bool hasScripts = false;
+            RunScript("scripts\\launcher\\end\\", hasScripts);
+
+            if (hasScripts) interMsg("");
+        }
+
+        ClearGlobal(failed || error);
+    }
+
+    if (error)
+    {
+        wstring msg = TextBoxMessage(1010);
+        interMsg(msg);
+        DebugLogging(msg);
+    }
+    else
+    {
+        auto diff   = chrono::high_resolution_clock::now() - start_time;
+        int seconds = chrono::duration_cast<chrono::seconds>(diff).count();
+        wstring msg = TextBoxMessage(1009) + L": " + to_wstring(seconds) + L" " + TextBoxMessage(1012);
+        interMsg(msg);
+        DebugLogging(msg);
+    }
+
+    DebugOutput();
+    disconnectProcess();
+}
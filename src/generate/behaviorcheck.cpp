@@ -38,12 +38,12 @@ void beginConnectionCheck(const string& current,
                           const unordered_map<wstring, USetWstr>& postBhvrRefBy,
                           const NemesisInfo& nemesisInfo)
 {
-    string file = GetFileName(original);
-    auto bhvitr = behaviorJoints.find(file);
+    string file               = GetFileName(original);
+    const VecStr* characterList = nemesis::GenerationContext::Current().behaviorJoints.Find(file);
 
-    if (bhvitr == behaviorJoints.end() || bhvitr->second.empty()) return;
+    if (!characterList || characterList->empty()) return;
 
-    connectionCheckLoop(current, original, noRepeat, postBhvrRefBy, bhvitr->second, nemesisInfo);
+    connectionCheckLoop(current, original, noRepeat, postBhvrRefBy, *characterList, nemesisInfo);
 }
 
 bool connectionCheckLoop(const string& current,
@@ -122,31 +122,33 @@ bool isConnectedToCharacter(const string& current,
 
 void behaviorCheck(BehaviorStart* process)
 {
+    nemesis::GenerationContext& context = process->context;
+
     // test if anim file used has been registered
-    for (auto& it : usedAnim)
-    {
-        VecStr forwardPort = behaviorJoints[it.first];
+    context.usedAnim.ForEach([&](nemesis::PathHandle behaviorFile, SetStr& usedList) {
+        const VecStr* forwardPort = context.behaviorJoints.Find(behaviorFile.Lower());
+
+        if (!forwardPort) return;
 
-        for (auto& behavior : forwardPort)
+        for (auto& behavior : *forwardPort)
         {
-            auto& registBhvr = registeredAnim[nemesis::to_lower_copy(behavior)];
+            const SetStr* registBhvr = context.registeredAnim.Find(nemesis::InternPath(behavior));
 
-            for (auto& path : it.second)
+            for (auto& path : usedList)
             {
                 string lowerfilename = nemesis::to_lower_copy(filesystem::path(path).filename().string());
 
-                if (registBhvr.find(lowerfilename) == registBhvr.end())
+                if (!registBhvr || registBhvr->find(lowerfilename) == registBhvr->end())
                 {
                     WarningMessage(1013, behavior + ".hkx", path);
                 }
             }
         }
-    }
+    });
 
     // test duplicate anim file
-    for (auto& animation : animModMatch) // first string
-    {
-        for (auto duplicatelist : animation.second) // second string
+    context.animModMatch.ForEach([](nemesis::PathHandle behaviorFile, auto& matchList) {
+        for (auto& duplicatelist : matchList) // animation file
         {
             if (duplicatelist.second.size() == 2)
             {
@@ -161,7 +163,7 @@ void behaviorCheck(BehaviorStart* process)
 
                     warning.pop_back();
                     warning.pop_back();
-                    WarningMessage(1014, animation.first, duplicatelist.first, warning);
+                    WarningMessage(1014, behaviorFile.Lower(), duplicatelist.first, warning);
                 }
             }
             else
@@ -169,7 +171,7 @@ void behaviorCheck(BehaviorStart* process)
                 ErrorMessage(1066);
             }
         }
-    }
+    });
 
     USetStr noRepeat;
 
@@ -6,9 +6,11 @@
 #include <QtCore/QProcess>
 
 #include "utilities/atomiclock.h"
+#include "utilities/filedeploy.h"
 
 #include "generate/alternateanimation.h"
 #include "generate/behaviorgenerator.h"
+#include "generate/generationcontext.h"
 
 #pragma warning(disable : 4503)
 
@@ -17,8 +19,6 @@ using namespace std;
 namespace sf = filesystem;
 
 std::atomic<int> fileprotek = 0;
-atomic_flag failedBehaviorFlag{};
-VecWstr failedBehaviors;
 
 class HkxCompileCount
 {
@@ -27,6 +27,7 @@ class HkxCompileCount
     mutable sf::path output;
 
 public:
+    // numbers are never reused, runs in parallel can compile files of the same name
     HkxCompileCount()
     {
         cur = fileprotek++;
@@ -34,8 +35,6 @@ public:
 
     ~HkxCompileCount()
     {
-        --fileprotek;
-
         if (sf::exists(input)) sf::remove(input);
         if (sf::exists(output)) sf::remove(output);
     }
@@ -59,7 +58,7 @@ sf::path tryGetRelative(sf::path filepath)
 
     do
     {
-        if (nemesis::to_lower_copy(filepath).find(nemesis::to_lower_copy(current.wstring())) == 0)
+        if (nemesis::ifind(filepath.wstring(), current.wstring()) == 0)
         {
             return target.append(filepath.wstring().substr(current.wstring().length() + 1));
         }
@@ -109,13 +108,23 @@ bool HkxCompiler::hkxcmdProcess(fpath xmlfile, fpath hkxfile, bool last) const
     {
         if (last) ErrorMessage(1003, xmlfile);
 
-        Lockless lock(failedBehaviorFlag);
-        failedBehaviors.push_back(xmlfile);
-        failedBehaviors.push_back(hkxfile);
+        nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
+        Lockless lock(context.failedBehaviorsLock);
+        context.failedBehaviors.push_back(xmlfile);
+        context.failedBehaviors.push_back(hkxfile);
         return false;
     }
 
-    sf::copy_file(output, hkxfile, sf::copy_options::overwrite_existing);
+    nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
+
+    if (!nemesis::DeployFile(output, hkxfile))
+    {
+        ++context.unchangedBehaviors;
+        return true;
+    }
+
+    Lockless lock(context.deployedBehaviorsLock);
+    context.deployedBehaviors.push_back(hkxfile);
     return true;
 }
 
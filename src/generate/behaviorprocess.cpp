@@ -20,6 +20,7 @@
 #include "utilities/filechecker.h"
 
 #include "generate/addanims.h"
+#include "generate/behaviorbatch.h"
 #include "generate/behaviorcheck.h"
 #include "generate/installscripts.h"
 #include "generate/papyruscompile.h"
@@ -38,20 +39,14 @@ namespace sf = filesystem;
 
 extern bool processdone;
 extern mutex processlock;
-extern mutex cv2_m;
-extern condition_variable cv2;
 extern condition_variable cv;
 extern Terminator* p_terminate;
-extern VecWstr failedBehaviors;
 extern atomic<int> m_RunningThread;
-extern atomic<int> behaviorRun;
 extern atomic<int> extraCore;
 
 mutex anim_lock;
 std::atomic_flag atomic_lock{};
 
-extern VecWstr fileCheckMsg;
-
 void addOnInstall(string templine,
                   string& elementLine,
                   vector<VecStr>& groupAddOnElement,
@@ -88,6 +83,11 @@ void BehaviorStart::addBehaviorPick(VecStr behaviorOrder, unordered_map<string,
     cmdline                            = true;
 }
 
+void BehaviorStart::setBatch(nemesis::GenerationBatch* _batch)
+{
+    batch = _batch;
+}
+
 void BehaviorStart::message(string input)
 {
     emit incomingMessage(QString::fromStdString(input));
@@ -100,42 +100,56 @@ void BehaviorStart::message(wstring input)
 
 void BehaviorStart::InitializeGeneration()
 {
+    nemesis::GenerationContext::Scope scope(context);
     std::thread* checkThread = nullptr;
 
+    // counted as running before anything can fail, so the EndAttempt below always ends the run
+    context.runningThread = 1;
+    ++m_RunningThread;
+
     try
     {
-        extraCore = 0;
-        ClearGlobal();
-        milestoneStart();
-        string version;
-
-        if (!isEngineUpdated(version, nemesisInfo))
+        if (batch)
         {
-            interMsg(TextBoxMessage(1000));
-            m_RunningThread = 0;
-            unregisterProcess(true);
-            emit disableLaunch();
-            return;
+            // the batch has checked the engine and read the inputs shared by its profiles
+            context.Clear();
+            milestoneStart();
+            context.CopyInputs(batch->context);
         }
+        else
+        {
+            extraCore = 0;
+            ClearGlobal();
+            milestoneStart();
+            string version;
 
-        interMsg(TextBoxMessage(1003));
-        interMsg(TextBoxMessage(1017) + L": " + nemesis::transform_to<wstring>(version));
-        interMsg("");
-        interMsg(TextBoxMessage(1004));
-        interMsg("");
+            if (!isEngineUpdated(version, nemesisInfo))
+            {
+                interMsg(TextBoxMessage(1000));
+                context.runningThread = 0;
+                --m_RunningThread;
+                unregisterProcess(true);
+                emit disableLaunch();
+                return;
+            }
 
-        if (error) throw nemesis::exception();
+            interMsg(TextBoxMessage(1003));
+            interMsg(TextBoxMessage(1017) + L": " + nemesis::transform_to<wstring>(version));
+            interMsg("");
+            interMsg(TextBoxMessage(1004));
+            interMsg("");
+
+            if (error) throw nemesis::exception();
 
-        // Check the existence of required files
-        FileCheck();
+            // Check the existence of required files
+            FileCheck();
+
+            // Script Run
+            RunScript("scripts\\launcher\\start\\");
+            ClearGlobal();
+            GetBehaviorManifest();
+        }
 
-        // Script Run
-        RunScript("scripts\\launcher\\start\\");
-        ClearGlobal();
-        characterHKX();
-        GetBehaviorPath();
-        GetBehaviorProject();
-        GetBehaviorProjectPath();
         behaviorActivateMod(behaviorPriority);
         ClearTempXml(nemesisInfo);
 
@@ -187,14 +201,27 @@ void BehaviorStart::InitializeGeneration()
 
 void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
 {
+    nemesis::GenerationContext::Scope scope(context);
+
     // register animation & organize AE n Var
     wstring directory = getTempBhvrPath(nemesisInfo).wstring() + L"\\";
     unordered_map<string, int>
         animationCount; // animation type counter; use to determine how many of the that type of animation have been installed
-    shared_ptr<TemplateInfo> BehaviorTemplate = make_shared<TemplateInfo>(); // get animation type
+    shared_ptr<TemplateInfo> BehaviorTemplate; // get animation type
+    vector<unique_ptr<registerAnimation>> animationList; // get anim list installed by mods
+
+    if (batch)
+    {
+        // generation inserts into the template and the animation infos, so each profile works on a copy
+        BehaviorTemplate = make_shared<TemplateInfo>(batch->GetTemplate());
+        animationList    = batch->CopyAnimationList();
+    }
+    else
+    {
+        BehaviorTemplate = make_shared<TemplateInfo>();
+        animationList    = openFile(BehaviorTemplate.get(), nemesisInfo);
+    }
 
-    vector<unique_ptr<registerAnimation>> animationList
-        = move(openFile(BehaviorTemplate.get(), nemesisInfo)); // get anim list installed by mods
     unordered_map<string, vector<shared_ptr<NewAnimation>>>
         newAnimation; // record each of the animation created from registerAnimation
 
@@ -209,11 +236,18 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
 
     if (error) throw nemesis::exception();
 
-    if (PCEACheck(nemesisInfo)) ReadPCEA(nemesisInfo);
+    // a batch reads PCEA and checks the hkx files once for all of its profiles
+    if (!batch)
+    {
+        if (PCEACheck(nemesisInfo)) ReadPCEA(nemesisInfo);
 
-    checkThread = new std::thread(checkAllFiles, nemesisInfo->GetDataPath() + L"meshes\\actors");
+        checkThread = new std::thread([this, actors = sf::path(nemesisInfo->GetDataPath() + L"meshes\\actors")]() {
+            nemesis::GenerationContext::Scope scope(context);
+            checkAllFiles(actors);
+        });
+    }
 
-    if (animReplaced.size() > 0 || animationList.size() > 0) interMsg("");
+    if (context.animReplaced.size() > 0 || animationList.size() > 0) interMsg("");
 
     DebugLogging("Registering new animations...");
 
@@ -242,15 +276,15 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
                 = make_shared<unordered_map<string, unordered_map<string, AnimTemplate>>>();
 
             // project, header, template
-            shared_ptr<unordered_map<string, map<string, AnimTemplate, alphanum_less>>> asdTemplate
-                = make_shared<unordered_map<string, map<string, AnimTemplate, alphanum_less>>>();
+            shared_ptr<unordered_map<string, nemesis::NaturalMap<AnimTemplate>>> asdTemplate
+                = make_shared<unordered_map<string, nemesis::NaturalMap<AnimTemplate>>>();
 
             unordered_map<string, VecStr>* functionlines = &BehaviorTemplate->behaviortemplate[templatecode];
             unordered_map<string, unordered_map<string, VecStr>>* animdatalines
                 = &BehaviorTemplate->animdatatemplate[templatecode];
-            unordered_map<string, map<string, VecStr, alphanum_less>>* asdlines
+            unordered_map<string, nemesis::NaturalMap<VecStr>>* asdlines
                 = &BehaviorTemplate->asdtemplate[templatecode];
-            newAnimation[templatecode].reserve(50 * memory);
+            newAnimation.try_emplace(templatecode); // a template whose animations are all skipped keeps its list
             animationCount[templatecode]++;
             bool isGroup;
             bool ignoreGroup = BehaviorTemplate->optionlist[templatecode].ignoreGroup;
@@ -259,7 +293,8 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
             if (BehaviorTemplate->coreTemplate[templatecode].length() > 0)
             {
                 coreModName     = "Nemesis_" + modID + "_";
-                wstring corepath = wstring(behaviorPath[nemesis::transform_to<wstring>(BehaviorTemplate->coreTemplate[templatecode])]);
+                wstring corepath
+                    = context.GetBehaviorPath(nemesis::InternPath(BehaviorTemplate->coreTemplate[templatecode]));
                 wstring corename = GetFileName(corepath);
                 corepath        = corepath.substr(0, corepath.length() - corename.length());
                 DebugLogging(L"Core behavior name: " + corename);
@@ -366,7 +401,6 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
             }
             else
             {
-                animInfoGroup.reserve(50 * memory);
                 isGroup = false;
             }
 
@@ -467,7 +501,6 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
                                 VecStr* element    = &(*elementList)[k];
                                 string elementLine = (*elementListLine)[k];
                                 vector<VecStr> groupAddOnElement;
-                                groupAddOnElement.reserve(memory / 10);
 
                                 for (uint l = 0; l < element->size(); ++l)
                                 {
@@ -516,7 +549,6 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
                                 VecStr* element    = &(*elementList)[k];
                                 string elementLine = (*elementListLine)[k];
                                 vector<VecStr> groupAddOnElement;
-                                groupAddOnElement.reserve(memory / 10);
 
                                 for (uint l = 0; l < element->size(); ++l)
                                 {
@@ -621,7 +653,6 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
                                     VecStr* element    = &(*elementList)[k];
                                     string elementLine = (*elementListLine)[k];
                                     vector<VecStr> groupAddOnElement;
-                                    groupAddOnElement.reserve(memory / 10);
 
                                     for (uint l = 0; l < element->size(); ++l)
                                     {
@@ -671,7 +702,6 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
                                     VecStr* element    = &(*elementList)[k];
                                     string elementLine = (*elementListLine)[k];
                                     vector<VecStr> groupAddOnElement;
-                                    groupAddOnElement.reserve(memory / 10);
 
                                     for (uint l = 0; l < element->size(); ++l)
                                     {
@@ -713,7 +743,6 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
                             VecStr* element    = &(*elementList)[k];
                             string elementLine = (*elementListLine)[k];
                             vector<VecStr> groupAddOnElement;
-                            groupAddOnElement.reserve(memory / 10);
 
                             for (uint l = 0; l < element->size(); ++l)
                             {
@@ -760,7 +789,6 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
                             VecStr* element    = &(*elementList)[k];
                             string elementLine = (*elementListLine)[k];
                             vector<VecStr> groupAddOnElement;
-                            groupAddOnElement.reserve(memory / 10);
 
                             for (uint l = 0; l < element->size(); ++l)
                             {
@@ -848,16 +876,30 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
     if (error) throw nemesis::exception();
     emit progressUp();
 
-    if (pcealist.size() > 0 || alternateAnim.size() > 0)
+    if (context.pcealist.size() > 0 || context.alternateAnim.size() > 0)
     {
-        InstallScripts* ScriptWorker = new InstallScripts(nemesisInfo); // install PCEA & AA script
-        connect(ScriptWorker, SIGNAL(end()), this, SLOT(EndAttempt()));
-        connect(ScriptWorker, SIGNAL(end()), ScriptWorker, SLOT(deleteLater()));
-        QtConcurrent::run(ScriptWorker, &InstallScripts::Run);
+        InstallScripts* ScriptWorker = new InstallScripts(nemesisInfo, context); // install PCEA & AA script
+
+        if (batch)
+        {
+            // profiles of a batch have no event loop, the worker ends the run from its own thread
+            connect(ScriptWorker, &InstallScripts::end, this, &BehaviorStart::EndAttempt, Qt::DirectConnection);
+            QtConcurrent::run([ScriptWorker]() {
+                ScriptWorker->Run();
+                delete ScriptWorker;
+            });
+        }
+        else
+        {
+            connect(ScriptWorker, SIGNAL(end()), this, SLOT(EndAttempt()));
+            connect(ScriptWorker, SIGNAL(end()), ScriptWorker, SLOT(deleteLater()));
+            QtConcurrent::run(ScriptWorker, &InstallScripts::Run);
+        }
     }
 
     {
-        wstring filename(nemesisInfo->GetDataPath() + L"scripts\\FNIS.pex");
+        sf::create_directories(nemesisInfo->GetStagePath() + L"scripts");
+        wstring filename(nemesisInfo->GetStagePath() + L"scripts\\FNIS.pex");
         sf::copy_file(
             sf::path("alternate animation\\FNBE.pex"), filename, sf::copy_options::overwrite_existing);
         FILE* f;
@@ -898,7 +940,7 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
     VecWstr filelist;
     read_directory(directory, filelist);
     emit progressUp();
-    behaviorRun = 1;
+    context.behaviorRun = 1;
 
     for (auto file : filelist)
     {
@@ -930,9 +972,21 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
         }
     }
 
-    nemesis::ThreadPool tp;
+    // profiles of a batch share its scheduler, so each of them waits on its own tasks only
+    unique_ptr<nemesis::ThreadPool> localPool = batch ? nullptr : make_unique<nemesis::ThreadPool>();
+    nemesis::ThreadPool& tp                    = batch ? batch->scheduler : *localPool;
+    vector<future<void>> tasks;
     vector<BehaviorSub*> behaviorSubList;
 
+    auto joinTasks = [&]() {
+        if (!batch) return tp.join_all();
+
+        for (auto& task : tasks)
+        {
+            task.wait();
+        }
+    };
+
     try
     {
         for (auto file : filelist)
@@ -959,9 +1013,10 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
 
                     if (isCore) modID = nemesis::transform_to<string>(coreModList[lowerFileName][repeatcount]);
 
-                    bool skip            = false;
-                    wstring tempfilename = lowerFileName.substr(0, lowerFileName.find_last_of(L"."));
-                    wstring temppath     = behaviorPath[tempfilename];
+                    bool skip                          = false;
+                    wstring tempfilename               = lowerFileName.substr(0, lowerFileName.find_last_of(L"."));
+                    nemesis::PathHandle behaviorHandle = nemesis::InternPath(tempfilename);
+                    wstring temppath                   = context.GetBehaviorPath(behaviorHandle);
 
                     if (temppath.length() != 0)
                     {
@@ -983,6 +1038,7 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
 
                     worker->addInfo(directory,
                                     nemesis::transform_to<string>(file),
+                                    behaviorHandle,
                                     BehaviorTemplate,
                                     newAnimation,
                                     AnimVar,
@@ -1001,17 +1057,17 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
 
                     if (lowerFileName == L"animationdatasinglefile.txt")
                     {
-                        tp.enqueue(&BehaviorSub::AnimDataCompilation, worker); // 9 progress ups
+                        tasks.push_back(tp.enqueue(&BehaviorSub::AnimDataCompilation, worker)); // 9 progress ups
                     }
                     else if (lowerFileName == L"animationsetdatasinglefile.txt")
                     {
-                        tp.enqueue(&BehaviorSub::ASDCompilation, worker);
+                        tasks.push_back(tp.enqueue(&BehaviorSub::ASDCompilation, worker));
                     }
                     else
                     {
                         if (temppath.find(L"characters") == 0) worker->isCharacter = true;
 
-                        tp.enqueue(&BehaviorSub::BehaviorCompilation, worker);
+                        tasks.push_back(tp.enqueue(&BehaviorSub::BehaviorCompilation, worker));
                     }
 
                     ++repeatcount;
@@ -1053,9 +1109,10 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
 
                             if (isCore) modID = nemesis::transform_to<string>(coreModList[lowerFileName][repeatcount]);
 
-                            bool skip           = false;
-                            wstring tempfilename = lowerFileName.substr(0, lowerFileName.find_last_of(L"."));
-                            wstring temppath     = behaviorPath[nemesis::transform_to<wstring>(tempfilename)];
+                            bool skip                          = false;
+                            wstring tempfilename               = lowerFileName.substr(0, lowerFileName.find_last_of(L"."));
+                            nemesis::PathHandle behaviorHandle = nemesis::InternPath(tempfilename);
+                            wstring temppath                   = context.GetBehaviorPath(behaviorHandle);
 
                             if (temppath.length() != 0)
                             {
@@ -1075,6 +1132,7 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
 
                             worker->addInfo(directory,
                                             nemesis::transform_to<string>(fpfile),
+                                            behaviorHandle,
                                             BehaviorTemplate,
                                             newAnimation,
                                             AnimVar,
@@ -1093,18 +1151,18 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
 
                             if (lowerFileName == L"animationdatasinglefile.txt")
                             {
-                                tp.enqueue(&BehaviorSub::AnimDataCompilation,
-                                           worker); // 9 progress ups
+                                tasks.push_back(tp.enqueue(&BehaviorSub::AnimDataCompilation,
+                                                           worker)); // 9 progress ups
                             }
                             else if (lowerFileName == L"animationsetdatasinglefile.txt")
                             {
-                                tp.enqueue(&BehaviorSub::ASDCompilation, worker);
+                                tasks.push_back(tp.enqueue(&BehaviorSub::ASDCompilation, worker));
                             }
                             else
                             {
                                 if (temppath.find(L"characters") == 0) worker->isCharacter = true;
 
-                                tp.enqueue(&BehaviorSub::BehaviorCompilation, worker);
+                                tasks.push_back(tp.enqueue(&BehaviorSub::BehaviorCompilation, worker));
                             }
 
                             ++repeatcount;
@@ -1114,25 +1172,32 @@ void BehaviorStart::GenerateBehavior(std::thread*& checkThread)
             }
         }
     }
-    catch (exception& ex)
+    catch (...)
     {
-        tp.join_all();
-        
+        // the queued tasks still count on the run, its end has to wait for them
+        {
+            lock_guard<mutex> lg(context.behaviorRunLock);
+            --context.behaviorRun;
+        }
+
+        context.behaviorRunDone.notify_one();
+        joinTasks();
+
         for (auto& each : behaviorSubList)
         {
             delete each;
         }
 
-        throw ex;
+        throw;
     }
 
     {
-        lock_guard<mutex> lg(cv2_m);
-        --behaviorRun;
+        lock_guard<mutex> lg(context.behaviorRunLock);
+        --context.behaviorRun;
     }
 
-    cv2.notify_one();
-    tp.join_all();
+    context.behaviorRunDone.notify_one();
+    joinTasks();
 
     for (auto& each : behaviorSubList)
     {
@@ -1147,9 +1212,13 @@ atomic_flag& BehaviorStart::getNewAnimFlag()
 
 void BehaviorStart::milestoneStart()
 {
-    m_RunningThread = 1;
-    failedBehaviors.clear();
-    PatchReset();
+    context.failedBehaviors.clear();
+    context.deployedBehaviors.clear();
+    context.unchangedBehaviors = 0;
+
+    // a batch resets the patches and owns the message log for all of its profiles
+    if (!batch) PatchReset();
+
     start_time = std::chrono::high_resolution_clock::now();
 
     DebugLogging("Nemesis Behavior Version: v" + GetNemesisVersion());
@@ -1160,7 +1229,8 @@ void BehaviorStart::milestoneStart()
     DebugLogging("Skyrim Special Edition: " + string(SSE ? "TRUE" : "FALSE"));
     int counter = 0;
 
-    connectProcess(this);
+    if (!batch) connectProcess(this);
+
     wstring directory   = getTempBhvrPath(nemesisInfo).wstring();
     wstring fpdirectory = directory + L"\\_1stperson";
     VecWstr filelist;
@@ -1201,6 +1271,13 @@ void BehaviorStart::milestoneStart()
 
 void BehaviorStart::unregisterProcess(bool skip)
 {
+    if (batch)
+    {
+        // the batch runs the end scripts and reports once all of its profiles are done
+        emit end();
+        return;
+    }
+
     if (!skip)
     {
         if (!error)
@@ -1258,34 +1335,49 @@ void BehaviorStart::unregisterProcess(bool skip)
 
 void BehaviorStart::EndAttempt()
 {
-    Lockless lock(atomic_lock);
+    nemesis::GenerationContext::Scope scope(context);
+    Lockless lock(endFlag);
 
-    --m_RunningThread;
-
-    if (m_RunningThread == 0)
+    if (--context.runningThread == 0)
     {
-        checkAllStoredHKX();
-        newMilestone();
+        --m_RunningThread;
 
         try
         {
-            for (int i = 0; i < failedBehaviors.size(); i += 2)
+            // the hkx check, the papyrus compile folder and the log belong to the batch
+            if (!batch) checkAllStoredHKX();
+
+            newMilestone();
+
+            for (int i = 0; i < context.failedBehaviors.size(); i += 2)
             {
-                hkxCompiler.hkxcmdProcess(failedBehaviors[i], failedBehaviors[i + 1], true);
-                DebugLogging(L"Processing behavior: " + failedBehaviors[i]
+                hkxCompiler.hkxcmdProcess(context.failedBehaviors[i], context.failedBehaviors[i + 1], true);
+                DebugLogging(L"Processing behavior: " + context.failedBehaviors[i]
                              + L" (Check point #, Behavior compile complete)");
                 emit progressUp();
             }
 
-            for (auto& msg : fileCheckMsg)
+            if (!batch)
             {
-                interMsg(msg);
+                for (auto& msg : context.fileCheckMsg)
+                {
+                    interMsg(msg);
+                }
             }
 
-            failedBehaviors.clear();
+            context.failedBehaviors.clear();
+            sort(context.deployedBehaviors.begin(), context.deployedBehaviors.end());
+
+            for (auto& hkxfile : context.deployedBehaviors)
+            {
+                DebugLogging(L"Behavior changed: " + hkxfile);
+            }
+
+            DebugLogging("Behaviors changed: " + to_string(context.deployedBehaviors.size())
+                         + ", behaviors unchanged: " + to_string(context.unchangedBehaviors));
             behaviorCheck(this);
             
-            if (isFileExist(papyrusTempCompile())) sf::remove_all(papyrusTempCompile());
+            if (!batch && isFileExist(papyrusTempCompile())) sf::remove_all(papyrusTempCompile());
 
             emit progressUp();
         }
@@ -1294,21 +1386,32 @@ void BehaviorStart::EndAttempt()
         catch (...)
         {}
 
-        if (error) 
-        { 
-            ClearGlobal();
-        }
-        else
+        // whatever fails above, the run is unregistered, a batch waits for the end of each of its profiles
+        try
         {
-            ClearGlobal(false);
+            if (batch)
+            {
+                context.Clear(error);
+            }
+            else if (error)
+            {
+                ClearGlobal();
+            }
+            else
+            {
+                ClearGlobal(false);
 
-            if (!cmdline) std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+                if (!cmdline) std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+            }
         }
+        catch (...)
+        {}
 
         try
         {
             unregisterProcess();
-            p_terminate->exitSignal();
+
+            if (!batch) p_terminate->exitSignal();
         }
         catch (...)
         {}
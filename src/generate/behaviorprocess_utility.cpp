@@ -1,9 +1,11 @@
 #include "nemesisinfo.h"
 
 #include "utilities/algorithm.h"
-#include "utilities/atomiclock.h"
+#include "utilities/threadpool.h"
 
+#include "generate/hkobject.h"
 #include "generate/behaviorgenerator.h"
+#include "generate/behaviorreferences.h"
 #include "generate/behaviorprocess_utility.h"
 
 #include "generate/animation/nodejoint.h"
@@ -24,14 +26,7 @@ void animThreadStart(shared_ptr<NewAnimArgs> args)
 	{
 		try
 		{
-			if (args->core)
-			{
-                Lockless lock(args->atomicLock.coreLock);
-
-				if (args->isCoreDone) return;
-
-				args->isCoreDone = true;
-			}
+			if (args->skip) return;
 
 			// getlines from newAnination
 			args->dummyAnimation->setZeroEvent(args->ZeroEvent);
@@ -70,6 +65,8 @@ void groupThreadStart(shared_ptr<newGroupArgs> args)
 		{
 			args->groupTemp->setZeroEvent(args->ZeroEvent);
             args->groupTemp->setZeroVariable(args->ZeroVariable);
+            args->groupTemp->setIDRange(args->idRange);
+            args->groupTemp->setReferences(args->references);
             args->groupTemp->getFunctionLines(args->allEditLines,
                                               args->lowerBehaviorFile,
                                               args->filename,
@@ -110,26 +107,78 @@ void elementUpdate(size_t& elementLine, int& counter, int& curID, map<int, VecSt
 {
 	if (elementLine != -1)
 	{
-		size_t position = catalystMap[curID][elementLine].find("numelements=\"") + 13;
-		string oldElement = catalystMap[curID][elementLine].substr(position, catalystMap[curID][elementLine].
-			find("\">", position) - position);
+		string& line = catalystMap[curID][elementLine];
+		nemesis::HkParamHeader header;
 
-		if (oldElement != to_string(counter))
+		// replace the count itself, the old number can also appear earlier in the line
+		if (nemesis::HkParam::ReadHeader(line, header) && header.countBegin != NOT_FOUND)
 		{
-			catalystMap[curID][elementLine].replace(catalystMap[curID][elementLine].find(oldElement), oldElement.length(),
-				to_string(counter));
+			line.replace(header.countBegin, header.countLength, to_string(counter));
 		}
 
 		elementLine = -1;
 	}
 }
 
-void unpackToCatalyst(map<int, VecStr>& catalystMap, unordered_map<int, shared_ptr<NodeJoint>>& existingNodes)
+void runNodeTasks(vector<function<void()>>& tasks, const string& behaviorFile)
 {
-	for (auto& node : existingNodes)
-	{
-		catalystMap[node.first] = node.second->unpack();
-	}
+    // most behaviors only have a handful of nodes to patch, a helper is only worth it for every 64 tasks
+    nemesis::ParallelFor(tasks.size(), 64, [&](size_t i) {
+        if (error) return;
+
+        try
+        {
+            try
+            {
+                tasks[i]();
+            }
+            catch (exception& ex)
+            {
+                ErrorMessage(6002, behaviorFile, ex.what());
+            }
+        }
+        catch (nemesis::exception&)
+        {
+            // resolved exception
+        }
+    });
+
+    if (error) throw nemesis::exception();
+}
+
+void unpackToCatalyst(map<int, VecStr>& catalystMap,
+                      map<int, nemesis::BehaviorReferences>& nodeReferences,
+                      unordered_map<int, shared_ptr<NodeJoint>>& existingNodes,
+                      const string& behaviorFile)
+{
+    struct Unpacked
+    {
+        int ID;
+        VecStr lines;
+        nemesis::BehaviorReferences references;
+    };
+
+    // each node unpacks and counts its own elements, the catalyst is only written in the merge after
+    vector<Unpacked> unpacked(existingNodes.size());
+    vector<function<void()>> tasks;
+    tasks.reserve(existingNodes.size());
+    size_t i = 0;
+
+    for (auto& node : existingNodes)
+    {
+        Unpacked* each   = &unpacked[i++];
+        NodeJoint* joint = node.second.get();
+        each->ID         = node.first;
+        tasks.emplace_back([each, joint]() { each->lines = joint->unpack(&each->references); });
+    }
+
+    runNodeTasks(tasks, behaviorFile);
+
+    for (auto& node : unpacked)
+    {
+        catalystMap[node.ID]    = move(node.lines);
+        nodeReferences[node.ID] = move(node.references);
+    }
 }
 
 int bonePatch(std::filesystem::path rigfile, int oribone, bool& newBone, const HkxCompiler& hkxCompiler)
@@ -243,7 +292,7 @@ void processExistFuncID(std::vector<int>& funcIDs,
 		if (curNode == existingNodes.end() || curNode->second == nullptr) existingNodes[functionID] = make_shared<NodeJoint>(catalystMap[functionID], templateCode, filename,
 			behaviorFile, templateGroup);
 
-		vector<vector<unordered_map<string, bool>>> optionPicked;
+		vector<vector<nemesis::OptionSet>> optionPicked;
 		SSMap IDExist;
 		unordered_map<string, bool> otherAnimType;
 		string strID = to_string(lastID);
@@ -253,7 +302,7 @@ void processExistFuncID(std::vector<int>& funcIDs,
 
 		for (auto& groupInfo : groupAnimInfo)
 		{
-			vector<unordered_map<string, bool>> curGroupInfo;
+			vector<nemesis::OptionSet> curGroupInfo;
 
 			for (auto& animInfo : groupInfo)
 			{
@@ -282,7 +331,7 @@ void redirToStageDir(filesystem::path& outpath, const NemesisInfo* nemesisInfo)
 {
     wstring wout = outpath.wstring();
 
-    if (stagePath.length() > 0 && wordFind(outpath, nemesisInfo->GetDataPath()) == 0)
+    if (nemesisInfo->IsStaged() && wordFind(wout, nemesisInfo->GetDataPath()) == 0)
     {
         wout.replace(0, nemesisInfo->GetDataPath().length(), nemesisInfo->GetStagePath());
         outpath = wout;
@@ -298,3 +347,14 @@ std::filesystem::path getTempBhvrPath(const NemesisInfo* nemesisInfo)
 
 	return "temp_behaviors";
 }
+
+std::filesystem::path getTempXmlPath(const NemesisInfo* nemesisInfo)
+{
+    // behaviors read from the shared temp_behaviors, but each staging directory keeps its own xml files
+    if (nemesisInfo->IsStaged())
+    {
+        return nemesisInfo->GetStagePath() + L"nemesis_engine\\temp_behaviors\\xml";
+    }
+
+    return "temp_behaviors\\xml";
+}
@@ -0,0 +1,126 @@
+#include "Global.h"
+
+#include "generate/hkobject.h"
+#include "generate/behaviorreferences.h"
+
+using namespace std;
+
+namespace
+{
+    const string_view objectOpen = "<hkobject ";
+    const string_view paramOpen  = "<hkparam name=\"";
+    const string_view paramClose = "</hkparam>";
+} // namespace
+
+void nemesis::BehaviorReferences::AddBehavior(string_view behavior)
+{
+    behaviors.emplace_back(behavior);
+}
+
+void nemesis::BehaviorReferences::AddClip(string_view clipName, string_view animationName)
+{
+    clips.push_back(Clip{string(clipName), string(animationName)});
+}
+
+void nemesis::BehaviorReferences::Merge(const BehaviorReferences& other)
+{
+    behaviors.insert(behaviors.end(), other.behaviors.begin(), other.behaviors.end());
+    clips.insert(clips.end(), other.clips.begin(), other.clips.end());
+}
+
+void nemesis::BehaviorReferences::Track(const string& line)
+{
+    size_t pos = line.find_first_not_of("\t ");
+
+    if (pos == NOT_FOUND) return;
+
+    string_view view(line);
+    view.remove_prefix(pos);
+
+    // <hkobject name="#0001" class="hkbClipGenerator" signature="0x333b85b9">
+    if (view.compare(0, objectOpen.length(), objectOpen) == 0)
+    {
+        node = Node::Other;
+        HkObjectHeader header;
+
+        if (!HkObject::ReadHeader(line, header)) return;
+
+        if (header.className == "hkbCharacterStringData")
+        {
+            node = Node::CharacterData;
+        }
+        else if (header.className == "hkbClipGenerator")
+        {
+            node = Node::Clip;
+        }
+        else if (header.className == "hkbBehaviorReferenceGenerator")
+        {
+            node = Node::BehaviorReference;
+        }
+
+        return;
+    }
+
+    // <hkparam name="animationName">Animations\idle.hkx</hkparam>
+    if (node == Node::Other || view.compare(0, paramOpen.length(), paramOpen) != 0) return;
+
+    view.remove_prefix(paramOpen.length());
+    size_t close = view.find("\">");
+
+    if (close == NOT_FOUND) return;
+
+    string_view param = view.substr(0, close);
+    string_view value = view.substr(close + 2);
+    value             = value.substr(0, value.find(paramClose));
+
+    switch (node)
+    {
+        case Node::CharacterData:
+        {
+            if (param != "behaviorFilename") return;
+
+            AddBehavior(value);
+            node = Node::Other;
+            break;
+        }
+        case Node::BehaviorReference:
+        {
+            if (param != "behaviorName") return;
+
+            AddBehavior(value);
+            node = Node::Other;
+            break;
+        }
+        case Node::Clip:
+        {
+            if (param == "name")
+            {
+                clipName = string(value);
+            }
+            else if (param == "animationName")
+            {
+                AddClip(clipName, value);
+                node = Node::Other;
+            }
+
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+const VecStr& nemesis::BehaviorReferences::GetBehaviors() const
+{
+    return behaviors;
+}
+
+const vector<nemesis::BehaviorReferences::Clip>& nemesis::BehaviorReferences::GetClips() const
+{
+    return clips;
+}
+
+bool nemesis::BehaviorReferences::Empty() const
+{
+    return behaviors.empty() && clips.empty();
+}
@@ -8,23 +8,31 @@
 
 #include "utilities/conditions.h"
 #include "utilities/threadpool.h"
+#include "utilities/changemanifest.h"
 #include "utilities/atomiclock.h"
+#include "utilities/lineclassifier.h"
+#include "utilities/memorybudget.h"
 #include "utilities/stringsplit.h"
 #include "utilities/readtextfile.h"
 
 #include "generate/addanims.h"
 #include "generate/addevents.h"
 #include "generate/addvariables.h"
+#include "generate/behaviorbatch.h"
 #include "generate/behaviorprocess.h"
 #include "generate/playerexclusive.h"
 #include "generate/generator_utility.h"
 #include "generate/behaviorgenerator.h"
 #include "generate/behaviorsubprocess.h"
+#include "generate/hkobject.h"
+#include "generate/behaviorwriter.h"
+#include "generate/behaviorreferences.h"
 #include "generate/animationdatatracker.h"
 #include "generate/behaviorprocess_utility.h"
 
 #include "generate/animation/import.h"
 #include "generate/animation/nodejoint.h"
+#include "generate/animation/fragmentcache.h"
 #include "generate/animation/templatetree.h"
 #include "generate/animation/grouptemplate.h"
 #include "generate/animation/singletemplate.h"
@@ -37,13 +45,20 @@ namespace sf = filesystem;
 struct NodeJoint;
 
 extern Terminator* p_terminate;
-extern atomic<int> m_RunningThread;
-extern atomic_flag animdata_lock;
 
 atomic<int> extraCore = 0;
-atomic<int> behaviorRun;
-condition_variable cv2;
-mutex cv2_m;
+
+namespace
+{
+    // clip generator put together from the HkObject of another one
+    void addClip(nemesis::BehaviorReferences& references, const nemesis::HkObject& clip)
+    {
+        const nemesis::HkParam* name          = clip.Find("name");
+        const nemesis::HkParam* animationName = clip.Find("animationName");
+
+        if (animationName) references.AddClip(name ? name->GetValue() : "", animationName->GetValue());
+    }
+} // namespace
 
 struct IDCatcher
 {
@@ -80,12 +95,14 @@ struct SubEnd
 
     ~SubEnd()
     {
+        nemesis::GenerationContext& context = process->context;
+
         {
-            lock_guard<mutex> lg(cv2_m);
-            --behaviorRun;
+            lock_guard<mutex> lg(context.behaviorRunLock);
+            --context.behaviorRun;
         }
 
-        cv2.notify_one();
+        context.behaviorRunDone.notify_one();
         process->EndAttempt();
     }
 };
@@ -101,18 +118,29 @@ void BehaviorSub::BehaviorCompilation()
 
     try
     {
-        ++m_RunningThread;
+        ++process->context.runningThread;
 
         {
-            lock_guard<mutex> lg(cv2_m);
-            ++behaviorRun;
+            lock_guard<mutex> lg(process->context.behaviorRunLock);
+            ++process->context.behaviorRun;
         }
 
         try
         {
             try
             {
+                // counted as running before it waits, so the animation data keeps waiting for it
+                nemesis::MemoryBudget::Ticket ticket;
+
+                if (nemesis::MemoryBudget::Instance().GetLimit() > 0)
+                {
+                    ticket = nemesis::MemoryBudget::Instance().Acquire(EstimateFootprint());
+                }
+
+                if (error) throw nemesis::exception();
+
                 CompilingBehavior();
+                ReleaseInputs();
             }
             catch (exception& ex)
             {
@@ -137,6 +165,75 @@ void BehaviorSub::BehaviorCompilation()
     }
 }
 
+size_t BehaviorSub::EstimateFootprint() const
+{
+    namespace sf = std::filesystem;
+
+    wstring filepath         = directory + nemesis::transform_to<wstring>(curfilefromlist);
+    string lowerBehaviorFile = nemesis::to_lower_copy(curfilefromlist.substr(0, curfilefromlist.find_last_of(".")));
+    const VecStr* sharedLines = process->batch ? process->batch->GetBehaviorLines(filepath) : nullptr;
+    size_t catalystBytes      = 0;
+
+    // a line costs about as much again as its text: a vanilla behavior line averages 42 bytes (21.5 MB over 513k
+    // lines in the test environment) and its pair<uint, string> slot takes 40
+    if (sharedLines)
+    {
+        for (auto& line : *sharedLines)
+        {
+            catalystBytes += line.length() + sizeof(pair<uint, string>);
+        }
+    }
+    else
+    {
+        std::error_code ec;
+        uintmax_t filesize = sf::file_size(filepath, ec);
+        catalystBytes      = ec ? 0 : size_t(filesize) * 2;
+    }
+
+    size_t animationBytes = 0;
+    auto codelist         = BehaviorTemplate->grouplist.find(lowerBehaviorFile);
+
+    if (codelist != BehaviorTemplate->grouplist.end())
+    {
+        for (auto& code : codelist->second)
+        {
+            auto anims     = newAnimation.find(code);
+            auto templates = BehaviorTemplate->behaviortemplate.find(code);
+
+            if (anims == newAnimation.end() || templates == BehaviorTemplate->behaviortemplate.end()) continue;
+
+            auto lines = templates->second.find(lowerBehaviorFile);
+
+            if (lines == templates->second.end()) continue;
+
+            size_t templateBytes = 0;
+
+            for (auto& line : lines->second)
+            {
+                templateBytes += line.length() + sizeof(string);
+            }
+
+            animationBytes += anims->second.size() * templateBytes;
+        }
+    }
+
+    // the peak is while CompilingBehavior splits the file into nodes: catalyst and catalystMap each hold every line
+    // and modLine adds a pair<uint, string> per line, about half a catalyst. Afterwards catalystMap and the
+    // BehaviorWriter buffer stay below that, at about one and a half. The lines generated for the new animations are
+    // built by the templates, then copied into catalystMap. Derived from the containers, not measured
+    return catalystBytes * 5 / 2 + animationBytes * 2;
+}
+
+void BehaviorSub::ReleaseInputs()
+{
+    // the sub stays alive until every behavior of the run is done, its copies of the run inputs need not
+    newAnimation    = unordered_map<string, vector<shared_ptr<NewAnimation>>>();
+    AnimVar         = unordered_map<string, var>();
+    newAnimEvent    = mapSetString();
+    newAnimVariable = mapSetString();
+    ignoreFunction  = unordered_map<string, unordered_map<int, bool>>();
+}
+
 void BehaviorSub::modPick(unordered_map<string, vector<pair<uint, shared_ptr<string>>>>& modEditStore,
                           vector<pair<uint, string>>& catalyst,
                           vector<pair<uint, string>>& modLine,
@@ -256,6 +353,8 @@ void BehaviorSub::CompilingBehavior()
     wstring filepath         = directory + nemesis::transform_to<wstring>(curfilefromlist);
     string behaviorFile      = curfilefromlist.substr(0, curfilefromlist.find_last_of("."));
     string lowerBehaviorFile = nemesis::to_lower_copy(nemesis::transform_to<string>(behaviorFile));
+    nemesis::GenerationContext& context      = process->context;
+    const wstring& behaviorPath              = context.GetBehaviorPath(behaviorHandle);
 
     bool isFirstPerson = lowerBehaviorFile.find("_1stperson") != NOT_FOUND;
 
@@ -277,6 +376,7 @@ void BehaviorSub::CompilingBehavior()
 
     SSMap IDExist;
     map<int, VecStr> catalystMap;
+    map<int, nemesis::BehaviorReferences> nodeReferences; // clips and behaviors of the catalyst nodes
     VecStr characterFiles;
 
     set<string> pceaMod;
@@ -291,25 +391,25 @@ void BehaviorSub::CompilingBehavior()
     if (modID.length() > 0)
     {
         outputdir = "new_behaviors\\"
-                    + GetFileDirectory(behaviorPath[lowerBehaviorFile].substr(
-                        behaviorPath[lowerBehaviorFile].find("\\") + 1))
+                    + GetFileDirectory(behaviorPath.substr(
+                        behaviorPath.find("\\") + 1))
                     + modID + lowerBehaviorFile;
     }
     else
     {
         outputdir = "new_behaviors\\"
-                    + behaviorPath[lowerBehaviorFile].substr(behaviorPath[lowerBehaviorFile].find("\\") + 1);
+                    + behaviorPath.substr(behaviorPath.find("\\") + 1);
     }
 #else
     if (modID.length() > 0)
     {
-        outputdir = GetFileDirectory(behaviorPath[nemesis::transform_to<wstring>(lowerBehaviorFile)]).data()
+        outputdir = GetFileDirectory(behaviorPath).data()
                     + nemesis::transform_to<wstring>(modID)
                     + nemesis::transform_to<wstring>(lowerBehaviorFile);
     }
     else
     {
-        outputdir = behaviorPath[nemesis::transform_to<wstring>(lowerBehaviorFile)];
+        outputdir = behaviorPath;
     }
 #endif
     if (error) throw nemesis::exception();
@@ -334,7 +434,7 @@ void BehaviorSub::CompilingBehavior()
     double duration;
 
     {
-        bool hasAA   = alternateAnim.size() != 0;
+        bool hasAA   = context.alternateAnim.size() != 0;
         bool isOpen  = true;
         bool newBone = false;
         bool modif   = false;
@@ -368,19 +468,43 @@ void BehaviorSub::CompilingBehavior()
         vector<pair<uint, string>> modLine;
         VecStr origLines;
 
-        if (sf::is_directory(filepath)) ErrorMessage(3001, filepath);
+        // a batch reads each behavior once and shares the lines with all of its profiles
+        const VecStr* sharedLines = process->batch ? process->batch->GetBehaviorLines(filepath) : nullptr;
+        unique_ptr<FileReader> BehaviorFormat;
+        size_t size;
+
+        if (sharedLines)
+        {
+            size = sharedLines->size();
+        }
+        else
+        {
+            if (sf::is_directory(filepath)) ErrorMessage(3001, filepath);
+
+            size           = fileLineCount(filepath);
+            BehaviorFormat = make_unique<FileReader>(filepath);
+
+            if (!BehaviorFormat->GetFile()) ErrorMessage(3002, filepath);
+        }
 
-        size_t size = fileLineCount(filepath);
         catalyst.reserve(size);
         modLine.reserve(size);
-        FileReader BehaviorFormat(filepath);
-
-        if (!BehaviorFormat.GetFile()) ErrorMessage(3002, filepath);
 
         bool hasDeleted = false;
         uint numline    = 0;
 
         string line;
+        size_t sharedNum = 0;
+
+        auto nextLine = [&]() -> bool
+        {
+            if (!sharedLines) return BehaviorFormat->GetLines(line);
+
+            if (sharedNum == sharedLines->size()) return false;
+
+            line = (*sharedLines)[sharedNum++];
+            return true;
+        };
         unordered_map<string, vector<pair<uint, shared_ptr<string>>>> modEditStore;
 
         auto storingLine = [&]() 
@@ -422,15 +546,11 @@ void BehaviorSub::CompilingBehavior()
 
                 if (pos != NOT_FOUND && line.find("signature=\"", pos) != NOT_FOUND)
                 {
-                    string ID = nemesis::regex_replace(
-                        string(line),
-                        nemesis::regex(".*<hkobject name=\"#([0-9]+)\" class=\"[a-zA-Z]+\" "
-                                       "signature=\".*\">.*"),
-                        string("\\1"));
+                    nemesis::HkObjectHeader header;
 
-                    if (ID != line)
+                    if (nemesis::HkObject::ReadHeader(line, header) && header.ID != -1)
                     {
-                        curID = stoi(ID);
+                        curID = header.ID;
 
                         if (curID >= lastID) lastID = curID + 1;
                     }
@@ -441,20 +561,21 @@ void BehaviorSub::CompilingBehavior()
             }
         };
 
-        while (BehaviorFormat.GetLines(line))
+        while (nextLine())
         {
-            bool skip = false;
+            bool skip                    = false;
+            nemesis::LineClass lineClass = nemesis::ClassifyLine(line);
 
-            if (line.find("<!-- ") != NOT_FOUND)
+            if (lineClass.Has(nemesis::LineMarker::Comment))
             {
                 if (line.find("\t\t<!-- *") == NOT_FOUND && line.find("\t\t<!-- original -->") && NOT_FOUND)
                 {
                     modPick(modEditStore, catalyst, modLine, hasDeleted);
                 }
 
-                if (line.find("<!-- NEW *") != NOT_FOUND)
+                if (lineClass.Has(nemesis::LineMarker::NewMod))
                 {
-                    size_t tempint = line.find("<!-- NEW *") + 10;
+                    size_t tempint = lineClass.Find(nemesis::LineMarker::NewMod) + 10;
                     string mod     = line.substr(tempint, line.find("* -->", tempint + 1) - tempint);
 
                     if (process->chosenBehavior.find(mod) == process->chosenBehavior.end())
@@ -470,7 +591,7 @@ void BehaviorSub::CompilingBehavior()
                     modif = true;
                     skip  = true;
                 }
-                else if (line.find("<!-- ORIGINAL -->") != NOT_FOUND)
+                else if (lineClass.Has(nemesis::LineMarker::Original))
                 {
                     if (!modif) ErrorMessage(1211, filepath, numline);
 
@@ -478,7 +599,7 @@ void BehaviorSub::CompilingBehavior()
                     orig   = true;
                     skip   = true;
                 }
-                else if (line.find("<!-- CLOSE -->") != NOT_FOUND)
+                else if (lineClass.Has(nemesis::LineMarker::Close))
                 {
                     if (modif)
                     {
@@ -596,7 +717,8 @@ void BehaviorSub::CompilingBehavior()
         }
         else
         {
-            characterFiles = behaviorJoints[nemesis::transform_to<string>(lowerBehaviorFile)];
+            const VecStr* joints = context.behaviorJoints.Find(lowerBehaviorFile);
+            characterFiles       = joints ? *joints : VecStr();
             DebugLogging(L"Processing behavior: " + filepath + L" (IsCharater: FALSE)");
         }
 
@@ -667,14 +789,14 @@ void BehaviorSub::CompilingBehavior()
                     pos += 30;
                     string animPath
                         = nemesis::to_lower_copy(line.substr(pos, line.find("</hkparam>", pos) - pos));
-                    addUsedAnim(lowerBehaviorFile, animPath);
+                    addUsedAnim(behaviorHandle, animPath);
                     string animFile = GetFileName(animPath) + ".hkx";
 
                     if (!isFirstPerson)
                     {
-                        auto replacer = animReplaced.find(animFile);
+                        auto replacer = context.animReplaced.find(animFile);
 
-                        if (replacer != animReplaced.end() && replacer->second.size())
+                        if (replacer != context.animReplaced.end() && replacer->second.size())
                         {
                             pceaID.insert(make_pair(curID, &replacer->second));
 
@@ -689,22 +811,22 @@ void BehaviorSub::CompilingBehavior()
                     if (hasAA)
                     {
                         string tempAnimFile = isFirstPerson ? animFile + "_1p*" : animFile;
-                        auto aa             = alternateAnim.find(tempAnimFile);
+                        auto aa             = context.alternateAnim.find(tempAnimFile);
 
-                        if (aa != alternateAnim.end())
+                        if (aa != context.alternateAnim.end())
                         {
                             clipAA[curID][animFile] = aa->second;
-                            AAGroupList.insert(isFirstPerson ? AAGroup[animFile] + "_1p*"
-                                                             : AAGroup[animFile]);
-                            auto aaEvent = AAHasEvent.find(tempAnimFile);
+                            AAGroupList.insert(isFirstPerson ? context.AAGroup[animFile] + "_1p*"
+                                                             : context.AAGroup[animFile]);
+                            auto aaEvent = context.AAHasEvent.find(tempAnimFile);
 
-                            if (aaEvent != AAHasEvent.end())
+                            if (aaEvent != context.AAHasEvent.end())
                             {
                                 for (string& AA_animName : aaEvent->second)
                                 {
-                                    for (unsigned int k = 0; k < AAEvent[AA_animName].size(); ++k)
+                                    for (unsigned int k = 0; k < context.AAEvent[AA_animName].size(); ++k)
                                     {
-                                        if (k % 2 == 0) AAEventName.insert(AAEvent[AA_animName][k]);
+                                        if (k % 2 == 0) AAEventName.insert(context.AAEvent[AA_animName][k]);
                                     }
                                 }
                             }
@@ -780,12 +902,14 @@ void BehaviorSub::CompilingBehavior()
         bool norElement    = false;
         bool characterAA   = false;
 
+        int referencesID                           = -1;
+        nemesis::BehaviorReferences* curReferences = nullptr;
+
         // add picked behavior and remove not picked behavior
         for (uint l = 0; l < catalyst.size(); ++l)
         {
             bool elementCatch = false;
             string line       = catalyst[l].second;
-            nemesis::smatch check;
 
             if (line.length() == 0)
             { 
@@ -794,41 +918,39 @@ void BehaviorSub::CompilingBehavior()
             else
             {
                 newMod = modLine[l].second;
+                nemesis::LineClass lineClass = nemesis::ClassifyLine(line);
 
-                if (line.find("<!-- ", 0) != NOT_FOUND)
+                if (lineClass.Has(nemesis::LineMarker::Comment))
                 {
-                    if (line.find("<!-- NEW ^", 0) != NOT_FOUND || line.find("<!-- FOREACH ^") != NOT_FOUND)
+                    if (lineClass.Has(nemesis::LineMarker::NewTemplate)
+                        || lineClass.Has(nemesis::LineMarker::ForEach))
                     {
                         ++special;
                     }
-                    else if (line.find("<!-- CLOSE -->", 0) != NOT_FOUND)
+                    else if (lineClass.Has(nemesis::LineMarker::Close))
                     {
                         --special;
                     }
                 }
 
-                if (line.find("<hkobject name=\"", 0) != NOT_FOUND
-                    && line.find("signature=\"", 0) != NOT_FOUND)
+                if (lineClass.Has(nemesis::LineMarker::Object) && line.find("signature=\"", 0) != NOT_FOUND)
                 {
                     isClipTrigger = false;
-                    nemesis::smatch match;
+                    nemesis::HkObjectHeader header;
 
-                    if (nemesis::regex_search(
-                            line,
-                            match,
-                            nemesis::regex(
-                                "<hkobject name=\"#(.*)\" class=\"([a-zA-Z]+)\" signature=\".*\">")))
+                    if (nemesis::HkObject::ReadHeader(line, header) && header.name.length() > 1
+                        && header.name[0] == '#')
                     {
-                        curID       = stoi(match[1]);
+                        curID       = stoi(string(header.name.substr(1)));
                         elementLine = -1;
 
-                        if (match[2] == "hkbClipTriggerArray") isClipTrigger = true;
+                        if (header.className == "hkbClipTriggerArray") isClipTrigger = true;
                     }
                 }
 
-                if (line.find("$", line.find("#")) != NOT_FOUND)
+                if (lineClass.Has(nemesis::LineMarker::TemplateID))
                 {
-                    if (line.find(">#") != NOT_FOUND)
+                    if (lineClass.Has(nemesis::LineMarker::Reference))
                     {
                         size_t reference = count(line.begin(), line.end(), '#');
                         size_t nextpos   = 0;
@@ -903,221 +1025,168 @@ void BehaviorSub::CompilingBehavior()
                     }
                 }
 
-                // get event id from newAnimation
-                if ((!doneEventName && line.find("<hkparam name=\"eventNames\" numelements=", 0) != NOT_FOUND)
-                    || (!doneEventInfo
-                        && line.find("<hkparam name=\"eventInfos\" numelements=", 0) != NOT_FOUND))
+                nemesis::HkParamHeader array;
+                string_view arrayName;
+
+                if (lineClass.Has(nemesis::LineMarker::NumElements) && nemesis::HkParam::ReadHeader(line, array)
+                    && array.countBegin != NOT_FOUND)
                 {
-                    line.find("<hkparam name=\"eventNames\" numelements=", 0) != NOT_FOUND
-                        ? doneEventName = true
-                        : doneEventInfo = true;
+                    arrayName = string_view(line).substr(array.nameBegin, array.nameLength);
+                }
 
-                    nemesis::smatch match;
+                // get event id from newAnimation
+                if ((!doneEventName && arrayName == "eventNames") || (!doneEventInfo && arrayName == "eventInfos"))
+                {
+                    arrayName == "eventNames" ? doneEventName = true : doneEventInfo = true;
 
-                    if (nemesis::regex_search(
-                            line, match, nemesis::regex("<hkparam name=\"(.+?)\" numelements=\"(.+?)\">")))
+                    if (eventelements == -1)
                     {
-                        if (eventelements == -1)
-                        {
-                            if (line.find("</hkparam>") == NOT_FOUND)
-                            {
-                                counter         = 0;
-                                eventOpen       = true;
-                                elementCatch    = true;
-                                string templine = line.substr(0, match.position(1));
-                                openRange       = count(templine.begin(), templine.end(), '\t');
-                                curNum          = match[1];
-                            }
-                        }
-                        else
+                        if (!array.closed)
                         {
-                            string templine = line.substr(0, match.position(1));
-                            openRange       = count(templine.begin(), templine.end(), '\t');
-                            curNum          = match[1];
-                            replacedNum     = true;
+                            counter         = 0;
                             eventOpen       = true;
-                            line.replace(match.position(2), match[2].length(), to_string(eventelements));
+                            elementCatch    = true;
+                            string templine = line.substr(0, array.nameBegin);
+                            openRange       = count(templine.begin(), templine.end(), '\t');
+                            curNum          = arrayName;
                         }
                     }
+                    else
+                    {
+                        string templine = line.substr(0, array.nameBegin);
+                        openRange       = count(templine.begin(), templine.end(), '\t');
+                        curNum          = arrayName;
+                        replacedNum     = true;
+                        eventOpen       = true;
+                        line.replace(array.countBegin, array.countLength, to_string(eventelements));
+                    }
                 }
-                else if ((!doneAttributeName
-                          && line.find("<hkparam name=\"attributeNames\" numelements=") != NOT_FOUND)
-                         || (!doneAttributeDef
-                             && line.find("<hkparam name=\"attributeDefaults\" numelements=") != NOT_FOUND))
+                else if ((!doneAttributeName && arrayName == "attributeNames")
+                         || (!doneAttributeDef && arrayName == "attributeDefaults"))
                 {
-                    line.find("<hkparam name=\"attributeNames\" numelements=") != NOT_FOUND
-                        ? doneAttributeName = true
-                        : doneAttributeDef  = true;
-
-                    nemesis::smatch match;
+                    arrayName == "attributeNames" ? doneAttributeName = true : doneAttributeDef = true;
 
-                    if (nemesis::regex_search(
-                            line, match, nemesis::regex("<hkparam name=\"(.+?)\" numelements=\"(.+?)\">")))
+                    if (attributeelements == -1)
                     {
-                        if (attributeelements == -1)
+                        if (!array.closed)
                         {
-                            if (line.find("</hkparam>") == NOT_FOUND)
-                            {
-                                counter         = 0;
-                                attriOpen       = true;
-                                elementCatch    = true;
-                                string templine = line.substr(0, match.position(1));
-                                openRange       = count(templine.begin(), templine.end(), '\t');
-                                curNum          = match[1];
-                            }
-                        }
-                        else
-                        {
-                            line.replace(match.position(2), match[2].length(), to_string(attributeelements));
+                            counter         = 0;
+                            attriOpen       = true;
+                            elementCatch    = true;
+                            string templine = line.substr(0, array.nameBegin);
+                            openRange       = count(templine.begin(), templine.end(), '\t');
+                            curNum          = arrayName;
                         }
                     }
+                    else
+                    {
+                        line.replace(array.countBegin, array.countLength, to_string(attributeelements));
+                    }
                 }
-                else if ((!doneCharacProName
-                          && line.find("<hkparam name=\"characterPropertyNames\" numelements=") != NOT_FOUND)
-                         || (!doneCharacProInfo
-                             && line.find("<hkparam name=\"characterPropertyInfos\" numelements=")
-                                    != NOT_FOUND))
+                else if ((!doneCharacProName && arrayName == "characterPropertyNames")
+                         || (!doneCharacProInfo && arrayName == "characterPropertyInfos"))
                 {
-                    line.find("<hkparam name=\"characterPropertyNames\" numelements=") != NOT_FOUND
-                        ? doneCharacProName = true
-                        : doneCharacProInfo = true;
-
-                    nemesis::smatch match;
+                    arrayName == "characterPropertyNames" ? doneCharacProName = true : doneCharacProInfo = true;
 
-                    if (nemesis::regex_search(
-                            line, match, nemesis::regex("<hkparam name=\"(.+?)\" numelements=\"(.+?)\">")))
+                    if (characterelements == -1)
                     {
-                        if (characterelements == -1)
-                        {
-                            if (line.find("</hkparam>") == NOT_FOUND)
-                            {
-                                counter         = 0;
-                                charOpen        = true;
-                                elementCatch    = true;
-                                string templine = line.substr(0, match.position(1));
-                                openRange       = count(templine.begin(), templine.end(), '\t');
-                                curNum          = match[1];
-                            }
-                        }
-                        else
+                        if (!array.closed)
                         {
-                            line.replace(match.position(2), match[2].length(), to_string(characterelements));
+                            counter         = 0;
+                            charOpen        = true;
+                            elementCatch    = true;
+                            string templine = line.substr(0, array.nameBegin);
+                            openRange       = count(templine.begin(), templine.end(), '\t');
+                            curNum          = arrayName;
                         }
                     }
+                    else
+                    {
+                        line.replace(array.countBegin, array.countLength, to_string(characterelements));
+                    }
                 }
-                else if ((!doneVarName
-                          && line.find("<hkparam name=\"variableNames\" numelements=") != NOT_FOUND)
-                         || (!doneVarWord
-                             && line.find("<hkparam name=\"wordVariableValues\" numelements=") != NOT_FOUND)
-                         || (!doneVarInfo
-                             && line.find("<hkparam name=\"variableInfos\" numelements=") != NOT_FOUND))
+                else if ((!doneVarName && arrayName == "variableNames")
+                         || (!doneVarWord && arrayName == "wordVariableValues")
+                         || (!doneVarInfo && arrayName == "variableInfos"))
                 {
-                    line.find("<hkparam name=\"variableNames\" numelements=") != NOT_FOUND
+                    arrayName == "variableNames"
                         ? doneVarName = true
-                        : line.find("<hkparam name=\"wordVariableValues\" numelements=") != NOT_FOUND
-                              ? doneVarWord = true
-                              : doneVarInfo = true;
-
-                    nemesis::smatch match;
+                        : arrayName == "wordVariableValues" ? doneVarWord = true : doneVarInfo = true;
 
-                    if (nemesis::regex_search(
-                            line, match, nemesis::regex("<hkparam name=\"(.+?)\" numelements=\"(.+?)\">")))
+                    if (variableelements == -1)
                     {
-                        if (variableelements == -1)
-                        {
-                            if (line.find("</hkparam>") == NOT_FOUND)
-                            {
-                                counter         = 0;
-                                varOpen         = true;
-                                elementCatch    = true;
-                                string templine = line.substr(0, match.position(1));
-                                openRange       = count(templine.begin(), templine.end(), '\t');
-                                curNum          = match[1];
-                            }
-                        }
-                        else
+                        if (!array.closed)
                         {
-                            replacedNum     = true;
+                            counter         = 0;
                             varOpen         = true;
-                            string templine = line.substr(0, match.position(1));
+                            elementCatch    = true;
+                            string templine = line.substr(0, array.nameBegin);
                             openRange       = count(templine.begin(), templine.end(), '\t');
-                            curNum          = match[1];
-                            line.replace(match.position(2), match[2].length(), to_string(variableelements));
+                            curNum          = arrayName;
                         }
                     }
+                    else
+                    {
+                        replacedNum     = true;
+                        varOpen         = true;
+                        string templine = line.substr(0, array.nameBegin);
+                        openRange       = count(templine.begin(), templine.end(), '\t');
+                        curNum          = arrayName;
+                        line.replace(array.countBegin, array.countLength, to_string(variableelements));
+                    }
                 }
-                else if (!doneAnimName
-                         && line.find("<hkparam name=\"animationNames\" numelements=\"") != NOT_FOUND)
+                else if (!doneAnimName && arrayName == "animationNames")
                 {
                     if (curfilefromlist.find("_1stperson\\") != NOT_FOUND) fp_animOpen = true;
 
                     doneAnimName = true;
-                    nemesis::smatch match;
 
-                    if (nemesis::regex_search(
-                            line, match, nemesis::regex("<hkparam name=\"(.+?)\" numelements=\"(.+?)\">")))
+                    if (!array.closed)
                     {
-                        if (line.find("</hkparam>") == NOT_FOUND)
+                        counter         = 0;
+                        animOpen        = true;
+                        elementCatch    = true;
+                        string templine = line.substr(0, array.nameBegin);
+                        openRange       = count(templine.begin(), templine.end(), '\t');
+                        string number   = line.substr(array.countBegin, array.countLength);
+                        curNum          = arrayName;
+
+                        if (!isOnlyNumber(number))
                         {
-                            counter         = 0;
-                            animOpen        = true;
-                            elementCatch    = true;
-                            string templine = line.substr(0, match.position(1));
-                            openRange       = count(templine.begin(), templine.end(), '\t');
-                            string number   = match[2];
-                            curNum          = match[1];
-
-                            if (!isOnlyNumber(number))
-                            {
-                                ErrorMessage(1174,
-                                             filepath,
-                                             catalyst[l].first,
-                                             line.substr(line.find(
-                                                 "<hkparam name=\"animationNames\" numelements=\"")));
-                            }
-
-                            base = stoi(number);
+                            ErrorMessage(1174,
+                                         filepath,
+                                         catalyst[l].first,
+                                         line.substr(line.find(
+                                             "<hkparam name=\"animationNames\" numelements=\"")));
                         }
+
+                        base = stoi(number);
                     }
                 }
-                else if ((!doneDeform
-                          && line.find("<hkparam name=\"deformableSkinNames\" numelements=\"") != NOT_FOUND)
-                         || (!doneRigid
-                             && line.find("<hkparam name=\"rigidSkinNames\" numelements=\"") != NOT_FOUND)
-                         || (!doneAnimFileName
-                             && line.find("<hkparam name=\"animationFilenames\" numelements=\"")
-                                    != NOT_FOUND))
+                else if ((!doneDeform && arrayName == "deformableSkinNames")
+                         || (!doneRigid && arrayName == "rigidSkinNames")
+                         || (!doneAnimFileName && arrayName == "animationFilenames"))
                 {
-                    line.find("<hkparam name=\"deformableSkinNames\" numelements=\"") != NOT_FOUND
+                    arrayName == "deformableSkinNames"
                         ? doneDeform = true
-                        : line.find("<hkparam name=\"rigidSkinNames\" numelements=\"") != NOT_FOUND
-                              ? doneRigid        = true
-                              : doneAnimFileName = true;
+                        : arrayName == "rigidSkinNames" ? doneRigid = true : doneAnimFileName = true;
 
-                    nemesis::smatch match;
-
-                    if (nemesis::regex_search(
-                            line, match, nemesis::regex("<hkparam name=\"(.+?)\" numelements=\"(.+?)\">")))
+                    if (!array.closed)
                     {
-                        if (line.find("</hkparam>") == NOT_FOUND)
-                        {
-                            counter         = 0;
-                            otherAnimOpen   = true;
-                            elementCatch    = true;
-                            string templine = line.substr(0, match.position(1));
-                            openRange       = count(templine.begin(), templine.end(), '\t');
-                            curNum          = match[1];
-                        }
+                        counter         = 0;
+                        otherAnimOpen   = true;
+                        elementCatch    = true;
+                        string templine = line.substr(0, array.nameBegin);
+                        openRange       = count(templine.begin(), templine.end(), '\t');
+                        curNum          = arrayName;
                     }
                 }
-                else if (nemesis::regex_search(
-                             line, check, nemesis::regex("<hkparam name=\"(.+?)\" numelements=\""))
-                         && line.find("</hkparam>", check.position(1)) == NOT_FOUND)
+                else if (!arrayName.empty() && !array.closed)
                 {
                     counter         = 0;
                     norElement      = true;
                     elementCatch    = true;
-                    string templine = line.substr(0, check.position(1));
+                    string templine = line.substr(0, array.nameBegin);
                     openRange       = count(templine.begin(), templine.end(), '\t');
                 }
                 // counting for numelement
@@ -1243,7 +1312,7 @@ void BehaviorSub::CompilingBehavior()
                                                  variableid,
                                                  varName);
 
-                                    for (int k = 0; k < AAgroup_Counter[AAVariable]; ++k)
+                                    for (int k = 0; k < context.AAgroup_Counter[AAVariable]; ++k)
                                     {
                                         AddVariables(curNum,
                                                      catalystMap[curID],
@@ -1387,9 +1456,11 @@ void BehaviorSub::CompilingBehavior()
                                  it != BehaviorTemplate->grouplist.end();
                                  ++it)
                             {
-                                for (unsigned int k = 0; k < behaviorJoints[it->first].size(); ++k)
+                                const VecStr* joints = context.behaviorJoints.Find(it->first);
+
+                                for (unsigned int k = 0; joints && k < joints->size(); ++k)
                                 {
-                                    if (lowerBehaviorFile != behaviorJoints[it->first][k]) continue;
+                                    if (lowerBehaviorFile != (*joints)[k]) continue;
 
                                     for (auto& templatecode : it->second)
                                     {
@@ -1408,6 +1479,7 @@ void BehaviorSub::CompilingBehavior()
                                                          outputdir,
                                                          behaviorFile,
                                                          lowerBehaviorFile,
+                                                         behaviorHandle,
                                                          newMod,
                                                          catalystMap[curID],
                                                          counter,
@@ -1423,7 +1495,7 @@ void BehaviorSub::CompilingBehavior()
 
                             if (!isFirstPerson)
                             {
-                                for (auto& AA : alternateAnim)
+                                for (auto& AA : context.alternateAnim)
                                 {
                                     for (auto& anim : AA.second)
                                     {
@@ -1436,6 +1508,7 @@ void BehaviorSub::CompilingBehavior()
                                                      outputdir,
                                                      behaviorFile,
                                                      lowerBehaviorFile,
+                                                     behaviorHandle,
                                                      newMod,
                                                      catalystMap[curID],
                                                      counter,
@@ -1447,7 +1520,7 @@ void BehaviorSub::CompilingBehavior()
                                     }
                                 }
 
-                                for (auto& pcea : pcealist)
+                                for (auto& pcea : context.pcealist)
                                 {
                                     for (auto& animPath : pcea.animPathList)
                                     {
@@ -1457,6 +1530,7 @@ void BehaviorSub::CompilingBehavior()
                                                  outputdir,
                                                  behaviorFile,
                                                  lowerBehaviorFile,
+                                                 behaviorHandle,
                                                  newMod,
                                                  catalystMap[curID],
                                                  counter,
@@ -1484,15 +1558,15 @@ void BehaviorSub::CompilingBehavior()
                             string animFile = sf::path(animPath).filename().string();
 
                             if (!fp_animOpen && !characterAA
-                                && alternateAnim.find(nemesis::to_lower_copy(animFile))
-                                       != alternateAnim.end())
+                                && context.alternateAnim.find(nemesis::to_lower_copy(animFile))
+                                       != context.alternateAnim.end())
                             {
                                 if (!isCharacter) ErrorMessage(1184, behaviorFile);
 
                                 characterAA = true;
                             }
 
-                            if (activatedBehavior["gender*"])
+                            if (context.IsActivated("gender*"))
                             {
                                 if (lowerBehaviorFile == "defaultfemale")
                                 {
@@ -1541,40 +1615,42 @@ void BehaviorSub::CompilingBehavior()
                             nemesis::to_lower(animPath);
                             nemesis::to_lower(animFile);
                             isAdded[animPath] = true;
-                            registeredAnim[lowerBehaviorFile].insert(animFile);
-
-                            Lockless locker(animdata_lock);
-                            shared_ptr<AnimationDataTracker>& animData
-                                = charAnimDataInfo[lowerBehaviorFile][animFile];
-
-                            if (animData == nullptr)
-                                animData = make_shared<AnimationDataTracker>(counter, animFile);
-                            else
-                                animData->SetOrder(counter);
+                            context.registeredAnim.Update(
+                                behaviorHandle, [&](set<string>& registered) { registered.insert(animFile); });
+                            context.charAnimDataInfo.Update(
+                                lowerBehaviorFile, [&](map<string, shared_ptr<AnimationDataTracker>>& list) {
+                                    shared_ptr<AnimationDataTracker>& animData = list[animFile];
+
+                                    if (animData == nullptr)
+                                        animData = make_shared<AnimationDataTracker>(counter, animFile);
+                                    else
+                                        animData->SetOrder(counter);
+                                });
 
-                            locker.Unlock();
                             (this->*tryAddAnim)();
                             ++counter;
 
                             if (newMod.length() == 0) newMod = "Skyrim";
 
-                            vector<set<string>>* match_ptr = &animModMatch[lowerBehaviorFile][animFile];
-                            size_t matchSize               = match_ptr->size();
+                            context.animModMatch.Update(
+                                behaviorHandle, [&](unordered_map<string, vector<set<string>>>& matchList) {
+                                    vector<set<string>>& match = matchList[animFile];
 
-                            if (matchSize == 0)
-                            {
-                                match_ptr->push_back(set<string>{animPath});
-                                match_ptr->push_back(set<string>{newMod});
-                            }
-                            else if (matchSize == 2)
-                            {
-                                match_ptr->at(0).insert(animPath);
-                                match_ptr->at(1).insert(newMod);
-                            }
-                            else
-                            {
-                                ErrorMessage(1058);
-                            }
+                                    if (match.empty())
+                                    {
+                                        match.push_back(set<string>{animPath});
+                                        match.push_back(set<string>{newMod});
+                                    }
+                                    else if (match.size() == 2)
+                                    {
+                                        match[0].insert(animPath);
+                                        match[1].insert(newMod);
+                                    }
+                                    else
+                                    {
+                                        ErrorMessage(1058);
+                                    }
+                                });
                         }
                     }
                 }
@@ -1768,6 +1844,13 @@ void BehaviorSub::CompilingBehavior()
                         }
                     }
 
+                    if (referencesID != curID)
+                    {
+                        referencesID  = curID;
+                        curReferences = &nodeReferences[curID];
+                    }
+
+                    curReferences->Track(newline);
                     catalystMap[curID].push_back(newline);
                     ++repeated;
                 }
@@ -1781,7 +1864,7 @@ void BehaviorSub::CompilingBehavior()
         DebugLogging(L"Processing behavior: " + filepath
                      + L" (Check point 3, Behavior general processing complete)");
 
-        if (clipAA.size() == 0 && pceaID.size() == 0 && !activatedBehavior[lowerBehaviorFile] && !characterAA
+        if (clipAA.size() == 0 && pceaID.size() == 0 && !context.IsActivated(lowerBehaviorFile) && !characterAA
             && !newBone)
         {
             if (!isEdited(BehaviorTemplate.get(), lowerBehaviorFile, newAnimation, isCharacter, modID))
@@ -1789,10 +1872,10 @@ void BehaviorSub::CompilingBehavior()
                 // final output
 #ifdef DEBUG
                 outputdir = "new_behaviors\\"
-                            + behaviorPath[lowerBehaviorFile].substr(
-                                behaviorPath[lowerBehaviorFile].find("\\") + 1);
+                            + behaviorPath.substr(
+                                behaviorPath.find("\\") + 1);
 #else
-                outputdir = behaviorPath[nemesis::transform_to<wstring>(lowerBehaviorFile)] + L".hkx";
+                outputdir = behaviorPath + L".hkx";
 #endif
                 if (SSE) lowerBehaviorFile = "SSE\\" + lowerBehaviorFile;
 
@@ -1844,31 +1927,51 @@ void BehaviorSub::CompilingBehavior()
     // newAnimation ID in existing function
     if (catcher.size() != 0)
     {
+        struct CaughtID
+        {
+            const string* ID;
+            const string* newID;
+            int line;
+        };
+
+        // a line can catch several IDs, so everything caught in the same node is patched by the same task
+        map<int, vector<CaughtID>> nodeCatcher;
+        vector<function<void()>> tasks;
+
         for (auto it = catcher.begin(); it != catcher.end(); ++it)
         {
-            for (unsigned int k = 0; k < it->second.size(); ++k)
+            const string& newID = IDExist[it->first];
+
+            if (newID.length() == 0) ErrorMessage(1026, filepath, it->first.substr(0, it->first.find("$")));
+
+            for (auto& catching : it->second)
             {
-                int tempID   = it->second[k].getID();
-                int tempLine = it->second[k].getLine();
-                string* line = &catalystMap[it->second[k].getID()][it->second[k].getLine()];
+                nodeCatcher[catching.getID()].push_back(CaughtID{&it->first, &newID, catching.getLine()});
+            }
+        }
 
-                if (IDExist[it->first].length() != 0)
+        for (auto& node : nodeCatcher)
+        {
+            VecStr* lines             = &catalystMap[node.first];
+            vector<CaughtID>* caughts = &node.second;
+
+            tasks.emplace_back([lines, caughts]() {
+                for (auto& caught : *caughts)
                 {
+                    string* line = &(*lines)[caught.line];
                     line->append("%");
-                    string masterFormat = it->first.substr(0, it->first.find("$"));
-                    string numID        = it->first.substr(it->first.find("$") + 1);
+                    string masterFormat = caught.ID->substr(0, caught.ID->find("$"));
+                    string numID        = caught.ID->substr(caught.ID->find("$") + 1);
                     nemesis::smatch match;
                     nemesis::regex_match(
                         *line, match, nemesis::regex(".*(" + masterFormat + "[$]" + numID + ")[^0-9]+.*"));
-                    line->replace(match.position(1), it->first.length(), IDExist[it->first]);
+                    line->replace(match.position(1), caught.ID->length(), *caught.newID);
                     line->pop_back();
                 }
-                else
-                {
-                    ErrorMessage(1026, filepath, it->first.substr(0, it->first.find("$")));
-                }
-            }
+            });
         }
+
+        runNodeTasks(tasks, behaviorFile);
     }
 
     if (error) throw nemesis::exception();
@@ -1877,6 +1980,7 @@ void BehaviorSub::CompilingBehavior()
 
     // add new animation
     vector<shared_ptr<VecStr>> allEditLines;
+    unordered_map<const VecStr*, shared_ptr<nemesis::BehaviorReferences>> editReferences; // per block of allEditLines
     unordered_map<string, bool> isCoreDone;
     unordered_map<int, int> functionState;
     unordered_map<int, shared_ptr<NodeJoint>> existingNodes;
@@ -1938,7 +2042,6 @@ void BehaviorSub::CompilingBehavior()
                 if (!newAnimSkip(newAnimCopy, modID))
                 {
                     shared_ptr<group> subFunctionIDs = make_shared<group>();
-                    subFunctionIDs->singlelist.reserve(memory);
                     group newSubFunctionIDs;
                     vector<int> stateID;
                     vector<int> stateMultiplier = {0};
@@ -1958,14 +2061,11 @@ void BehaviorSub::CompilingBehavior()
                         if (newAnimCopy[0]->GetGroupAnimInfo()[0]->ignoreGroup)
                         {
                             ignoreGroup = true;
-                            // newSubFunctionIDs.singlelist.reserve(memory);
-                            groupFunctionIDs->grouplist.reserve(memory);
                         }
                     }
                     else
                     {
                         stateID.push_back(0);
-                        groupFunctionIDs->grouplist.reserve(memory);
                     }
 
                     if (error) throw nemesis::exception();
@@ -1983,10 +2083,29 @@ void BehaviorSub::CompilingBehavior()
                                      + nemesis::transform_to<wstring>(templateCode) + L", Animation count: "
                                      + to_wstring(newAnimCount) + L")");
                         shared_ptr<NewAnimation> dummyAnimation;
-                        //int IDMultiplier = newAnimCopy[0]->getNextID(lowerBehaviorFile);
                         NewAnimLock animLock;
+                        vector<pair<shared_ptr<nemesis::IDRange>, shared_ptr<VecStr>>> idInstances;
                         nemesis::ThreadPool tp;
                         auto start_time = chrono::steady_clock::now();
+                        const VecStr& templateLines
+                            = BehaviorTemplate->behaviortemplate[templateCode][lowerBehaviorFile];
+                        shared_ptr<nemesis::FragmentCache> fragments;
+
+                        // the profiles of a batch compile the same behavior at once, and a hit only replays the
+                        // registrations a fragment records, so templates with other handlers are generated each run
+                        if (!process->batch && !BehaviorTemplate->optionlist[templateCode].core
+                            && newAnimCopy[0]->isReplayable(lowerBehaviorFile))
+                        {
+                            nemesis::FragmentHash context;
+                            context.Add(templateCode).Add(lowerBehaviorFile).Add(templateLines);
+                            context.Add(nemesis::ChangeManifest::HashFile(
+                                L"behavior templates\\" + nemesis::transform_to<wstring>(templateCode)
+                                + L"\\option_list.txt"));
+                            context.Add(eventid).Add(variableid).Add(exportID).Add(ZeroEvent).Add(ZeroVariable);
+                            context.Add(uint64_t(hasGroup)).Add(uint64_t(ignoreGroup)).Add(stateMultiplier);
+                            fragments = make_shared<nemesis::FragmentCache>(
+                                lowerBehaviorFile, templateCode, context, lastID);
+                        }
 
                         // individual animation
                         if (hasGroup)
@@ -2004,6 +2123,14 @@ void BehaviorSub::CompilingBehavior()
                                     }
                                     else
                                     {
+                                        if (subFunctionIDs->singlelist.empty())
+                                        {
+                                            subFunctionIDs->IDs.Reserve(
+                                                lastID,
+                                                newAnimCopy[k]->getGroupIDDemand(lowerBehaviorFile),
+                                                animLock.nodeIDLock);
+                                        }
+
                                         subFunctionIDs->singlelist.emplace_back(make_shared<single>());
                                         subFunctionIDs->singlelist.back()
                                             ->format["Nemesis" + modID + lowerBehaviorFile + to_string(k)]
@@ -2036,13 +2163,13 @@ void BehaviorSub::CompilingBehavior()
                                             groupFunctionIDs,
                                             false,
                                             groupAnimInfo);
+                                        args->fragments = fragments;
 
                                         if (newAnimCopy[k]->isLast())
                                         {
                                             subFunctionIDs->singlelist.shrink_to_fit();
                                             groupFunctionIDs->grouplist.push_back(subFunctionIDs);
                                             subFunctionIDs = make_shared<group>();
-                                            subFunctionIDs->singlelist.reserve(memory);
                                             groupAnimInfo.push_back(newAnimCopy[k]->GetGroupAnimInfo());
 
                                             for (unsigned int statenum = 0; statenum < stateID.size();
@@ -2062,7 +2189,23 @@ void BehaviorSub::CompilingBehavior()
 
                                         if (error) throw nemesis::exception();
 
-                                        //lastID += IDMultiplier;
+                                        // the first animation of a core template generates it
+                                        if (args->core)
+                                        {
+                                            args->skip       = args->isCoreDone;
+                                            args->isCoreDone = true;
+                                        }
+
+                                        if (!args->skip)
+                                        {
+                                            args->idRange->Reserve(
+                                                lastID,
+                                                newAnimCopy[k]->getIDDemand(lowerBehaviorFile, args->core),
+                                                animLock.nodeIDLock);
+                                            idInstances.emplace_back(args->idRange, args->allEditLines);
+                                        }
+
+                                        editReferences[args->allEditLines.get()] = args->references;
                                         tp.enqueue(animThreadStart, args);
                                         //animThreadStart(args);
                                     }
@@ -2088,6 +2231,14 @@ void BehaviorSub::CompilingBehavior()
                                     }
                                     else
                                     {
+                                        if (subFunctionIDs->singlelist.empty())
+                                        {
+                                            subFunctionIDs->IDs.Reserve(
+                                                lastID,
+                                                newAnimCopy[k]->getGroupIDDemand(lowerBehaviorFile),
+                                                animLock.nodeIDLock);
+                                        }
+
                                         subFunctionIDs->singlelist.emplace_back(make_shared<single>());
                                         subFunctionIDs->singlelist.back()
                                             ->format["Nemesis" + modID + lowerBehaviorFile + to_string(k)]
@@ -2118,6 +2269,7 @@ void BehaviorSub::CompilingBehavior()
                                             groupFunctionIDs,
                                             ignoreGroup,
                                             groupAnimInfo);
+                                        args->fragments = fragments;
 
                                         if (ignoreGroup)
                                         {
@@ -2126,7 +2278,6 @@ void BehaviorSub::CompilingBehavior()
                                                 subFunctionIDs->singlelist.shrink_to_fit();
                                                 groupFunctionIDs->grouplist.push_back(subFunctionIDs);
                                                 subFunctionIDs = make_shared<group>();
-                                                subFunctionIDs->singlelist.reserve(memory);
                                                 groupAnimInfo.push_back(newAnimCopy[k]->GetGroupAnimInfo());
 
                                                 for (unsigned int statenum = 0; statenum < stateID.size();
@@ -2149,7 +2300,23 @@ void BehaviorSub::CompilingBehavior()
 
                                         if (error) throw nemesis::exception();
 
-                                        //lastID += IDMultiplier;
+                                        // the first animation of a core template generates it
+                                        if (args->core)
+                                        {
+                                            args->skip       = args->isCoreDone;
+                                            args->isCoreDone = true;
+                                        }
+
+                                        if (!args->skip)
+                                        {
+                                            args->idRange->Reserve(
+                                                lastID,
+                                                newAnimCopy[k]->getIDDemand(lowerBehaviorFile, args->core),
+                                                animLock.nodeIDLock);
+                                            idInstances.emplace_back(args->idRange, args->allEditLines);
+                                        }
+
+                                        editReferences[args->allEditLines.get()] = args->references;
                                         tp.enqueue(animThreadStart, args);
                                         //animThreadStart(args);
                                     }
@@ -2163,6 +2330,21 @@ void BehaviorSub::CompilingBehavior()
 
                         tp.join_all();
 
+                        // the animations of the group still being collected are not in groupFunctionIDs yet
+                        auto overflowIDs = nemesis::ResolveOverflow(idInstances, lastID);
+                        nemesis::ReplaceIDs(*groupFunctionIDs, overflowIDs);
+                        nemesis::ReplaceIDs(*subFunctionIDs, overflowIDs);
+                        nemesis::ResolveImports(idInstances, exportID);
+                        idInstances.clear();
+
+                        if (fragments && !error)
+                        {
+                            fragments->Save();
+                            DebugLogging(L"Processing behavior: " + filepath + L" (Animation fragments reused: "
+                                         + to_wstring(fragments->GetHitCount()) + L", generated: "
+                                         + to_wstring(fragments->GetAddCount()) + L")");
+                        }
+
                         if (!ignoreGroup && !hasGroup)
                         {
                             subFunctionIDs->singlelist.shrink_to_fit();
@@ -2208,8 +2390,6 @@ void BehaviorSub::CompilingBehavior()
                                 true,
                                 false,
                                 BehaviorTemplate->optionlist[templateCode]);
-                            //IDMultiplier = getTemplateNextID(
-                            //    BehaviorTemplate->behaviortemplate[filename][lowerBehaviorFile]);
                             stateMultiplier = vector<int>();
 
                             if (!GetStateCount(
@@ -2266,7 +2446,10 @@ void BehaviorSub::CompilingBehavior()
 
                                     if (error) throw nemesis::exception();
 
-                                    //lastID += IDMultiplier;
+                                    args->idRange->Reserve(
+                                        lastID, grouptemplate_pack->process.idDemand, animLock.nodeIDLock);
+                                    idInstances.emplace_back(args->idRange, args->allEditLines);
+                                    editReferences[args->allEditLines.get()] = args->references;
                                     tp2.enqueue(groupThreadStart, args);
                                 }
                                 catch (nemesis::exception&)
@@ -2276,6 +2459,9 @@ void BehaviorSub::CompilingBehavior()
                             }
 
                             tp2.join_all();
+                            nemesis::ReplaceIDs(*groupFunctionIDs, nemesis::ResolveOverflow(idInstances, lastID));
+                            nemesis::ResolveImports(idInstances, exportID);
+                            idInstances.clear();
                         }
 
                         // master animation
@@ -2303,6 +2489,12 @@ void BehaviorSub::CompilingBehavior()
                             masterTemp->setZeroEvent(ZeroEvent);
                             masterTemp->setZeroVariable(ZeroVariable);
                             allEditLines.emplace_back(make_shared<VecStr>());
+                            idInstances.emplace_back(make_shared<nemesis::IDRange>(), allEditLines.back());
+                            idInstances.back().first->Reserve(
+                                lastID, mastertemplate_pack->process.idDemand, animLock.nodeIDLock);
+                            masterTemp->setIDRange(idInstances.back().first);
+                            editReferences[allEditLines.back().get()] = make_shared<nemesis::BehaviorReferences>();
+                            masterTemp->setReferences(editReferences[allEditLines.back().get()]);
                             masterTemp->getFunctionLines(allEditLines.back(),
                                                          lowerBehaviorFile,
                                                          filename,
@@ -2317,10 +2509,11 @@ void BehaviorSub::CompilingBehavior()
                                                          animLock,
                                                          -1);
 
-                            //lastID += getTemplateNextID(
-                            //    BehaviorTemplate->behaviortemplate[filename][lowerBehaviorFile]);
-
                             if (error) throw nemesis::exception();
+
+                            nemesis::ReplaceIDs(*groupFunctionIDs, nemesis::ResolveOverflow(idInstances, lastID));
+                            nemesis::ResolveImports(idInstances, exportID);
+                            idInstances.clear();
                         }
 
                         diff = chrono::steady_clock::now() - start_time;
@@ -2408,7 +2601,7 @@ void BehaviorSub::CompilingBehavior()
     if (error) throw nemesis::exception();
 
     // load to existing Nodes from behavior template
-    unpackToCatalyst(catalystMap, existingNodes);
+    unpackToCatalyst(catalystMap, nodeReferences, existingNodes, behaviorFile);
 
     DebugLogging("Total single animation processing time for " + behaviorFile + ": " + to_string(onetimer));
     DebugLogging("Total group animation processing time for " + behaviorFile + ": " + to_string(grouptimer));
@@ -2418,6 +2611,7 @@ void BehaviorSub::CompilingBehavior()
 
     // AA animation installation
     VecStr AAlines;
+    nemesis::BehaviorReferences aaReferences;
 
     if (clipAA.size() != 0)
     {
@@ -2446,7 +2640,7 @@ void BehaviorSub::CompilingBehavior()
                 if (!isChange) break;
 
                 VecStr children;
-                string groupName  = AAGroup[it->first];
+                string groupName  = context.AAGroup[it->first];
                 string importline = to_string(iter->first);
 
                 while (importline.length() < 4)
@@ -2454,8 +2648,7 @@ void BehaviorSub::CompilingBehavior()
                     importline = "0" + importline;
                 }
 
-                msglines.push_back("		<hkobject name=\"#" + importline
-                                   + "\" class=\"hkbManualSelectorGenerator\" signature=\"0xd932fab8\">");
+                nemesis::HkObject selector("#" + importline, "hkbManualSelectorGenerator", "0xd932fab8");
                 importline = "variableID[Nemesis_AA" + (isFirstPerson ? groupName + "_1p*" : groupName) + "]";
                 variableIDReplacer(importline, "AA", behaviorFile, variableid, ZeroVariable, 0);
 
@@ -2471,26 +2664,22 @@ void BehaviorSub::CompilingBehavior()
                     }
 
                     exportID["variable_binding"]["selectedGeneratorIndex!~^!" + importline] = tempID;
-                    importline = "			<hkparam name=\"variableBindingSet\">#" + tempID + "</hkparam>";
+                    importline = "#" + tempID;
                     ++lastID;
 
                     if (lastID == 9216) ++lastID;
                 }
                 else
                 {
-                    importline = "			<hkparam name=\"variableBindingSet\">#"
-                                 + exportID["variable_binding"]["selectedGeneratorIndex!~^!" + importline]
-                                 + "</hkparam>";
+                    importline = "#" + exportID["variable_binding"]["selectedGeneratorIndex!~^!" + importline];
                 }
 
-                msglines.push_back(importline);
-                msglines.push_back("			<hkparam name=\"userData\">0</hkparam>");
+                selector.Add(nemesis::HkParam("variableBindingSet", importline));
+                selector.Add(nemesis::HkParam("userData", "0"));
                 replacerCount[it->first]++;
-                msglines.push_back("			<hkparam name=\"name\">Nemesis_"
-                                   + to_string(replacerCount[it->first]) + "_" + groupName
-                                   + "_MSG</hkparam>");
-                msglines.push_back("			<hkparam name=\"generators\" numelements=\""
-                                   + to_string(it->second.size() + 1) + "\">");
+                selector.Add(nemesis::HkParam(
+                    "name", "Nemesis_" + to_string(replacerCount[it->first]) + "_" + groupName + "_MSG"));
+                nemesis::HkParam& generators = selector.Add(nemesis::HkParam::Array("generators"));
 
                 string baseID = to_string(lastID);
 
@@ -2499,7 +2688,7 @@ void BehaviorSub::CompilingBehavior()
                     baseID = "0" + baseID;
                 }
 
-                msglines.push_back("				#" + baseID);
+                generators.AddElement("#" + baseID);
                 ++lastID;
 
                 if (lastID == 9216) ++lastID;
@@ -2515,7 +2704,7 @@ void BehaviorSub::CompilingBehavior()
                             tempID = "0" + tempID;
                         }
 
-                        msglines.push_back("				#" + tempID);
+                        generators.AddElement("#" + tempID);
                         children.push_back(tempID);
                         ++lastID;
 
@@ -2523,52 +2712,27 @@ void BehaviorSub::CompilingBehavior()
                     }
                     else
                     {
-                        msglines.push_back("				#" + baseID);
+                        generators.AddElement("#" + baseID);
                     }
                 }
 
-                msglines.push_back("			</hkparam>");
-                msglines.push_back("			<hkparam name=\"selectedGeneratorIndex\">0</hkparam>");
-                msglines.push_back("			<hkparam name=\"currentGeneratorIndex\">0</hkparam>");
-                msglines.push_back("		</hkobject>");
+                selector.Add(nemesis::HkParam("selectedGeneratorIndex", "0"));
+                selector.Add(nemesis::HkParam("currentGeneratorIndex", "0"));
+                selector.Serialize(msglines);
                 msglines.push_back("");
 
                 unordered_map<string, VecStr> triggerID;
-                string name;
-                string animpath;
+                nemesis::HkObject clip = nemesis::HkObject::Parse(catalystMap[iter->first]);
 
                 {
                     int i_baseID       = stoi(baseID);
                     auto pceaBaseIter = pceaID.find(iter->first);
+                    nemesis::HkObject baseClip = clip;
+                    baseClip.SetName("#" + baseID);
                     catalystMap[i_baseID].reserve(catalystMap[iter->first].size());
-                    catalystMap[i_baseID].push_back(
-                        "		<hkobject name=\"#" + baseID
-                        + "\" class=\"hkbClipGenerator\" signature=\"0x333b85b9\">");
-
-                    for (unsigned int i = 1; i < catalystMap[iter->first].size(); ++i)
-                    {
-                        string line = catalystMap[iter->first][i];
-                        catalystMap[i_baseID].push_back(line);
-                        size_t pos = line.find("<hkparam name=\"name\">");
-
-                        if (pos != NOT_FOUND)
-                        {
-                            pos += 21;
-                            name = line.substr(pos, line.find("</hkparam>", pos) - pos);
-                        }
-                        else
-                        {
-                            pos = line.find("<hkparam name=\"animationName\">");
-
-                            if (pos != NOT_FOUND)
-                            {
-                                pos += 30;
-                                animpath = line.substr(pos, line.find("</hkparam>", pos) - pos);
-                            }
-                        }
-                    }
-
-                    if (catalystMap[i_baseID].back().length() != 0) catalystMap[i_baseID].push_back("");
+                    baseClip.Serialize(catalystMap[i_baseID]);
+                    catalystMap[i_baseID].push_back("");
+                    nodeReferences[i_baseID] = nodeReferences[iter->first];
 
                     if (pceaBaseIter != pceaID.end())
                     {
@@ -2582,24 +2746,25 @@ void BehaviorSub::CompilingBehavior()
 
                 for (unsigned int i = 0; i < children.size(); ++i)
                 {
-                    AAlines.push_back("		<hkobject name=\"#" + children[i]
-                                      + "\" class=\"hkbClipGenerator\" signature=\"0x333b85b9\">");
-                    AAlines.push_back(catalystMap[iter->first][1]);
-                    AAlines.push_back(catalystMap[iter->first][2]);
-                    AAlines.push_back(catalystMap[iter->first][3]);
+                    nemesis::HkObject child = clip;
+                    child.SetName("#" + children[i]);
 
                     while (it->second[num] == "x")
                     {
                         ++num;
                     }
 
-                    AAlines.push_back("			<hkparam name=\"animationName\">Animations\\"
-                                      + it->second[num] + "</hkparam>");
+                    if (auto* animationName = child.Find("animationName"))
+                    {
+                        animationName->SetValue("Animations\\" + it->second[num]);
+                    }
+
+                    nemesis::HkParam* triggers = child.Find("triggers");
                     string animFile = nemesis::to_lower_copy(
                         it->second[num].substr(it->second[num].find_last_of("\\") + 1));
-                    auto aaEvent_itr = AAEvent.find(isFirstPerson ? animFile + "_1p*" : animFile);
+                    auto aaEvent_itr = context.AAEvent.find(isFirstPerson ? animFile + "_1p*" : animFile);
 
-                    if (aaEvent_itr != AAEvent.end())
+                    if (aaEvent_itr != context.AAEvent.end())
                     {
                         if (aaEvent_itr->second.size() > 0)
                         {
@@ -2610,29 +2775,22 @@ void BehaviorSub::CompilingBehavior()
                                 tempID = "0" + tempID;
                             }
 
-                            AAlines.push_back("			<hkparam name=\"triggers\">#" + tempID
-                                              + "</hkparam>");
+                            if (triggers) triggers->SetValue("#" + tempID);
+
                             triggerID[tempID] = aaEvent_itr->second;
                             ++lastID;
 
                             if (lastID == 9216) ++lastID;
                         }
-                        else
+                        else if (triggers)
                         {
-                            AAlines.push_back("			<hkparam name=\"triggers\">null</hkparam>");
+                            triggers->SetValue("null");
                         }
                     }
-                    else
-                    {
-                        AAlines.push_back(catalystMap[iter->first][5]);
-                    }
-
-                    for (unsigned int j = 6; j < catalystMap[iter->first].size(); ++j)
-                    {
-                        AAlines.push_back(catalystMap[iter->first][j]);
-                    }
 
-                    if (AAlines.back().length() != 0) AAlines.push_back("");
+                    child.Serialize(AAlines);
+                    AAlines.push_back("");
+                    addClip(aaReferences, child);
 
                     if (error) throw nemesis::exception();
 
@@ -2698,7 +2856,11 @@ void BehaviorSub::CompilingBehavior()
                 if (error) throw nemesis::exception();
             }
 
-            if (isChange) catalystMap[iter->first] = msglines;
+            if (isChange)
+            {
+                catalystMap[iter->first] = msglines;
+                nodeReferences.erase(iter->first);
+            }
         }
 
         DebugLogging(L"Processing behavior: " + filepath
@@ -2706,6 +2868,7 @@ void BehaviorSub::CompilingBehavior()
     }
 
     VecStr PCEALines;
+    nemesis::BehaviorReferences pceaReferences;
 
     if (pceaID.size() > 0)
     {
@@ -2716,7 +2879,9 @@ void BehaviorSub::CompilingBehavior()
         for (auto& datalist : pceaID)
         {
             vector<VecStr> lineRe;
-            string importline = to_string(datalist.first);
+            nemesis::BehaviorReferences clipReferences;
+            string importline      = to_string(datalist.first);
+            nemesis::HkObject clip = nemesis::HkObject::Parse(catalystMap[datalist.first]);
 
             if (error) throw nemesis::exception();
 
@@ -2728,8 +2893,7 @@ void BehaviorSub::CompilingBehavior()
 
                 // populating manual selector generator
                 VecStr msglines;
-                msglines.push_back("		<hkobject name=\"#" + importline
-                                   + "\" class=\"hkbManualSelectorGenerator\" signature=\"0xd932fab8\">");
+                nemesis::HkObject selector("#" + importline, "hkbManualSelectorGenerator", "0xd932fab8");
                 importline = "variableID[" + data->modFile + "]";
                 variableIDReplacer(importline, "PCEA", behaviorFile, variableid, ZeroVariable, 0);
 
@@ -2743,24 +2907,21 @@ void BehaviorSub::CompilingBehavior()
                     }
 
                     exportID["variable_binding"]["selectedGeneratorIndex!~^!" + importline] = tempID;
-                    importline = "			<hkparam name=\"variableBindingSet\">#" + tempID + "</hkparam>";
+                    importline = "#" + tempID;
                     ++lastID;
 
                     if (lastID == 9216) ++lastID;
                 }
                 else
                 {
-                    importline = "			<hkparam name=\"variableBindingSet\">#"
-                                 + exportID["variable_binding"]["selectedGeneratorIndex!~^!" + importline]
-                                 + "</hkparam>";
+                    importline = "#" + exportID["variable_binding"]["selectedGeneratorIndex!~^!" + importline];
                 }
 
-                msglines.push_back(importline);
-                msglines.push_back("			<hkparam name=\"userData\">0</hkparam>");
+                selector.Add(nemesis::HkParam("variableBindingSet", importline));
+                selector.Add(nemesis::HkParam("userData", "0"));
                 ++replacerCount[data->modFile];
-                msglines.push_back("			<hkparam name=\"name\">Nemesis_PCEA_" + data->modFile
-                                   + "_MSG</hkparam>");
-                msglines.push_back("			<hkparam name=\"generators\" numelements=\"2\">");
+                selector.Add(nemesis::HkParam("name", "Nemesis_PCEA_" + data->modFile + "_MSG"));
+                nemesis::HkParam& generators = selector.Add(nemesis::HkParam::Array("generators"));
 
                 importline = to_string(lastID);
 
@@ -2769,7 +2930,7 @@ void BehaviorSub::CompilingBehavior()
                     importline = "0" + importline;
                 }
 
-                msglines.push_back("				#" + importline);
+                generators.AddElement("#" + importline);
                 ++lastID;
 
                 if (lastID == 9216) ++lastID;
@@ -2781,35 +2942,28 @@ void BehaviorSub::CompilingBehavior()
                     baseID = "0" + baseID;
                 }
 
-                msglines.push_back("				#" + baseID);
+                generators.AddElement("#" + baseID);
                 ++lastID;
 
                 if (lastID == 9216) ++lastID;
 
-                msglines.push_back("			</hkparam>");
-                msglines.push_back("			<hkparam name=\"selectedGeneratorIndex\">0</hkparam>");
-                msglines.push_back("			<hkparam name=\"currentGeneratorIndex\">0</hkparam>");
-                msglines.push_back("		</hkobject>");
+                selector.Add(nemesis::HkParam("selectedGeneratorIndex", "0"));
+                selector.Add(nemesis::HkParam("currentGeneratorIndex", "0"));
+                selector.Serialize(msglines);
                 msglines.push_back("");
 
                 lineRe.push_back(msglines);
                 msglines.clear();
 
                 // populating clip generator
-                msglines.push_back("		<hkobject name=\"#" + baseID
-                                   + "\" class=\"hkbClipGenerator\" signature=\"0x333b85b9\">");
-                msglines.push_back(catalystMap[datalist.first][1]);
-                msglines.push_back(catalystMap[datalist.first][2]);
-                msglines.push_back(catalystMap[datalist.first][3]);
-                msglines.push_back("			<hkparam name=\"animationName\">" + data->animPath
-                                   + "</hkparam>");
-
-                for (unsigned int j = 5; j < catalystMap[datalist.first].size(); ++j)
-                {
-                    msglines.push_back(catalystMap[datalist.first][j]);
-                }
+                nemesis::HkObject pceaClip = clip;
+                pceaClip.SetName("#" + baseID);
 
-                if (msglines.back().length() != 0) msglines.push_back("");
+                if (auto* animationName = pceaClip.Find("animationName")) animationName->SetValue(data->animPath);
+
+                pceaClip.Serialize(msglines);
+                msglines.push_back("");
+                addClip(clipReferences, pceaClip);
 
                 if (error) throw nemesis::exception();
 
@@ -2817,12 +2971,9 @@ void BehaviorSub::CompilingBehavior()
             }
 
             VecStr msglines;
-            msglines.push_back("		<hkobject name=\"#" + importline
-                               + "\" class=\"hkbClipGenerator\" signature=\"0x333b85b9\">");
-            msglines.insert(
-                msglines.end(), catalystMap[datalist.first].begin() + 1, catalystMap[datalist.first].end());
-
-            if (msglines.back().length() != 0) msglines.push_back("");
+            clip.SetName("#" + importline);
+            clip.Serialize(msglines);
+            msglines.push_back("");
 
             lineRe.push_back(msglines);
 
@@ -2830,9 +2981,19 @@ void BehaviorSub::CompilingBehavior()
                 PCEALines.insert(PCEALines.end(), it->begin(), it->end());
             }
 
+            // in the order of PCEALines, the original clip comes first
+            pceaReferences.Merge(nodeReferences[datalist.first]);
+            auto& clips = clipReferences.GetClips();
+
+            for (auto clip = clips.rbegin(); clip != clips.rend(); ++clip)
+            {
+                pceaReferences.AddClip(clip->clipName, clip->animationName);
+            }
+
             if (error) throw nemesis::exception();
 
             catalystMap.erase(catalystMap.find(datalist.first));
+            nodeReferences.erase(datalist.first);
         }
 
         DebugLogging(L"Processing behavior: " + filepath + L" (Check point 4.8, PCEA count: "
@@ -2854,179 +3015,71 @@ void BehaviorSub::CompilingBehavior()
     DebugLogging(L"Processing behavior: " + filepath + L" (Check point 5, Prepare to output)");
     process->newMilestone();
 
-    if (behaviorPath[nemesis::transform_to<wstring>(lowerBehaviorFile)].size() == 0) ErrorMessage(1068, behaviorFile);
+    if (behaviorPath.size() == 0) ErrorMessage(1068, behaviorFile);
 
-    wstring filename = getTempBhvrPath(nemesisInfo).wstring() + L"\\xml\\" + nemesis::transform_to<wstring>(modID + lowerBehaviorFile) + L".xml";
+    wstring filename = getTempXmlPath(nemesisInfo).wstring() + L"\\"
+                       + nemesis::transform_to<wstring>(modID + lowerBehaviorFile) + L".xml";
 
     redirToStageDir(outputdir, nemesisInfo);
 
     if (!FolderCreate(GetFileDirectory(filename)) || !FolderCreate(GetFileDirectory(outputdir))) return;
 
-    ofstream output(filename);
-    bool isClip = false;
-    bool isBehavior = false;
-    string clipName;
     wstring projectdir = outputdir.parent_path().parent_path().wstring();
+    nemesis::BehaviorWriter writer;
+    nemesis::BehaviorReferences references;
 
-    if (!output.is_open()) ErrorMessage(1025, filename);
-
-    if (isCharacter)
+    for (int i = firstID; i < firstID + 4; ++i)
     {
-        for (int i = firstID; i < firstID + 4; ++i)
-        {
-            for (auto& eachline : catalystMap[i])
-            {
-                output << eachline + "\n";
-                checkBehaviorJoint(outputdir, projectdir, eachline, process, isBehavior);
-            }
-
-            if (error) throw nemesis::exception();
-        }
-
-        output
-            << "<!-- ======================== NEMESIS import TEMPLATE START ======================== -->\n";
-
-        if (additionallines.size() > 0)
-        {
-            output << "\n";
-
-            for (auto& eachline : additionallines)
-            {
-                output << eachline + "\n";
-                checkBehaviorJoint(outputdir, projectdir, eachline, process, isBehavior);
-            }
-
-            if (error) throw nemesis::exception();
-        }
-
-        output
-            << "<!-- ======================== NEMESIS import TEMPLATE END ======================== -->\n\n";
-        output << "<!-- ======================== NEMESIS PCEA TEMPLATE START ======================== -->\n";
-
-        if (PCEALines.size() > 0)
-        {
-            output << "\n";
-
-            for (auto& eachline : PCEALines)
-            {
-                output << eachline + "\n";
-                checkBehaviorJoint(outputdir, projectdir, eachline, process, isBehavior);
-            }
-
-            if (error) throw nemesis::exception();
-        }
-
-        output << "<!-- ======================== NEMESIS PCEA TEMPLATE END ======================== -->\n\n";
-        output << "<!-- ======================== NEMESIS alternate animation TEMPLATE START "
-                  "======================== -->\n";
-
-        if (AAlines.size() > 0)
-        {
-            output << "\n";
-
-            for (auto& eachline : AAlines)
-            {
-                output << eachline + "\n";
-                checkBehaviorJoint(outputdir, projectdir, eachline, process, isBehavior);
-            }
-
-            if (error) throw nemesis::exception();
-        }
-
-        output << "<!-- ======================== NEMESIS alternate animation TEMPLATE END "
-                  "======================== -->\n\n";
-
-        for (unsigned int j = 0; j < allEditLines.size(); ++j)
-        {
-            for (auto& eachline : (*allEditLines[j]))
-            {
-                output << eachline + "\n";
-                checkBehaviorJoint(outputdir, projectdir, eachline, process, isBehavior);
-            }
-
-            if (error) throw nemesis::exception();
-        }
+        writer.Add(catalystMap[i]);
+        references.Merge(nodeReferences[i]);
     }
-    else
-    {
-        for (int i = firstID; i < firstID + 4; ++i)
-        {
-            for (auto& eachline : catalystMap[i])
-            {
-                output << eachline + "\n";
-                checkClipAnimData(
-                    outputdir, projectdir, eachline, characterFiles, clipName, isClip, process, isBehavior);
-            }
 
-            if (error) throw nemesis::exception();
-        }
-
-        output
-            << "<!-- ======================== NEMESIS import TEMPLATE START ======================== -->\n";
-
-        if (additionallines.size() > 0)
-        {
-            output << "\n";
-
-            for (auto& eachline : additionallines)
-            {
-                output << eachline + "\n";
-                checkClipAnimData(
-                    outputdir, projectdir, eachline, characterFiles, clipName, isClip, process, isBehavior);
-            }
-
-            if (error) throw nemesis::exception();
-        }
+    writer.Add("<!-- ======================== NEMESIS import TEMPLATE START ======================== -->\n");
 
-        output
-            << "<!-- ======================== NEMESIS import TEMPLATE END ======================== -->\n\n";
-        output << "<!-- ======================== NEMESIS PCEA TEMPLATE START ======================== -->\n";
-
-        if (PCEALines.size() > 0)
-        {
-            output << "\n";
+    if (additionallines.size() > 0)
+    {
+        writer.Add("\n");
+        writer.Add(additionallines);
+    }
 
-            for (auto& eachline : PCEALines)
-            {
-                output << eachline + "\n";
-                checkClipAnimData(
-                    outputdir, projectdir, eachline, characterFiles, clipName, isClip, process, isBehavior);
-            }
+    writer.Add("<!-- ======================== NEMESIS import TEMPLATE END ======================== -->\n\n");
+    writer.Add("<!-- ======================== NEMESIS PCEA TEMPLATE START ======================== -->\n");
 
-            if (error) throw nemesis::exception();
-        }
+    if (PCEALines.size() > 0)
+    {
+        writer.Add("\n");
+        writer.Add(PCEALines);
+    }
 
-        output << "<!-- ======================== NEMESIS PCEA TEMPLATE END ======================== -->\n\n";
-        output << "<!-- ======================== NEMESIS alternate animation TEMPLATE START "
-                  "======================== -->\n";
+    writer.Add("<!-- ======================== NEMESIS PCEA TEMPLATE END ======================== -->\n\n");
+    writer.Add("<!-- ======================== NEMESIS alternate animation TEMPLATE START "
+               "======================== -->\n");
 
-        if (AAlines.size() > 0)
-        {
-            output << "\n";
+    if (AAlines.size() > 0)
+    {
+        writer.Add("\n");
+        writer.Add(AAlines);
+    }
 
-            for (auto& eachline : AAlines)
-            {
-                output << eachline + "\n";
-                checkClipAnimData(
-                    outputdir, projectdir, eachline, characterFiles, clipName, isClip, process, isBehavior);
-            }
+    writer.Add("<!-- ======================== NEMESIS alternate animation TEMPLATE END "
+               "======================== -->\n\n");
 
-            if (error) throw nemesis::exception();
-        }
+    for (auto& editlines : allEditLines)
+    {
+        writer.Add(*editlines);
+    }
 
-        output << "<!-- ======================== NEMESIS alternate animation TEMPLATE END "
-                  "======================== -->\n\n";
+    // a character file only publishes what its catalyst nodes refer to
+    if (!isCharacter)
+    {
+        references.Merge(pceaReferences);
+        references.Merge(aaReferences);
 
-        for (unsigned int j = 0; j < allEditLines.size(); ++j)
+        for (auto& editlines : allEditLines)
         {
-            for (auto& eachline : (*allEditLines[j]))
-            {
-                output << eachline + "\n";
-                checkClipAnimData(
-                    outputdir, projectdir, eachline, characterFiles, clipName, isClip, process, isBehavior);
-            }
+            auto itr = editReferences.find(editlines.get());
 
-            if (error) throw nemesis::exception();
+            if (itr != editReferences.end()) references.Merge(*itr->second);
         }
     }
 
@@ -3035,21 +3088,18 @@ void BehaviorSub::CompilingBehavior()
 
     for (size_t it = firstID; it < size; ++it)
     {
-        for (auto& eachline : catalystMap[it])
-        {
-            output << eachline + "\n";
-            checkClipAnimData(
-                outputdir, projectdir, eachline, characterFiles, clipName, isClip, process, isBehavior);
-        }
-
-        if (error) throw nemesis::exception();
+        writer.Add(catalystMap[it]);
+        references.Merge(nodeReferences[it]);
     }
 
-    if (catalystMap.rbegin()->second.back().length() != 0) output << "\n";
+    if (catalystMap.rbegin()->second.back().length() != 0) writer.Add("\n");
+
+    writer.Add("	</hksection>\n\n");
+    writer.Add("</hkpackfile>\n");
+
+    if (!writer.Write(filename)) ErrorMessage(1025, filename);
 
-    output << "	</hksection>\n\n";
-    output << "</hkpackfile>\n";
-    output.close();
+    nemesis::BehaviorWriter::Publish(references, outputdir, projectdir, characterFiles, process);
 
     if (error) throw nemesis::exception();
 
@@ -3068,6 +3118,7 @@ void BehaviorSub::CompilingBehavior()
 
 void BehaviorSub::addInfo(const wstring& newDirectory,
                           const string& curfile,
+                          nemesis::PathHandle newBehaviorHandle,
                           shared_ptr<TemplateInfo> newBehaviorTemplate,
                           unordered_map<string, vector<shared_ptr<NewAnimation>>> addAnimation,
                           unordered_map<string, var> newAnimVar,
@@ -3080,6 +3131,7 @@ void BehaviorSub::addInfo(const wstring& newDirectory,
 {
     directory        = newDirectory;
     curfilefromlist  = curfile;
+    behaviorHandle   = newBehaviorHandle;
     BehaviorTemplate = newBehaviorTemplate;
     newAnimation     = addAnimation;
     AnimVar          = newAnimVar;
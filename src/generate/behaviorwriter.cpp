@@ -0,0 +1,138 @@
+#include "Global.h"
+
+#include <fstream>
+
+#include "utilities/algorithm.h"
+#include "utilities/atomiclock.h"
+
+#include "generate/behaviorwriter.h"
+#include "generate/behaviorreferences.h"
+#include "generate/behaviorprocess.h"
+#include "generate/generationcontext.h"
+#include "generate/animationdatatracker.h"
+
+using namespace std;
+
+namespace sf = filesystem;
+
+namespace
+{
+    constexpr size_t writeChunk = 1 << 20;
+} // namespace
+
+void nemesis::BehaviorWriter::Add(const VecStr& lines)
+{
+    blocks.push_back(Block{&lines, ""});
+}
+
+void nemesis::BehaviorWriter::Add(string text)
+{
+    blocks.push_back(Block{nullptr, move(text)});
+}
+
+bool nemesis::BehaviorWriter::Write(const sf::path& filename) const
+{
+    ofstream output(filename);
+
+    if (!output.is_open()) return false;
+
+    string buffer;
+    buffer.reserve(writeChunk * 2);
+
+    for (auto& block : blocks)
+    {
+        if (block.lines)
+        {
+            for (auto& line : *block.lines)
+            {
+                buffer.append(line);
+                buffer.push_back('\n');
+
+                if (buffer.size() < writeChunk) continue;
+
+                output.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        }
+        else
+        {
+            buffer.append(block.text);
+        }
+    }
+
+    output.write(buffer.data(), buffer.size());
+    output.close();
+    return !output.fail();
+}
+
+void nemesis::BehaviorWriter::Publish(const BehaviorReferences& references,
+                                      const sf::path& filepath,
+                                      const sf::path& projectdir,
+                                      const VecStr& characterFiles,
+                                      BehaviorStart* process)
+{
+    const VecStr& behaviors = references.GetBehaviors();
+    auto& clips             = references.GetClips();
+
+    if (!behaviors.empty())
+    {
+        wstring referrer = nemesis::to_lower_copy(filepath.wstring()) + L".hkx";
+        Lockless lock(process->postBehaviorFlag);
+
+        for (auto& behavior : behaviors)
+        {
+            process
+                ->postBhvrRefBy[nemesis::to_lower_copy(projectdir.wstring() + L"\\"
+                                                       + nemesis::transform_to<wstring>(behavior))]
+                .insert(referrer);
+        }
+    }
+
+    if (clips.empty() || characterFiles.empty()) return;
+
+    GenerationContext& context = process->context;
+    VecStr animFiles;
+    animFiles.reserve(clips.size());
+
+    for (auto& clip : clips)
+    {
+        animFiles.push_back(nemesis::to_lower_copy(sf::path(clip.animationName).filename().string()));
+    }
+
+    // the clip map of a character is only changed while its charAnimDataInfo shard is locked
+    for (auto& file : characterFiles)
+    {
+        context.charAnimDataInfo.Update(file, [&](map<string, shared_ptr<AnimationDataTracker>>& animDataInfo) {
+            for (size_t i = 0; i < clips.size(); ++i)
+            {
+                auto& clip                                    = clips[i];
+                const string& animFile                        = animFiles[i];
+                shared_ptr<AnimationDataTracker>& animDataPtr = animDataInfo[animFile];
+
+                if (animDataPtr == nullptr)
+                {
+                    animDataPtr           = make_shared<AnimationDataTracker>();
+                    animDataPtr->filename = animFile;
+                }
+
+                animDataPtr->cliplist.insert(clip.clipName);
+                context.clipPtrAnimData.Update(
+                    file, [&](map<string, vector<shared_ptr<AnimationDataTracker>>>& clipAnimData) {
+                        vector<shared_ptr<AnimationDataTracker>>& listAnimData = clipAnimData[clip.clipName];
+                        bool same                                               = false;
+
+                        for (auto& animData : listAnimData)
+                        {
+                            if (animData->filename == animFile)
+                            {
+                                same = true;
+                                break;
+                            }
+                        }
+
+                        if (!same) listAnimData.push_back(animDataPtr);
+                    });
+            }
+        });
+    }
+}
@@ -0,0 +1,92 @@
+#include <stdexcept>
+
+#include "generate/generationcontext.h"
+
+using namespace std;
+
+bool nemesis::GenerationContext::IsActivated(const string& behavior) const
+{
+    auto itr = activatedBehavior.find(behavior);
+    return itr != activatedBehavior.end() && itr->second;
+}
+
+const wstring& nemesis::GenerationContext::GetBehaviorPath(PathHandle file) const
+{
+    static const wstring none;
+    auto itr = behaviorPath.find(file);
+    return itr != behaviorPath.end() ? itr->second : none;
+}
+
+void nemesis::GenerationContext::Clear(bool all)
+{
+    if (all)
+    {
+        usedAnim.Clear();
+        registeredAnim.Clear();
+        animModMatch.Clear();
+        behaviorJoints.Clear();
+    }
+
+    clipPtrAnimData.Clear();
+    charAnimDataInfo.Clear();
+
+    behaviorProjectPath = PathMap<wstring>();
+    behaviorPath        = PathMap<wstring>();
+    AAGroup             = unordered_map<string, string>();
+    crc32Cache.Clear();
+
+    behaviorProject = PathMap<VecStr>();
+    alternateAnim   = unordered_map<string, VecStr>();
+    groupAA         = unordered_map<string, VecStr>();
+    groupAAPrefix   = unordered_map<string, VecStr>();
+    AAEvent         = unordered_map<string, VecStr>();
+    AAHasEvent      = unordered_map<string, VecStr>();
+
+    pcealist     = vector<PCEA>();
+    animReplaced = unordered_map<string, vector<PCEAData>>();
+
+    activatedBehavior = unordered_map<string, bool>();
+    AAGroupCount      = unordered_map<string, unordered_map<string, int>>();
+    AAgroup_Counter   = unordered_map<string, int>();
+    groupNameList     = set<string>();
+
+    fileCheckMsg = VecWstr();
+}
+
+void nemesis::GenerationContext::CopyInputs(const GenerationContext& inputs)
+{
+    behaviorPath        = inputs.behaviorPath;
+    behaviorProjectPath = inputs.behaviorProjectPath;
+    behaviorProject     = inputs.behaviorProject;
+
+    behaviorJoints.Clear();
+    inputs.behaviorJoints.ForEach(
+        [&](const string& behavior, const VecStr& joints) { behaviorJoints[behavior] = joints; });
+
+    alternateAnim   = inputs.alternateAnim;
+    groupAA         = inputs.groupAA;
+    groupAAPrefix   = inputs.groupAAPrefix;
+    AAEvent         = inputs.AAEvent;
+    AAHasEvent      = inputs.AAHasEvent;
+    AAGroup         = inputs.AAGroup;
+    AAGroupCount    = inputs.AAGroupCount;
+    groupNameList   = inputs.groupNameList;
+    AAgroup_Counter = inputs.AAgroup_Counter;
+
+    pcealist     = inputs.pcealist;
+    animReplaced = inputs.animReplaced;
+}
+
+nemesis::GenerationContext& nemesis::GenerationContext::Current()
+{
+    void* bound = TaskLocal::Get();
+
+    if (!bound) throw logic_error("GenerationContext::Current() called on a thread that is not bound to a run");
+
+    return *static_cast<GenerationContext*>(bound);
+}
+
+nemesis::GenerationContext::Scope::Scope(GenerationContext& context)
+    : scope(&context, &context.cancelled)
+{
+}
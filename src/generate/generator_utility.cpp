@@ -8,12 +8,16 @@
 #include "utilities/conditions.h"
 #include "utilities/lastupdate.h"
 #include "utilities/atomiclock.h"
+#include "utilities/changemanifest.h"
+#include "utilities/pathmanifest.h"
 #include "utilities/stringsplit.h"
 #include "utilities/readtextfile.h"
 
+#include "generate/hkxscanner.h"
 #include "generate/behaviorprocess.h"
 #include "generate/playerexclusive.h"
 #include "generate/generator_utility.h"
+#include "generate/generationcontext.h"
 #include "generate/animationdatatracker.h"
 #include "generate/behaviorprocess_utility.h"
 
@@ -26,25 +30,16 @@ using namespace std;
 
 namespace sf = std::filesystem;
 
-extern unordered_map<string, string> crc32Cache;
 extern VecWstr warningMsges;
 
-static bool* globalThrow;
-
-VecWstr fileCheckMsg;
-VecWstr hkxFiles;
-
-atomic_flag animdata_lock{};
+nemesis::HkxScanner hkxScanner(L"cache\\hkx_architecture");
 
 void updateRequired(sf::path filepath);
-void newFileCheck(sf::path directory, const unordered_set<wstring>& isChecked);
 void readList(sf::path directory,
               sf::path animationDirectory,
               vector<unique_ptr<registerAnimation>>& list,
               TemplateInfo& behaviortemplate,
               bool firstP);
-void fileArchitectureCheck(sf::path hkxfile);
-void checkFolder(sf::path filepath);
 
 bool FolderCreate(sf::path curBehaviorPath)
 {
@@ -329,7 +324,7 @@ vector<unique_ptr<registerAnimation>> openFile(TemplateInfo* behaviortemplate, c
 
 	for (auto& behaviorGroup : behaviortemplate->grouplist)
 	{
-		wstring path = behaviorPath[nemesis::transform_to<wstring>(behaviorGroup.first)];
+		wstring path = nemesis::GenerationContext::Current().GetBehaviorPath(nemesis::InternPath(behaviorGroup.first));
 
 		if (path.length() == 0) ErrorMessage(1050, behaviorGroup.first);
 
@@ -366,69 +361,37 @@ void updateRequired(sf::path filepath)
     interMsg("");
 }
 
-void newFileCheck(filesystem::path directory, const unordered_set<wstring>& isChecked)
+bool isUpdateTrackedFile(const wstring& directory, const wstring& file)
 {
-	VecWstr filelist;
-	read_directory(directory, filelist);
+	if (!nemesis::iequals(sf::path(file).extension().wstring(), L".txt")) return false;
 
-	try
+	if (directory.find(L"animationdatasinglefile") != NOT_FOUND)
 	{
-		for (auto& file : filelist)
-		{
-			wstring path = directory.wstring() + L"\\" + file;
-			nemesis::to_lower(path);
-			std::filesystem::path curfile(path);
+		size_t pos      = directory.find(L"\\") + 1;
+		wstring modcode = directory.substr(pos, directory.find(L"\\", pos) - pos);
+		return file.find(modcode + L"$") == NOT_FOUND;
+	}
 
-			if (std::filesystem::is_directory(curfile))
-			{
-				newFileCheck(path, isChecked);
-			}
-			else if (nemesis::iequals(curfile.extension().string(), ".txt"))
-			{
-                wstring wdir = directory.wstring();
+	if (directory.find(L"animationsetdatasinglefile") != NOT_FOUND)
+	{
+		return sf::path(directory).stem().wstring().find(L"~") != NOT_FOUND && file.length() > 0 && file[0] != L'$';
+	}
 
-				if (wdir.find(L"animationdatasinglefile") != NOT_FOUND)
-				{
-                    size_t pos     = wdir.find(L"\\") + 1;
-                    wstring modcode = wdir.substr(pos, wdir.find(L"\\", pos) - pos);
+	return !nemesis::iequals(file, L"option_list.txt");
+}
 
-					if (file.find(modcode + L"$") == NOT_FOUND)
-					{
-                        if (isChecked.find(path) == isChecked.end())
-                        {
-                            updateRequired(path);
-                            throw false;
-                        }
-					}
-				}
-				else if (wdir.find(L"animationsetdatasinglefile") != NOT_FOUND)
-				{					
-					if (directory.stem().wstring().find(L"~") != NOT_FOUND && file.length() > 0 && file[0] != L'$')
-					{
-                        if (isChecked.find(path) == isChecked.end())
-                        {
-                            updateRequired(path);
-                            throw false;
-                        }
-					}
-				}
-				else if (!nemesis::iequals(file, L"option_list.txt"))
-				{
-                    if (isChecked.find(path) == isChecked.end())
-                    {
-                        updateRequired(path);
-                        throw false;
-                    }
-				}
-			}
+nemesis::ChangeManifest::ChangeSet GetEngineChanges(bool stopAtFirst)
+{
+	nemesis::ChangeManifest manifest;
+	nemesis::ChangeManifest::ChangeSet changes;
 
-			if (globalThrow) break;
-		}
-	}
-	catch (bool& ex)
+	if (!manifest.Load(nemesis::ChangeManifest::defaultFile) || manifest.GetNemesisVersion() != GetNemesisVersion())
 	{
-		globalThrow = &ex;
+		changes.outdated = true;
+		return changes;
 	}
+
+	return manifest.GetChanges(isUpdateTrackedFile, stopAtFirst);
 }
 
 bool isEngineUpdated(string& versionCode, const NemesisInfo* nemesisInfo)
@@ -440,174 +403,172 @@ bool isEngineUpdated(string& versionCode, const NemesisInfo* nemesisInfo)
 
 	if (filelist.size() < 3) ErrorMessage(6006);
 
-	VecWstr storeline;
-	wstring filename = L"cache\\engine_update";
-    unordered_set<wstring> isChecked;
-
-	if (!isFileExist(filename)) return false;
+	nemesis::ChangeManifest manifest;
 
-	if (!GetFunctionLines(filename, storeline, false)) return false;
+	if (!manifest.Load(nemesis::ChangeManifest::defaultFile)) return false;
 
-	if (storeline.size() > 0)
-	{
-		if (nemesis::transform_to<wstring>(GetNemesisVersion()) != storeline[0]) return false;
+	if (manifest.GetNemesisVersion() != GetNemesisVersion()) return false;
 
-		storeline.erase(storeline.begin());
-	}
+	versionCode = manifest.GetEngineVersion();
+	auto changes = manifest.GetChanges(isUpdateTrackedFile, true);
 
-	if (storeline.size() > 0)
+	if (changes.files.size() > 0)
 	{
-		versionCode = nemesis::transform_to<string>(storeline[0]);
-		storeline.erase(storeline.begin());
-	}
+		const wstring& file = changes.files.front();
 
-	for (auto& line : storeline)
-	{
-		if (line.length() > 0)
+		// a new file gets the notice the new file check gave, a changed or removed one the single line it had
+		if (changes.added.find(file) != changes.added.end())
 		{
-			size_t pos = line.find(L">>");
-
-			if (pos == NOT_FOUND) ErrorMessage(2021);
-
-			wstring part1 = line.substr(0, pos);
-			wstring part2 = line.substr(pos + 2);
-
-			if (!isFileExist(part1) || GetLastModified(part1) != part2)
-            {
-                interMsg(TextBoxMessage(1019) + L": " + part1);
-                DebugLogging(EngTextBoxMessage(1019) + ": " + nemesis::transform_to<string>(part1));
-                return false;
-            }
-
-			isChecked.insert(part1);
+			updateRequired(file);
+		}
+		else
+		{
+			interMsg(TextBoxMessage(1019) + L": " + file);
+			DebugLogging(EngTextBoxMessage(1019) + ": " + nemesis::transform_to<string>(file));
 		}
-	}
-
-	globalThrow = nullptr;
-	std::thread t1(newFileCheck, "mod", isChecked);
-	std::thread t2(newFileCheck, "behavior templates", isChecked);
-
-	t1.join();
-	t2.join();
 
-	if (globalThrow)
-	{
-		globalThrow = nullptr;
 		return false;
 	}
 
-	globalThrow = nullptr;
 	return true;
 }
 
-void GetBehaviorPath()
+// installs last updated before the manifest have the lists in the text files that came before it
+bool MigrateBehaviorManifest(const wstring& filename)
 {
-	wstring filename = L"cache\\behavior_path";
+	wstring pathFile        = L"cache\\behavior_path";
+	wstring projectFile     = L"cache\\behavior_project";
+	wstring projectPathFile = L"cache\\behavior_project_path";
+	wstring jointsFile      = L"cache\\behavior_joints";
 
-	if (isFileExist(filename))
+	if (!isFileExist(pathFile) || !isFileExist(projectFile) || !isFileExist(projectPathFile)
+		|| !isFileExist(jointsFile))
 	{
+		return false;
+	}
+
+	DebugLogging(L"Migrating behavior path cache to " + filename);
+	nemesis::PathManifest::Builder builder;
+
+	// key=value per line
+	auto readPairs = [&](const wstring& file, nemesis::PathManifest::Table table) {
 		int linecount = 0;
-		FileReader pathFile(filename);
+		FileReader reader(file);
 
-		if (pathFile.GetFile())
-		{
-			wstring line;
+		if (!reader.GetFile()) ErrorMessage(2000, file);
 
-			while (pathFile.GetLines(line))
-			{
-				++linecount;
-				size_t pos = line.find(L"=");
+		wstring line;
+
+		while (reader.GetLines(line))
+		{
+			++linecount;
+			size_t pos = line.find(L"=");
 
-				if (pos == NOT_FOUND) ErrorMessage(1067, filename, linecount);
+			if (pos == NOT_FOUND) ErrorMessage(1067, file, linecount);
 
-				behaviorPath[line.substr(0, pos)] = line.substr(pos + 1);
-			}
+			builder.Add<wchar_t>(table, wstring_view(line).substr(0, pos), wstring_view(line).substr(pos + 1));
 		}
-		else
+	};
+
+	// key line followed by its value lines, blocks are separated by an empty line
+	auto readBlocks = [&](const wstring& file, nemesis::PathManifest::Table table) {
+		FileReader reader(file);
+
+		if (!reader.GetFile()) ErrorMessage(2000, file);
+
+		string line;
+		string key;
+		bool newKey = true;
+
+		while (reader.GetLines(line))
 		{
-			ErrorMessage(2000, filename);
+			if (line.length() == 0)
+			{
+				newKey = true;
+			}
+			else if (newKey)
+			{
+				key    = line;
+				newKey = false;
+			}
+			else
+			{
+				builder.Add<char>(table, key, VecStr{line});
+			}
 		}
-	}
-	else
-	{
-		ErrorMessage(1068, filename);
-	}
+	};
+
+	readPairs(pathFile, nemesis::PathManifest::BehaviorPath);
+	readBlocks(projectFile, nemesis::PathManifest::BehaviorProject);
+	readPairs(projectPathFile, nemesis::PathManifest::BehaviorProjectPath);
+	readBlocks(jointsFile, nemesis::PathManifest::BehaviorJoints);
+
+	if (!builder.Save(filename)) ErrorMessage(2009, filename);
+
+	return true;
 }
 
-void GetBehaviorProject()
+void characterHKX(const nemesis::PathManifest& manifest)
 {
-	string filename = "cache\\behavior_project";
+	auto& behaviorJoints = nemesis::GenerationContext::Current().behaviorJoints;
 
-	if (isFileExist(filename))
-	{
-		string characterfile;
-		bool newChar = true;
-		FileReader pathFile(filename);
+	manifest.ForEach<char>(nemesis::PathManifest::BehaviorJoints,
+						   [&](string_view header, const vector<string_view>& joints) {
+							   if (header.length() == 0) ErrorMessage(1094);
 
-		if (pathFile.GetFile())
-		{
-			string line;
+							   VecStr& list = behaviorJoints[string(header)];
+							   list.insert(list.end(), joints.begin(), joints.end());
+						   });
+}
 
-			while (pathFile.GetLines(line))
-			{
-				if (line.length() == 0)
-				{
-					newChar = true;
-				}
-				else if (newChar)
-				{
-					characterfile = line;
-					newChar = false;
-				}
-				else
-				{
-					behaviorProject[characterfile].push_back(line);
-				}
-			}
-		}
-		else
-		{
-			ErrorMessage(2000, filename);
-		}
-	}
-	else
-	{
-		ErrorMessage(1068, filename);
-	}
+void GetBehaviorPath(const nemesis::PathManifest& manifest)
+{
+	auto& behaviorPath = nemesis::GenerationContext::Current().behaviorPath;
+	behaviorPath.reserve(manifest.Size(nemesis::PathManifest::BehaviorPath));
+
+	manifest.ForEach<wchar_t>(nemesis::PathManifest::BehaviorPath,
+							  [&](wstring_view file, const vector<wstring_view>& path) {
+								  if (path.size() > 0) behaviorPath[nemesis::InternPath(file)] = path[0];
+							  });
 }
 
-void GetBehaviorProjectPath()
+void GetBehaviorProject(const nemesis::PathManifest& manifest)
 {
-	string filename = "cache\\behavior_project_path";
+	auto& behaviorProject = nemesis::GenerationContext::Current().behaviorProject;
+	behaviorProject.reserve(manifest.Size(nemesis::PathManifest::BehaviorProject));
 
-	if (isFileExist(filename))
-	{
-		int linecount = 0;
-		FileReader pathFile(filename);
+	manifest.ForEach<char>(nemesis::PathManifest::BehaviorProject,
+						   [&](string_view characterfile, const vector<string_view>& projects) {
+							   VecStr& list = behaviorProject[nemesis::InternPath(characterfile)];
+							   list.insert(list.end(), projects.begin(), projects.end());
+						   });
+}
 
-		if (pathFile.GetFile())
-		{
-			wstring line;
+void GetBehaviorProjectPath(const nemesis::PathManifest& manifest)
+{
+	auto& behaviorProjectPath = nemesis::GenerationContext::Current().behaviorProjectPath;
+	behaviorProjectPath.reserve(manifest.Size(nemesis::PathManifest::BehaviorProjectPath));
 
-			while (pathFile.GetLines(line))
-			{
-				++linecount;
-				size_t pos = line.find(L"=");
+	manifest.ForEach<wchar_t>(nemesis::PathManifest::BehaviorProjectPath,
+							  [&](wstring_view project, const vector<wstring_view>& path) {
+								  if (path.size() > 0) behaviorProjectPath[nemesis::InternPath(project)] = path[0];
+							  });
+}
 
-				if (pos == NOT_FOUND) ErrorMessage(1067, filename, linecount);
+void GetBehaviorManifest()
+{
+	wstring filename = nemesis::PathManifest::defaultFile;
+	nemesis::PathManifest manifest;
 
-				behaviorProjectPath[line.substr(0, pos)] = line.substr(pos + 1);
-			}
-		}
-		else
-		{
-			ErrorMessage(2000, filename);
-		}
-	}
-	else
-	{
-		ErrorMessage(1068, filename);
-	}
+	if (!isFileExist(filename) && !MigrateBehaviorManifest(filename)) ErrorMessage(1068, filename);
+
+	// mapped once, every list is read from the same view
+	if (!manifest.Load(filename)) ErrorMessage(2000, filename);
+
+	characterHKX(manifest);
+	GetBehaviorPath(manifest);
+	GetBehaviorProject(manifest);
+	GetBehaviorProjectPath(manifest);
 }
 
 void GetAnimData()
@@ -660,53 +621,6 @@ void GetAnimData()
 	}
 }
 
-void characterHKX()
-{
-	string filename = "cache\\behavior_joints";
-
-	if (isFileExist(filename))
-	{
-		bool open = false;
-		FileReader file(filename);
-
-		if (file.GetFile())
-		{
-			string line;
-			string header;
-
-			while (file.GetLines(line))
-			{
-				if (line.length() != 0)
-				{
-					if (!open)
-					{
-						open = true;
-						header = line;
-					}
-					else
-					{
-						if (header.length() == 0) ErrorMessage(1094);
-
-						behaviorJoints[header].push_back(line);
-					}
-				}
-				else
-				{
-					open = false;
-				}
-			}
-		}
-		else
-		{
-			ErrorMessage(3002, filename);
-		}
-	}
-	else
-	{
-		ErrorMessage(1068, filename);
-	}
-}
-
 string GetFileName(string filepath)
 {
 	return std::filesystem::path(filepath).stem().string();
@@ -791,13 +705,17 @@ bool isEdited(TemplateInfo* BehaviorTemplate, string& lowerBehaviorFile, unorder
 
 	if (isCharacter)
 	{
-		if ((lowerBehaviorFile == "defaultfemale" || lowerBehaviorFile == "defaultmale") && animReplaced.size() > 0) return true;
+		nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
+
+		if ((lowerBehaviorFile == "defaultfemale" || lowerBehaviorFile == "defaultmale") && context.animReplaced.size() > 0) return true;
 
 		for (auto templist : BehaviorTemplate->grouplist)
 		{
-			VecStr behaviorNames = behaviorJoints[templist.first];
+			const VecStr* behaviorNames = context.behaviorJoints.Find(templist.first);
+
+			if (!behaviorNames) continue;
 
-			for (auto name : behaviorNames)
+			for (auto name : *behaviorNames)
 			{
 				if (templist.second.size() == 0 || lowerBehaviorFile != name) continue;
 
@@ -827,206 +745,39 @@ bool newAnimSkip(vector<shared_ptr<NewAnimation>> newAnim, string modID)
 	return true;
 }
 
-void checkBehaviorJoint(
-    sf::path filepath, sf::path projectdir, string& line, BehaviorStart* process, bool& isBehavior)
+void fileArchitectureCheck(const nemesis::HkxFile& hkxfile)
 {
-    if (isBehavior)
+    if (SSE)
     {
-        if (line.find("<hkparam name=\"behaviorFilename\">") != NOT_FOUND)
+        if (hkxfile.charcode == 0x4)
         {
-            size_t pos = line.find("<hkparam name=\"behaviorFilename\">");
-
-            if (pos != NOT_FOUND)
-            {
-                isBehavior = false;
-                pos += 33;
-                string behaviorFile = line.substr(pos, line.find("</hkparam>", pos) - pos);
-                Lockless nlock(process->postBehaviorFlag);
-                process
-                    ->postBhvrRefBy[nemesis::to_lower_copy(projectdir.wstring() + L"\\"
-                                                           + nemesis::transform_to<wstring>(behaviorFile))]
-                    .insert(nemesis::to_lower_copy(filepath) + L".hkx");
-            }
-
-            isBehavior = false;
+            WarningMessage(1027, "32bit", hkxfile.path);
+            nemesis::GenerationContext::Current().fileCheckMsg.push_back(warningMsges.back());
         }
     }
-    else if (line.find("class=\"hkbCharacterStringData\" signature=\"0x655b42bc\">") != NOT_FOUND)
+    else if (hkxfile.charcode == 0x8)
     {
-        isBehavior = true;
+        WarningMessage(1027, "64bit", hkxfile.path);
+        nemesis::GenerationContext::Current().fileCheckMsg.push_back(warningMsges.back());
     }
 }
 
-void checkClipAnimData(sf::path filepath, 
-					   sf::path projectdir,
-					   string& line,
-                       VecStr& characterFiles,
-                       string& clipName,
-                       bool& isClip,
-                       BehaviorStart* process,
-                       bool& isBehavior)
+void checkAllStoredHKX()
 {
-    if (!isClip)
-    {
-        if (line.find("class=\"hkbClipGenerator\" signature=\"0x333b85b9\">") != NOT_FOUND)
-        {
-            isClip = true;
-        }
-    }
-	else
-	{
-		size_t pos = line.find("<hkparam name=\"animationName\">");
-
-		if (pos != NOT_FOUND)
-		{
-			isClip = false;
-            pos += 30;
-            string animFile = std::filesystem::path(line.substr(pos, line.find("</hkparam>", pos) - pos))
-                                  .filename()
-                                  .string();
-            nemesis::to_lower(animFile);
-
-			for (auto file : characterFiles)
-			{
-                Lockless locker(animdata_lock);
-				shared_ptr<AnimationDataTracker>& animDataPtr = charAnimDataInfo[file][animFile];
-
-				if (animDataPtr == nullptr)
-				{
-					animDataPtr = make_shared<AnimationDataTracker>();
-					animDataPtr->filename = animFile;
-				}
-
-                animDataPtr->cliplist.insert(clipName);
-                vector<shared_ptr<AnimationDataTracker>>& listAnimData = clipPtrAnimData[file][clipName];
-
-				if (listAnimData.size() > 0)
-				{
-					bool same = false;
-
-					for (auto& animData : listAnimData)
-					{
-						if (animData->filename == animFile)
-						{
-							same = true;
-							break;
-						}
-					}
-
-					if (!same)
-					{
-						clipPtrAnimData[file][clipName].push_back(animDataPtr);
-					}
-				}
-				else
-				{
-					clipPtrAnimData[file][clipName].push_back(animDataPtr);
-				}
-			}
-		}
-		else
-		{
-			pos = line.find("<hkparam name=\"name\">");
+	nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
+	Lockless lock(context.hkxFilesLock);
 
-			if (pos != NOT_FOUND)
-			{
-				pos += 21;
-				clipName = line.substr(pos, line.find("</hkparam>", pos) - pos);
-			}
-		}
+	for (auto& file : context.hkxFiles)
+	{
+		fileArchitectureCheck(file);
 	}
 
-	if (!isBehavior)
-    {
-        if (line.find("class=\"hkbBehaviorReferenceGenerator\" signature=\"0xfcb5423\">") != NOT_FOUND)
-        {
-            isBehavior = true;
-        }
-    }
-    else
-    {
-        size_t pos = line.find("<hkparam name=\"behaviorName\">");
-
-        if (pos != NOT_FOUND)
-        {
-            isBehavior = false;
-            pos += 29;
-            string behaviorFile = line.substr(pos, line.find("</hkparam>", pos) - pos);
-            Lockless nlock(process->postBehaviorFlag);
-            process
-                ->postBhvrRefBy[nemesis::transform_to<wstring>(nemesis::to_lower_copy(
-                    projectdir.wstring() + L"\\" + nemesis::transform_to<wstring>(behaviorFile)))]
-                .insert(nemesis::to_lower_copy(filepath) + L".hkx");
-        }
-    }
-}
-
-void fileArchitectureCheck(sf::path hkxfile)
-{
-    FILE* f;
-    _wfopen_s(&f, hkxfile.wstring().c_str(), L"r+b");
-
-    if (f)
-    {
-        fseek(f, 0x10, SEEK_SET);
-        unsigned char charcode;
-        fread(&charcode, sizeof(charcode), 1, f);
-        fclose(f);
-
-        if (SSE)
-        {
-            if (charcode == 0x4)
-            {
-                WarningMessage(1027, "32bit", hkxfile);
-                fileCheckMsg.push_back(warningMsges.back());
-            }
-        }
-        else if (charcode == 0x8)
-        {
-            WarningMessage(1027, "64bit", hkxfile);
-            fileCheckMsg.push_back(warningMsges.back());
-        }
-    }
-}
-
-void fileArchitectureCheck(wstring hkxfile)
-{
-    fileArchitectureCheck(nemesis::transform_to<string>(hkxfile));
-}
-
-void checkAllStoredHKX()
-{
-	for (auto& file : hkxFiles)
+	if (!context.hkxFiles.empty() && !hkxScanner.SaveCache(context.hkxFiles))
 	{
-		if (isFileExist(file))
-		{
-			fileArchitectureCheck(file);
-		}
+		DebugLogging(L"Failed to save hkx architecture cache");
 	}
 
-	hkxFiles.clear();
-}
-
-void checkFolder(sf::path filepath)
-{
-    VecWstr list;
-    read_directory(filepath, list);
-
-    for (auto& each : list)
-    {
-        std::filesystem::path file(filepath.wstring() + L"\\" + each);
-
-        if (std::filesystem::is_directory(file))
-        {
-            checkFolder(file.string());
-        }
-        else if (nemesis::iequals(file.extension().wstring(), L".hkx"))
-        {
-            hkxFiles.push_back(file.wstring());
-        }
-
-        if (error) throw nemesis::exception();
-    }
+	context.hkxFiles.clear();
 }
 
 void checkAllFiles(sf::path filepath)
@@ -1038,9 +789,13 @@ void checkAllFiles(sf::path filepath)
 			try
 			{
 				DebugLogging("Background hkx file architecture check: INITIALIZED");
-				hkxFiles.clear();
-				checkFolder(filepath);
-				DebugLogging("Background hkx file architecture check: COMPLETED");
+				auto files = hkxScanner.Scan(filepath);
+				DebugLogging("Background hkx file architecture check: COMPLETED (" + to_string(files.size())
+							 + " files, " + to_string(hkxScanner.GetCacheHitCount()) + " cached)");
+
+				nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
+				Lockless lock(context.hkxFilesLock);
+				context.hkxFiles = move(files);
 			}
 			catch (const exception& ex)
 			{
@@ -1070,14 +825,6 @@ void ClearGlobal(bool all)
 	{
 		DebugLogging("Global reset all: TRUE");
 
-		usedAnim = unordered_map<string, SetStr>();
-
-		registeredAnim = unordered_map<string, SetStr>();
-
-		animModMatch = unordered_map<string, unordered_map<string, vector<SetStr>>>();
-
-		behaviorJoints = unordered_map<string, VecStr>();
-
 		warningMsges = VecWstr();
 	}
 	else
@@ -1085,32 +832,5 @@ void ClearGlobal(bool all)
 		DebugLogging("Global reset all: FALSE");
 	}
 
-	clipPtrAnimData = map<string, map<string, vector<shared_ptr<AnimationDataTracker>>>>();
-	charAnimDataInfo = map<string, map<string, shared_ptr<AnimationDataTracker>>>();
-
-	behaviorProjectPath = unordered_map<wstring, wstring>();
-	behaviorPath = unordered_map<wstring, wstring>();
-	AAGroup = unordered_map<string, string>();
-	crc32Cache = unordered_map<string, string>();
-	
-	behaviorProject = unordered_map<string, VecStr>();
-	alternateAnim = unordered_map<string, VecStr>();
-	groupAA = unordered_map<string, VecStr>();
-	groupAAPrefix = unordered_map<string, VecStr>();
-	AAEvent = unordered_map<string, VecStr>();
-	AAHasEvent = unordered_map<string, VecStr>();
-
-	pcealist = vector<PCEA>();
-
-	animReplaced = unordered_map<string, vector<PCEAData>>();
-
-	activatedBehavior = unordered_map<string, bool>();
-	
-	AAGroupCount = unordered_map<string, unordered_map<string, int>>();
-
-	AAgroup_Counter = unordered_map<string, int>();
-
-	groupNameList = set<string>();
-
-	fileCheckMsg = VecWstr();
+	nemesis::GenerationContext::Current().Clear(all);
 }
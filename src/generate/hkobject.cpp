@@ -0,0 +1,452 @@
+#include "Global.h"
+
+#include "generate/hkobject.h"
+
+using namespace std;
+
+namespace
+{
+    const string_view objectOpen  = "<hkobject name=\"";
+    const string_view paramOpen   = "<hkparam name=\"";
+    const string_view paramClose  = "</hkparam>";
+    const string_view numelements = " numelements=\"";
+
+    string_view TrimLeft(const string& line)
+    {
+        size_t pos = line.find_first_not_of("\t ");
+        return pos == NOT_FOUND ? string_view() : string_view(line).substr(pos);
+    }
+
+    bool StartsWith(string_view text, string_view prefix)
+    {
+        return text.compare(0, prefix.length(), prefix) == 0;
+    }
+
+    // (0.000000 0.000000 0.000000) and <hkcstring>a b</hkcstring> are single elements
+    size_t CountTokens(string_view text)
+    {
+        size_t count = 0;
+        size_t i     = 0;
+
+        while (true)
+        {
+            i = text.find_first_not_of("\t ", i);
+
+            if (i == NOT_FOUND) break;
+
+            if (text[i] == '(')
+            {
+                i = text.find(')', i);
+            }
+            else if (StartsWith(text.substr(i), "<hkcstring>"))
+            {
+                i = text.find("</hkcstring>", i);
+
+                if (i != NOT_FOUND) i += 11;
+            }
+            else
+            {
+                i = text.find_first_of("\t ", i);
+            }
+
+            ++count;
+
+            if (i == NOT_FOUND) break;
+
+            ++i;
+        }
+
+        return count;
+    }
+
+    // longer runs of digits do not fit an int and are not node IDs
+    constexpr size_t maxIDDigits = 9;
+
+    bool ReadID(string_view digits, int& ID)
+    {
+        if (digits.empty() || digits.length() > maxIDDigits) return false;
+
+        ID = stoi(string(digits));
+        return true;
+    }
+
+    void AddReferences(string_view text, vector<int>& references)
+    {
+        for (size_t pos = text.find('#'); pos != NOT_FOUND; pos = text.find('#', pos))
+        {
+            size_t end = ++pos;
+            int ID;
+
+            while (end < text.length() && isdigit(static_cast<unsigned char>(text[end])))
+            {
+                ++end;
+            }
+
+            if (ReadID(text.substr(pos, end - pos), ID)) references.push_back(ID);
+
+            pos = end;
+        }
+    }
+} // namespace
+
+nemesis::HkParam::HkParam(string _name, string _value)
+    : name(move(_name))
+    , value(move(_value))
+{
+}
+
+nemesis::HkParam nemesis::HkParam::Array(string name)
+{
+    HkParam param(move(name), "");
+    param.isArray = true;
+    return param;
+}
+
+const string& nemesis::HkParam::GetName() const
+{
+    return name;
+}
+
+bool nemesis::HkParam::IsArray() const
+{
+    return isArray;
+}
+
+string nemesis::HkParam::GetValue() const
+{
+    return value;
+}
+
+void nemesis::HkParam::SetValue(string _value)
+{
+    value   = move(_value);
+    isBlock = false;
+    body.clear();
+    original.clear();
+}
+
+void nemesis::HkParam::AddElement(const string& element)
+{
+    isBlock = true;
+    body.push_back(indent + "\t" + element);
+    original.clear();
+}
+
+void nemesis::HkParam::AddElement(const VecStr& element)
+{
+    isBlock = true;
+
+    for (auto& line : element)
+    {
+        body.push_back(indent + "\t" + line);
+    }
+
+    original.clear();
+}
+
+size_t nemesis::HkParam::GetElementCount() const
+{
+    if (!isBlock) return CountTokens(value);
+
+    size_t count = 0;
+    int depth    = 0;
+
+    for (auto& line : body)
+    {
+        string_view trimmed = TrimLeft(line);
+
+        if (trimmed.empty()) continue;
+
+        if (StartsWith(trimmed, "<hkobject>") || StartsWith(trimmed, "<hkobject "))
+        {
+            if (depth == 0) ++count;
+
+            if (trimmed.find("</hkobject>") == NOT_FOUND) ++depth;
+        }
+        else if (StartsWith(trimmed, "</hkobject>"))
+        {
+            --depth;
+        }
+        else if (depth == 0 && !StartsWith(trimmed, "<!--"))
+        {
+            count += CountTokens(trimmed);
+        }
+    }
+
+    return count;
+}
+
+vector<int> nemesis::HkParam::GetReferences() const
+{
+    vector<int> references;
+    AddReferences(value, references);
+
+    for (auto& line : body)
+    {
+        AddReferences(line, references);
+    }
+
+    return references;
+}
+
+void nemesis::HkParam::Serialize(VecStr& lines) const
+{
+    if (!original.empty())
+    {
+        HkParamHeader header;
+
+        if (!isArray || !ReadHeader(original.front(), header) || header.countBegin == NOT_FOUND)
+        {
+            lines.insert(lines.end(), original.begin(), original.end());
+            return;
+        }
+
+        lines.push_back(original.front());
+        lines.back().replace(header.countBegin, header.countLength, to_string(GetElementCount()));
+        lines.insert(lines.end(), original.begin() + 1, original.end());
+        return;
+    }
+
+    string open = indent + "<hkparam name=\"" + name + "\"";
+
+    if (isArray) open.append(" numelements=\"" + to_string(GetElementCount()) + "\"");
+
+    if (!isBlock)
+    {
+        lines.push_back(open + ">" + value + "</hkparam>");
+        return;
+    }
+
+    lines.push_back(open + ">");
+    lines.insert(lines.end(), body.begin(), body.end());
+    lines.push_back(indent + "</hkparam>");
+}
+
+bool nemesis::HkParam::ReadHeader(const string& line, HkParamHeader& header)
+{
+    size_t pos = line.find(paramOpen);
+
+    if (pos == NOT_FOUND) return false;
+
+    header.nameBegin = pos + paramOpen.length();
+    size_t quote     = line.find('"', header.nameBegin);
+
+    if (quote == NOT_FOUND) return false;
+
+    header.nameLength  = quote - header.nameBegin;
+    header.countBegin  = NOT_FOUND;
+    header.countLength = 0;
+
+    if (line.compare(quote + 1, numelements.length(), numelements) == 0)
+    {
+        header.countBegin = quote + 1 + numelements.length();
+        quote             = line.find('"', header.countBegin);
+
+        if (quote == NOT_FOUND) return false;
+
+        header.countLength = quote - header.countBegin;
+    }
+
+    header.closed = line.find(paramClose, quote) != NOT_FOUND;
+    return true;
+}
+
+nemesis::HkObject::HkObject(string _name, string _className, string _signature)
+    : name(move(_name))
+    , className(move(_className))
+    , signature(move(_signature))
+{
+}
+
+nemesis::HkObject nemesis::HkObject::Parse(const VecStr& lines)
+{
+    HkObjectHeader header;
+
+    if (lines.empty() || !ReadHeader(lines.front(), header)) return HkObject("", "", "");
+
+    HkObject object{string(header.name), string(header.className), string(header.signature)};
+    object.indent = lines.front().substr(0, lines.front().find('<'));
+    object.open   = lines.front();
+
+    for (size_t i = 1; i < lines.size(); ++i)
+    {
+        const string& line  = lines[i];
+        string_view trimmed = TrimLeft(line);
+        HkParamHeader paramHeader;
+
+        if (StartsWith(trimmed, "</hkobject>"))
+        {
+            object.close = line;
+            break;
+        }
+
+        HkParam param;
+        param.original.push_back(line);
+
+        if (!StartsWith(trimmed, paramOpen) || !HkParam::ReadHeader(line, paramHeader))
+        {
+            object.params.push_back(move(param));
+            continue;
+        }
+
+        param.name    = line.substr(paramHeader.nameBegin, paramHeader.nameLength);
+        param.indent  = line.substr(0, line.find('<'));
+        param.isArray = paramHeader.countBegin != NOT_FOUND;
+
+        if (paramHeader.closed)
+        {
+            size_t open  = line.find('>', paramHeader.nameBegin + paramHeader.nameLength);
+            size_t close = line.rfind(paramClose);
+            param.value  = line.substr(open + 1, close - open - 1);
+        }
+        else
+        {
+            // a nested block can hold multi-line params of its own
+            int depth     = 1;
+            param.isBlock = true;
+
+            while (++i < lines.size())
+            {
+                const string& inner = lines[i];
+                string_view content = TrimLeft(inner);
+                param.original.push_back(inner);
+
+                if (StartsWith(content, paramClose))
+                {
+                    if (--depth == 0) break;
+                }
+                else if (StartsWith(content, paramOpen) && content.find(paramClose) == NOT_FOUND)
+                {
+                    ++depth;
+                }
+
+                param.body.push_back(inner);
+            }
+        }
+
+        object.params.push_back(move(param));
+    }
+
+    return object;
+}
+
+const string& nemesis::HkObject::GetName() const
+{
+    return name;
+}
+
+void nemesis::HkObject::SetName(string _name)
+{
+    name = move(_name);
+    open.clear();
+}
+
+const string& nemesis::HkObject::GetClass() const
+{
+    return className;
+}
+
+nemesis::HkParam* nemesis::HkObject::Find(const string& paramName)
+{
+    for (auto& param : params)
+    {
+        if (param.name == paramName) return &param;
+    }
+
+    return nullptr;
+}
+
+const nemesis::HkParam* nemesis::HkObject::Find(const string& paramName) const
+{
+    for (auto& param : params)
+    {
+        if (param.name == paramName) return &param;
+    }
+
+    return nullptr;
+}
+
+nemesis::HkParam& nemesis::HkObject::Add(HkParam param)
+{
+    param.indent = indent + "\t";
+    params.push_back(move(param));
+    return params.back();
+}
+
+vector<int> nemesis::HkObject::GetReferences() const
+{
+    vector<int> references;
+
+    for (auto& param : params)
+    {
+        if (param.name.empty()) continue;
+
+        auto list = param.GetReferences();
+        references.insert(references.end(), list.begin(), list.end());
+    }
+
+    return references;
+}
+
+void nemesis::HkObject::Serialize(VecStr& lines) const
+{
+    if (!open.empty())
+    {
+        lines.push_back(open);
+    }
+    else
+    {
+        lines.push_back(indent + "<hkobject name=\"" + name + "\" class=\"" + className + "\" signature=\""
+                        + signature + "\">");
+    }
+
+    for (auto& param : params)
+    {
+        param.Serialize(lines);
+    }
+
+    lines.push_back(close.empty() ? indent + "</hkobject>" : close);
+}
+
+bool nemesis::HkObject::ReadHeader(const string& line, HkObjectHeader& header)
+{
+    size_t pos = line.find(objectOpen);
+
+    if (pos == NOT_FOUND) return false;
+
+    string_view view(line);
+    view.remove_prefix(pos + objectOpen.length());
+
+    size_t quote = view.find('"');
+
+    if (quote == NOT_FOUND) return false;
+
+    header.name = view.substr(0, quote);
+    view.remove_prefix(quote + 1);
+
+    for (auto* attribute : {&header.className, &header.signature})
+    {
+        string_view key = attribute == &header.className ? "class=\"" : "signature=\"";
+        pos             = view.find(key);
+
+        if (pos == NOT_FOUND) return false;
+
+        view.remove_prefix(pos + key.length());
+        quote = view.find('"');
+
+        if (quote == NOT_FOUND) return false;
+
+        *attribute = view.substr(0, quote);
+        view.remove_prefix(quote + 1);
+    }
+
+    header.ID = -1;
+
+    if (header.name.length() > 1 && header.name[0] == '#'
+        && header.name.find_first_not_of("0123456789", 1) == NOT_FOUND)
+    {
+        ReadID(header.name.substr(1), header.ID);
+    }
+
+    return true;
+}
@@ -0,0 +1,235 @@
+#include "Global.h"
+
+#include <deque>
+#include <mutex>
+
+#include "utilities/binaryio.h"
+#include "utilities/threadpool.h"
+
+#include "generate/hkxscanner.h"
+
+using namespace std;
+
+namespace sf = filesystem;
+
+namespace
+{
+    constexpr uint32_t cacheMagic   = 0x584b484e; // "NHKX"
+    constexpr uint32_t cacheVersion = 1;
+    constexpr size_t headerBatch    = 256;
+
+    void WalkDirectory(const sf::path& directory, vector<sf::path>& subdirs, vector<nemesis::HkxFile>& found)
+    {
+        error_code ec;
+
+        // unreadable folders are skipped, the check is advisory only
+        for (sf::directory_iterator itr(directory, ec), end; !ec && itr != end; itr.increment(ec))
+        {
+            const sf::directory_entry& entry = *itr;
+            error_code entryec;
+
+            if (nemesis::to_lower_copy(entry.path().filename().wstring()).find(L"folder_managed_by_vortex")
+                != NOT_FOUND)
+            {
+                continue;
+            }
+
+            if (entry.is_directory(entryec))
+            {
+                subdirs.push_back(entry.path());
+            }
+            else if (nemesis::iequals(entry.path().extension().wstring(), L".hkx"))
+            {
+                nemesis::HkxFile file;
+                file.path  = entry.path().wstring();
+                file.size  = entry.file_size(entryec);
+                file.mtime = entry.last_write_time(entryec).time_since_epoch().count();
+                found.push_back(move(file));
+            }
+        }
+    }
+} // namespace
+
+nemesis::HkxScanner::HkxScanner(sf::path _cachefile)
+    : cachefile(_cachefile)
+{
+}
+
+vector<nemesis::HkxFile> nemesis::HkxScanner::Scan(const sf::path& directory)
+{
+    LoadCache();
+
+    vector<HkxFile> files;
+    deque<sf::path> pending = {directory};
+    mutex walkMutex;
+    condition_variable walkCv;
+    size_t busy    = 0;
+    uint threadNum = (std::max)(thread::hardware_concurrency(), 1U);
+
+    {
+        // every worker takes a folder from the shared queue and pushes back its subfolders
+        // the walk is done once the queue is empty and no worker is still reading a folder
+        nemesis::ThreadPool tp(threadNum);
+        vector<future<void>> jobs;
+
+        for (uint i = 0; i < threadNum; ++i)
+        {
+            jobs.emplace_back(tp.enqueue([&]() {
+                vector<HkxFile> found;
+
+                while (true)
+                {
+                    sf::path current;
+
+                    {
+                        unique_lock<mutex> lock(walkMutex);
+                        walkCv.wait(lock, [&]() { return !pending.empty() || busy == 0 || error; });
+
+                        if (pending.empty() || error) break;
+
+                        current = move(pending.front());
+                        pending.pop_front();
+                        ++busy;
+                    }
+
+                    vector<sf::path> subdirs;
+                    WalkDirectory(current, subdirs, found);
+
+                    {
+                        lock_guard<mutex> lock(walkMutex);
+                        pending.insert(pending.end(), subdirs.begin(), subdirs.end());
+                        --busy;
+                    }
+
+                    walkCv.notify_all();
+                }
+
+                lock_guard<mutex> lock(walkMutex);
+                files.insert(files.end(), make_move_iterator(found.begin()), make_move_iterator(found.end()));
+            }));
+        }
+
+        tp.join_all();
+
+        if (error) throw nemesis::exception();
+
+        for (auto& job : jobs)
+        {
+            job.get();
+        }
+    }
+
+    sort(files.begin(), files.end(), [](const HkxFile& l, const HkxFile& r) { return l.path < r.path; });
+
+    vector<HkxFile*> uncached;
+    cacheHit = 0;
+
+    for (auto& file : files)
+    {
+        auto itr = cache.find(file.path);
+
+        if (itr != cache.end() && itr->second.size == file.size && itr->second.mtime == file.mtime)
+        {
+            file.charcode = itr->second.charcode;
+            ++cacheHit;
+        }
+        else
+        {
+            uncached.push_back(&file);
+        }
+    }
+
+    ReadHeaders(uncached);
+    return files;
+}
+
+bool nemesis::HkxScanner::SaveCache(const vector<HkxFile>& files) const
+{
+    BinaryWriter output(cachefile, cacheMagic, cacheVersion);
+    output.Write(uint64_t(files.size()));
+
+    for (auto& file : files)
+    {
+        output.WriteString(file.path);
+        output.Write(file.size);
+        output.Write(file.mtime);
+        output.Write(file.charcode);
+    }
+
+    return output.Commit();
+}
+
+size_t nemesis::HkxScanner::GetCacheHitCount() const
+{
+    return cacheHit;
+}
+
+void nemesis::HkxScanner::LoadCache()
+{
+    cache.clear();
+    BinaryReader input(cachefile, cacheMagic, cacheVersion);
+    uint64_t count;
+
+    // path length, size, mtime and charcode of each entry
+    constexpr size_t entrySize = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(int64_t) + sizeof(unsigned char);
+
+    // a corrupted cache is ignored, every file is read again
+    if (!input.IsValid() || !input.ReadCount(count, entrySize)) return;
+
+    cache.reserve(size_t(count));
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        wstring path;
+        CacheEntry entry;
+
+        if (!input.ReadString(path) || !input.Read(entry.size) || !input.Read(entry.mtime)
+            || !input.Read(entry.charcode))
+        {
+            // corrupted cache, every file is read again
+            cache.clear();
+            return;
+        }
+
+        cache[move(path)] = entry;
+    }
+}
+
+void nemesis::HkxScanner::ReadHeaders(vector<HkxFile*>& files) const
+{
+    if (files.empty()) return;
+
+    nemesis::ThreadPool tp;
+    vector<future<void>> jobs;
+
+    for (size_t start = 0; start < files.size(); start += headerBatch)
+    {
+        size_t end = (std::min)(start + headerBatch, files.size());
+
+        jobs.emplace_back(tp.enqueue([&files, start, end]() {
+            for (size_t i = start; i < end; ++i)
+            {
+                FILE* f;
+                _wfopen_s(&f, files[i]->path.c_str(), L"rb");
+
+                if (f)
+                {
+                    fseek(f, 0x10, SEEK_SET);
+
+                    if (fread(&files[i]->charcode, sizeof(files[i]->charcode), 1, f) != 1) files[i]->charcode = 0;
+
+                    fclose(f);
+                }
+            }
+        }));
+    }
+
+    tp.join_all();
+
+    if (error) throw nemesis::exception();
+
+    for (auto& job : jobs)
+    {
+        job.get();
+    }
+}
@@ -2,27 +2,34 @@
 #include "nemesisinfo.h"
 
 #include "generate/installscripts.h"
+#include "generate/generationcontext.h"
 #include "generate/playerexclusive.h"
 #include "generate/alternateanimation.h"
 
 using namespace std;
 
-extern atomic<int> m_RunningThread;
-
-InstallScripts::InstallScripts(const NemesisInfo* _ini)
+InstallScripts::InstallScripts(const NemesisInfo* _ini, nemesis::GenerationContext& _context)
 {
     nemesisInfo = _ini;
+    context     = &_context;
+
+    // counted before the worker starts, so the run cannot finish while the worker waits for its turn
+    ++context->runningThread;
 }
 
 void InstallScripts::Run()
 {
+    nemesis::GenerationContext::Scope scope(*context);
+
+    // profiles of a batch compile their scripts in the same papyrus temp folder, one at a time
+    static mutex installLock;
+    lock_guard<mutex> installGuard(installLock);
+
     try
     {
-        ++m_RunningThread;
-
         try
         {
-            if (alternateAnim.size() > 0)
+            if (context->alternateAnim.size() > 0)
             {
                 if (!AAInstallation(nemesisInfo))
                 {
@@ -59,7 +66,7 @@ void InstallScripts::Run()
 
         try
         {
-            if (pcealist.size() > 0) PCEAInstallation(nemesisInfo);
+            if (context->pcealist.size() > 0) PCEAInstallation(nemesisInfo);
         }
         catch (exception& ex)
         {
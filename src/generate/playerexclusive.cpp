@@ -8,10 +8,13 @@
 #include "nemesisinfo.h"
 
 #include "utilities/regex.h"
+#include "utilities/binaryio.h"
+#include "utilities/threadpool.h"
 #include "utilities/writetextfile.h"
 
 #include "generate/papyruscompile.h"
 #include "generate/playerexclusive.h"
+#include "generate/generationcontext.h"
 #include "generate/generator_utility.h"
 #include "generate/alternateanimation.h"
 
@@ -20,33 +23,95 @@ namespace sf = filesystem;
 
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 
-vector<PCEA> pcealist;
-unordered_map<string, vector<PCEAData>> animReplaced;
-
-void tryDelete(string file, int repeated = 0)
+namespace
 {
-    if (repeated > 100) ErrorMessage(1082, "PCEA_animations", file);
+    constexpr uint32_t manifestMagic   = 0x4143504e; // "NPCA"
+    constexpr uint32_t manifestVersion = 2;
 
-    if (!sf::remove(file)) tryDelete(file, repeated + 1);
-}
+    const wchar_t manifestFile[] = L"cache\\pcea_animations";
 
-bool Delete(sf::path file)
-{
-    if (sf::is_directory(file))
+    // source an animation under PCEA_animations was deployed from
+    struct Deployment
+    {
+        wstring source;
+        uint64_t size = 0;
+        int64_t mtime = 0;
+    };
+
+    // lower target path, deployment
+    using DeploymentMap = unordered_map<wstring, Deployment>;
+
+    bool GetDeployment(const sf::path& source, Deployment& deployment)
+    {
+        error_code ec;
+        deployment.source = source.wstring();
+        deployment.size   = sf::file_size(source, ec);
+
+        if (ec) return false;
+
+        deployment.mtime = sf::last_write_time(source, ec).time_since_epoch().count();
+        return !ec;
+    }
+
+    DeploymentMap LoadManifest()
     {
-        string tempbehavior = file.string();
-        VecStr filelist;
-        read_directory(tempbehavior, filelist);
-        tempbehavior.append("\\");
+        DeploymentMap manifest;
+        nemesis::BinaryReader input(manifestFile, manifestMagic, manifestVersion);
+        uint64_t count;
 
-        for (auto& curfile : filelist)
+        // target, source, size, mtime
+        if (!input.IsValid() || !input.ReadCount(count, 4 + 4 + 8 + 8)) return manifest;
+
+        manifest.reserve(size_t(count));
+
+        for (uint64_t i = 0; i < count; ++i)
         {
-            Delete(tempbehavior + curfile);
+            wstring target;
+            Deployment deployment;
+
+            if (!input.ReadString(target) || !input.ReadString(deployment.source) || !input.Read(deployment.size)
+                || !input.Read(deployment.mtime))
+            {
+                // every animation is deployed again
+                manifest.clear();
+                return manifest;
+            }
+
+            manifest[move(target)] = move(deployment);
         }
+
+        return manifest;
     }
 
-    tryDelete(file.string());
-    return true;
+    bool SaveManifest(const DeploymentMap& manifest)
+    {
+        nemesis::BinaryWriter output(manifestFile, manifestMagic, manifestVersion);
+        output.Write(uint64_t(manifest.size()));
+
+        for (auto& entry : manifest)
+        {
+            output.WriteString(entry.first);
+            output.WriteString(entry.second.source);
+            output.Write(entry.second.size);
+            output.Write(entry.second.mtime);
+        }
+
+        return output.Commit();
+    }
+} // namespace
+
+// animations PCEA_animations is to hold after this run
+struct PCEASync
+{
+    DeploymentMap planned; // lower target path, deployment
+    vector<pair<sf::path, sf::path>> deployments; // source, target
+};
+
+void tryDelete(string file, int repeated = 0)
+{
+    if (repeated > 100) ErrorMessage(1082, "PCEA_animations", file);
+
+    if (!sf::remove(file)) tryDelete(file, repeated + 1);
 }
 
 void forcedCopy(sf::path animFile, sf::path newAnimFile, int count = 0)
@@ -63,7 +128,22 @@ void forcedCopy(sf::path animFile, sf::path newAnimFile, int count = 0)
     }
 }
 
-void PCEASubFolder(string path, unsigned short number, string pceafolder, string subpath, PCEA& mod)
+// hard link when the mod and the data folder share a volume, a copy otherwise
+void deployAnimation(const sf::path& animFile, const sf::path& newAnimFile)
+{
+    // the old file may be a link to another mod's animation, writing into it would change that animation
+    if (sf::exists(newAnimFile)) tryDelete(newAnimFile.string());
+
+    error_code ec;
+    sf::create_hard_link(animFile, newAnimFile, ec);
+
+    if (ec) forcedCopy(animFile, newAnimFile);
+
+    if (!sf::exists(newAnimFile)) ErrorMessage(1185, newAnimFile.string());
+}
+
+void PCEASubFolder(
+    string path, unsigned short number, const sf::path& pceafolder, string subpath, PCEA& mod, PCEASync& sync)
 {
     VecStr animlist;
     read_directory(path, animlist);
@@ -76,40 +156,142 @@ void PCEASubFolder(string path, unsigned short number, string pceafolder, string
         {
             if (!nemesis::iequals(animFile.extension().string(), ".hkx")) continue;
 
+            // numbered by the animations of the lower mod numbers planned before, not by the files on disk,
+            // so a file keeps its name from run to run
+            // the target is joined like the paths PCEADeploy walks, so the manifest keys match them
             int numb           = 0;
             string newFileName = "fp2" + to_string(numb++) + "_" + anim;
+            wstring target     = (pceafolder / newFileName).wstring();
 
-            while (isFileExist(pceafolder + "\\" + newFileName))
+            while (sync.planned.find(nemesis::to_lower_copy(target)) != sync.planned.end())
+            {
                 newFileName = "fp2" + to_string(numb++) + "_" + anim;
+                target      = (pceafolder / newFileName).wstring();
+            }
 
-            sf::path newAnimFile(pceafolder + "\\" + newFileName);
+            Deployment& deployment      = sync.planned[nemesis::to_lower_copy(target)];
             string lowerAnim            = nemesis::to_lower_copy(anim);
             mod.animPathList[lowerAnim] = "Animations\\Nemesis_PCEA\\" + subpath + "\\" + newFileName;
 
-            if (!isFileExist(pceafolder)) sf::create_directories(pceafolder);
+            if (!isFileExist(pceafolder.wstring())) sf::create_directories(pceafolder);
 
-            forcedCopy(animFile, newAnimFile);
+            if (!GetDeployment(animFile, deployment)) ErrorMessage(1185, target);
 
-            if (!sf::exists(animFile)) ErrorMessage(1185, newAnimFile.string());
+            sync.deployments.emplace_back(animFile, target);
         }
         else
         {
-            PCEASubFolder(animFile.string(), number, pceafolder + "\\" + anim, subpath + "\\" + anim, mod);
+            PCEASubFolder(animFile.string(), number, pceafolder / anim, subpath + "\\" + anim, mod, sync);
         }
     }
 }
 
+// only the animations whose source changed since the last run are deployed again, the files and folders no mod
+// provides any more are removed
+void PCEADeploy(const sf::path& pceafolder, PCEASync& sync)
+{
+    DeploymentMap manifest = LoadManifest();
+    vector<pair<sf::path, sf::path>*> outdated;
+    vector<sf::path> stale;
+    vector<sf::path> folders;
+    error_code ec;
+
+    for (sf::recursive_directory_iterator itr(pceafolder, ec), end; !ec && itr != end; itr.increment(ec))
+    {
+        error_code entryec;
+
+        if (itr->is_directory(entryec))
+        {
+            folders.push_back(itr->path());
+            continue;
+        }
+
+        if (sync.planned.find(nemesis::to_lower_copy(itr->path().wstring())) == sync.planned.end())
+        {
+            stale.push_back(itr->path());
+        }
+    }
+
+    for (auto& file : stale)
+    {
+        tryDelete(file.string());
+    }
+
+    for (auto& deployment : sync.deployments)
+    {
+        wstring target = nemesis::to_lower_copy(deployment.second.wstring());
+        auto last      = manifest.find(target);
+        auto& current  = sync.planned.at(target);
+        error_code sizeec;
+
+        if (last == manifest.end() || last->second.source != current.source || last->second.size != current.size
+            || last->second.mtime != current.mtime || sf::file_size(deployment.second, sizeec) != current.size
+            || sizeec)
+        {
+            outdated.push_back(&deployment);
+        }
+    }
+
+    DebugLogging("PCEA animations deployed: " + to_string(outdated.size()) + ", unchanged: "
+                 + to_string(sync.deployments.size() - outdated.size()) + ", removed: " + to_string(stale.size()));
+
+    if (!outdated.empty())
+    {
+        nemesis::ThreadPool tp;
+
+        for (auto& deployment : outdated)
+        {
+            tp.enqueue([deployment]() {
+                if (error) return;
+
+                try
+                {
+                    try
+                    {
+                        deployAnimation(deployment->first, deployment->second);
+                    }
+                    catch (exception& ex)
+                    {
+                        ErrorMessage(6002, deployment->second.string(), ex.what());
+                    }
+                }
+                catch (nemesis::exception&)
+                {
+                    // resolved exception
+                }
+            });
+        }
+
+        tp.join_all();
+    }
+
+    if (error) throw nemesis::exception();
+
+    // the walk lists a folder before its subfolders, so backwards a folder is empty once its subfolders are removed
+    for (auto folder = folders.rbegin(); folder != folders.rend(); ++folder)
+    {
+        error_code removeec;
+
+        if (sf::is_empty(*folder, removeec) && !removeec) sf::remove(*folder, removeec);
+    }
+
+    // a manifest that cannot be written only costs a full deployment next run
+    if (!SaveManifest(sync.planned)) DebugLogging(L"Failed to save PCEA manifest: " + wstring(manifestFile));
+}
+
 void ReadPCEA(const NemesisInfo* nemesisInfo)
 {
     DebugLogging("Reading PCEA files...");
-    pcealist     = vector<PCEA>();
-    animReplaced = unordered_map<string, vector<PCEAData>>();
+    nemesis::GenerationContext& context = nemesis::GenerationContext::Current();
+    auto& pcealist                      = context.pcealist;
+    auto& animReplaced                  = context.animReplaced;
+    pcealist                            = vector<PCEA>();
+    animReplaced                        = unordered_map<string, vector<PCEAData>>();
 
     VecWstr folderlist;
     wstring datapath = nemesisInfo->GetDataPath() + L"meshes\\actors\\character\\Animations\\Nemesis_PCEA";
     sf::path pceafolder(datapath + L"\\PCEA_animations");
-
-    if (isFileExist(pceafolder.string())) Delete(pceafolder);
+    PCEASync sync;
 
     if (!FolderCreate(datapath + L"\\PCEA_animations\\")) return;
 
@@ -140,13 +322,14 @@ void ReadPCEA(const NemesisInfo* nemesisInfo)
         {
             PCEA mod;
             mod.modFile = folder.substr(folder.find("|") + 1);
-            PCEASubFolder(
-                folder.substr(0, folder.find("|")), number, pceafolder.string(), "PCEA_animations", mod);
+            PCEASubFolder(folder.substr(0, folder.find("|")), number, pceafolder, "PCEA_animations", mod, sync);
 
             if (mod.animPathList.size() > 0) modlist[number] = mod;
         }
     }
 
+    PCEADeploy(pceafolder, sync);
+
     // limitation lifts
     // if (modlist.size() > 10) ErrorMessage(7000);
 
@@ -177,6 +360,7 @@ void ReadPCEA(const NemesisInfo* nemesisInfo)
 
 bool PCEAInstallation(const NemesisInfo* nemesisInfo)
 {
+    const auto& pcealist = nemesis::GenerationContext::Current().pcealist;
     sf::path import(nemesisInfo->GetDataPath() + L"scripts\\source");
     wstring filename = nemesisInfo->GetDataPath() + L"Nemesis PCEA.esp";
     DebugLogging(filename);
@@ -1,5 +1,7 @@
 #include "Global.h"
 
+#include <charconv>
+#include <cstdint>
 #include <filesystem>
 
 #include <QtGui/QIcon>
@@ -13,6 +15,8 @@
 #include "ui/MultiInstanceCheck.h"
 #include "ui/NemesisEngine.h"
 
+#include "utilities/memorybudget.h"
+
 extern std::wstring stagePath;
 
 int main(int argc, char* argv[])
@@ -20,6 +24,7 @@ int main(int argc, char* argv[])
     bool generate = false;
     bool update   = false;
     VecStr modlist;
+    std::wstring batchfile;
     std::string logfile = "CriticalLog.txt";
 
     try
@@ -71,6 +76,31 @@ int main(int argc, char* argv[])
 
                     if (stagePath.size() > 0 && stagePath.back() == L'\"') stagePath.pop_back();
                 }
+                else if (std::string_view(argv[i]).find("-max-memory=") == 0)
+                {
+                    // megabytes the behavior compilations may hold at once, by their estimated footprint
+                    // only plain digits are taken, stoull would wrap "-1" and skip leading spaces
+                    std::string_view value(argv[i] + 12);
+                    size_t megabytes = 0;
+                    auto result      = std::from_chars(value.data(), value.data() + value.size(), megabytes);
+
+                    if (value.empty() || result.ec != std::errc() || result.ptr != value.data() + value.size()
+                        || megabytes > SIZE_MAX / (1024 * 1024))
+                    {
+                        std::cout << "Invalid argument. \"max-memory\" takes the number of megabytes";
+                        return 1;
+                    }
+
+                    nemesis::MemoryBudget::Instance().SetLimit(megabytes * 1024 * 1024);
+                }
+                else if (std::string_view(argv[i]).find("-batch=") == 0)
+                {
+                    batchfile = nemesis::transform_to<std::wstring>(std::string(argv[i] + 7));
+
+                    if (batchfile.size() > 0 && batchfile[0] == L'\"') batchfile = batchfile.substr(1);
+
+                    if (batchfile.size() > 0 && batchfile.back() == L'\"') batchfile.pop_back();
+                }
                 else
                 {
                     modlist.push_back(argv[i]);
@@ -99,7 +129,16 @@ int main(int argc, char* argv[])
             {
                 NewDebugMessage(*new DebugMsg("english"));
                 NemesisInfo* nemesisInfo = new NemesisInfo;
-                CmdGenerateInitialize(modlist, nemesisInfo);
+
+                if (batchfile.length() > 0)
+                {
+                    CmdBatchInitialize(batchfile, nemesisInfo);
+                }
+                else
+                {
+                    CmdGenerateInitialize(modlist, nemesisInfo);
+                }
+
                 delete nemesisInfo;
             }
         }
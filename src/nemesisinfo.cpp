@@ -182,7 +182,7 @@ void NemesisInfo::setup()
     wstring curpath = sf::current_path().wstring();
     replace(curpath.begin(), curpath.end(), '/', '\\');
 
-    if (nemesis::to_lower_copy(curpath).find(L"\\project new reign - nemesis\\test environment") != NOT_FOUND)
+    if (nemesis::ifind(curpath, L"\\project new reign - nemesis\\test environment") != NOT_FOUND)
     {
         dataPath = sf::current_path().wstring() + L"\\data\\";
         curpath  = dataPath + L"Nemesis_Engine";
@@ -332,6 +332,11 @@ const string& NemesisInfo::GetStagePathA() const
     return nemesis::transform_to<string>(stageDirectory);
 }
 
+bool NemesisInfo::IsStaged() const
+{
+    return stageDirectory != dataPath;
+}
+
 const bool& NemesisInfo::IsFirst() const
 {
     return first;
@@ -372,6 +377,11 @@ void NemesisInfo::setFirst(bool _first)
     first = _first;
 }
 
+void NemesisInfo::setStagePath(const wstring& path)
+{
+    stageDirectory = path + L"\\";
+}
+
 void NemesisInfo::setWidth(uint _width)
 {
     width = _width;
@@ -13,10 +13,36 @@
 
 #include "update/updateprocess.h"
 
+#include "generate/behaviorbatch.h"
 #include "generate/behaviorprocess.h"
 
 using namespace std;
 
+// hidden mods first, then the mods of modlist with the last one taking the highest priority
+void GetBehaviorPick(VecStr modlist, VecStr& behaviorPriority, unordered_map<string, bool>& chosenBehavior)
+{
+    VecStr hiddenModList = getHiddenMods();
+
+    for (auto& mod : hiddenModList)
+    {
+        behaviorPriority.push_back(mod);
+        chosenBehavior[mod] = true;
+    }
+
+    for (auto& each : modlist)
+    {
+        nemesis::to_lower(each);
+        wstring mod = nemesis::transform_to<wstring>(each);
+        auto itr = modinfo.find(mod);
+
+        if (itr != modinfo.end())
+        {
+            behaviorPriority.insert(behaviorPriority.begin(), each);
+            chosenBehavior[each] = true;
+        }
+    }
+}
+
 void CmdGenerateInitialize(VecStr modlist, const NemesisInfo* nemesisInfo)
 {
     string modcode;
@@ -45,27 +71,8 @@ void CmdGenerateInitialize(VecStr modlist, const NemesisInfo* nemesisInfo)
     wcout << TextBoxMessage(1017) + L": " + nemesis::transform_to<wstring>(version) + L"\n\n";
     wcout << TextBoxMessage(1004) + L"\n";
     VecStr behaviorPriority;
-    VecStr hiddenModList = getHiddenMods();
     unordered_map<string, bool> chosenBehavior;
-
-    for (auto& mod : hiddenModList)
-    {
-        behaviorPriority.push_back(mod);
-        chosenBehavior[mod] = true;
-    }
-
-    for (auto& each : modlist)
-    {
-        nemesis::to_lower(each);
-        wstring mod = nemesis::transform_to<wstring>(mod);
-        auto itr = modinfo.find(mod);
-
-        if (itr != modinfo.end())
-        {
-            behaviorPriority.insert(behaviorPriority.begin(), each);
-            chosenBehavior[each] = true;
-        }
-    }
+    GetBehaviorPick(modlist, behaviorPriority, chosenBehavior);
 
     QThread* thread       = new QThread;
     BehaviorStart* worker = new BehaviorStart(nemesisInfo);
@@ -92,6 +99,55 @@ void CmdGenerateInitialize(VecStr modlist, const NemesisInfo* nemesisInfo)
     exit(static_cast<int>(error));
 }
 
+void CmdBatchInitialize(const wstring& batchfile, const NemesisInfo* nemesisInfo)
+{
+    wstring errmsg;
+
+    if (!readMod(errmsg))
+    {
+        CEMsgBox* msgbox = new CEMsgBox;
+        QString msg      = QString::fromStdWString(errmsg);
+        msgbox->setText(msg);
+        msgbox->setWindowTitle("CRITITAL ERROR");
+        msgbox->show();
+        error = true;
+        return;
+    }
+
+    string version;
+
+    if (!isEngineUpdated(version, nemesisInfo))
+    {
+        wcout << TextBoxMessage(1000) + L"\n";
+        return;
+    }
+
+    wcout << TextBoxMessage(1003) + L"\n";
+    wcout << TextBoxMessage(1017) + L": " + nemesis::transform_to<wstring>(version) + L"\n\n";
+    wcout << TextBoxMessage(1004) + L"\n";
+    vector<nemesis::GenerationProfile> profiles;
+
+    try
+    {
+        for (auto& each : nemesis::ReadBatchFile(batchfile))
+        {
+            nemesis::GenerationProfile profile;
+            profile.stageDirectory = each.first;
+            GetBehaviorPick(each.second, profile.behaviorPriority, profile.chosenBehavior);
+            profiles.push_back(move(profile));
+        }
+
+        nemesis::GenerateBatch(profiles, nemesisInfo);
+    }
+    catch (nemesis::exception&)
+    {
+        // resolved exception
+    }
+
+    cout << "End\n";
+    exit(static_cast<int>(error));
+}
+
 void CmdUpdateInitialize(const NemesisInfo* nemesisInfo)
 {
     QThread* thread          = new QThread;
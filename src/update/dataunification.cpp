@@ -11,6 +11,8 @@ OBJECTIVES:
 #include "utilities/lastupdate.h"
 #include "utilities/stringsplit.h"
 
+#include "generate/generationcontext.h"
+
 #pragma warning(disable:4503)
 
 using namespace std;
@@ -19,7 +21,7 @@ atomic_flag newAnimAdditionLock{};
 
 void CombineAnimData(string filename, string characterfile, string modcode, string filepath, VecStr storeline, MasterAnimData& animData, bool isHeader);
 
-bool newAnimUpdateExt(string folderpath, string modcode, string behaviorfile, map<string, VecStr, alphanum_less>& newFile, map<string, VecStr>& newAnimAddition,
+bool newAnimUpdateExt(string folderpath, string modcode, string behaviorfile, nemesis::NodeTable& newFile, map<string, VecStr>& newAnimAddition,
                       unordered_map<wstring, wstring>& lastUpdate)
 {
 	VecStr nodelist;
@@ -220,7 +222,7 @@ bool newAnimUpdateExt(string folderpath, string modcode, string behaviorfile, ma
 
 		if (combinelines.size() != 0 && combinelines.back().length() != 0) combinelines.push_back("");
 
-		newFile[nodeID] = combinelines;
+		newFile[nodeID] = move(combinelines);
 	}
 
 	return true;
@@ -456,19 +458,26 @@ bool newAnimDataSetUpdateExt(string folderpath, string modcode, string projectfi
 	return true;
 }
 
-void behaviorJointsOutput()
+void behaviorJointsOutput(nemesis::PathManifest::Builder& manifest)
 {
+	unordered_map<string, VecStr> behaviorJoints;
 	unordered_map<string, VecStr> combinedBehaviorJoints;
 
+	// the joints are followed on a copy, a lookup into the shard being walked would wait for its own lock
+	nemesis::GenerationContext::Current().behaviorJoints.ForEach(
+		[&](const string& behavior, VecStr& joints) { behaviorJoints.emplace(behavior, joints); });
+
 	for (auto it = behaviorJoints.begin(); it != behaviorJoints.end(); ++it)
 	{
 		for (unsigned int i = 0; i < it->second.size(); ++i)
 		{
 			VecStr temp = it->second;
+			auto next   = behaviorJoints.find(temp[i]);
 
-			while (!behaviorJoints[temp[i].data()].empty())
+			while (next != behaviorJoints.end() && !next->second.empty())
 			{
-				temp = behaviorJoints[temp[i].data()];
+				temp = next->second;
+				next = behaviorJoints.find(temp[i]);
 			}
 
 			combinedBehaviorJoints[it->first] = temp;
@@ -478,27 +487,9 @@ void behaviorJointsOutput()
 		if (error) throw nemesis::exception();
 	}
 
-	FileWriter output(L"cache\\behavior_joints");
-
-	if (output.is_open())
-	{
-		for (auto it : combinedBehaviorJoints)
-		{
-			output << it.first << "\n";
-
-			for (unsigned int i = 0; i < it.second.size(); ++i)
-			{
-				output << it.second[i] << "\n";
-			}
-
-			output << "\n";
-		}
-
-		if (error) throw nemesis::exception();
-	}
-	else
+	for (auto& it : combinedBehaviorJoints)
 	{
-		ErrorMessage(2009, "behavior_joint");
+		manifest.Add<char>(nemesis::PathManifest::BehaviorJoints, it.first, it.second);
 	}
 }
 
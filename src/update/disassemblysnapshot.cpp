@@ -0,0 +1,307 @@
+#include "utilities/binaryio.h"
+#include "utilities/changemanifest.h"
+
+#include "update/nodetable.h"
+#include "update/disassemblysnapshot.h"
+
+using namespace std;
+
+namespace sf = filesystem;
+
+namespace
+{
+    constexpr uint32_t snapshotMagic   = 0x4e53444e; // "NDSN"
+    constexpr uint32_t snapshotVersion = 2; // 2: node names of the behavior snapshot
+
+    enum SnapshotKind : uint32_t
+    {
+        BEHAVIOR,
+        ANIMDATA,
+        ANIMSETDATA
+    };
+
+    void WriteLines(nemesis::BinaryWriter& output, const VecStr& lines)
+    {
+        output.Write(uint32_t(lines.size()));
+
+        for (auto& line : lines)
+        {
+            output.WriteString(line);
+        }
+    }
+
+    bool ReadLines(nemesis::BinaryReader& input, VecStr& lines)
+    {
+        uint32_t count;
+
+        if (!input.ReadCount(count, 4)) return false;
+
+        lines.resize(count);
+
+        for (auto& line : lines)
+        {
+            if (!input.ReadString(line)) return false;
+        }
+
+        return true;
+    }
+
+    void WriteMap(nemesis::BinaryWriter& output, const SSMap& map)
+    {
+        output.Write(uint32_t(map.size()));
+
+        for (auto& entry : map)
+        {
+            output.WriteString(entry.first);
+            output.WriteString(entry.second);
+        }
+    }
+
+    bool ReadMap(nemesis::BinaryReader& input, SSMap& map)
+    {
+        uint32_t count;
+
+        if (!input.ReadCount(count, 4 + 4)) return false;
+
+        map.reserve(count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            string key;
+
+            if (!input.ReadString(key) || !input.ReadString(map[key])) return false;
+        }
+
+        return true;
+    }
+
+    void WriteBlocks(nemesis::BinaryWriter& output, const vector<nemesis::AnimDataRecord::Block>& blocks)
+    {
+        output.Write(uint32_t(blocks.size()));
+
+        for (auto& block : blocks)
+        {
+            output.WriteString(block.key);
+            output.Write(block.linenum);
+            WriteLines(output, block.lines);
+        }
+    }
+
+    bool ReadBlocks(nemesis::BinaryReader& input, vector<nemesis::AnimDataRecord::Block>& blocks)
+    {
+        uint32_t count;
+
+        // key, line number, line count
+        if (!input.ReadCount(count, 4 + 4 + 4)) return false;
+
+        blocks.resize(count);
+
+        for (auto& block : blocks)
+        {
+            if (!input.ReadString(block.key) || !input.Read(block.linenum) || !ReadLines(input, block.lines))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    nemesis::BinaryWriter StartSnapshot(const sf::path& cachefile, SnapshotKind kind, uint64_t sourceHash)
+    {
+        nemesis::BinaryWriter output(cachefile, snapshotMagic, snapshotVersion);
+        output.Write(uint32_t(kind));
+        output.Write(sourceHash);
+        return output;
+    }
+
+    // false when the snapshot is missing, of another kind or taken from another version of the source
+    bool OpenSnapshot(nemesis::BinaryReader& input, SnapshotKind kind, uint64_t sourceHash)
+    {
+        uint32_t fileKind;
+        uint64_t fileHash;
+
+        return input.IsValid() && input.Read(fileKind) && input.Read(fileHash) && fileKind == kind
+               && fileHash == sourceHash;
+    }
+} // namespace
+
+nemesis::DisassemblySnapshot::DisassemblySnapshot(const sf::path& source, const string& name)
+    : cachefile(L"cache\\disassembly\\" + sf::path(name).wstring())
+    , sourceHash(ChangeManifest::HashFile(source.wstring()))
+{
+}
+
+bool nemesis::DisassemblySnapshot::Load(NodeTable& nodes,
+                                        map<string, unordered_map<string, bool>>& childrenState,
+                                        SSMap& stateID,
+                                        SSMap& parent) const
+{
+    MappedFile file;
+
+    if (sourceHash == 0 || !file.Open(cachefile)) return false;
+
+    BinaryReader input(file, snapshotMagic, snapshotVersion);
+    uint32_t count;
+
+    if (!OpenSnapshot(input, BEHAVIOR, sourceHash) || !input.ReadCount(count, 4 + 4)) return false;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        string nodeID;
+
+        if (!input.ReadString(nodeID) || !ReadLines(input, nodes[nodeID])) return false;
+    }
+
+    if (!input.ReadCount(count, 4 + 4)) return false;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        string nodeID;
+        VecStr states;
+
+        if (!input.ReadString(nodeID) || !ReadLines(input, states)) return false;
+
+        auto& children = childrenState[nodeID];
+
+        for (auto& state : states)
+        {
+            children[state] = true;
+        }
+    }
+
+    return ReadMap(input, stateID) && ReadMap(input, parent);
+}
+
+bool nemesis::DisassemblySnapshot::Load(AnimDataRecord& record) const
+{
+    MappedFile file;
+
+    if (sourceHash == 0 || !file.Open(cachefile)) return false;
+
+    BinaryReader input(file, snapshotMagic, snapshotVersion);
+    uint32_t count;
+
+    // line number, header, anims, infos
+    if (!OpenSnapshot(input, ANIMDATA, sourceHash) || !ReadLines(input, record.projectNames)
+        || !input.ReadCount(count, 4 + 4 + 4 + 4))
+    {
+        return false;
+    }
+
+    record.projects.resize(count);
+
+    for (auto& project : record.projects)
+    {
+        if (!input.Read(project.linenum) || !ReadLines(input, project.header) || !ReadBlocks(input, project.anims)
+            || !ReadBlocks(input, project.infos))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool nemesis::DisassemblySnapshot::Load(AnimSetDataRecord& record) const
+{
+    MappedFile file;
+
+    if (sourceHash == 0 || !file.Open(cachefile)) return false;
+
+    BinaryReader input(file, snapshotMagic, snapshotVersion);
+    uint32_t count;
+
+    // project, header, lines
+    if (!OpenSnapshot(input, ANIMSETDATA, sourceHash) || !ReadLines(input, record.projectList)
+        || !input.ReadCount(count, 4 + 4 + 4))
+    {
+        return false;
+    }
+
+    record.entries.resize(count);
+
+    for (auto& entry : record.entries)
+    {
+        if (!input.ReadString(entry.project) || !input.ReadString(entry.header) || !ReadLines(input, entry.lines))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool nemesis::DisassemblySnapshot::Save(NodeTable& nodes,
+                                        const map<string, unordered_map<string, bool>>& childrenState,
+                                        const SSMap& stateID,
+                                        const SSMap& parent) const
+{
+    if (sourceHash == 0) return false;
+
+    BinaryWriter output = StartSnapshot(cachefile, BEHAVIOR, sourceHash);
+    vector<NodeTable::Node> sorted = nodes.GetSortedNodes();
+    output.Write(uint32_t(sorted.size()));
+
+    for (auto& node : sorted)
+    {
+        output.WriteString(nodes.GetNodeName(node));
+        WriteLines(output, *node.lines);
+    }
+
+    output.Write(uint32_t(childrenState.size()));
+
+    for (auto& children : childrenState)
+    {
+        VecStr states;
+
+        for (auto& state : children.second)
+        {
+            if (state.second) states.push_back(state.first);
+        }
+
+        output.WriteString(children.first);
+        WriteLines(output, states);
+    }
+
+    WriteMap(output, stateID);
+    WriteMap(output, parent);
+    return output.Commit();
+}
+
+bool nemesis::DisassemblySnapshot::Save(const AnimDataRecord& record) const
+{
+    if (sourceHash == 0) return false;
+
+    BinaryWriter output = StartSnapshot(cachefile, ANIMDATA, sourceHash);
+    WriteLines(output, record.projectNames);
+    output.Write(uint32_t(record.projects.size()));
+
+    for (auto& project : record.projects)
+    {
+        output.Write(project.linenum);
+        WriteLines(output, project.header);
+        WriteBlocks(output, project.anims);
+        WriteBlocks(output, project.infos);
+    }
+
+    return output.Commit();
+}
+
+bool nemesis::DisassemblySnapshot::Save(const AnimSetDataRecord& record) const
+{
+    if (sourceHash == 0) return false;
+
+    BinaryWriter output = StartSnapshot(cachefile, ANIMSETDATA, sourceHash);
+    WriteLines(output, record.projectList);
+    output.Write(uint32_t(record.entries.size()));
+
+    for (auto& entry : record.entries)
+    {
+        output.WriteString(entry.project);
+        output.WriteString(entry.header);
+        WriteLines(output, entry.lines);
+    }
+
+    return output.Commit();
+}
@@ -5,6 +5,7 @@
 #include "utilities/stringsplit.h"
 
 #include "update/functionupdate.h"
+#include "generate/generationcontext.h"
 
 #pragma warning(disable : 4503)
 
@@ -79,7 +80,7 @@ VecStr GetFunctionEdits(string filename, VecStr storeline, int startline, int en
 bool NodeU::NodeUpdate(string modcode,
                        string behaviorfile,
                        string nodefile,
-                       unique_ptr<map<string, VecStr, alphanum_less>>& newFile,
+                       unique_ptr<nemesis::NodeTable>& newFile,
                        unique_ptr<SSMap>& stateID,
                        unique_ptr<SSMap>& parent,
                        unique_ptr<unordered_map<string, VecStr>>& statelist,
@@ -92,7 +93,7 @@ bool NodeU::NodeUpdate(string modcode,
 #endif
 )
 {
-    if (behaviorPath[nemesis::transform_to<wstring>(nemesis::to_lower_copy(behaviorfile))].empty())
+    if (nemesis::GenerationContext::Current().GetBehaviorPath(nemesis::InternPath(behaviorfile)).empty())
     {
         ErrorMessage(2006, behaviorfile);
     }
@@ -533,7 +534,7 @@ bool NodeU::NodeUpdate(string modcode,
 #if MULTITHREADED_UPDATE
         Lockless lock(filelock);
 #endif
-        (*newFile)[nodeID] = functionline;
+        (*newFile)[nodeID] = move(functionline);
     }
     else if (nemesis::iequals(nodefile, "#" + modcode + "$" + filecheck))
     {
@@ -563,7 +564,7 @@ bool NodeU::NodeUpdate(string modcode,
 #if MULTITHREADED_UPDATE
         Lockless lock(filelock);
 #endif
-        (*newFile)[nodeID] = storeline;
+        (*newFile)[nodeID] = move(storeline);
     }
     else if (nodefile != "__folder_managed_by_vortex")
     {
@@ -576,7 +577,7 @@ bool NodeU::NodeUpdate(string modcode,
 bool NodeU::FunctionUpdate(string modcode,
                            string behaviorfile,
                            string nodefile,
-                           unique_ptr<map<string, VecStr, alphanum_less>>& newFile,
+                           unique_ptr<nemesis::NodeTable>& newFile,
                            unique_ptr<SSMap>& stateID,
                            unique_ptr<SSMap>& parent,
                            unique_ptr<unordered_map<string, VecStr>>& statelist,
@@ -631,7 +632,7 @@ bool AnimDataUpdate(string modcode,
                     bool& openAnim,
                     bool& openInfo)
 {
-    if (behaviorPath[nemesis::transform_to<wstring>(nemesis::to_lower_copy(animdatafile))].empty())
+    if (nemesis::GenerationContext::Current().GetBehaviorPath(nemesis::InternPath(animdatafile)).empty())
     {
         ErrorMessage(2007, animdatafile);
     }
@@ -1147,7 +1148,7 @@ bool AnimSetDataUpdate(string modcode,
                        bool isNewProject,
                        unordered_map<wstring, wstring>& lastUpdate)
 {
-    if (behaviorPath[nemesis::transform_to<wstring>(nemesis::to_lower_copy(animdatasetfile))].empty())
+    if (nemesis::GenerationContext::Current().GetBehaviorPath(nemesis::InternPath(animdatasetfile)).empty())
     {
         ErrorMessage(2007, animdatasetfile);
     }
@@ -0,0 +1,195 @@
+#include <algorithm>
+
+#include "update/nodetable.h"
+
+using namespace std;
+
+namespace
+{
+    constexpr uint32_t vanilla = 0;
+
+    // vanilla IDs below this are indexed directly, vanilla behaviors stay far below it; a larger ID in a patch is
+    // kept in the map of the mod nodes, so it cannot size the direct index
+    constexpr uint32_t directIDs = 100000;
+
+    // digits only, short enough to fit in 32 bits, and padded with zeros to exactly width digits when shorter
+    // so that the ID can be written back the way it was read
+    bool ParseID(string_view number, size_t width, uint32_t& id)
+    {
+        if (number.length() < width || number.length() > 9) return false;
+
+        if (number.length() > width && number[0] == '0') return false;
+
+        uint32_t value = 0;
+
+        for (char ch : number)
+        {
+            if (ch < '0' || ch > '9') return false;
+
+            value = value * 10 + (ch - '0');
+        }
+
+        id = value;
+        return true;
+    }
+
+    nemesis::NodeTable::Key MakeKey(uint32_t modIndex, uint32_t id)
+    {
+        return (static_cast<nemesis::NodeTable::Key>(modIndex) << 32) | id;
+    }
+
+    uint32_t GetModIndex(nemesis::NodeTable::Key key)
+    {
+        return static_cast<uint32_t>(key >> 32);
+    }
+
+    uint32_t GetID(nemesis::NodeTable::Key key)
+    {
+        return static_cast<uint32_t>(key);
+    }
+} // namespace
+
+bool nemesis::NodeTable::GetKey(string_view nodeID, Key& key, bool create)
+{
+    if (nodeID.length() < 2 || nodeID[0] != '#') return false;
+
+    uint32_t id;
+    size_t pos = nodeID.find('$');
+
+    if (pos == string_view::npos)
+    {
+        if (!ParseID(nodeID.substr(1), 4, id)) return false;
+
+        key = MakeKey(vanilla, id);
+        return true;
+    }
+
+    if (pos == 1 || !ParseID(nodeID.substr(pos + 1), 1, id)) return false;
+
+    string lowerModcode(nodeID.substr(1, pos - 1));
+
+    for (auto& ch : lowerModcode)
+    {
+        ch = ch >= 'A' && ch <= 'Z' ? ch + ('a' - 'A') : ch;
+    }
+
+    auto itr = modIndexes.find(lowerModcode);
+
+    if (itr == modIndexes.end())
+    {
+        if (!create) return false;
+
+        itr = modIndexes.emplace(lowerModcode, uint32_t(modIndexes.size() + 1)).first;
+    }
+
+    key = MakeKey(itr->second, id);
+    return true;
+}
+
+nemesis::NodeTable::Entry* nemesis::NodeTable::Create(string_view nodeID)
+{
+    Key key;
+
+    if (!GetKey(nodeID, key, true)) return nullptr;
+
+    Entry* entry;
+
+    if (GetModIndex(key) != vanilla || GetID(key) >= directIDs)
+    {
+        entry = &modNodes[key];
+    }
+    else
+    {
+        uint32_t id = GetID(key);
+
+        if (id >= vanillaNodes.size()) vanillaNodes.resize(size_t(id) + 1);
+
+        entry = &vanillaNodes[id];
+    }
+
+    if (entry->name.empty()) entry->name = nodeID;
+
+    return entry;
+}
+
+VecStr& nemesis::NodeTable::operator[](string_view nodeID)
+{
+    Entry* entry = Create(nodeID);
+
+    return entry ? entry->lines : namedNodes[string(nodeID)];
+}
+
+VecStr* nemesis::NodeTable::find(string_view nodeID)
+{
+    Key key;
+
+    if (!GetKey(nodeID, key, false))
+    {
+        auto itr = namedNodes.find(nodeID);
+        return itr == namedNodes.end() ? nullptr : &itr->second;
+    }
+
+    if (GetModIndex(key) != vanilla || GetID(key) >= directIDs)
+    {
+        auto itr = modNodes.find(key);
+        return itr == modNodes.end() ? nullptr : &itr->second.lines;
+    }
+
+    uint32_t id = GetID(key);
+    return id < vanillaNodes.size() && !vanillaNodes[id].name.empty() ? &vanillaNodes[id].lines : nullptr;
+}
+
+size_t nemesis::NodeTable::size() const
+{
+    size_t vanillaCount
+        = count_if(vanillaNodes.begin(), vanillaNodes.end(), [](const Entry& entry) { return !entry.name.empty(); });
+    return vanillaCount + modNodes.size() + namedNodes.size();
+}
+
+vector<nemesis::NodeTable::Node> nemesis::NodeTable::GetSortedNodes()
+{
+    vector<pair<NaturalKey, Node>> nodes;
+    nodes.reserve(vanillaNodes.size() + modNodes.size() + namedNodes.size());
+
+    for (auto& entry : vanillaNodes)
+    {
+        if (!entry.name.empty()) nodes.emplace_back(NaturalKey(entry.name), Node{&entry.name, &entry.lines});
+    }
+
+    for (auto& entry : modNodes)
+    {
+        nodes.emplace_back(NaturalKey(entry.second.name), Node{&entry.second.name, &entry.second.lines});
+    }
+
+    for (auto& entry : namedNodes)
+    {
+        nodes.emplace_back(NaturalKey(entry.first), Node{&entry.first, &entry.second});
+    }
+
+    // keys are built once, each comparison is a memcmp
+    sort(nodes.begin(), nodes.end(), [](const auto& l, const auto& r) { return l.first < r.first; });
+
+    vector<Node> sorted;
+    sorted.reserve(nodes.size());
+
+    for (auto& node : nodes)
+    {
+        sorted.push_back(node.second);
+    }
+
+    return sorted;
+}
+
+string_view nemesis::NodeTable::GetModCode(const Node& node) const
+{
+    size_t pos = node.name->find('$');
+
+    if (pos == string::npos || pos < 1) return string_view();
+
+    return string_view(*node.name).substr(1, pos - 1);
+}
+
+const string& nemesis::NodeTable::GetNodeName(const Node& node) const
+{
+    return *node.name;
+}
@@ -0,0 +1,111 @@
+#include "utilities/binaryio.h"
+
+#include "update/updateindex.h"
+
+using namespace std;
+
+namespace sf = filesystem;
+
+namespace
+{
+    constexpr uint32_t indexMagic   = 0x5849554e; // "NUIX"
+    constexpr uint32_t indexVersion = 1;
+} // namespace
+
+bool nemesis::UpdateIndex::Load(const sf::path& filepath)
+{
+    Clear();
+    BinaryReader input(filepath, indexMagic, indexVersion);
+    uint64_t count;
+
+    // a count that cannot fit in the rest of the file fails the load, the update then runs in full
+    // name length, crc32 and joint count of each behavior
+    if (!input.Read(animSetDataCrc32) || !input.ReadCount(count, sizeof(uint32_t) * 3)) return false;
+
+    behaviors.reserve(size_t(count));
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        string behavior;
+        BehaviorState state;
+        uint32_t jointCount;
+
+        if (!input.ReadString(behavior) || !input.Read(state.crc32) || !input.ReadCount(jointCount, sizeof(uint32_t)))
+        {
+            return false;
+        }
+
+        state.joints.resize(jointCount);
+
+        for (auto& joint : state.joints)
+        {
+            if (!input.ReadString(joint)) return false;
+        }
+
+        behaviors[behavior] = move(state);
+    }
+
+    if (!input.ReadCount(count, sizeof(uint32_t) * 2)) return false;
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        string modcode;
+        uint32_t behaviorCount;
+
+        if (!input.ReadString(modcode) || !input.ReadCount(behaviorCount, sizeof(uint32_t))) return false;
+
+        set<string>& list = modBehaviors[modcode];
+
+        for (uint32_t j = 0; j < behaviorCount; ++j)
+        {
+            string behavior;
+
+            if (!input.ReadString(behavior)) return false;
+
+            list.insert(move(behavior));
+        }
+    }
+
+    return true;
+}
+
+bool nemesis::UpdateIndex::Save(const sf::path& filepath) const
+{
+    BinaryWriter output(filepath, indexMagic, indexVersion);
+    output.Write(animSetDataCrc32);
+    output.Write(uint64_t(behaviors.size()));
+
+    for (auto& behavior : behaviors)
+    {
+        output.WriteString(behavior.first);
+        output.Write(behavior.second.crc32);
+        output.Write(uint32_t(behavior.second.joints.size()));
+
+        for (auto& joint : behavior.second.joints)
+        {
+            output.WriteString(joint);
+        }
+    }
+
+    output.Write(uint64_t(modBehaviors.size()));
+
+    for (auto& mod : modBehaviors)
+    {
+        output.WriteString(mod.first);
+        output.Write(uint32_t(mod.second.size()));
+
+        for (auto& behavior : mod.second)
+        {
+            output.WriteString(behavior);
+        }
+    }
+
+    return output.Commit();
+}
+
+void nemesis::UpdateIndex::Clear()
+{
+    behaviors.clear();
+    modBehaviors.clear();
+    animSetDataCrc32 = 0;
+}
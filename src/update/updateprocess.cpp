@@ -11,15 +11,20 @@
 
 #include "utilities/filechecker.h"
 #include "utilities/lastupdate.h"
+#include "utilities/changemanifest.h"
 #include "utilities/renew.h"
 #include "utilities/stringsplit.h"
+#include "utilities/lineclassifier.h"
 #if MULTITHREADED_UPDATE
 #include "utilities/threadpool.h"
 #endif
 
 #include "update/dataunification.h"
 #include "update/updateprocess.h"
+#include "update/disassemblysnapshot.h"
 
+#include "generate/hkobject.h"
+#include "generate/generator_utility.h"
 #include "generate/behaviorprocess_utility.h"
 
 using namespace std;
@@ -79,7 +84,7 @@ public:
 
 struct arguPack
 {
-    arguPack(map<string, unique_ptr<map<string, VecStr, alphanum_less>>>& n_newFile,
+    arguPack(map<string, unique_ptr<nemesis::NodeTable>>& n_newFile,
              SSSMap& n_parent,
              MasterAnimData& n_animData,
              MasterAnimSetData& n_animSetData,
@@ -101,7 +106,7 @@ struct arguPack
     }
 
     shared_ptr<UpdateLock> modUpdate;
-    map<string, unique_ptr<map<string, VecStr, alphanum_less>>>& newFile;
+    map<string, unique_ptr<nemesis::NodeTable>>& newFile;
 
     unordered_map<string, unique_ptr<SSMap>> n_stateID;
 #if MULTITHREADED_UPDATE
@@ -136,6 +141,8 @@ void UpdateFilesStart::startUpdatingFile()
 
     // Seperate try-catch for easier debugging purpose
 
+    nemesis::GenerationContext::Scope scope(context);
+
     try
     {
         ClearGlobal();
@@ -167,9 +174,16 @@ void UpdateFilesStart::startUpdatingFile()
         RunScript("scripts\\update\\start\\");
         DebugLogging("External script run complete");
 
-        // clear the temp_behaviors folder to prevent it from bloating
-        ClearTempBehaviors(nemesisInfo);
-        DebugLogging("Temp behavior clearance complete");
+        if (PlanPartialUpdate(directory))
+        {
+            DebugLogging("Partial update: " + to_string(mergeTargets.size()) + " behavior(s) to merge");
+        }
+        else
+        {
+            // clear the temp_behaviors folder to prevent it from bloating
+            ClearTempBehaviors(nemesisInfo);
+            DebugLogging("Temp behavior clearance complete");
+        }
 
         // create "temp_behaviors" folder
         if (!isFileExist(directory)) sf::create_directory(directory);
@@ -289,6 +303,8 @@ void UpdateFilesStart::startUpdatingFile()
 
 void UpdateFilesStart::UpdateFiles()
 {
+    nemesis::GenerationContext::Scope scope(context);
+
     try
     {
         try
@@ -345,62 +361,19 @@ bool UpdateFilesStart::VanillaUpdate()
 
     emit progressUp(); // 3
 
-    if (behaviorPath.size() != 0)
+    for (auto& it : context.behaviorPath)
     {
-        FileWriter output("cache\\behavior_path");
-
-        if (output.is_open())
-        {
-            for (auto it = behaviorPath.begin(); it != behaviorPath.end(); ++it)
-            {
-                output << it->first << "=" << it->second << "\n";
-            }
-        }
-        else
-        {
-            ErrorMessage(2009, "cache\\behavior_path");
-        }
+        behaviorManifest.Add<wchar_t>(nemesis::PathManifest::BehaviorPath, it.first.Wide(), it.second);
     }
 
-    if (behaviorProject.size() != 0)
+    for (auto& it : context.behaviorProject)
     {
-        FileWriter output("cache\\behavior_project");
-
-        if (output.is_open())
-        {
-            for (auto it = behaviorProject.begin(); it != behaviorProject.end(); ++it)
-            {
-                output << it->first.data() << "\n";
-
-                for (unsigned int i = 0; i < it->second.size(); ++i)
-                {
-                    output << it->second[i] << "\n";
-                }
-
-                output << "\n";
-            }
-        }
-        else
-        {
-            ErrorMessage(2009, "cache\\behavior_project");
-        }
+        behaviorManifest.Add<char>(nemesis::PathManifest::BehaviorProject, it.first.Utf8(), it.second);
     }
 
-    if (behaviorProjectPath.size() != 0)
+    for (auto& it : context.behaviorProjectPath)
     {
-        FileWriter output("cache\\behavior_project_path");
-
-        if (output.is_open())
-        {
-            for (auto it = behaviorProjectPath.begin(); it != behaviorProjectPath.end(); ++it)
-            {
-                output << it->first << "=" << it->second << "\n";
-            }
-        }
-        else
-        {
-            ErrorMessage(2009, "cache\\behavior_project_path");
-        }
+        behaviorManifest.Add<wchar_t>(nemesis::PathManifest::BehaviorProjectPath, it.first.Wide(), it.second);
     }
 
     return true;
@@ -461,10 +434,17 @@ void UpdateFilesStart::RegisterBehavior(shared_ptr<RegisterQueue> curBehavior)
 #if MULTITHREADED_UPDATE
                 Lockless lock(behaviorPathLock);
 #endif
-                behaviorPath[nemesis::to_lower_copy(curFileName)]
+                context.behaviorPath[nemesis::InternPath(curFileName)]
                     = nemesis::to_lower_copy(curBehavior->file.parent_path().wstring() + L"\\" + curFileName);
             }
 
+            // animation data is only merged in a full update
+            if (partialUpdate)
+            {
+                emit progressUp();
+                return;
+            }
+
             if (!AnimDataDisassemble(newPath, animData)) return;
 
             saveLastUpdate(nemesis::to_lower_copy(newPath), lastUpdate);
@@ -481,10 +461,16 @@ void UpdateFilesStart::RegisterBehavior(shared_ptr<RegisterQueue> curBehavior)
 #if MULTITHREADED_UPDATE
                 Lockless lock(behaviorPathLock);
 #endif
-                behaviorPath[nemesis::to_lower_copy(curFileName)]
+                context.behaviorPath[nemesis::InternPath(curFileName)]
                     = nemesis::to_lower_copy(curBehavior->file.parent_path().wstring() + L"\\" + curFileName);
             }
 
+            if (partialUpdate)
+            {
+                emit progressUp();
+                return;
+            }
+
             if (!AnimSetDataDisassemble(newPath, animSetData)) return;
 
             saveLastUpdate(nemesis::to_lower_copy(newPath), lastUpdate);
@@ -510,19 +496,38 @@ void UpdateFilesStart::RegisterBehavior(shared_ptr<RegisterQueue> curBehavior)
 #if MULTITHREADED_UPDATE
                 Lockless lock(behaviorPathLock);
 #endif
-                behaviorPath[curFileName]
+                context.behaviorPath[nemesis::InternPath(curFileName)]
                     = nemesis::to_lower_copy(curBehavior->file.parent_path().wstring() + L"\\"
                                              + curBehavior->file.stem().wstring().substr(8));
             }
 
-            unique_ptr<map<string, VecStr, alphanum_less>> _curNewFile
-                = make_unique<map<string, VecStr, alphanum_less>>();
+            if (!isMergeTarget(curFileNameA))
+            {
+                emit progressUp();
+                return;
+            }
+
+            unique_ptr<nemesis::NodeTable> _curNewFile
+                = make_unique<nemesis::NodeTable>();
             unique_ptr<map<string, unordered_map<string, bool>>> _childrenState
                 = make_unique<map<string, unordered_map<string, bool>>>();
             unique_ptr<SSMap> _stateID = make_unique<SSMap>();
             unique_ptr<SSMap> _parent  = make_unique<SSMap>();
 
-            VanillaDisassemble(newPath, _curNewFile, _childrenState, _stateID, _parent);
+            string snapshotName = curFileNameA;
+            replace(snapshotName.begin(), snapshotName.end(), '\\', '~');
+            nemesis::DisassemblySnapshot snapshot(newPath, snapshotName);
+
+            if (!snapshot.Load(*_curNewFile, *_childrenState, *_stateID, *_parent))
+            {
+                _curNewFile     = make_unique<nemesis::NodeTable>();
+                _childrenState  = make_unique<map<string, unordered_map<string, bool>>>();
+                _stateID        = make_unique<SSMap>();
+                _parent         = make_unique<SSMap>();
+
+                VanillaDisassemble(newPath, _curNewFile, _childrenState, _stateID, _parent);
+                snapshot.Save(*_curNewFile, *_childrenState, *_stateID, *_parent);
+            }
 
             {
 #if MULTITHREADED_UPDATE
@@ -542,7 +547,8 @@ void UpdateFilesStart::RegisterBehavior(shared_ptr<RegisterQueue> curBehavior)
             if (nemesis::to_lower_copy(curBehavior->file.parent_path().filename().wstring()).find(L"characters")
                 == 0)
             {
-                registeredAnim[nemesis::to_lower_copy(curFileNameA)] = SetStr();
+                context.registeredAnim.Update(nemesis::InternPath(curFileNameA),
+                                              [](SetStr& registered) { registered.clear(); });
             }
         }
         else if (wordFind(curFileName, L"Nemesis_") == 0
@@ -561,7 +567,7 @@ void UpdateFilesStart::RegisterBehavior(shared_ptr<RegisterQueue> curBehavior)
 #if MULTITHREADED_UPDATE
                 Lockless lock(behaviorProjectPathLock);
 #endif
-                behaviorProjectPath[curFileName] = curPath;
+                context.behaviorProjectPath[nemesis::InternPath(curFileName)] = curPath;
             }
 
             VecStr storeline;
@@ -588,7 +594,8 @@ void UpdateFilesStart::RegisterBehavior(shared_ptr<RegisterQueue> curBehavior)
 #if MULTITHREADED_UPDATE
                     Lockless lock(behaviorProjectLock);
 #endif
-                    behaviorProject[characterfile.data()].push_back(nemesis::transform_to<string>(curFileName));
+                    context.behaviorProject[nemesis::InternPath(characterfile)].push_back(
+                        nemesis::transform_to<string>(curFileName));
                 }
 
                 if (line.find("<hkparam name=\"characterFilenames\" numelements=\"") != NOT_FOUND
@@ -687,7 +694,7 @@ void UpdateFilesStart::GetPathLoop(const filesystem::path& path, bool isFirstPer
 }
 
 bool UpdateFilesStart::VanillaDisassemble(const wstring& path,
-                                          unique_ptr<map<string, VecStr, alphanum_less>>& curNewFile,
+                                          unique_ptr<nemesis::NodeTable>& curNewFile,
                                           unique_ptr<map<string, unordered_map<string, bool>>>& childrenState,
                                           unique_ptr<SSMap>& stateID,
                                           unique_ptr<SSMap>& parent)
@@ -716,10 +723,11 @@ bool UpdateFilesStart::VanillaDisassemble(const wstring& path,
                 if (curline.find("SERIALIZE_IGNORED") == NOT_FOUND)
                 {
                     bool isVector4 = false;
+                    nemesis::HkParamHeader param;
 
-                    if (storeline.size() > 0 && storeline.back().find("numelements=\"") != NOT_FOUND
-                        && storeline.back().find("</hkparam>", storeline.back().find("numelements=\""))
-                               == NOT_FOUND)
+                    // first line after the header of an array that spans several lines
+                    if (storeline.size() > 0 && nemesis::HkParam::ReadHeader(storeline.back(), param)
+                        && param.countBegin != NOT_FOUND && !param.closed)
                     {
                         if (curline.find("			#") != NOT_FOUND)
                         {
@@ -780,14 +788,14 @@ bool UpdateFilesStart::VanillaDisassemble(const wstring& path,
                         }
                     }
 
-                    if (curline.find("<hkparam name=\"stateId\">") != NOT_FOUND)
+                    // <hkparam name="stateId">3</hkparam>
+                    if (nemesis::HkParam::ReadHeader(curline, param) && param.closed
+                        && curline.compare(param.nameBegin, param.nameLength, "stateId") == 0)
                     {
-                        string stateIDStr = nemesis::regex_replace(
-                            string(curline),
-                            nemesis::regex(".*<hkparam name=\"stateId\">([0-9]+)</hkparam>.*"),
-                            string("\\1"));
+                        size_t pos        = param.nameBegin + param.nameLength + 2;
+                        string stateIDStr = curline.substr(pos, curline.find("</hkparam>", pos) - pos);
 
-                        if (stateIDStr != curline)
+                        if (!stateIDStr.empty() && stateIDStr.find_first_not_of("0123456789") == NOT_FOUND)
                         {
                             (*stateID)[curID] = stateIDStr;
                         }
@@ -909,45 +917,46 @@ bool UpdateFilesStart::VanillaDisassemble(const wstring& path,
                     }
                     else
                     {
-                        if (curline.find("<hkobject name=\"", 0) != NOT_FOUND
-                            && curline.find("signature=\"", curline.find("<hkobject name=\"")) != NOT_FOUND)
+                        nemesis::HkObjectHeader header;
+
+                        if (nemesis::HkObject::ReadHeader(curline, header))
                         {
-                            if (curline.find("class=\"hkbStateMachine\" signature=\"") != NOT_FOUND)
-                                isSM = true;
-                            else
-                                isSM = false;
+                            isSM = header.className == "hkbStateMachine";
 
                             if (storeline.size() != 0 && curID.length() != 0)
                             {
                                 storeline.shrink_to_fit();
-                                (*curNewFile)[curID] = storeline;
+                                (*curNewFile)[curID] = move(storeline);
+                                storeline            = VecStr();
                                 storeline.reserve(2000);
-                                storeline.clear();
                             }
 
-                            size_t pos = curline.find("<hkobject name=\"#") + 16;
-                            curID      = curline.substr(
-                                pos, curline.find("\" class=\"", curline.find("<hkobject name=\"")) - pos);
+                            curID = string(header.name);
                         }
 
                         storeline.push_back(curline);
                     }
                 }
             }
-            else if (curline.find("<hkobject name=\"#") != NOT_FOUND)
+            else
             {
-                skip       = false;
-                size_t pos = curline.find("<hkobject name=\"#") + 16;
-                curID      = curline.substr(pos,
-                                       curline.find("\" class=\"", curline.find("<hkobject name=\"")) - pos);
-                storeline.push_back(curline);
+                nemesis::HkObjectHeader header;
+
+                // the first node, everything before it is the packfile header
+                if (nemesis::HkObject::ReadHeader(curline, header) && header.name.length() > 1
+                    && header.name[0] == '#')
+                {
+                    skip  = false;
+                    curID = string(header.name);
+                    storeline.push_back(curline);
+                }
             }
         }
 
         if (storeline.size() != 0 && curID.length() != 0)
         {
             storeline.shrink_to_fit();
-            (*curNewFile)[curID] = storeline;
+            (*curNewFile)[curID] = move(storeline);
         }
     }
     else
@@ -990,6 +999,40 @@ bool UpdateFilesStart::AnimDataDisassemble(const wstring& path, MasterAnimData&
     bool end     = false;
     bool out     = true;
 
+    nemesis::AnimDataRecord record;
+    nemesis::DisassemblySnapshot snapshot(path, "animationdatasinglefile");
+
+    // the calls the parse below made the last time it read this version of the file
+    // every project has to be one of the listed names, as the replay looks them up by index
+    if (snapshot.Load(record) && record.projects.size() <= record.projectNames.size())
+    {
+        for (size_t i = 0; i < record.projectNames.size(); ++i)
+        {
+            animData.add(record.projectNames[i], i + 1);
+        }
+
+        for (size_t i = 0; i < record.projects.size(); ++i)
+        {
+            auto& project                          = record.projects[i];
+            shared_ptr<AnimDataProject_Condt> proj = animData.projectlist[i].raw->second;
+            proj->update("original", project.header, project.linenum);
+
+            for (auto& block : project.anims)
+            {
+                proj->aadd(block.key, "original", block.lines, block.linenum);
+            }
+
+            for (auto& block : project.infos)
+            {
+                proj->iadd(block.key, "original", block.lines, block.linenum);
+            }
+        }
+
+        return true;
+    }
+
+    record = nemesis::AnimDataRecord();
+
     if (!GetFunctionLines(path, storeline)) return false;
 
     {
@@ -1004,6 +1047,7 @@ bool UpdateFilesStart::AnimDataDisassemble(const wstring& path, MasterAnimData&
     for (size_t i = 1; i < num; ++i)
     {
         animData.add(storeline[i], i);
+        record.projectNames.push_back(storeline[i]);
     }
 
     try
@@ -1031,6 +1075,7 @@ bool UpdateFilesStart::AnimDataDisassemble(const wstring& path, MasterAnimData&
 
             templine.push_back(storeline[i++]);
             proj->update("original", templine, i - templine.size() + 1);
+            record.projects.push_back({templine, uint32_t(i - templine.size() + 1)});
             templine.clear();
 
             if (proj->childActive == "0") continue;
@@ -1043,6 +1088,8 @@ bool UpdateFilesStart::AnimDataDisassemble(const wstring& path, MasterAnimData&
                 if (templine.back().length() == 0)
                 {
                     proj->aadd(templine[0], "original", templine, i - templine.size() + 2);
+                    record.projects.back().anims.push_back(
+                        {templine[0], templine, uint32_t(i - templine.size() + 2)});
                     templine.clear();
                 }
 
@@ -1061,6 +1108,8 @@ bool UpdateFilesStart::AnimDataDisassemble(const wstring& path, MasterAnimData&
                 if (templine.back().length() == 0)
                 {
                     proj->iadd(templine[0], "original", templine, i - templine.size() + 2);
+                    record.projects.back().infos.push_back(
+                        {templine[0], templine, uint32_t(i - templine.size() + 2)});
                     templine.clear();
                 }
 
@@ -1073,6 +1122,7 @@ bool UpdateFilesStart::AnimDataDisassemble(const wstring& path, MasterAnimData&
         ErrorMessage(3014);
     }
 
+    snapshot.Save(record);
     return true;
 }
 
@@ -1086,6 +1136,31 @@ bool UpdateFilesStart::AnimSetDataDisassemble(const wstring& path, MasterAnimSet
     VecStr newline;
     newline.reserve(500);
 
+    nemesis::AnimSetDataRecord record;
+    nemesis::DisassemblySnapshot snapshot(path, "animationsetdatasinglefile");
+
+    // what the parse below added the last time it read this version of the file
+    if (snapshot.Load(record))
+    {
+        animSetData.projectList.insert(
+            animSetData.projectList.end(), record.projectList.begin(), record.projectList.end());
+
+        for (auto& entry : record.entries)
+        {
+            animSetData.newAnimSetData[entry.project][entry.header] = move(entry.lines);
+        }
+
+        return true;
+    }
+
+    record = nemesis::AnimSetDataRecord();
+
+    // every assignment is recorded for the snapshot
+    auto store = [&](const string& curProject, const string& curHeader, const VecStr& lines) {
+        animSetData.newAnimSetData[curProject][curHeader] = lines;
+        record.entries.push_back({curProject, curHeader, lines});
+    };
+
     if (!GetFunctionLines(path, storeline)) return false;
 
     {
@@ -1105,12 +1180,14 @@ bool UpdateFilesStart::AnimSetDataDisassemble(const wstring& path, MasterAnimSet
     bool special       = false;
     bool isInfo        = false;
     animSetData.projectList.push_back(project);
+    record.projectList.push_back(project);
     animDataSetHeader[project].push_back(header);
 
     for (int i = 1; i < num; ++i)
     {
         newline.push_back(storeline[i]);
         animSetData.projectList.push_back(nemesis::to_lower_copy(storeline[i]));
+        record.projectList.push_back(animSetData.projectList.back());
     }
 
     for (unsigned int i = num; i < storeline.size(); ++i)
@@ -1119,7 +1196,7 @@ bool UpdateFilesStart::AnimSetDataDisassemble(const wstring& path, MasterAnimSet
         {
             header = animDataSetHeader[project][headercounter];
             newline.shrink_to_fit();
-            animSetData.newAnimSetData[project][header] = newline;
+            store(project, header, newline);
             newline.reserve(100);
             newline.clear();
             project = animSetData.projectList[projectcounter];
@@ -1142,7 +1219,7 @@ bool UpdateFilesStart::AnimSetDataDisassemble(const wstring& path, MasterAnimSet
                     header = nemesis::to_lower_copy(animDataSetHeader[project][headercounter]);
                     ++headercounter;
                     newline.shrink_to_fit();
-                    animSetData.newAnimSetData[project][header] = newline;
+                    store(project, header, newline);
                     newline.reserve(100);
                     newline.clear();
                     break;
@@ -1161,7 +1238,7 @@ bool UpdateFilesStart::AnimSetDataDisassemble(const wstring& path, MasterAnimSet
             header = animDataSetHeader[project][headercounter];
             ++headercounter;
             newline.shrink_to_fit();
-            animSetData.newAnimSetData[project][header] = newline;
+            store(project, header, newline);
             newline.reserve(100);
             newline.clear();
         }
@@ -1175,9 +1252,10 @@ bool UpdateFilesStart::AnimSetDataDisassemble(const wstring& path, MasterAnimSet
 
         header = animDataSetHeader[project][headercounter];
         newline.shrink_to_fit();
-        animSetData.newAnimSetData[project][header] = newline;
+        store(project, header, newline);
     }
 
+    snapshot.Save(record);
     return true;
 }
 
@@ -1357,7 +1435,7 @@ void UpdateFilesStart::ModThread(const string& directory,
         }
         else
         {
-            unique_ptr<map<string, VecStr, alphanum_less>>& newFile(pack[modcode]->newFile[behavior]);
+            unique_ptr<nemesis::NodeTable>& newFile(pack[modcode]->newFile[behavior]);
             shared_ptr<UpdateLock> modUpdate(pack[modcode]->modUpdate);
 
             (*modUpdate)[behavior + node.substr(0, node.find_last_of("."))].FunctionUpdate(
@@ -1720,6 +1798,8 @@ void UpdateFilesStart::JoiningEdits(string directory)
 
                 for (auto& behavior : modQueue)
                 {
+                    if (!isMergeTarget(behavior.first)) continue;
+
                     for (auto& node : behavior.second)
                     {
                         processQueue.push_back(TargetQueue(behavior.first, node.first));
@@ -1835,14 +1915,12 @@ void UpdateFilesStart::CombiningFiles()
         VecStr fileline;
         fileline.reserve(behavior.second->size());
 
-        for (auto& node : (*behavior.second)) // behavior node ID
+        for (auto& node : behavior.second->GetSortedNodes()) // behavior node ID
         {
-            size_t pos = node.first.find("$");
+            string_view modID = behavior.second->GetModCode(node);
 
-            if (pos != NOT_FOUND)
+            if (modID.length() > 0)
             {
-                string modID = node.first.substr(1, pos - 1);
-
                 if (OpeningMod != modID && isOpen)
                 {
                     fileline.push_back("<!-- CLOSE -->");
@@ -1851,21 +1929,26 @@ void UpdateFilesStart::CombiningFiles()
 
                 if (!isOpen)
                 {
-                    fileline.push_back("<!-- NEW *" + modID + "* -->");
                     OpeningMod = modID;
-                    isOpen     = true;
+                    fileline.push_back("<!-- NEW *" + OpeningMod + "* -->");
+                    isOpen = true;
                 }
             }
 
-            if (node.second.size() == 0) ErrorMessage(2008, behavior.first + " (" + node.first + ")");
+            if (node.lines->size() == 0)
+            {
+                ErrorMessage(2008, behavior.first + " (" + behavior.second->GetNodeName(node) + ")");
+            }
 
-            for (string& line : node.second)
+            for (string& line : *node.lines)
             {
-                if (line.find("class=\"hkRootLevelContainer\" signature=\"0x2772c11e\">", 0) != NOT_FOUND)
+                nemesis::HkObjectHeader header;
+
+                // a behavior has one root container
+                if (rootID.empty() && nemesis::HkObject::ReadHeader(line, header)
+                    && header.className == "hkRootLevelContainer")
                 {
-                    rootID = "#"
-                             + nemesis::regex_replace(
-                                 string(line), nemesis::regex("[^0-9]*([0-9]+).*"), string("\\1"));
+                    rootID = string(header.name);
                 }
 
                 fileline.push_back(line);
@@ -1892,6 +1975,7 @@ void UpdateFilesStart::CombiningFiles()
             {
                 bool behaviorRef = false;
                 string total     = nemesis::transform_to<string>(filepath) + "\n";
+                VecStr joints;
 
                 writeSave(output, "<?xml version=\"1.0\" encoding=\"ascii\"?>\n", total);
                 writeSave(
@@ -1904,17 +1988,29 @@ void UpdateFilesStart::CombiningFiles()
                 for (auto& line : fileline)
                 {
                     writeSave(output, line + "\n", total);
-                    size_t pos = line.find("<hkobject name=\"");
+                    nemesis::LineClass lineClass = nemesis::ClassifyLine(line);
 
-                    if (pos != NOT_FOUND && line.find("signature=\"", pos) != NOT_FOUND)
+                    if (lineClass.Has(nemesis::LineMarker::Object))
                     {
-                        behaviorRef = line.find("class=\"hkbBehaviorReferenceGenerator\" signature=\"", pos)
-                                      != NOT_FOUND;
+                        nemesis::HkObjectHeader header;
+
+                        if (nemesis::HkObject::ReadHeader(line, header))
+                        {
+                            behaviorRef = header.className == "hkbBehaviorReferenceGenerator";
+                        }
+
+                        continue;
                     }
 
-                    if (behaviorRef && line.find("<hkparam name=\"behaviorName\">") != NOT_FOUND)
+                    string_view param = lineClass.ParamName(line);
+
+                    if (param.empty()) continue;
+
+                    // <hkparam name="behaviorName">Behaviors\0_master.hkx</hkparam>
+                    size_t nextpos = lineClass.Find(nemesis::LineMarker::Param) + 15 + param.length() + 2;
+
+                    if (behaviorRef && param == "behaviorName")
                     {
-                        size_t nextpos = line.find("behaviorName\">") + 14;
                         string behaviorName
                             = GetFileName(line.substr(nextpos, line.find("</hkparam>", nextpos) - nextpos));
                         nemesis::to_lower(behaviorName);
@@ -1924,12 +2020,11 @@ void UpdateFilesStart::CombiningFiles()
                             behaviorName = "_1stperson\\" + behaviorName;
                         }
 
-                        behaviorJoints[behaviorName].push_back(lowerBehaviorFile);
+                        joints.push_back(behaviorName);
                         behaviorRef = false;
                     }
-                    else if (line.find("<hkparam name=\"behaviorFilename\">") != NOT_FOUND)
+                    else if (param == "behaviorFilename")
                     {
-                        size_t nextpos = line.find("behaviorFilename\">") + 18;
                         string behaviorName
                             = line.substr(nextpos, line.find("</hkparam>", nextpos) - nextpos);
                         behaviorName = GetFileName(behaviorName);
@@ -1940,14 +2035,17 @@ void UpdateFilesStart::CombiningFiles()
                             behaviorName = "_1stperson\\" + behaviorName;
                         }
 
-                        behaviorJoints[behaviorName].push_back(lowerBehaviorFile);
+                        joints.push_back(behaviorName);
                     }
                 }
 
                 writeSave(output, "	</hksection>\n\n", total);
                 writeSave(output, "</hkpackfile>\n", total);
                 fileline.clear();
-                (firstPerson ? bigNum2 : bigNum) += CRC32Convert(total);
+
+                auto& state  = updateIndex.behaviors[lowerBehaviorFile];
+                state.crc32  = CRC32Convert(total);
+                state.joints = move(joints);
             }
             else
             {
@@ -1956,10 +2054,34 @@ void UpdateFilesStart::CombiningFiles()
         }
     }
 
+    // in a partial update, the behaviors that were not merged again keep their state from the last update
+    map<string, const nemesis::UpdateIndex::BehaviorState*> mergedBehaviors;
+
+    for (auto& behavior : updateIndex.behaviors)
+    {
+        mergedBehaviors[behavior.first] = &behavior.second;
+    }
+
+    for (auto& behavior : mergedBehaviors)
+    {
+        (behavior.first.find("_1stperson\\") == 0 ? bigNum2 : bigNum) += behavior.second->crc32;
+
+        for (auto& joint : behavior.second->joints)
+        {
+            context.behaviorJoints.Update(joint, [&](VecStr& joints) { joints.push_back(behavior.first); });
+        }
+    }
+
     emit progressUp(); // 28
-    behaviorJointsOutput();
+    behaviorJointsOutput(behaviorManifest);
 
-    if (CreateFolder(compilingfolder))
+    if (!behaviorManifest.Save(nemesis::PathManifest::defaultFile))
+    {
+        ErrorMessage(2009, nemesis::PathManifest::defaultFile);
+    }
+
+    // animation data is only merged in a full update
+    if (!partialUpdate && CreateFolder(compilingfolder))
     {
         wstring filepath = compilingfolder + L"animationdatasinglefile.txt";
         FileWriter output(filepath);
@@ -1984,7 +2106,7 @@ void UpdateFilesStart::CombiningFiles()
     }
     emit progressUp(); // 29
 
-    if (CreateFolder(compilingfolder))
+    if (!partialUpdate && CreateFolder(compilingfolder))
     {
         wstring filepath = compilingfolder + L"animationsetdatasinglefile.txt";
         FileWriter output(filepath);
@@ -2033,7 +2155,7 @@ void UpdateFilesStart::CombiningFiles()
                     outputlist << "\n";
                 }
 
-                bigNum2 += CRC32Convert(total);
+                updateIndex.animSetDataCrc32 = CRC32Convert(total);
             }
             else
             {
@@ -2046,24 +2168,53 @@ void UpdateFilesStart::CombiningFiles()
         }
     }
 
+    bigNum2 += updateIndex.animSetDataCrc32;
     emit progressUp(); // 30
 
-    FileWriter lastmod("cache\\engine_update");
+    nemesis::ChangeManifest lastmod;
 
-    if (lastmod.is_open())
+    if (partialUpdate)
     {
-        lastmod << GetNemesisVersion() << "\n";
-        engineVersion = to_string(bigNum % 10000) + "-" + to_string(bigNum2 % 10000);
-        lastmod << engineVersion << "\n";
+        // files of the unchanged mods and behaviors were not read again
+        lastmod.Load(nemesis::ChangeManifest::defaultFile);
+        lastmod.RemoveFiles([&](const wstring& filepath) {
+            for (auto& modcode : changedMods)
+            {
+                if (filepath.find(L"mod\\" + nemesis::transform_to<wstring>(modcode) + L"\\") == 0) return true;
+            }
+
+            return false;
+        });
+    }
+
+    engineVersion = to_string(bigNum % 10000) + "-" + to_string(bigNum2 % 10000);
+    lastmod.SetVersion(GetNemesisVersion(), engineVersion);
+    lastmod.AddRoot(L"mod");
+    lastmod.AddRoot(L"behavior templates");
+
+    for (auto& it : lastUpdate)
+    {
+        lastmod.AddFile(it.first);
+    }
+
+    if (!lastmod.Save(nemesis::ChangeManifest::defaultFile))
+    {
+        ErrorMessage(2009, nemesis::ChangeManifest::defaultFile);
+    }
+
+    updateIndex.modBehaviors.clear();
 
-        for (auto& it : lastUpdate)
+    for (auto& modcode : modFileList)
+    {
+        for (auto& behavior : modcode.second)
         {
-            lastmod << it.first + L">>" + it.second + L"\n";
+            updateIndex.modBehaviors[modcode.first].insert(behavior.first);
         }
     }
-    else
+
+    if (!updateIndex.Save(nemesis::UpdateIndex::defaultFile))
     {
-        ErrorMessage(2009, "cache\\engine_update");
+        ErrorMessage(2009, nemesis::UpdateIndex::defaultFile);
     }
 
     emit progressUp(); // 31
@@ -2088,6 +2239,9 @@ void UpdateFilesStart::newAnimUpdate(string sourcefolder, string curCode)
 
             if (sf::is_directory(curfolder))
             {
+                // behaviors that are not merged again keep the template nodes of the last update
+                if (!isMergeTarget(nemesis::to_lower_copy(beh))) continue;
+
                 if (nemesis::iequals(beh, "animationdatasinglefile"))
                 {
                     VecStr characterlist;
@@ -2245,6 +2399,109 @@ void UpdateFilesStart::newAnimProcess(string sourcefolder)
     emit progressUp(); // 5
 }
 
+bool UpdateFilesStart::PlanPartialUpdate(const string& directory)
+{
+    partialUpdate = false;
+    changedMods.clear();
+    mergeTargets.clear();
+
+    if (!updateIndex.Load(nemesis::UpdateIndex::defaultFile))
+    {
+        updateIndex.Clear();
+        return false;
+    }
+
+    auto changes  = GetEngineChanges();
+    bool partial  = !changes.outdated && changes.files.size() > 0 && changes.templates.empty();
+    wstring wroot = nemesis::transform_to<wstring>(directory);
+
+    for (auto& file : changes.files)
+    {
+        // a change outside of the patch mods affects every behavior
+        if (file.find(wroot) != 0) partial = false;
+    }
+
+    for (auto& modcode : changes.mods)
+    {
+        if (!partial) break;
+
+        auto itr = updateIndex.modBehaviors.find(modcode);
+
+        if (itr != updateIndex.modBehaviors.end()) mergeTargets.insert(itr->second.begin(), itr->second.end());
+
+        // behaviors the mod touches now
+        string modpath = directory + modcode + "\\";
+        VecStr behaviorlist;
+
+        if (sf::is_directory(modpath)) read_directory(modpath, behaviorlist);
+
+        for (auto& behavior : behaviorlist)
+        {
+            nemesis::to_lower(behavior);
+
+            if (!sf::is_directory(modpath + behavior)) continue;
+
+            if (behavior != "_1stperson")
+            {
+                mergeTargets.insert(behavior);
+                continue;
+            }
+
+            VecStr fbehaviorlist;
+            read_directory(modpath + behavior, fbehaviorlist);
+
+            for (auto& fbehavior : fbehaviorlist)
+            {
+                if (sf::is_directory(modpath + behavior + "\\" + fbehavior))
+                {
+                    mergeTargets.insert(behavior + "\\" + nemesis::to_lower_copy(fbehavior));
+                }
+            }
+        }
+    }
+
+    // animation data is merged as a whole
+    if (mergeTargets.find("animationdatasinglefile") != mergeTargets.end()
+        || mergeTargets.find("animationsetdatasinglefile") != mergeTargets.end())
+    {
+        partial = false;
+    }
+
+    wstring compilingfolder = getTempBhvrPath(nemesisInfo).wstring() + L"\\";
+
+    for (auto& behavior : updateIndex.behaviors)
+    {
+        if (!partial) break;
+
+        if (mergeTargets.find(behavior.first) == mergeTargets.end()
+            && !isFileExist(compilingfolder + nemesis::transform_to<wstring>(behavior.first) + L".txt"))
+        {
+            partial = false;
+        }
+    }
+
+    if (!partial)
+    {
+        mergeTargets.clear();
+        updateIndex.Clear();
+        return false;
+    }
+
+    for (auto& behavior : mergeTargets)
+    {
+        updateIndex.behaviors.erase(behavior);
+    }
+
+    changedMods   = changes.mods;
+    partialUpdate = true;
+    return true;
+}
+
+bool UpdateFilesStart::isMergeTarget(const string& behavior) const
+{
+    return !partialUpdate || mergeTargets.find(behavior) != mergeTargets.end();
+}
+
 void UpdateFilesStart::milestoneStart(string directory)
 {
     m_RunningThread = 1;
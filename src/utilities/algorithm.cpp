@@ -6,147 +6,393 @@
 
 #include "utilities/algorithm.h"
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define ALGORITHM_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 using namespace std;
 
-namespace nemesis
+namespace
 {
-    const char* to_lower_copy(const char* data)
+    template <typename C>
+    constexpr C ascii_upper(C ch) noexcept
+    {
+        return ch >= C('a') && ch <= C('z') ? C(ch - (C('a') - C('A'))) : ch;
+    }
+
+#ifdef ALGORITHM_SSE2
+    // 'A' to 'Z' get 0x20 added, every other byte is kept; bytes above 0x7f are negative and never in range
+    __m128i LowerBlock(__m128i block)
+    {
+        const __m128i before = _mm_set1_epi8('A' - 1);
+        const __m128i after  = _mm_set1_epi8('Z' + 1);
+        const __m128i bit    = _mm_set1_epi8(0x20);
+        __m128i upper        = _mm_and_si128(_mm_cmpgt_epi8(block, before), _mm_cmplt_epi8(block, after));
+        return _mm_or_si128(block, _mm_and_si128(upper, bit));
+    }
+
+    __m128i UpperBlock(__m128i block)
     {
-        char* temp = _strdup(data);
-        int size   = strlen(data);
-        int i      = 0;
+        const __m128i before = _mm_set1_epi8('a' - 1);
+        const __m128i after  = _mm_set1_epi8('z' + 1);
+        const __m128i bit    = _mm_set1_epi8(0x20);
+        __m128i lower        = _mm_and_si128(_mm_cmpgt_epi8(block, before), _mm_cmplt_epi8(block, after));
+        return _mm_xor_si128(block, _mm_and_si128(lower, bit));
+    }
 
-        while (i < size)
+    __m128i Load(const char* data)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    }
+
+    unsigned int LowestBit(unsigned int bits)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, bits);
+        return index;
+#else
+        return __builtin_ctz(bits);
+#endif
+    }
+
+    unsigned int HighestBit(unsigned int bits)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse(&index, bits);
+        return index;
+#else
+        return 31 - __builtin_clz(bits);
+#endif
+    }
+#endif
+
+    template <typename C, typename F>
+    void Transform(basic_string<C>& data, F convert)
+    {
+        for (auto& ch : data)
         {
-            temp[i] = tolower(temp[i]);
-            i++;
+            ch = convert(ch);
         }
+    }
 
-        return temp;
+    void LowerInPlace(string& data)
+    {
+        size_t i = 0;
+
+#ifdef ALGORITHM_SSE2
+        for (; i + 16 <= data.size(); i += 16)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&data[i]), LowerBlock(Load(&data[i])));
+        }
+#endif
+
+        for (; i < data.size(); ++i)
+        {
+            data[i] = nemesis::ascii_lower(data[i]);
+        }
     }
 
-    const wchar_t* to_lower_copy(const wchar_t* data)
+    void UpperInPlace(string& data)
     {
-        wchar_t* temp = _wcsdup(data);
-        int size      = wcslen(data);
-        int i         = 0;
+        size_t i = 0;
 
-        while (i < size)
+#ifdef ALGORITHM_SSE2
+        for (; i + 16 <= data.size(); i += 16)
         {
-            temp[i] = tolower(temp[i]);
-            i++;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&data[i]), UpperBlock(Load(&data[i])));
         }
+#endif
 
-        return temp;
+        for (; i < data.size(); ++i)
+        {
+            data[i] = ascii_upper(data[i]);
+        }
     }
 
-    string to_lower_copy(const string& data)
+    // same length is checked by the caller
+    bool EqualsFolded(const char* l, const char* r, size_t size) noexcept
     {
-        return to_lower_copy(data.c_str());
+        size_t i = 0;
+
+#ifdef ALGORITHM_SSE2
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i equal = _mm_cmpeq_epi8(LowerBlock(Load(l + i)), LowerBlock(Load(r + i)));
+
+            if (_mm_movemask_epi8(equal) != 0xffff) return false;
+        }
+#endif
+
+        for (; i < size; ++i)
+        {
+            if (nemesis::ascii_lower(l[i]) != nemesis::ascii_lower(r[i])) return false;
+        }
+
+        return true;
     }
 
-    wstring to_lower_copy(const wstring& data)
+    bool EqualsFolded(const wchar_t* l, const wchar_t* r, size_t size) noexcept
     {
-        return to_lower_copy(data.c_str());
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (nemesis::ascii_lower(l[i]) != nemesis::ascii_lower(r[i])) return false;
+        }
+
+        return true;
     }
 
-    void to_lower(string& data)
+    // candidates are the positions holding the first letter of word in either case
+    size_t FindFolded(string_view text, string_view word, size_t pos) noexcept
     {
-        data = to_lower_copy(data.c_str());
+        if (word.empty()) return pos <= text.size() ? pos : string_view::npos;
+
+        if (word.size() > text.size()) return string_view::npos;
+
+        size_t last = text.size() - word.size();
+        char first  = nemesis::ascii_lower(word[0]);
+        char other  = ascii_upper(first);
+
+#ifdef ALGORITHM_SSE2
+        const __m128i lower = _mm_set1_epi8(first);
+        const __m128i upper = _mm_set1_epi8(other);
+
+        for (; pos + 16 <= last + 1; pos += 16)
+        {
+            __m128i block = Load(text.data() + pos);
+            unsigned int bits
+                = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, lower), _mm_cmpeq_epi8(block, upper)));
+
+            while (bits != 0)
+            {
+                size_t offset = LowestBit(bits);
+
+                if (EqualsFolded(text.data() + pos + offset + 1, word.data() + 1, word.size() - 1))
+                {
+                    return pos + offset;
+                }
+
+                bits &= bits - 1;
+            }
+        }
+#endif
+
+        for (; pos <= last; ++pos)
+        {
+            if ((text[pos] == first || text[pos] == other)
+                && EqualsFolded(text.data() + pos + 1, word.data() + 1, word.size() - 1))
+            {
+                return pos;
+            }
+        }
+
+        return string_view::npos;
     }
 
-    void to_lower(wstring& data)
+    size_t FindFolded(wstring_view text, wstring_view word, size_t pos) noexcept
     {
-        data = to_lower_copy(data.c_str());
+        if (word.empty()) return pos <= text.size() ? pos : wstring_view::npos;
+
+        if (word.size() > text.size()) return wstring_view::npos;
+
+        for (size_t last = text.size() - word.size(); pos <= last; ++pos)
+        {
+            if (EqualsFolded(text.data() + pos, word.data(), word.size())) return pos;
+        }
+
+        return wstring_view::npos;
     }
 
-    const char* to_upper_copy(const char* data)
+    // same candidates as FindFolded, from the last one backwards
+    size_t ReverseFindFolded(string_view text, string_view word) noexcept
     {
-        char* temp = _strdup(data);
-        int size   = strlen(data);
-        int i      = 0;
+        if (word.size() > text.size()) return string_view::npos;
+
+        if (word.empty()) return text.size();
+
+        size_t end = text.size() - word.size() + 1;
+        char first = nemesis::ascii_lower(word[0]);
+        char other = ascii_upper(first);
 
-        while (i < size)
+#ifdef ALGORITHM_SSE2
+        const __m128i lower = _mm_set1_epi8(first);
+        const __m128i upper = _mm_set1_epi8(other);
+
+        for (; end >= 16; end -= 16)
         {
-            temp[i] = toupper(temp[i]);
-            i++;
+            __m128i block = Load(text.data() + end - 16);
+            unsigned int bits
+                = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, lower), _mm_cmpeq_epi8(block, upper)));
+
+            while (bits != 0)
+            {
+                unsigned int offset = HighestBit(bits);
+                size_t pos          = end - 16 + offset;
+
+                if (EqualsFolded(text.data() + pos + 1, word.data() + 1, word.size() - 1)) return pos;
+
+                bits &= ~(1u << offset);
+            }
+        }
+#endif
+
+        for (size_t pos = end; pos-- > 0;)
+        {
+            if ((text[pos] == first || text[pos] == other)
+                && EqualsFolded(text.data() + pos + 1, word.data() + 1, word.size() - 1))
+            {
+                return pos;
+            }
         }
 
-        return temp;
+        return string_view::npos;
     }
 
-    const wchar_t* to_upper_copy(const wchar_t* data)
+    size_t ReverseFindFolded(wstring_view text, wstring_view word) noexcept
     {
-        wchar_t* temp = _wcsdup(data);
-        int size      = wcslen(data);
-        int i         = 0;
+        if (word.size() > text.size()) return wstring_view::npos;
 
-        while (i < size)
+        for (size_t pos = text.size() - word.size() + 1; pos-- > 0;)
         {
-            temp[i] = toupper(temp[i]);
-            i++;
+            if (EqualsFolded(text.data() + pos, word.data(), word.size())) return pos;
         }
 
-        return temp;
+        return wstring_view::npos;
+    }
+
+    template <typename C>
+    bool HasAlpha(basic_string_view<C> text) noexcept
+    {
+        for (C ch : text)
+        {
+            if (nemesis::ascii_lower(ch) != ascii_upper(ch)) return true;
+        }
+
+        return false;
+    }
+} // namespace
+
+namespace nemesis
+{
+    string to_lower_copy(const char* data)
+    {
+        string copy(data);
+        LowerInPlace(copy);
+        return copy;
+    }
+
+    wstring to_lower_copy(const wchar_t* data)
+    {
+        wstring copy(data);
+        Transform(copy, [](wchar_t ch) { return ascii_lower(ch); });
+        return copy;
+    }
+
+    string to_lower_copy(const string& data)
+    {
+        string copy(data);
+        LowerInPlace(copy);
+        return copy;
+    }
+
+    wstring to_lower_copy(const wstring& data)
+    {
+        wstring copy(data);
+        Transform(copy, [](wchar_t ch) { return ascii_lower(ch); });
+        return copy;
+    }
+
+    void to_lower(string& data)
+    {
+        LowerInPlace(data);
+    }
+
+    void to_lower(wstring& data)
+    {
+        Transform(data, [](wchar_t ch) { return ascii_lower(ch); });
+    }
+
+    string to_upper_copy(const char* data)
+    {
+        string copy(data);
+        UpperInPlace(copy);
+        return copy;
+    }
+
+    wstring to_upper_copy(const wchar_t* data)
+    {
+        wstring copy(data);
+        Transform(copy, [](wchar_t ch) { return ascii_upper(ch); });
+        return copy;
     }
 
     string to_upper_copy(const string& data)
     {
-        return to_upper_copy(data.c_str());
+        string copy(data);
+        UpperInPlace(copy);
+        return copy;
     }
 
     wstring to_upper_copy(const wstring& data)
     {
-        return to_upper_copy(data.c_str());
+        wstring copy(data);
+        Transform(copy, [](wchar_t ch) { return ascii_upper(ch); });
+        return copy;
     }
 
     void to_upper(string& data)
     {
-        data = to_upper_copy(data.c_str());
+        UpperInPlace(data);
     }
 
     void to_upper(wstring& data)
     {
-        data = to_upper_copy(data.c_str());
+        Transform(data, [](wchar_t ch) { return ascii_upper(ch); });
     }
 
-    bool iequals(const char* l, const char* r)
+    bool iequals(string_view l, string_view r) noexcept
     {
-        return strcmp(to_lower_copy(l), to_lower_copy(r)) == 0;
+        return l.size() == r.size() && EqualsFolded(l.data(), r.data(), l.size());
     }
 
-    bool iequals(const wchar_t* l, const wchar_t* r)
+    bool iequals(wstring_view l, wstring_view r) noexcept
     {
-        return wcscmp(to_lower_copy(l), to_lower_copy(r)) == 0;
+        return l.size() == r.size() && EqualsFolded(l.data(), r.data(), l.size());
     }
 
-    bool iequals(const char* l, const string& r)
+    size_t ifind(string_view text, string_view word, size_t pos) noexcept
     {
-        return strcmp(to_lower_copy(l), to_lower_copy(r.c_str())) == 0;
+        return FindFolded(text, word, pos);
     }
 
-    bool iequals(const wchar_t* l, const wstring& r)
+    size_t ifind(wstring_view text, wstring_view word, size_t pos) noexcept
     {
-        return wcscmp(to_lower_copy(l), to_lower_copy(r.c_str())) == 0;
+        return FindFolded(text, word, pos);
     }
 
-    bool iequals(const string& l, const char* r)
+    size_t irfind(string_view text, string_view word) noexcept
     {
-        return strcmp(to_lower_copy(l.c_str()), to_lower_copy(r)) == 0;
+        return ReverseFindFolded(text, word);
     }
 
-    bool iequals(const wstring& l, const wchar_t* r)
+    size_t irfind(wstring_view text, wstring_view word) noexcept
     {
-        return wcscmp(to_lower_copy(l.c_str()), to_lower_copy(r)) == 0;
+        return ReverseFindFolded(text, word);
     }
 
-    bool iequals(const string& l, const string& r)
+    bool has_alpha(string_view text) noexcept
     {
-        return strcmp(to_lower_copy(l.c_str()), to_lower_copy(r.c_str())) == 0;
+        return HasAlpha(text);
     }
 
-    bool iequals(const wstring& l, const wstring& r)
+    bool has_alpha(wstring_view text) noexcept
     {
-        return wcscmp(to_lower_copy(l.c_str()), to_lower_copy(r.c_str())) == 0;
+        return HasAlpha(text);
     }
 } // namespace nemesis
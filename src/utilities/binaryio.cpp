@@ -0,0 +1,243 @@
+#include <fstream>
+#include <utility>
+
+#include <QtCore/QFile.h>
+
+#include "utilities/binaryio.h"
+
+using namespace std;
+
+namespace sf = filesystem;
+
+nemesis::BinaryWriter::BinaryWriter(const sf::path& _filepath, uint32_t magic, uint32_t version)
+    : filepath(_filepath)
+{
+    buffer.reserve(4096);
+    Write(magic);
+    Write(version);
+}
+
+void nemesis::BinaryWriter::WriteBytes(const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void nemesis::BinaryWriter::WriteString(string_view str)
+{
+    Write(uint32_t(str.length()));
+    WriteBytes(str.data(), str.length());
+}
+
+void nemesis::BinaryWriter::WriteString(wstring_view str)
+{
+    Write(uint32_t(str.length()));
+    WriteBytes(str.data(), str.length() * sizeof(wchar_t));
+}
+
+size_t nemesis::BinaryWriter::Size() const
+{
+    return buffer.size();
+}
+
+bool nemesis::BinaryWriter::Commit()
+{
+    sf::path temppath = filepath;
+    temppath += L".tmp";
+    error_code ec;
+
+    if (filepath.has_parent_path()) sf::create_directories(filepath.parent_path(), ec);
+
+    {
+        ofstream output(temppath, ios::binary | ios::trunc);
+
+        if (!output.is_open()) return false;
+
+        output.write(buffer.data(), buffer.size());
+
+        if (!output.good()) return false;
+    }
+
+    sf::rename(temppath, filepath, ec);
+
+    if (!ec) return true;
+
+    sf::remove(temppath, ec);
+    return false;
+}
+
+nemesis::BinaryReader::BinaryReader(const sf::path& filepath, uint32_t magic, uint32_t version)
+{
+    ifstream input(filepath, ios::binary | ios::ate);
+
+    if (!input.is_open()) return;
+
+    streamoff size = input.tellg();
+
+    if (size < streamoff(sizeof(uint32_t) * 2)) return;
+
+    buffer.resize(size_t(size));
+    input.seekg(0);
+
+    if (!input.read(buffer.data(), size)) return;
+
+    data       = buffer.data();
+    this->size = buffer.size();
+    Validate(magic, version);
+}
+
+nemesis::BinaryReader::BinaryReader(const MappedFile& file, uint32_t magic, uint32_t version)
+    : data(file.Data())
+    , size(file.Size())
+{
+    if (size < sizeof(uint32_t) * 2) return;
+
+    Validate(magic, version);
+}
+
+void nemesis::BinaryReader::Validate(uint32_t magic, uint32_t version)
+{
+    uint32_t filemagic;
+    uint32_t fileversion;
+    valid = true;
+
+    if (!Read(filemagic) || !Read(fileversion) || filemagic != magic || fileversion != version) valid = false;
+}
+
+bool nemesis::BinaryReader::IsValid() const
+{
+    return valid;
+}
+
+bool nemesis::BinaryReader::AtEnd() const
+{
+    return pos >= size;
+}
+
+size_t nemesis::BinaryReader::Remaining() const
+{
+    return valid ? size - pos : 0;
+}
+
+bool nemesis::BinaryReader::ReadBytes(void* data, size_t size)
+{
+    if (!valid || this->size - pos < size)
+    {
+        valid = false;
+        return false;
+    }
+
+    memcpy(data, this->data + pos, size);
+    pos += size;
+    return true;
+}
+
+bool nemesis::BinaryReader::ReadString(string& str)
+{
+    uint32_t length;
+
+    if (!Read(length) || size - pos < length)
+    {
+        valid = false;
+        return false;
+    }
+
+    str.assign(data + pos, length);
+    pos += length;
+    return true;
+}
+
+bool nemesis::BinaryReader::ReadString(wstring& str)
+{
+    uint32_t length;
+
+    if (!Read(length) || (size - pos) / sizeof(wchar_t) < length)
+    {
+        valid = false;
+        return false;
+    }
+
+    str.resize(length);
+    memcpy(str.data(), data + pos, length * sizeof(wchar_t));
+    pos += length * sizeof(wchar_t);
+    return true;
+}
+
+nemesis::MappedFile::MappedFile() = default;
+
+nemesis::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : file(move(other.file))
+    , data(exchange(other.data, nullptr))
+    , size(exchange(other.size, 0))
+{
+}
+
+nemesis::MappedFile& nemesis::MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        file = move(other.file);
+        data = exchange(other.data, nullptr);
+        size = exchange(other.size, 0);
+    }
+
+    return *this;
+}
+
+nemesis::MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool nemesis::MappedFile::Open(const sf::path& filepath)
+{
+    Close();
+    file = make_unique<QFile>(QString::fromStdWString(filepath.wstring()));
+
+    if (!file->open(QIODevice::ReadOnly) || file->size() == 0)
+    {
+        file.reset();
+        return false;
+    }
+
+    data = reinterpret_cast<const char*>(file->map(0, file->size()));
+
+    if (!data)
+    {
+        file.reset();
+        return false;
+    }
+
+    size = size_t(file->size());
+    return true;
+}
+
+void nemesis::MappedFile::Close()
+{
+    if (file)
+    {
+        if (data) file->unmap(reinterpret_cast<uchar*>(const_cast<char*>(data)));
+
+        file->close();
+        file.reset();
+    }
+
+    data = nullptr;
+    size = 0;
+}
+
+bool nemesis::MappedFile::IsOpen() const
+{
+    return data != nullptr;
+}
+
+const char* nemesis::MappedFile::Data() const
+{
+    return data;
+}
+
+size_t nemesis::MappedFile::Size() const
+{
+    return size;
+}
@@ -0,0 +1,410 @@
+#include "Global.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "utilities/binaryio.h"
+#include "utilities/threadpool.h"
+#include "utilities/xxhash64.h"
+#include "utilities/changemanifest.h"
+
+using namespace std;
+
+namespace sf = filesystem;
+
+namespace
+{
+    constexpr uint32_t manifestMagic   = 0x5055454e; // "NEUP"
+    constexpr uint32_t manifestVersion = 3;
+    constexpr size_t statBatch         = 512;
+
+    const wstring modRoot      = L"mod\\";
+    const wstring templateRoot = L"behavior templates\\";
+
+    bool isVortexFolder(const wstring& name)
+    {
+        return nemesis::ifind(name, L"folder_managed_by_vortex") != NOT_FOUND;
+    }
+
+    bool GetFileState(const wstring& filepath, uint64_t& size, int64_t& mtime)
+    {
+        error_code ec;
+        sf::directory_entry entry(filepath, ec);
+
+        if (ec || !entry.is_regular_file(ec)) return false;
+
+        size  = entry.file_size(ec);
+        mtime = entry.last_write_time(ec).time_since_epoch().count();
+        return !ec;
+    }
+
+    int64_t GetFolderTime(const wstring& directory)
+    {
+        error_code ec;
+        int64_t mtime = sf::last_write_time(directory, ec).time_since_epoch().count();
+        return ec ? -1 : mtime;
+    }
+
+    // runs func(begin, end) over [0, count) in batches on every thread
+    template <typename F>
+    void ParallelBatches(size_t count, size_t batch, F&& func)
+    {
+        if (count == 0) return;
+
+        nemesis::ThreadPool tp;
+        vector<future<void>> jobs;
+
+        for (size_t begin = 0; begin < count; begin += batch)
+        {
+            size_t end = (std::min)(begin + batch, count);
+            jobs.emplace_back(tp.enqueue([&func, begin, end]() { func(begin, end); }));
+        }
+
+        tp.join_all();
+
+        if (error) throw nemesis::exception();
+
+        for (auto& job : jobs)
+        {
+            job.get();
+        }
+    }
+
+    void AddChange(const wstring& filepath, nemesis::ChangeManifest::ChangeSet& changes)
+    {
+        changes.files.push_back(filepath);
+
+        for (auto* root : {&modRoot, &templateRoot})
+        {
+            if (filepath.compare(0, root->length(), *root) != 0) continue;
+
+            size_t pos = filepath.find(L'\\', root->length());
+
+            if (pos == NOT_FOUND) continue;
+
+            string group = nemesis::transform_to<string>(filepath.substr(root->length(), pos - root->length()));
+            (root == &modRoot ? changes.mods : changes.templates).insert(group);
+        }
+    }
+
+    // every tracked file under a folder that did not exist during the last update
+    void FindNewFiles(const wstring& directory,
+                      const nemesis::ChangeManifest::TrackFilter& isTracked,
+                      const unordered_set<wstring>& recordedFolders,
+                      const unordered_set<wstring>& recordedFiles,
+                      bool recursive,
+                      vector<wstring>& found)
+    {
+        error_code ec;
+
+        for (sf::directory_iterator itr(directory, ec), end; !ec && itr != end; itr.increment(ec))
+        {
+            wstring name = itr->path().filename().wstring();
+
+            if (isVortexFolder(name)) continue;
+
+            wstring path = directory + L"\\" + nemesis::to_lower_copy(name);
+            error_code entryec;
+
+            if (itr->is_directory(entryec))
+            {
+                if (recursive || recordedFolders.find(path) == recordedFolders.end())
+                {
+                    FindNewFiles(path, isTracked, recordedFolders, recordedFiles, true, found);
+                }
+            }
+            else if (isTracked(directory, name) && recordedFiles.find(path) == recordedFiles.end())
+            {
+                found.push_back(path);
+            }
+        }
+    }
+} // namespace
+
+void nemesis::ChangeManifest::SetVersion(const string& _nemesisVersion, const string& _engineVersion)
+{
+    nemesisVersion = _nemesisVersion;
+    engineVersion  = _engineVersion;
+}
+
+void nemesis::ChangeManifest::AddFile(const wstring& filepath)
+{
+    files.push_back(FileRecord{filepath, 0, 0, 0});
+}
+
+void nemesis::ChangeManifest::AddRoot(const wstring& directory)
+{
+    roots.push_back(nemesis::to_lower_copy(directory));
+}
+
+void nemesis::ChangeManifest::RemoveFiles(const function<bool(const wstring&)>& match)
+{
+    files.erase(remove_if(files.begin(), files.end(), [&](const FileRecord& record) { return match(record.path); }),
+                files.end());
+}
+
+bool nemesis::ChangeManifest::Save(const sf::path& filepath, bool hashContent)
+{
+    sort(files.begin(), files.end(), [](const FileRecord& l, const FileRecord& r) { return l.path < r.path; });
+    files.erase(unique(files.begin(),
+                       files.end(),
+                       [](const FileRecord& l, const FileRecord& r) { return l.path == r.path; }),
+                files.end());
+
+    // a file with the size and modified time the last manifest has for it keeps the hash recorded there
+    unordered_map<wstring, const FileRecord*> previous;
+    ChangeManifest last;
+
+    if (hashContent && last.Load(filepath))
+    {
+        previous.reserve(last.files.size());
+
+        for (auto& record : last.files)
+        {
+            if (record.hash != 0) previous.emplace(record.path, &record);
+        }
+    }
+
+    ParallelBatches(files.size(), statBatch, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            FileRecord& record = files[i];
+            record.hash        = 0;
+
+            if (!GetFileState(record.path, record.size, record.mtime))
+            {
+                record.size  = 0;
+                record.mtime = -1;
+                continue;
+            }
+
+            if (!hashContent) continue;
+
+            auto itr = previous.find(record.path);
+
+            if (itr != previous.end() && itr->second->size == record.size && itr->second->mtime == record.mtime)
+            {
+                record.hash = itr->second->hash;
+            }
+            else
+            {
+                record.hash = HashFile(record.path);
+            }
+        }
+    });
+
+    folders.clear();
+
+    for (auto& root : roots)
+    {
+        RecordFolder(root);
+    }
+
+    BinaryWriter output(filepath, manifestMagic, manifestVersion);
+    output.WriteString(nemesisVersion);
+    output.WriteString(engineVersion);
+    output.Write(uint64_t(files.size()));
+
+    for (auto& record : files)
+    {
+        output.WriteString(record.path);
+        output.Write(record.size);
+        output.Write(record.mtime);
+        output.Write(record.hash);
+    }
+
+    output.Write(uint64_t(folders.size()));
+
+    for (auto& record : folders)
+    {
+        output.WriteString(record.path);
+        output.Write(record.mtime);
+    }
+
+    return output.Commit();
+}
+
+bool nemesis::ChangeManifest::Load(const sf::path& filepath)
+{
+    BinaryReader input(filepath, manifestMagic, manifestVersion);
+    uint64_t count;
+    files.clear();
+    folders.clear();
+
+    // path length, size, mtime and hash of each file
+    if (!input.ReadString(nemesisVersion) || !input.ReadString(engineVersion)
+        || !input.ReadCount(count, sizeof(uint32_t) + sizeof(uint64_t) + sizeof(int64_t) + sizeof(uint64_t)))
+    {
+        return false;
+    }
+
+    files.resize(size_t(count));
+
+    for (auto& record : files)
+    {
+        if (!input.ReadString(record.path) || !input.Read(record.size) || !input.Read(record.mtime)
+            || !input.Read(record.hash))
+        {
+            return false;
+        }
+    }
+
+    if (!input.ReadCount(count, sizeof(uint32_t) + sizeof(int64_t))) return false;
+
+    folders.resize(size_t(count));
+
+    for (auto& record : folders)
+    {
+        if (!input.ReadString(record.path) || !input.Read(record.mtime)) return false;
+    }
+
+    return true;
+}
+
+const string& nemesis::ChangeManifest::GetNemesisVersion() const
+{
+    return nemesisVersion;
+}
+
+const string& nemesis::ChangeManifest::GetEngineVersion() const
+{
+    return engineVersion;
+}
+
+nemesis::ChangeManifest::ChangeSet nemesis::ChangeManifest::GetChanges(const TrackFilter& isTracked,
+                                                                       bool stopAtFirst) const
+{
+    ChangeSet changes;
+    atomic<bool> stop = false;
+    mutex changeMutex;
+    vector<wstring> changed;
+
+    auto report = [&](vector<wstring>& list, bool isNew) {
+        if (list.empty()) return;
+
+        lock_guard<mutex> lock(changeMutex);
+        changed.insert(changed.end(), list.begin(), list.end());
+
+        if (isNew) changes.added.insert(list.begin(), list.end());
+
+        if (stopAtFirst) stop = true;
+    };
+
+    ParallelBatches(files.size(), statBatch, [&](size_t begin, size_t end) {
+        vector<wstring> list;
+
+        for (size_t i = begin; i < end && !stop; ++i)
+        {
+            const FileRecord& record = files[i];
+            uint64_t size;
+            int64_t mtime;
+
+            if (!GetFileState(record.path, size, mtime))
+            {
+                // removed since the last update
+                if (record.mtime != -1) list.push_back(record.path);
+            }
+            else if (size != record.size
+                     || (mtime != record.mtime && (record.hash == 0 || HashFile(record.path) != record.hash)))
+            {
+                // a changed time alone is not a change if the content is the same
+                list.push_back(record.path);
+            }
+
+            if (stopAtFirst && !list.empty()) break;
+        }
+
+        report(list, false);
+    });
+
+    if (!stop)
+    {
+        unordered_set<wstring> recordedFiles;
+        unordered_set<wstring> recordedFolders;
+        recordedFiles.reserve(files.size());
+        recordedFolders.reserve(folders.size());
+
+        for (auto& record : files)
+        {
+            recordedFiles.insert(record.path);
+        }
+
+        for (auto& record : folders)
+        {
+            recordedFolders.insert(record.path);
+        }
+
+        // a folder only gets a new modified time when an entry is added, removed or renamed directly inside it
+        ParallelBatches(folders.size(), statBatch, [&](size_t begin, size_t end) {
+            vector<wstring> list;
+
+            for (size_t i = begin; i < end && !stop; ++i)
+            {
+                int64_t mtime = GetFolderTime(folders[i].path);
+
+                if (mtime == folders[i].mtime || mtime == -1) continue;
+
+                FindNewFiles(folders[i].path, isTracked, recordedFolders, recordedFiles, false, list);
+
+                if (stopAtFirst && !list.empty()) break;
+            }
+
+            report(list, true);
+        });
+    }
+
+    sort(changed.begin(), changed.end());
+
+    for (auto& file : changed)
+    {
+        AddChange(file, changes);
+    }
+
+    return changes;
+}
+
+uint64_t nemesis::ChangeManifest::HashFile(const wstring& filepath)
+{
+    FILE* f;
+    _wfopen_s(&f, filepath.c_str(), L"rb");
+
+    if (!f) return 0;
+
+    // XXH64 of the content; never 0 so 0 can mean "not hashed"
+    // sizes are compared before hashes, the hash only has to tell apart files of the same size
+    XXHash64 hasher;
+    unsigned char buffer[65536];
+    size_t length;
+
+    while ((length = fread(buffer, 1, sizeof(buffer), f)) > 0)
+    {
+        hasher.Update(buffer, length);
+    }
+
+    uint64_t hash = hasher.Digest();
+    fclose(f);
+    return hash == 0 ? 1 : hash;
+}
+
+void nemesis::ChangeManifest::RecordFolder(const sf::path& directory)
+{
+    int64_t mtime = GetFolderTime(directory.wstring());
+
+    if (mtime == -1) return;
+
+    folders.push_back(FolderRecord{directory.wstring(), mtime});
+    error_code ec;
+
+    for (sf::directory_iterator itr(directory, ec), end; !ec && itr != end; itr.increment(ec))
+    {
+        wstring name = itr->path().filename().wstring();
+        error_code entryec;
+
+        if (!isVortexFolder(name) && itr->is_directory(entryec))
+        {
+            RecordFolder(directory.wstring() + L"\\" + nemesis::to_lower_copy(name));
+        }
+    }
+}
@@ -207,18 +207,10 @@ bool nemesis::Condt::isTrue(AnimThreadInfo& animthrinfo,
                     {
                         if (animthrinfo.animMulti == -1 || animthrinfo.multiOption != format)
                         {
-                            size_t a_size = mtOptPick[groupMulti].size();
-
-                            while (animMulti < a_size)
+                            if (mtOptPick[groupMulti].size() > 0)
                             {
-                                auto& opt  = mtOptPick[groupMulti][animMulti];
-                                auto& pick = opt.find((*optioncondt)[3]);
-
-                                result = isNot ? pick == opt.end() : pick != opt.end();
-
-                                if (!result) break;
-
-                                ++animMulti;
+                                result = isNot ? !animthrinfo.masterOptionAny[groupMulti].test(optionIDs[3])
+                                               : animthrinfo.masterOptionAll[groupMulti].test(optionIDs[3]);
                             }
 
                             a_multi = true;
@@ -239,9 +231,7 @@ bool nemesis::Condt::isTrue(AnimThreadInfo& animthrinfo,
 
                     if (!a_multi)
                     {
-                        auto& opt  = mtOptPick[groupMulti][animMulti];
-                        auto& pick = opt.find((*optioncondt)[3]);
-                        result     = isNot ? pick == opt.end() : pick != opt.end();
+                        result = mtOptPick[groupMulti][animMulti].test(optionIDs[3]) != isNot;
                     }
 
                     ++groupMulti;
@@ -298,22 +288,15 @@ bool nemesis::Condt::isTrue(AnimThreadInfo& animthrinfo,
 
             if (multi)
             {
-                animMulti = gpOptPick.size();
-
-                for (size_t i = 0; i < animMulti; ++i)
+                if (gpOptPick.size() > 0)
                 {
-                    auto& opt  = gpOptPick[i];
-                    auto& pick = opt.find((*optioncondt)[2]);
-                    result     = isNot ? pick == opt.end() : pick != opt.end();
-
-                    if (!result) break;
+                    result = isNot ? !animthrinfo.groupOptionAny.test(optionIDs[2])
+                                   : animthrinfo.groupOptionAll.test(optionIDs[2]);
                 }
             }
             else
             {
-                auto& opt  = gpOptPick[animMulti];
-                auto& pick = opt.find((*optioncondt)[2]);
-                result     = isNot ? pick == opt.end() : pick != opt.end();
+                result = gpOptPick[animMulti].test(optionIDs[2]) != isNot;
             }
         }
     }
@@ -413,9 +396,7 @@ bool nemesis::Condt::isMultiTrue(AnimThreadInfo& animinfo,
                 }
 			}
 
-			auto& opt  = animinfo.masterOptionPicked[groupMulti][animMulti];
-            auto& pick = opt.find((*optioncondt)[2]);
-			return pick != opt.end();
+			return animinfo.masterOptionPicked[groupMulti][animMulti].test(optionIDs[2]);
 		}
 		else
 		{
@@ -465,9 +446,7 @@ bool nemesis::Condt::isMultiTrue(AnimThreadInfo& animinfo,
 				return true;
 			}
 
-            auto& opt  = animinfo.groupOptionPicked[animMulti];
-            auto& pick = opt.find((*optioncondt)[2]);
-			return pick != opt.end();
+			return animinfo.groupOptionPicked[animMulti].test(optionIDs[2]);
 		}
 		else
 		{
@@ -903,6 +882,12 @@ void nemesis::Condt::conditionProcess(string condition, string format, string be
 		optioncondt = isGroup ? (isMaster ? make_shared<VecStr>(GetOptionInfo(condition, format + "_master", format, behaviorFile, multiOption, numline)) :
 			make_shared<VecStr>(GetOptionInfo(condition, format + "_group", format, behaviorFile, multiOption, numline))) :
 			make_shared<VecStr>(GetOptionInfo(condition, format, behaviorFile, numline));
+		optionIDs.reserve(optioncondt->size());
+
+		for (auto& each : *optioncondt)
+		{
+			optionIDs.push_back(nemesis::OptionIndex::Intern(each));
+		}
 	}
 
 	if (error) throw nemesis::exception();
@@ -1071,9 +1056,9 @@ void GetMultiFromAddOn(const nemesis::Condt& curcond,
 	}
 	else
 	{
-		unordered_map<string, VecStr>* addOnPtr = &groupAnimInfo[animMulti]->addOn;
+		const unordered_map<string, VecStr>* addOnPtr = &groupAnimInfo[animMulti]->GetOptions().addOn;
 
-		if (addOnPtr->find(addinfo.header) != addOnPtr->end() && (*addOnPtr)[addinfo.header].size() > 0)
+		if (addOnPtr->find(addinfo.header) != addOnPtr->end() && addOnPtr->at(addinfo.header).size() > 0)
 		{
 			unordered_map<string, VecStr>* groupAdditionPtr = &groupAnimInfo[animMulti]->groupAddition[addinfo.header];
 
@@ -6,6 +6,8 @@
 
 #include "utilities/filechecker.h"
 
+#include "generate/generationcontext.h"
+
 using namespace std;
 
 void processFileError(pair<string_view, int> err);
@@ -75,8 +77,9 @@ bool PCEACheck(const NemesisInfo* nemesisInfo)
     return true;
 }
 
-void behaviorActivateMod(VecStr behaviorPriority)
+void behaviorActivateMod(const VecStr& behaviorPriority)
 {
+    auto& activatedBehavior = nemesis::GenerationContext::Current().activatedBehavior;
     unordered_map<string, VecStr>
         behaviorActivator; // modcode, behavior; existence of the behavior in any of these
     string directory = "mod\\";
@@ -0,0 +1,51 @@
+#include <cstring>
+
+#include "utilities/binaryio.h"
+#include "utilities/filedeploy.h"
+
+using namespace std;
+
+namespace sf = filesystem;
+
+bool nemesis::SameContent(const sf::path& file1, const sf::path& file2)
+{
+    error_code ec;
+    uintmax_t size = sf::file_size(file1, ec);
+
+    if (ec || size != sf::file_size(file2, ec) || ec) return false;
+
+    if (size == 0) return true;
+
+    MappedFile content1;
+    MappedFile content2;
+
+    if (!content1.Open(file1) || !content2.Open(file2) || content1.Size() != content2.Size()) return false;
+
+    return memcmp(content1.Data(), content2.Data(), content1.Size()) == 0;
+}
+
+bool nemesis::DeployFile(const sf::path& source, const sf::path& target)
+{
+    if (SameContent(source, target)) return false;
+
+    sf::path temppath = target;
+    temppath += L".tmp";
+    error_code ec;
+
+    if (target.has_parent_path()) sf::create_directories(target.parent_path(), ec);
+
+    sf::copy_file(source, temppath, sf::copy_options::overwrite_existing, ec);
+
+    if (!ec)
+    {
+        sf::rename(temppath, target, ec);
+
+        if (!ec) return true;
+    }
+
+    sf::remove(temppath, ec);
+
+    // the target is in use or the folder refuses the temporary file, a plain copy reports why
+    sf::copy_file(source, target, sf::copy_options::overwrite_existing);
+    return true;
+}
@@ -36,8 +36,9 @@ void saveLastUpdate(const wchar_t* filename, unordered_map<wstring, wstring>& la
 {
     try
     {
+        // file state is taken when the change manifest is saved
         Lockless_s lock(updateLock);
-        lastUpdate[filename] = GetLastModified(filename);
+        lastUpdate.emplace(filename, wstring());
     }
     catch (exception& ex)
     {
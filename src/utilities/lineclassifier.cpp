@@ -0,0 +1,178 @@
+#include "utilities/lineclassifier.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define LINECLASSIFIER_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    bool StartsWith(string_view text, size_t pos, string_view literal)
+    {
+        return text.compare(pos, literal.length(), literal) == 0;
+    }
+
+#ifdef LINECLASSIFIER_SSE2
+    unsigned int LowestBit(unsigned int bits)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, bits);
+        return index;
+#else
+        return __builtin_ctz(bits);
+#endif
+    }
+#endif
+} // namespace
+
+void nemesis::LineClass::Set(LineMarker marker, size_t pos) noexcept
+{
+    if (Has(marker)) return;
+
+    mask |= Bit(marker);
+    positions[static_cast<size_t>(marker)] = static_cast<uint32_t>(pos);
+}
+
+string_view nemesis::LineClass::ParamName(string_view line) const noexcept
+{
+    if (!Has(LineMarker::Param)) return string_view();
+
+    size_t begin = Find(LineMarker::Param) + 15;
+    size_t quote = line.find('"', begin);
+
+    return quote == string_view::npos ? string_view() : line.substr(begin, quote - begin);
+}
+
+nemesis::LineClass nemesis::ClassifyLine(string_view line)
+{
+    LineClass result;
+    bool hash = false;
+
+    auto probe = [&](size_t pos) {
+        switch (line[pos])
+        {
+            case '<':
+            {
+                if (StartsWith(line, pos, "<!--"))
+                {
+                    result.Set(LineMarker::Comment, pos);
+                    size_t next = pos + 4;
+
+                    if (StartsWith(line, next, " *"))
+                    {
+                        result.Set(LineMarker::ModCode, pos);
+                    }
+                    else if (StartsWith(line, next, " NEW *"))
+                    {
+                        result.Set(LineMarker::NewMod, pos);
+                    }
+                    else if (StartsWith(line, next, " NEW ^"))
+                    {
+                        result.Set(LineMarker::NewTemplate, pos);
+                    }
+                    else if (StartsWith(line, next, " FOREACH ^"))
+                    {
+                        result.Set(LineMarker::ForEach, pos);
+                    }
+                    else if (StartsWith(line, next, " ORIGINAL -->"))
+                    {
+                        result.Set(LineMarker::Original, pos);
+                    }
+                    else if (StartsWith(line, next, " CLOSE -->"))
+                    {
+                        result.Set(LineMarker::Close, pos);
+                    }
+                    else if (StartsWith(line, next, " CONDITION"))
+                    {
+                        result.Set(LineMarker::Condition, pos);
+                    }
+                }
+                else if (StartsWith(line, pos, "<hkobject name=\""))
+                {
+                    result.Set(LineMarker::Object, pos);
+                }
+                else if (StartsWith(line, pos, "<hkparam name=\""))
+                {
+                    result.Set(LineMarker::Param, pos);
+                    size_t quote = line.find('"', pos + 15);
+
+                    if (quote != string_view::npos && StartsWith(line, quote + 1, " numelements=\""))
+                    {
+                        result.Set(LineMarker::NumElements, quote + 2);
+                    }
+                }
+                else if (StartsWith(line, pos, "</hkparam>"))
+                {
+                    result.Set(LineMarker::ParamClose, pos);
+                }
+                else if (StartsWith(line, pos, "<hkcstring>"))
+                {
+                    result.Set(LineMarker::CString, pos);
+                }
+
+                break;
+            }
+            case '$':
+            {
+                if (hash) result.Set(LineMarker::TemplateID, pos);
+
+                if (StartsWith(line, pos, "$eventID["))
+                {
+                    result.Set(LineMarker::EventID, pos);
+                }
+                else if (StartsWith(line, pos, "$variableID["))
+                {
+                    result.Set(LineMarker::VariableID, pos);
+                }
+
+                break;
+            }
+            case '#':
+            {
+                hash = true;
+
+                if (pos > 0 && line[pos - 1] == '>') result.Set(LineMarker::Reference, pos - 1);
+
+                break;
+            }
+        }
+    };
+
+    const char* data = line.data();
+    size_t size      = line.size();
+    size_t i         = 0;
+
+#ifdef LINECLASSIFIER_SSE2
+    const __m128i open   = _mm_set1_epi8('<');
+    const __m128i dollar = _mm_set1_epi8('$');
+    const __m128i sharp  = _mm_set1_epi8('#');
+
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hit   = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, open), _mm_cmpeq_epi8(block, dollar)),
+                                   _mm_cmpeq_epi8(block, sharp));
+        unsigned int bits = static_cast<unsigned int>(_mm_movemask_epi8(hit));
+
+        while (bits != 0)
+        {
+            probe(i + LowestBit(bits));
+            bits &= bits - 1;
+        }
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        if (data[i] == '<' || data[i] == '$' || data[i] == '#') probe(i);
+    }
+
+    return result;
+}
@@ -0,0 +1,87 @@
+#include "debugmsg.h"
+
+#include "utilities/memorybudget.h"
+
+using namespace std;
+
+nemesis::MemoryBudget::Ticket::Ticket(MemoryBudget* _budget, size_t _bytes)
+    : budget(_budget)
+    , bytes(_bytes)
+{
+}
+
+nemesis::MemoryBudget::Ticket::Ticket(Ticket&& other) noexcept
+    : budget(other.budget)
+    , bytes(other.bytes)
+{
+    other.budget = nullptr;
+}
+
+nemesis::MemoryBudget::Ticket& nemesis::MemoryBudget::Ticket::operator=(Ticket&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (budget) budget->Release(bytes);
+
+        budget       = other.budget;
+        bytes        = other.bytes;
+        other.budget = nullptr;
+    }
+
+    return *this;
+}
+
+nemesis::MemoryBudget::Ticket::~Ticket()
+{
+    if (budget) budget->Release(bytes);
+}
+
+nemesis::MemoryBudget& nemesis::MemoryBudget::Instance()
+{
+    static MemoryBudget budget;
+    return budget;
+}
+
+void nemesis::MemoryBudget::SetLimit(size_t limit_bytes)
+{
+    {
+        lock_guard<mutex> guard(lock);
+        limit = limit_bytes;
+    }
+
+    released.notify_all();
+}
+
+size_t nemesis::MemoryBudget::GetLimit() const
+{
+    lock_guard<mutex> guard(lock);
+    return limit;
+}
+
+nemesis::MemoryBudget::Ticket nemesis::MemoryBudget::Acquire(size_t bytes)
+{
+    unique_lock<mutex> guard(lock);
+
+    if (limit == 0) return Ticket();
+
+    // nothing signals an error to the waiting threads, so they check their run's flag every now and then
+    while (!error && count > 0 && used + bytes > limit)
+    {
+        released.wait_for(guard, chrono::milliseconds(100));
+    }
+
+    used += bytes;
+    ++count;
+    return Ticket(this, bytes);
+}
+
+void nemesis::MemoryBudget::Release(size_t bytes)
+{
+    {
+        lock_guard<mutex> guard(lock);
+        used -= bytes;
+        --count;
+    }
+
+    released.notify_all();
+}
@@ -0,0 +1,67 @@
+#include <cstdint>
+
+#include "utilities/naturalkey.h"
+
+using namespace std;
+
+namespace
+{
+    // ascii order of the word sort, from the first weight up; upper case letters share the lower case weight
+    constexpr char sortOrder[] = " !\"#$%&()*,./:;?@[\\]^_`{|}~+<=>0123456789abcdefghijklmnopqrstuvwxyz";
+
+    // 0 for the characters the first pass leaves out
+    struct WeightTable
+    {
+        uint8_t weights[256] = {};
+
+        WeightTable()
+        {
+            for (size_t i = 0; i + 1 < sizeof(sortOrder); ++i)
+            {
+                weights[static_cast<unsigned char>(sortOrder[i])] = uint8_t(i + 1);
+            }
+
+            for (int ch = 'A'; ch <= 'Z'; ++ch)
+            {
+                weights[ch] = weights[ch + ('a' - 'A')];
+            }
+
+            for (int ch = 0x80; ch < 0x100; ++ch)
+            {
+                weights[ch] = uint8_t(ch);
+            }
+        }
+    };
+
+    const WeightTable table;
+} // namespace
+
+nemesis::NaturalKey::NaturalKey(string_view str)
+{
+    // weights of the first pass, a 0 separator, the number of characters it left out and the case folded string
+    // strings equal in the first pass sort the one with fewer hyphens or apostrophes first, and only strings equal
+    // but for case get the same key
+    packed.reserve(str.length() * 2 + 2);
+    size_t ignored = 0;
+
+    for (char ch : str)
+    {
+        uint8_t weight = table.weights[static_cast<unsigned char>(ch)];
+
+        if (weight == 0)
+        {
+            ++ignored;
+            continue;
+        }
+
+        packed.push_back(char(weight));
+    }
+
+    packed.push_back('\0');
+    packed.push_back(char(ignored < 0xff ? ignored + 1 : 0xff));
+
+    for (char ch : str)
+    {
+        packed.push_back(ch >= 'A' && ch <= 'Z' ? ch + ('a' - 'A') : ch);
+    }
+}
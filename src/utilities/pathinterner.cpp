@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+#include "utilities/algorithm.h"
+#include "utilities/pathinterner.h"
+
+using namespace std;
+
+namespace
+{
+    void AppendUtf8(string& out, uint32_t code)
+    {
+        if (code < 0x80)
+        {
+            out.push_back(char(code));
+        }
+        else if (code < 0x800)
+        {
+            out.push_back(char(0xc0 | (code >> 6)));
+            out.push_back(char(0x80 | (code & 0x3f)));
+        }
+        else if (code < 0x10000)
+        {
+            out.push_back(char(0xe0 | (code >> 12)));
+            out.push_back(char(0x80 | ((code >> 6) & 0x3f)));
+            out.push_back(char(0x80 | (code & 0x3f)));
+        }
+        else
+        {
+            out.push_back(char(0xf0 | (code >> 18)));
+            out.push_back(char(0x80 | ((code >> 12) & 0x3f)));
+            out.push_back(char(0x80 | ((code >> 6) & 0x3f)));
+            out.push_back(char(0x80 | (code & 0x3f)));
+        }
+    }
+
+    void AppendWide(wstring& out, uint32_t code)
+    {
+        if (sizeof(wchar_t) == 2 && code >= 0x10000)
+        {
+            code -= 0x10000;
+            out.push_back(wchar_t(0xd800 | (code >> 10)));
+            out.push_back(wchar_t(0xdc00 | (code & 0x3ff)));
+            return;
+        }
+
+        out.push_back(wchar_t(code));
+    }
+
+    void EncodeUtf8(wstring_view wide, string& out)
+    {
+        out.clear();
+        out.reserve(wide.size());
+
+        for (size_t i = 0; i < wide.size(); ++i)
+        {
+            uint32_t code = uint32_t(wide[i]);
+
+            if (code >= 0xd800 && code < 0xdc00 && i + 1 < wide.size())
+            {
+                uint32_t low = uint32_t(wide[i + 1]);
+
+                if (low >= 0xdc00 && low < 0xe000)
+                {
+                    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                    ++i;
+                }
+            }
+
+            AppendUtf8(out, code);
+        }
+    }
+
+    // a byte that does not start a valid sequence is kept as the code point of the same value, the way
+    // transform_to widens the narrow strings read from the template files
+    wstring DecodeUtf8(string_view utf8)
+    {
+        wstring wide;
+        wide.reserve(utf8.size());
+
+        for (size_t i = 0; i < utf8.size();)
+        {
+            unsigned char lead = utf8[i];
+            size_t length      = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xe ? 3 : (lead >> 3) == 0x1e ? 4 : 0;
+            uint32_t code      = length == 1 ? lead : length == 2 ? lead & 0x1f : length == 3 ? lead & 0x0f : lead & 0x07;
+            bool valid         = length != 0 && i + length <= utf8.size();
+
+            for (size_t k = 1; valid && k < length; ++k)
+            {
+                unsigned char next = utf8[i + k];
+                valid              = (next & 0xc0) == 0x80;
+                code               = (code << 6) | (next & 0x3f);
+            }
+
+            if (!valid)
+            {
+                AppendWide(wide, lead);
+                ++i;
+                continue;
+            }
+
+            AppendWide(wide, code);
+            i += length;
+        }
+
+        return wide;
+    }
+
+    void Normalize(string_view path, string& normalized, string& lower)
+    {
+        normalized.assign(path.data(), path.size());
+        replace(normalized.begin(), normalized.end(), '/', '\\');
+        lower = normalized;
+        nemesis::to_lower(lower);
+    }
+} // namespace
+
+const string& nemesis::PathHandle::Utf8() const
+{
+    return PathInterner::Instance().Get(id).utf8;
+}
+
+const string& nemesis::PathHandle::Lower() const
+{
+    return PathInterner::Instance().Get(id).lower;
+}
+
+const wstring& nemesis::PathHandle::Wide() const
+{
+    return PathInterner::Instance().Get(id).wide;
+}
+
+size_t nemesis::PathInterner::FoldedHash::operator()(string_view lower) const noexcept
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (unsigned char ch : lower)
+    {
+        hash ^= ch;
+        hash *= 1099511628211ull;
+    }
+
+    return size_t(hash);
+}
+
+nemesis::PathInterner& nemesis::PathInterner::Instance()
+{
+    static PathInterner interner;
+    return interner;
+}
+
+nemesis::PathInterner::PathInterner()
+{
+    Insert("", "");
+}
+
+nemesis::PathInterner::~PathInterner()
+{
+    for (auto& chunk : chunks)
+    {
+        delete[] chunk.load();
+    }
+}
+
+nemesis::PathHandle nemesis::PathInterner::Intern(string_view utf8)
+{
+    // a byte that is not valid UTF-8 is the code point of its value, as narrowed by transform_to
+    if (any_of(utf8.begin(), utf8.end(), [](char ch) { return (unsigned char) ch >= 0x80; }))
+    {
+        thread_local string canonical;
+        EncodeUtf8(DecodeUtf8(utf8), canonical);
+        return InternEncoded(canonical);
+    }
+
+    return InternEncoded(utf8);
+}
+
+nemesis::PathHandle nemesis::PathInterner::Intern(wstring_view wide)
+{
+    thread_local string utf8;
+    EncodeUtf8(wide, utf8);
+    return InternEncoded(utf8);
+}
+
+nemesis::PathHandle nemesis::PathInterner::InternEncoded(string_view utf8)
+{
+    thread_local string normalized;
+    thread_local string lower;
+    Normalize(utf8, normalized, lower);
+
+    {
+        shared_lock<shared_mutex> lock(indexLock);
+        auto itr = index.find(lower);
+
+        if (itr != index.end()) return PathHandle(itr->second);
+    }
+
+    return Insert(normalized, lower);
+}
+
+size_t nemesis::PathInterner::Size() const noexcept
+{
+    return count.load(memory_order_acquire);
+}
+
+nemesis::PathHandle nemesis::PathInterner::Insert(string_view normalized, string_view lower)
+{
+    unique_lock<shared_mutex> lock(indexLock);
+    auto itr = index.find(lower);
+
+    if (itr != index.end()) return PathHandle(itr->second);
+
+    uint32_t id  = count.load(memory_order_relaxed);
+    size_t chunk = id >> chunkBits;
+
+    if (chunk >= maxChunks) throw length_error("Too many interned paths");
+
+    Entry* block = chunks[chunk].load(memory_order_relaxed);
+
+    if (!block)
+    {
+        block = new Entry[chunkSize];
+        chunks[chunk].store(block, memory_order_release);
+    }
+
+    Entry& entry = block[id & (chunkSize - 1)];
+    entry.utf8   = string(normalized);
+    entry.lower  = string(lower);
+    entry.wide   = DecodeUtf8(entry.utf8);
+    index.emplace(entry.lower, id);
+    count.store(id + 1, memory_order_release);
+    return PathHandle(id);
+}
+
+const nemesis::PathInterner::Entry& nemesis::PathInterner::Get(uint32_t id) const noexcept
+{
+    return chunks[id >> chunkBits].load(memory_order_acquire)[id & (chunkSize - 1)];
+}
@@ -0,0 +1,283 @@
+#include <algorithm>
+
+#include "utilities/pathmanifest.h"
+
+using namespace std;
+
+namespace sf = filesystem;
+
+namespace
+{
+    constexpr uint32_t manifestMagic   = 0x4d504e4e; // "NNPM"
+    constexpr uint32_t manifestVersion = 1;
+    constexpr uint32_t maxDisplacement = 1 << 24;
+
+    uint64_t Hash(string_view bytes, uint32_t seed)
+    {
+        uint64_t hash = 14695981039346656037ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+
+        for (unsigned char ch : bytes)
+        {
+            hash ^= ch;
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    // hash and displace: keys are grouped into buckets by the seed 0 hash, then the largest buckets are placed
+    // first, each with the first seed that moves all of its keys to free slots
+    bool BuildIndex(const vector<string_view>& keys, vector<uint32_t>& displacements, vector<uint32_t>& slots)
+    {
+        uint32_t entryCount  = uint32_t(keys.size());
+        uint32_t bucketCount = entryCount == 0 ? 0 : entryCount / 2 + 1;
+        vector<vector<uint32_t>> buckets(bucketCount);
+        displacements.assign(bucketCount, 0);
+        slots.assign(entryCount, UINT32_MAX);
+
+        for (uint32_t i = 0; i < entryCount; ++i)
+        {
+            buckets[Hash(keys[i], 0) % bucketCount].push_back(i);
+        }
+
+        vector<uint32_t> order(bucketCount);
+
+        for (uint32_t i = 0; i < bucketCount; ++i)
+        {
+            order[i] = i;
+        }
+
+        stable_sort(order.begin(), order.end(), [&](uint32_t l, uint32_t r) {
+            return buckets[l].size() > buckets[r].size();
+        });
+
+        vector<uint32_t> placed;
+
+        for (uint32_t bucket : order)
+        {
+            if (buckets[bucket].empty()) break;
+
+            uint32_t seed = 1;
+
+            for (; seed < maxDisplacement; ++seed)
+            {
+                placed.clear();
+
+                for (uint32_t entry : buckets[bucket])
+                {
+                    uint32_t slot = uint32_t(Hash(keys[entry], seed) % entryCount);
+
+                    if (slots[slot] != UINT32_MAX || find(placed.begin(), placed.end(), slot) != placed.end()) break;
+
+                    placed.push_back(slot);
+                }
+
+                if (placed.size() == buckets[bucket].size()) break;
+            }
+
+            if (seed == maxDisplacement) return false;
+
+            displacements[bucket] = seed;
+
+            for (size_t i = 0; i < placed.size(); ++i)
+            {
+                slots[placed[i]] = buckets[bucket][i];
+            }
+        }
+
+        return true;
+    }
+
+    struct Cursor
+    {
+        const char* data;
+        size_t size;
+        size_t pos = 0;
+
+        const uint32_t* TakeArray(size_t count)
+        {
+            if ((size - pos) / sizeof(uint32_t) < count) return nullptr;
+
+            const uint32_t* ptr = reinterpret_cast<const uint32_t*>(data + pos);
+            pos += count * sizeof(uint32_t);
+            return ptr;
+        }
+
+        bool Take(uint32_t& value)
+        {
+            const uint32_t* ptr = TakeArray(1);
+
+            if (!ptr) return false;
+
+            value = *ptr;
+            return true;
+        }
+    };
+} // namespace
+
+uint32_t nemesis::PathManifest::Builder::Intern(string_view bytes)
+{
+    auto itr = stringIndex.find(string(bytes));
+
+    if (itr != stringIndex.end()) return itr->second;
+
+    uint32_t id = uint32_t(strings.size());
+    strings.emplace_back(bytes);
+    stringIndex.emplace(strings.back(), id);
+    return id;
+}
+
+void nemesis::PathManifest::Builder::AddEntry(Table table, uint32_t key, vector<uint32_t> values)
+{
+    auto itr = entryIndex[table].find(key);
+
+    if (itr == entryIndex[table].end())
+    {
+        entryIndex[table].emplace(key, entries[table].size());
+        entries[table].push_back(Entry{key, move(values)});
+    }
+    else
+    {
+        auto& existing = entries[table][itr->second].values;
+        existing.insert(existing.end(), values.begin(), values.end());
+    }
+}
+
+bool nemesis::PathManifest::Builder::Save(const sf::path& filepath) const
+{
+    BinaryWriter output(filepath, manifestMagic, manifestVersion);
+    vector<uint32_t> ranges;
+    uint32_t blobSize = 0;
+    ranges.reserve(strings.size() * 2);
+
+    // strings are 4 byte aligned so wide strings can be viewed in place
+    for (auto& str : strings)
+    {
+        ranges.push_back(blobSize);
+        ranges.push_back(uint32_t(str.length()));
+        blobSize += (uint32_t(str.length()) + 3) & ~3U;
+    }
+
+    output.Write(uint32_t(strings.size()));
+    output.WriteBytes(ranges.data(), ranges.size() * sizeof(uint32_t));
+    output.Write(blobSize);
+
+    for (auto& str : strings)
+    {
+        const char padding[4] = {};
+        output.WriteBytes(str.data(), str.length());
+        output.WriteBytes(padding, ((str.length() + 3) & ~size_t(3)) - str.length());
+    }
+
+    for (auto& table : entries)
+    {
+        vector<string_view> keys;
+        vector<uint32_t> displacements;
+        vector<uint32_t> slots;
+        vector<uint32_t> flatEntries;
+        vector<uint32_t> values;
+        keys.reserve(table.size());
+        flatEntries.reserve(table.size() * 3);
+
+        for (auto& entry : table)
+        {
+            keys.push_back(strings[entry.key]);
+            flatEntries.push_back(entry.key);
+            flatEntries.push_back(uint32_t(values.size()));
+            flatEntries.push_back(uint32_t(entry.values.size()));
+            values.insert(values.end(), entry.values.begin(), entry.values.end());
+        }
+
+        if (!BuildIndex(keys, displacements, slots)) return false;
+
+        output.Write(uint32_t(table.size()));
+        output.Write(uint32_t(displacements.size()));
+        output.Write(uint32_t(values.size()));
+        output.WriteBytes(displacements.data(), displacements.size() * sizeof(uint32_t));
+        output.WriteBytes(slots.data(), slots.size() * sizeof(uint32_t));
+        output.WriteBytes(flatEntries.data(), flatEntries.size() * sizeof(uint32_t));
+        output.WriteBytes(values.data(), values.size() * sizeof(uint32_t));
+    }
+
+    return output.Commit();
+}
+
+bool nemesis::PathManifest::Load(const sf::path& filepath)
+{
+    stringCount = 0;
+
+    if (!file.Open(filepath)) return false;
+
+    Cursor cursor{file.Data(), file.Size()};
+    uint32_t magic;
+    uint32_t version;
+
+    if (!cursor.Take(magic) || !cursor.Take(version) || magic != manifestMagic || version != manifestVersion
+        || !cursor.Take(stringCount) || !(stringRanges = cursor.TakeArray(size_t(stringCount) * 2))
+        || !cursor.Take(blobSize))
+    {
+        file.Close();
+        return false;
+    }
+
+    blob = file.Data() + cursor.pos;
+
+    if (!cursor.TakeArray(blobSize / sizeof(uint32_t)))
+    {
+        file.Close();
+        return false;
+    }
+
+    for (auto& table : tables)
+    {
+        if (!cursor.Take(table.entryCount) || !cursor.Take(table.bucketCount) || !cursor.Take(table.valueCount)
+            || !(table.displacements = cursor.TakeArray(table.bucketCount))
+            || !(table.slots = cursor.TakeArray(table.entryCount))
+            || !(table.entries = cursor.TakeArray(size_t(table.entryCount) * 3))
+            || !(table.values = cursor.TakeArray(table.valueCount)))
+        {
+            file.Close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool nemesis::PathManifest::IsLoaded() const
+{
+    return file.IsOpen();
+}
+
+uint32_t nemesis::PathManifest::Size(Table table) const
+{
+    return IsLoaded() ? tables[table].entryCount : 0;
+}
+
+string_view nemesis::PathManifest::GetBytes(uint32_t id) const
+{
+    if (id >= stringCount) return string_view();
+
+    uint32_t offset = stringRanges[id * 2];
+    uint32_t length = stringRanges[id * 2 + 1];
+
+    if (offset > blobSize || blobSize - offset < length) return string_view();
+
+    return string_view(blob + offset, length);
+}
+
+uint32_t nemesis::PathManifest::FindEntry(Table table, string_view key) const
+{
+    if (!IsLoaded()) return npos;
+
+    const TableView& view = tables[table];
+
+    if (view.bucketCount == 0 || view.entryCount == 0) return npos;
+
+    uint32_t seed  = view.displacements[Hash(key, 0) % view.bucketCount];
+    uint32_t entry = view.slots[Hash(key, seed) % view.entryCount];
+
+    if (entry >= view.entryCount || GetBytes(view.entries[entry * 3]) != key) return npos;
+
+    return entry;
+}
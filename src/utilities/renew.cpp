@@ -76,7 +76,7 @@ void ClearTempBehaviors(const NemesisInfo* nemesisInfo)
 void ClearTempXml(const NemesisInfo* nemesisInfo)
 {
     VecWstr filelist;
-    wstring tempbehavior = getTempBhvrPath(nemesisInfo).wstring() + L"\\xml";
+    wstring tempbehavior = getTempXmlPath(nemesisInfo).wstring();
 
     if (isFileExist(tempbehavior) && sf::is_directory(tempbehavior))
     {
@@ -1,7 +1,71 @@
+#include <exception>
+
 #include "utilities/threadpool.h"
 
 using namespace std;
 
+namespace
+{
+    thread_local void* taskLocal = nullptr;
+    thread_local atomic<bool>* taskCancelled = nullptr;
+
+    atomic<bool> processCancelled{false};
+
+    const int helperCount = int(max(1u, thread::hardware_concurrency())) - 1;
+
+    // threads of the shared pool no ParallelFor is using
+    atomic<int> idleHelpers{helperCount};
+
+    int ClaimHelpers(int wanted)
+    {
+        int available = idleHelpers.load();
+
+        while (available > 0 && wanted > 0)
+        {
+            int taken = min(available, wanted);
+
+            if (idleHelpers.compare_exchange_weak(available, available - taken)) return taken;
+        }
+
+        return 0;
+    }
+
+    nemesis::ThreadPool& HelperPool()
+    {
+        static nemesis::ThreadPool pool(nemesis::uint(max(helperCount, 1)));
+        return pool;
+    }
+} // namespace
+
+void* nemesis::TaskLocal::Get() noexcept
+{
+    return taskLocal;
+}
+
+atomic<bool>& nemesis::TaskLocal::Cancelled() noexcept
+{
+    return taskCancelled ? *taskCancelled : processCancelled;
+}
+
+atomic<bool>& nemesis::TaskLocal::ProcessCancelled() noexcept
+{
+    return processCancelled;
+}
+
+nemesis::TaskLocal::Scope::Scope(void* value, atomic<bool>* cancelled) noexcept
+    : previous(taskLocal)
+    , previousCancelled(taskCancelled)
+{
+    taskLocal     = value;
+    taskCancelled = cancelled;
+}
+
+nemesis::TaskLocal::Scope::~Scope()
+{
+    taskLocal     = previous;
+    taskCancelled = previousCancelled;
+}
+
 nemesis::ThreadPool::ThreadPool(uint threads)
 {
     workers.reserve(threads);
@@ -40,6 +104,54 @@ nemesis::ThreadPool::~ThreadPool()
     if (!sync) join_all();
 }
 
+void nemesis::ParallelFor(size_t count, size_t grain, const function<void(size_t)>& task)
+{
+    atomic<size_t> next{0};
+    atomic<bool> failed{false};
+    exception_ptr thrown;
+    mutex thrownLock;
+
+    auto work = [&]() {
+        for (size_t i = next++; i < count && !failed; i = next++)
+        {
+            try
+            {
+                task(i);
+            }
+            catch (...)
+            {
+                lock_guard<mutex> guard(thrownLock);
+
+                if (!thrown) thrown = current_exception();
+
+                failed = true;
+            }
+        }
+    };
+
+    // a claimed helper always finds an idle thread in the pool, as no more helpers are out than the pool has threads
+    int helpers = ClaimHelpers(int(count / max(grain, size_t(1))));
+    vector<future<void>> jobs;
+    jobs.reserve(helpers);
+
+    for (int i = 0; i < helpers; ++i)
+    {
+        jobs.push_back(HelperPool().enqueue(work));
+    }
+
+    // the caller works too, so the loop finishes even when the pool drops the jobs
+    work();
+
+    for (auto& job : jobs)
+    {
+        job.wait();
+    }
+
+    idleHelpers += helpers;
+
+    if (thrown) rethrow_exception(thrown);
+}
+
 void nemesis::ThreadPool::newWorker()
 {
     workers.emplace_back([&] {
@@ -49,9 +161,9 @@ void nemesis::ThreadPool::newWorker()
 
             {
                 unique_lock<mutex> lock(queue_mutex);
-                condition.wait(lock, [&] { return error || abort || sync || !tasks.empty(); });
+                condition.wait(lock, [&] { return abort || sync || !tasks.empty(); });
 
-                if (error || abort || tasks.empty()) return;
+                if (abort || tasks.empty()) return;
 
                 task = tasks.front();
                 tasks.pop();
@@ -62,3 +174,27 @@ void nemesis::ThreadPool::newWorker()
     });
 }
 
+void nemesis::ThreadPool::push(function<void()> task)
+{
+    {
+        unique_lock<mutex> lock(queue_mutex);
+
+        atomic<bool>* cancelled = &TaskLocal::Cancelled();
+
+        if (*cancelled) return;
+
+        // don't allow enqueueing after stopping the pool
+        if (abort) throw runtime_error("enqueue on stopped ThreadPool");
+
+        // the task runs in the context of the thread that queued it, so one pool can serve several runs
+        // a task of a cancelled run is dropped, which breaks its promise and releases whoever waits on it
+        tasks.emplace([local = TaskLocal::Get(), cancelled, task = move(task)]() {
+            if (*cancelled) return;
+
+            TaskLocal::Scope scope(local, cancelled);
+            task();
+        });
+    }
+
+    condition.notify_one();
+}
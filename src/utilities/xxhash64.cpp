@@ -0,0 +1,142 @@
+#include <cstring>
+
+#include "utilities/xxhash64.h"
+
+namespace
+{
+    constexpr uint64_t prime1 = 11400714785074694791ULL;
+    constexpr uint64_t prime2 = 14029467366897019727ULL;
+    constexpr uint64_t prime3 = 1609587929392839161ULL;
+    constexpr uint64_t prime4 = 9650029242287828579ULL;
+    constexpr uint64_t prime5 = 2870177450012600261ULL;
+
+    uint64_t rotl(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    // little endian reads, the byte order the algorithm is defined in
+    uint64_t read64(const unsigned char* data)
+    {
+        uint64_t value = 0;
+
+        for (int i = 7; i >= 0; --i)
+        {
+            value = (value << 8) | data[i];
+        }
+
+        return value;
+    }
+
+    uint32_t read32(const unsigned char* data)
+    {
+        return uint32_t(data[0]) | uint32_t(data[1]) << 8 | uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24;
+    }
+
+    uint64_t round(uint64_t lane, uint64_t input)
+    {
+        lane += input * prime2;
+        return rotl(lane, 31) * prime1;
+    }
+
+    uint64_t mergeRound(uint64_t hash, uint64_t lane)
+    {
+        hash ^= round(0, lane);
+        return hash * prime1 + prime4;
+    }
+}
+
+nemesis::XXHash64::XXHash64(uint64_t seed)
+    : seed(seed)
+{
+    lanes[0] = seed + prime1 + prime2;
+    lanes[1] = seed + prime2;
+    lanes[2] = seed;
+    lanes[3] = seed - prime1;
+}
+
+void nemesis::XXHash64::Update(const void* data, size_t length)
+{
+    const unsigned char* input = static_cast<const unsigned char*>(data);
+    total += length;
+
+    if (buffered + length < sizeof(buffer))
+    {
+        memcpy(buffer + buffered, input, length);
+        buffered += length;
+        return;
+    }
+
+    if (buffered > 0)
+    {
+        size_t fill = sizeof(buffer) - buffered;
+        memcpy(buffer + buffered, input, fill);
+        input += fill;
+        length -= fill;
+        buffered = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            lanes[i] = round(lanes[i], read64(buffer + i * 8));
+        }
+    }
+
+    for (; length >= sizeof(buffer); input += sizeof(buffer), length -= sizeof(buffer))
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            lanes[i] = round(lanes[i], read64(input + i * 8));
+        }
+    }
+
+    memcpy(buffer, input, length);
+    buffered = length;
+}
+
+uint64_t nemesis::XXHash64::Digest() const
+{
+    uint64_t hash;
+
+    if (total >= sizeof(buffer))
+    {
+        hash = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            hash = mergeRound(hash, lanes[i]);
+        }
+    }
+    else
+    {
+        hash = seed + prime5;
+    }
+
+    hash += total;
+    size_t i = 0;
+
+    for (; i + 8 <= buffered; i += 8)
+    {
+        hash ^= round(0, read64(buffer + i));
+        hash = rotl(hash, 27) * prime1 + prime4;
+    }
+
+    if (i + 4 <= buffered)
+    {
+        hash ^= uint64_t(read32(buffer + i)) * prime1;
+        hash = rotl(hash, 23) * prime2 + prime3;
+        i += 4;
+    }
+
+    for (; i < buffered; ++i)
+    {
+        hash ^= buffer[i] * prime5;
+        hash = rotl(hash, 11) * prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+}